@@ -26,4 +26,20 @@ AC_DEFUN([TM_FASTALLOC],[
 	  AC_MSG_ERROR([bad option --enable-fastalloc=$enable_fastalloc])
 	  ;;
   esac
+
+  AC_ARG_ENABLE(atomic-refcount,
+  [  --enable-atomic-refcount
+                          thread safe reference counting],
+      [], [enable_atomic_refcount="no"])
+  case "$enable_atomic_refcount" in
+      yes)
+	  AC_MSG_RESULT([enabling thread safe reference counting])
+	  AC_DEFINE(ATOMIC_REFCOUNT, 1, [Use thread safe reference counting])
+	  ;;
+      no)
+	  ;;
+      *)
+	  AC_MSG_ERROR([bad option --enable-atomic-refcount=$enable_atomic_refcount])
+	  ;;
+  esac
 ])
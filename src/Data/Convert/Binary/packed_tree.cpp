@@ -0,0 +1,259 @@
+/******************************************************************************
+* MODULE     : packed_tree.cpp
+* DESCRIPTION: compact binary representation of trees
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "Binary/packed_tree.hpp"
+#include "file.hpp"
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef OS_MINGW
+#include <sys/mman.h>
+#endif
+
+#define PACKED_HEADER 4 // magic, version, checksum, number of words
+
+static int
+packed_magic () {
+  int m;
+  memcpy ((void*) &m, (const void*) "TMPK", 4);
+  return m;
+}
+
+static int
+packed_checksum (const int* w, int n) {
+  unsigned int h= 2166136261u;
+  for (int i=0; i<n; i++)
+    h= (h ^ ((unsigned int) w[i])) * 16777619u;
+  return (int) h;
+}
+
+/******************************************************************************
+* Packing trees
+******************************************************************************/
+
+struct packed_writer {
+  hashmap<string,int> str_code;
+  array<string>       strs;
+  hashmap<string,int> node_code;
+  array<int>          offs;
+  array<int>          words;
+
+  packed_writer (): str_code (-1), node_code (-1) {}
+  int make_string (string s);
+  int make_node (tree t);
+  string pack (tree t);
+};
+
+int
+packed_writer::make_string (string s) {
+  int code= str_code[s];
+  if (code >= 0) return code;
+  code= N(strs);
+  strs << s;
+  str_code (s)= code;
+  return code;
+}
+
+int
+packed_writer::make_node (tree t) {
+  array<int> w;
+  if (is_atomic (t)) w << (make_string (t->label) << 1);
+  else {
+    int i, n= N(t);
+    array<int> ch (n);
+    for (i=0; i<n; i++) ch[i]= make_node (t[i]);
+    w << ((make_string (as_string (L(t))) << 1) | 1) << n;
+    w << ch;
+  }
+  string key ((const char*) A(w), N(w) * sizeof (int));
+  int code= node_code[key];
+  if (code >= 0) return code;
+  code= N(offs);
+  offs << N(words);
+  words << w;
+  node_code (key)= code;
+  return code;
+}
+
+string
+packed_writer::pack (tree t) {
+  int i, root= make_node (t);
+  array<int> r;
+  r << packed_magic () << PACKED_TREE_VERSION << 0 << 0;
+  r << N(strs);
+  int pos= 0;
+  for (i=0; i<N(strs); i++) {
+    r << pos;
+    pos += N(strs[i]);
+  }
+  r << pos;
+  r << N(offs) << root << offs;
+  r << N(words) << words;
+  int start= N(r);
+  r->resize (start + ((pos + 3) >> 2));
+  for (i=start; i<N(r); i++) r[i]= 0;
+  char* pool= (char*) (A(r) + start);
+  for (i=0; i<N(strs); i++) {
+    string s= strs[i];
+    if (N(s) != 0) memcpy ((void*) pool, (const void*) &(s[0]), N(s));
+    pool += N(s);
+  }
+  r[3]= N(r) - PACKED_HEADER;
+  r[2]= packed_checksum (A(r) + PACKED_HEADER, r[3]);
+  return string ((const char*) A(r), N(r) * sizeof (int));
+}
+
+string
+pack_tree (tree t) {
+  packed_writer w;
+  return w.pack (t);
+}
+
+/******************************************************************************
+* Reading packed trees
+******************************************************************************/
+
+packed_tree_rep::packed_tree_rep (string s):
+  buf (s), data (NULL), size (N(s)), mapped (false), valid (false),
+  decoded (UNINIT)
+{
+  if (size > 0) data= &(buf[0]);
+  init ();
+}
+
+packed_tree_rep::packed_tree_rep (url u):
+  buf (), data (NULL), size (0), mapped (false), valid (false),
+  decoded (UNINIT)
+{
+#ifndef OS_MINGW
+  url r= resolve (u);
+  if (!is_none (r) && is_rooted_name (r)) {
+    c_string _name (concretize (r));
+    int fd= ::open (_name, O_RDONLY);
+    if (fd >= 0) {
+      struct stat st;
+      if (fstat (fd, &st) == 0 && st.st_size > 0 && st.st_size < (1 << 30)) {
+        void* p= mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+          data= (const char*) p;
+          size= (int) st.st_size;
+          mapped= true;
+        }
+      }
+      ::close (fd);
+    }
+  }
+#endif
+  if (!mapped && !load_string (u, buf, false) && N(buf) > 0) {
+    data= &(buf[0]);
+    size= N(buf);
+  }
+  init ();
+}
+
+packed_tree_rep::~packed_tree_rep () {
+#ifndef OS_MINGW
+  if (mapped) munmap ((void*) data, size);
+#endif
+}
+
+void
+packed_tree_rep::init () {
+  nr_strs= nr_nodes= 0;
+  str_offs= node_offs= words= NULL;
+  str_pool= NULL;
+  root_node= -1;
+  if (data == NULL || (size & 3) != 0 || (((size_t) data) & 3) != 0) return;
+  const int* w= (const int*) data;
+  int n= size >> 2;
+  if (n < PACKED_HEADER || w[0] != packed_magic ()) return;
+  if (w[1] != PACKED_TREE_VERSION || w[3] != n - PACKED_HEADER) return;
+  if (packed_checksum (w + PACKED_HEADER, w[3]) != w[2]) return;
+
+  int pos= PACKED_HEADER;
+  if (pos >= n) return;
+  nr_strs= w[pos++];
+  if (nr_strs < 0 || nr_strs > n - pos - 2) return;
+  str_offs= w + pos;
+  pos += nr_strs + 1;
+  nr_nodes= w[pos++];
+  if (nr_nodes <= 0 || nr_nodes > n - pos - 2) return;
+  root_node= w[pos++];
+  node_offs= w + pos;
+  pos += nr_nodes;
+  int nr_words= w[pos++];
+  if (nr_words < 0 || nr_words > n - pos) return;
+  words= w + pos;
+  pos += nr_words;
+  str_pool= (const char*) (w + pos);
+  int pool_size= (n - pos) << 2;
+  if (str_offs[0] != 0) return;
+  for (int i=0; i<nr_strs; i++)
+    if (str_offs[i+1] < str_offs[i] || str_offs[i+1] > pool_size) return;
+  if (root_node < 0 || root_node >= nr_nodes) return;
+  valid= check_nodes (nr_words);
+}
+
+bool
+packed_tree_rep::check_nodes (int nr_words) {
+  // Nodes are written after their children, so requiring children
+  // to have smaller indices also excludes cycles in corrupted files
+  for (int i=0; i<nr_nodes; i++) {
+    int off= node_offs[i];
+    if (off < 0 || off >= nr_words) return false;
+    int head= words[off];
+    if (head < 0 || (head >> 1) >= nr_strs) return false;
+    if ((head & 1) == 0) continue;
+    if (off + 1 >= nr_words) return false;
+    int n= words[off + 1];
+    if (n < 0 || n > nr_words - off - 2) return false;
+    for (int j=0; j<n; j++) {
+      int c= words[off + 2 + j];
+      if (c < 0 || c >= i) return false;
+    }
+  }
+  return true;
+}
+
+string
+packed_tree_rep::label (int i) {
+  int code= words[node_offs[i]] >> 1;
+  int start= str_offs[code];
+  return string (str_pool + start, str_offs[code+1] - start);
+}
+
+tree
+packed_tree_rep::get (int i) {
+  if (decoded->contains (i)) return decoded[i];
+  tree t;
+  if (is_atomic (i)) t= tree (label (i));
+  else {
+    int j, n= arity (i);
+    t= tree (make_tree_label (label (i)), n);
+    for (j=0; j<n; j++)
+      t[j]= get (child (i, j));
+  }
+  decoded (i)= t;
+  return t;
+}
+
+packed_tree::packed_tree (string s):
+  rep (tm_new<packed_tree_rep> (s)) {}
+
+packed_tree::packed_tree (url u):
+  rep (tm_new<packed_tree_rep> (u)) {}
+
+tree
+unpack_tree (string s) {
+  packed_tree p (s);
+  if (!p->ok ()) return tree (UNINIT);
+  return p->get (p->root ());
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+* MODULE     : packed_tree.hpp
+* DESCRIPTION: compact binary representation of trees
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef PACKED_TREE_H
+#define PACKED_TREE_H
+#include "url.hpp"
+#include "hashmap.hpp"
+
+/******************************************************************************
+* A packed tree consists of a header with a format version and a checksum,
+* followed by a table of strings and an array of nodes. Identical subtrees
+* are stored only once and nodes refer to their children and labels through
+* their indices. Packed trees are read directly from memory mapped files,
+* without any parsing, and nodes are only converted into trees on demand.
+* Each node is decoded at most once and the resulting trees are shared
+* between all their parents, so they should not be modified in place.
+* The format uses the native byte order and is only meant for caches.
+******************************************************************************/
+
+#define PACKED_TREE_VERSION 1
+
+class packed_tree;
+struct packed_tree_rep: concrete_struct {
+  string      buf;       // contents when not mapped
+  const char* data;      // start of the contents
+  int         size;      // size of the contents in bytes
+  bool        mapped;    // contents mapped into memory ?
+  bool        valid;     // well formed contents ?
+  int         nr_strs;   // number of strings
+  const int*  str_offs;  // start of each string in the pool
+  const char* str_pool;  // characters of all strings
+  int         nr_nodes;  // number of nodes
+  const int*  node_offs; // start of each node in the word array
+  const int*  words;     // encoded nodes
+  int         root_node; // index of the root node
+  hashmap<int,tree> decoded; // nodes which were already converted
+
+  packed_tree_rep (string s);
+  packed_tree_rep (url u);
+  ~packed_tree_rep ();
+  void init ();
+  bool check_nodes (int nr_words);
+
+  inline bool ok () { return valid; }
+  inline int  root () { return root_node; }
+  inline bool is_atomic (int i) { return (words[node_offs[i]] & 1) == 0; }
+  inline int  arity (int i) {
+    return is_atomic (i)? 0: words[node_offs[i] + 1]; }
+  inline int  child (int i, int j) { return words[node_offs[i] + 2 + j]; }
+  string label (int i);
+  tree   get (int i);
+};
+
+class packed_tree {
+  CONCRETE(packed_tree);
+  packed_tree (string s);
+  packed_tree (url u);
+};
+CONCRETE_CODE(packed_tree);
+
+string pack_tree (tree t);
+tree   unpack_tree (string s);
+
+#endif // defined PACKED_TREE_H
@@ -130,7 +130,68 @@ tree_to_scheme_tree (tree t) {
 * Conversion of trees to scheme strings
 ******************************************************************************/
 
+struct scheme_writer {
+  tm_ostream* out;   // where the output is written, if not NULL
+  string      buf;   // the resulting string, or the not yet written output
+
+  scheme_writer (tm_ostream* out2= NULL): out (out2), buf ("") {}
+  void write_symbol (string s);
+  void write (tree t);
+};
+
+void
+scheme_writer::write_symbol (string s) {
+  if (is_quoted (s)) buf << scm_quote (raw_unquote (s));
+  else buf << slash (s);
+}
+
+void
+scheme_writer::write (tree t) {
+  // same output as scheme_tree_to_string (tree_to_scheme_tree (t)),
+  // but without building the intermediate scheme tree
+  if (is_atomic (t)) write_symbol (scm_quote (t->label));
+  else {
+    int i, n= N(t), first= 0;
+    string s;
+    if (is_func (t, EXPAND) && is_atomic (t[0])) {
+      s= t[0]->label;
+      first= 1;
+    }
+    else {
+      s= as_string (L(t));
+      if (N(s) > 0 && is_digit (s[0]))
+        if (is_int (s)) s= "'" * s;
+    }
+    if ((s == "\'") && (n - first == 1)) {
+      buf << "\'";
+      write (t[first]);
+    }
+    else {
+      buf << "(";
+      write_symbol (s);
+      for (i=first; i<n; i++) {
+        buf << " ";
+        write (t[i]);
+      }
+      buf << ")";
+    }
+  }
+  if ((out != NULL) && (N(buf) >= (1 << 14))) {
+    *out << buf;
+    buf= "";
+  }
+}
+
 string
 tree_to_scheme (tree t) {
-  return scheme_tree_to_string (tree_to_scheme_tree (t));
+  scheme_writer w;
+  w.write (t);
+  return w.buf;
+}
+
+void
+tree_to_scheme (tree t, tm_ostream& out) {
+  scheme_writer w (&out);
+  w.write (t);
+  out << w.buf;
 }
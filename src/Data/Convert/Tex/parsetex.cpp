@@ -930,7 +930,7 @@ latex_parser::parse_command (string s, int& i, string cmd, int change) {
     while (i < N(s) && s[i] != '{') {
       if (i < N(s) && s[i] == '#') {
         while (i < N(s) && s[i] == '#') i++;
-        if (i < N(s) && is_digit (s[i])) args = s[i];
+        if (i < N(s) && is_digit (s[i])) args = s (i, i+1);
       }
       else
         i++;
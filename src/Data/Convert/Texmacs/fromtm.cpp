@@ -14,56 +14,122 @@
 #include "path.hpp"
 #include "vars.hpp"
 #include "drd_std.hpp"
+#include "file.hpp"
+#include <string.h>
+#ifndef OS_MINGW
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 /******************************************************************************
 * Conversion of TeXmacs strings of the present format to TeXmacs trees
 ******************************************************************************/
 
+// The reader works directly on the characters of the buffer, which may
+// be a memory mapped file: tokens are ranges in the buffer and only
+// the decoded strings of the leaves and of new tag names are allocated.
+
+#define TOKEN_EOF        0  // end of the buffer
+#define TOKEN_SPACE      1  // " "
+#define TOKEN_RETURN     2  // "\n"
+#define TOKEN_BAR        3  // "|"
+#define TOKEN_CLOSE      4  // ">"
+#define TOKEN_OPEN       5  // "<"
+#define TOKEN_OPEN_RAW   6  // "<#"
+#define TOKEN_OPEN_ARGS  7  // "<\\"
+#define TOKEN_OPEN_MORE  8  // "<|"
+#define TOKEN_OPEN_END   9  // "</"
+#define TOKEN_TEXT      10  // the text between start and end
+#define TOKEN_END_CLOSE 11  // "/>", after the name of a closing tag
+#define TOKEN_END_BAR   12  // "/|"
+#define TOKEN_ARGS_CLOSE 13 // "\\>", after the name of an opening tag
+#define TOKEN_ARGS_BAR  14  // "\\|"
+#define TOKEN_MORE_CLOSE 15 // "|>", after the name of a separating tag
+#define TOKEN_MORE_BAR  16  // "||"
+#define TOKEN_KINDS     17
+
+static const char* token_string [TOKEN_KINDS]= {
+  "", " ", "\n", "|", ">", "<", "<#", "<\\", "<|", "</", "",
+  "/>", "/|", "\\>", "\\|", "|>", "||" };
+
+struct tm_tag {
+  string     raw;             // the undecoded text token of the name
+  string     name;            // the decoded name
+  tree_label l;               // the corresponding label
+  bool       apply;           // encoded as EXPAND_APPLY applied to name
+};
+
 struct tm_reader {
   string  version;            // document was composed using this version
   hashmap<string,int> codes;  // codes for to present version
   tree_label EXPAND_APPLY;    // APPLY (version < 0.3.3.22) or EXPAND (otherw)
   bool    backslash_ok;       // true for versions >= 1.0.1.23
   bool    with_extensions;    // true for versions >= 1.0.2.4
-  string  buf;                // the string being read from
+  const char* buf;            // the characters being read from
+  int     n;                  // the number of characters in buf
   int     pos;                // the current position of the reader
-  string  last;               // last read string
-
-  tm_reader (string buf2):
+  int     last;               // kind of the last read token
+  int     start, end;         // range of the last text token in buf
+  bool    escaped;            // whether this range contains backslashes
+  array<tm_tag> tags;         // the tag names encountered so far
+  array<int>    table;        // hash table from text tokens to tags
+  int     special [TOKEN_KINDS]; // tags for names which are not text tokens
+
+  tm_reader (const char* buf2, int n2):
     version (TEXMACS_VERSION),
     codes (STD_CODE),
     EXPAND_APPLY (EXPAND),
     backslash_ok (true),
     with_extensions (true),
-    buf (buf2), pos (0), last ("") {}
-  tm_reader (string buf2, string version2):
+    buf (buf2), n (n2) { init (); }
+  tm_reader (const char* buf2, int n2, string version2):
     version (version2),
     codes (get_codes (version)),
     EXPAND_APPLY (version_inf (version, "0.3.3.22")? APPLY: EXPAND),
     backslash_ok (version_inf (version, "1.0.1.23")? false: true),
     with_extensions (version_inf (version, "1.0.2.4")? false: true),
-    buf (buf2), pos (0), last ("") {}
+    buf (buf2), n (n2) { init (); }
 
+  void   init ();
   int    skip_blank ();
   string decode (string s);
-  string read_char ();
-  string read_next ();
-  string read_function_name ();
-  tree   read_apply (string s, bool skip_flag);
+  int    read_char ();
+  int    read_next ();
+  string text ();
+  void   append_text (string& s);
+  bool   ends_with_bar ();
+  int    new_tag (string raw, string name);
+  int    read_tag ();
+  tree   make_tag (int k);
+  int    read_function_name (bool named);
+  tree   read_apply (int k, bool skip_flag);
   tree   read (bool skip_flag);
 };
 
+void
+tm_reader::init () {
+  pos= 0;
+  last= TOKEN_EOF;
+  start= end= 0;
+  escaped= false;
+  table= array<int> (256);
+  for (int i=0; i<N(table); i++) table[i]= -1;
+  for (int i=0; i<TOKEN_KINDS; i++) special[i]= -1;
+}
+
 int
 tm_reader::skip_blank () {
-  int n=0;
-  for (; pos < N(buf); pos++) {
+  int nr=0;
+  for (; pos < n; pos++) {
     if (buf[pos]==' ') continue;
     if (buf[pos]=='\t') continue;
     if (buf[pos]=='\r') continue;
-    if (buf[pos]=='\n') { n++; continue; }
+    if (buf[pos]=='\n') { nr++; continue; }
     break;
   }
-  return n;
+  return nr;
 }
 
 string
@@ -86,91 +152,206 @@ tm_reader::decode (string s) {
   return r;
 }
 
-string
+inline int
 tm_reader::read_char () {
-  while (((pos+1) < N(buf)) && (buf[pos] == '\\') && (buf[pos+1] == '\n')) {
+  // returns the next character, skipping continued lines, or -1 at the end
+  while (((pos+1) < n) && (buf[pos] == '\\') && (buf[pos+1] == '\n')) {
     pos += 2;
-    skip_spaces (buf, pos);
+    while ((pos < n) && ((buf[pos] == ' ') || (buf[pos] == '\t'))) pos++;
   }
-  if (pos >= N(buf)) return "";
-  pos++;
-  return buf (pos-1, pos);
+  if (pos >= n) return -1;
+  return (unsigned char) buf[pos++];
 }
 
-string
+int
 tm_reader::read_next () {
   int old_pos= pos;
-  string c= read_char ();
-  if (c == "") return c;
-  switch (c[0]) {
+  int c= read_char ();
+  switch (c) {
+  case -1:
+    return TOKEN_EOF;
   case '\t':
   case '\n':
   case '\r':
-  case ' ': 
+  case ' ':
     pos--;
-    if (skip_blank () <= 1) return " ";
-    else return "\n";
+    if (skip_blank () <= 1) return TOKEN_SPACE;
+    else return TOKEN_RETURN;
   case '<':
-    {
-      old_pos= pos;
-      c= read_char ();
-      if (c == "") return "";
-      if (c == "#") return "<#";
-      if ((c == "\\") || (c == "|") || (c == "/")) return "<" * c;
-      if (is_iso_alpha (c[0]) || (c == ">")) {
-        pos= old_pos;
-        return "<";
-      }
-      pos= old_pos;
-      return "<";
-      /*
-      string d= read_char ();
-      if ((d == "\\") || (d == "|") || (d == "/")) return "<" * c * d;
-      pos= old_pos;
-      return "<" * c;
-      */
-    }
+    old_pos= pos;
+    c= read_char ();
+    if (c == -1) return TOKEN_EOF;
+    if (c == '#') return TOKEN_OPEN_RAW;
+    if (c == '\\') return TOKEN_OPEN_ARGS;
+    if (c == '|') return TOKEN_OPEN_MORE;
+    if (c == '/') return TOKEN_OPEN_END;
+    pos= old_pos;
+    return TOKEN_OPEN;
   case '|':
+    return TOKEN_BAR;
   case '>':
-    return c;
+    return TOKEN_CLOSE;
   }
 
-  string r;
-  pos= old_pos;
+  pos= start= old_pos;
+  escaped= false;
   while (true) {
     old_pos= pos;
     c= read_char ();
-    if (c == "") return r;
-    else if (c == "\\") {
-      if ((pos < N(buf)) && (buf[pos] == '\\') && backslash_ok) {
-        r << c << "\\";
+    if (c == -1) { end= old_pos; return TOKEN_TEXT; }
+    else if (c == '\\') {
+      escaped= true;
+      if ((pos < n) && (buf[pos] == '\\') && backslash_ok) pos++;
+      else (void) read_char ();
+    }
+    else if (c == '\t' || c == '\r' || c == '\n' || c == ' ' ||
+             c == '<' || c == '|' || c == '>') break;
+    else if (pos != old_pos + 1) escaped= true;
+  }
+  pos= end= old_pos;
+  return TOKEN_TEXT;
+}
+
+string
+tm_reader::text () {
+  // undecoded contents of the last text token, without continued lines
+  if (!escaped) return string (buf + start, end - start);
+  string r;
+  int old_pos= pos;
+  pos= start;
+  while (pos < end) {
+    int c= read_char ();
+    if (c == -1) break;
+    else if (c == '\\') {
+      r << '\\';
+      if ((pos < n) && (buf[pos] == '\\') && backslash_ok) {
+        r << '\\';
         pos++;
       }
-      else r << c << read_char ();
+      else {
+        c= read_char ();
+        if (c != -1) r << ((char) c);
+      }
     }
-    else if (c == "\t") break;
-    else if (c == "\r") break;
-    else if (c == "\n") break;
-    else if (c == " ") break;
-    else if (c == "<") break;
-    else if (c == "|") break;
-    else if (c == ">") break;
-    else r << c;
+    else r << ((char) c);
   }
   pos= old_pos;
   return r;
 }
 
-string
-tm_reader::read_function_name () {
-  string name= decode (read_next ());
-  // cout << "==> " << name << "\n";
+void
+tm_reader::append_text (string& s) {
+  if (escaped) s << decode (text ());
+  else {
+    int k= N(s), l= end - start;
+    s->resize (k + l);
+    memcpy (&(s[k]), buf + start, l);
+  }
+}
+
+bool
+tm_reader::ends_with_bar () {
+  switch (last) {
+  case TOKEN_BAR:
+  case TOKEN_OPEN_MORE:
+  case TOKEN_END_BAR:
+  case TOKEN_ARGS_BAR:
+  case TOKEN_MORE_BAR:
+    return true;
+  case TOKEN_TEXT:
+    {
+      string r= text ();
+      return (N(r) > 0) && (r[N(r)-1] == '|');
+    }
+  }
+  return false;
+}
+
+/******************************************************************************
+* Tag names
+******************************************************************************/
+
+static inline int
+hash_range (const char* s, int n) {
+  unsigned int h= 2166136261U;
+  for (int i=0; i<n; i++) h= (h ^ ((unsigned char) s[i])) * 16777619U;
+  return (int) (h & 0x7fffffff);
+}
+
+int
+tm_reader::new_tag (string raw, string name) {
+  tm_tag tag;
+  tag.raw  = raw;
+  tag.name = name;
+  tag.l    = make_tree_label (name);
+  tag.apply= !with_extensions;
+  if (codes->contains (name)) {
+    tag.l    = (tree_label) codes [name];
+    tag.apply= false;
+  }
+  tags << tag;
+  return N(tags) - 1;
+}
+
+int
+tm_reader::read_tag () {
+  // reads a tag name and returns the index of the corresponding tag
+  int kind= read_next ();
+  if (kind != TOKEN_TEXT) {
+    if (special[kind] < 0) {
+      string s= token_string[kind];
+      special[kind]= new_tag (s, decode (s));
+    }
+    return special[kind];
+  }
+
+  int l= end - start, mask= N(table) - 1;
+  int i= hash_range (buf + start, l) & mask;
+  while (table[i] >= 0) {
+    string raw= tags[table[i]].raw;
+    if (N(raw) == l && memcmp (&(raw[0]), buf + start, l) == 0)
+      return table[i];
+    i= (i + 1) & mask;
+  }
+  int k= new_tag (string (buf + start, l), decode (text ()));
+  table[i]= k;
+  if (2 * N(tags) > N(table)) {
+    array<int> old= table;
+    table= array<int> (2 * N(old));
+    mask= N(table) - 1;
+    for (i=0; i<N(table); i++) table[i]= -1;
+    for (int j=0; j<N(old); j++)
+      if (old[j] >= 0) {
+        string raw= tags[old[j]].raw;
+        i= hash_range (&(raw[0]), N(raw)) & mask;
+        while (table[i] >= 0) i= (i + 1) & mask;
+        table[i]= old[j];
+      }
+  }
+  return k;
+}
+
+tree
+tm_reader::make_tag (int k) {
+  if (tags[k].apply) return tree (EXPAND_APPLY, tags[k].name);
+  return tree (tags[k].l);
+}
+
+/******************************************************************************
+* Reading the document
+******************************************************************************/
+
+int
+tm_reader::read_function_name (bool named) {
+  int k= -1;
+  if (named) k= read_tag ();
+  else (void) read_next ();
   while (true) {
     last= read_next ();
-    // cout << "~~> " << last << "\n";
-    if ((last == "") || (last == "|") || (last == ">")) break;
+    if ((last == TOKEN_EOF) || (last == TOKEN_BAR) || (last == TOKEN_CLOSE))
+      break;
   }
-  return name;
+  return k;
 }
 
 static void
@@ -186,27 +367,16 @@ get_collection (tree& u, tree t) {
 }
 
 tree
-tm_reader::read_apply (string name, bool skip_flag) {
-  // cout << "Read apply " << name << INDENT << LF;
-  tree t (make_tree_label (name));
-  if (!with_extensions)
-    t= tree (EXPAND_APPLY, name);
-  if (codes->contains (name)) {
-    // cout << "  " << name << " -> " << as_string ((tree_label) codes [name]) << "\n";
-    t= tree ((tree_label) codes [name]);
-  }
-
+tm_reader::read_apply (int k, bool skip_flag) {
+  tree t= make_tag (k);
   bool closed= !skip_flag;
-  while (pos < N(buf)) {
-    // cout << "last= " << last << LF;
-    bool sub_flag= (skip_flag) && ((last == "") || (last[N(last)-1] != '|'));
+  while (pos < n) {
+    bool sub_flag= skip_flag && ((last == TOKEN_EOF) || !ends_with_bar ());
     if (sub_flag) (void) skip_blank ();
     t << read (sub_flag);
-    if ((last == "/>") || (last == "/|")) closed= true;
-    if (closed && ((last == ">") || (last == "/>"))) break;
+    if ((last == TOKEN_END_CLOSE) || (last == TOKEN_END_BAR)) closed= true;
+    if (closed && ((last == TOKEN_CLOSE) || (last == TOKEN_END_CLOSE))) break;
   }
-  // cout << "last= " << last << UNINDENT << LF;
-  // cout << "Done" << LF;
 
   if (is_func (t, COLLECTION)) {
     tree u (COLLECTION);
@@ -235,6 +405,14 @@ flush (tree& D, tree& C, string& S, bool& spc_flag, bool& ret_flag) {
   }
 }
 
+static inline int
+hex_digit (char c) {
+  if ((c >= '0') && (c <= '9')) return c - '0';
+  if ((c >= 'A') && (c <= 'F')) return c + 10 - 'A';
+  if ((c >= 'a') && (c <= 'f')) return c + 10 - 'a';
+  return 0;
+}
+
 tree
 tm_reader::read (bool skip_flag) {
   tree   D (DOCUMENT);
@@ -245,75 +423,67 @@ tm_reader::read (bool skip_flag) {
 
   while (true) {
     last= read_next ();
-    // cout << "--> " << last << "\n";
-    if (last == "") break;
-    if (last == "|") break;
-    if (last == ">") break;
-    
-    if (last[0] == '<') {
-      if (last[N(last)-1] == '\\') {
-        flush (D, C, S, spc_flag, ret_flag);
-        string name= read_function_name ();
-        if (last == ">") last= "\\>";
-        else last= "\\|";
-        C << read_apply (name, true);
-      }
-      else if (last[N(last)-1] == '|') {
-        (void) read_function_name ();
-        if (last == ">") last= "|>";
-        else last= "||";
-        break;
-      }
-      else if (last[N(last)-1] == '/') {
-        (void) read_function_name ();
-        if (last == ">") last= "/>";
-        else last= "/|";
-        break;
+    if (last == TOKEN_EOF) break;
+    if (last == TOKEN_BAR) break;
+    if (last == TOKEN_CLOSE) break;
+
+    if (last == TOKEN_OPEN_ARGS) {
+      flush (D, C, S, spc_flag, ret_flag);
+      int k= read_function_name (true);
+      if (last == TOKEN_CLOSE) last= TOKEN_ARGS_CLOSE;
+      else last= TOKEN_ARGS_BAR;
+      C << read_apply (k, true);
+    }
+    else if (last == TOKEN_OPEN_MORE) {
+      (void) read_function_name (false);
+      if (last == TOKEN_CLOSE) last= TOKEN_MORE_CLOSE;
+      else last= TOKEN_MORE_BAR;
+      break;
+    }
+    else if (last == TOKEN_OPEN_END) {
+      (void) read_function_name (false);
+      if (last == TOKEN_CLOSE) last= TOKEN_END_CLOSE;
+      else last= TOKEN_END_BAR;
+      break;
+    }
+    else if (last == TOKEN_OPEN_RAW) {
+      string r;
+      while ((pos+2 < n) && (buf[pos] != '>')) {
+        if (buf[pos] == '-') r << ((char) (-hex_digit (buf[pos+1])));
+        else r << ((char) ((hex_digit (buf[pos]) << 4) +
+                           hex_digit (buf[pos+1])));
+        pos += 2;
       }
-      else if (last[N(last)-1] == '#') {
-        string r;
-        while ((buf[pos] != '>') && (pos+2<N(buf))) {
-          r << ((char) from_hexadecimal (buf (pos, pos+2)));
-          pos += 2;
-        }
-        if (buf[pos] == '>') pos++;
-        flush (D, C, S, spc_flag, ret_flag);
-        C << tree (RAW_DATA, r);
-        last= read_next ();
-        break;
+      if ((pos < n) && (buf[pos] == '>')) pos++;
+      flush (D, C, S, spc_flag, ret_flag);
+      C << tree (RAW_DATA, r);
+      last= read_next ();
+      break;
+    }
+    else if (last == TOKEN_OPEN) {
+      flush (D, C, S, spc_flag, ret_flag);
+      int k= read_tag ();
+      int sep= TOKEN_CLOSE;
+      if (tags[k].name == ">") {
+        if (special[TOKEN_EOF] < 0) special[TOKEN_EOF]= new_tag ("", "");
+        k= special[TOKEN_EOF];
       }
-      else {
-        flush (D, C, S, spc_flag, ret_flag);
-        string name= decode (read_next ());
-        string sep = ">";
-        if (name == ">") name= "";
-        else sep = read_next ();
-        // cout << "==> " << name << "\n";
-        // cout << "~~> " << sep << "\n";
-        if (sep == '|') {
-          last= "|";
-          C << read_apply (name, false);
-        }
-        else {
-          tree t (make_tree_label (name));
-          if (!with_extensions)
-            t= tree (EXPAND_APPLY, name);
-          if (codes->contains (name)) {
-            // cout << name << " -> " << as_string ((tree_label) codes [name]) << "\n";
-            t= tree ((tree_label) codes [name]);
-          }
-          C << t;
-        }
+      else sep= read_next ();
+      if (sep == TOKEN_BAR) {
+        last= TOKEN_BAR;
+        C << read_apply (k, false);
       }
+      else C << make_tag (k);
     }
-    else if (last == " ") spc_flag= true;
-    else if (last == "\n") ret_flag= true;
+    else if (last == TOKEN_SPACE) spc_flag= true;
+    else if (last == TOKEN_RETURN) ret_flag= true;
     else {
-      flush (D, C, S, spc_flag, ret_flag);
-      // cout << "<<< " << last << "\n";
-      // cout << ">>> " << decode (last) << "\n";
-      S << decode (last);
-      if ((S == "") && (N(C) == 0)) C << "";
+      // consecutive pieces of text are gathered into a single leaf
+      if (ret_flag) flush (D, C, S, spc_flag, ret_flag);
+      if (spc_flag) { S << ' '; spc_flag= false; }
+      bool first= (N(S) == 0) && (N(C) == 0);
+      append_text (S);
+      if (first && (N(S) == 0)) C << "";
     }
   }
 
@@ -321,7 +491,6 @@ tm_reader::read (bool skip_flag) {
   flush (D, C, S, spc_flag, ret_flag);
   if (N(C) == 1) D << C[0];
   else if (N(C)>1) D << C;
-  // cout << "*** " << D << "\n";
   if (N(D)==0) return "";
   if (N(D)==1) {
     if (!skip_flag) return D[0];
@@ -333,13 +502,13 @@ tm_reader::read (bool skip_flag) {
 
 tree
 texmacs_to_tree (string s) {
-  tm_reader tmr (s);
+  tm_reader tmr (&(s[0]), N(s));
   return tmr.read (true);
 }
 
 tree
 texmacs_to_tree (string s, string version) {
-  tm_reader tmr (s, version);
+  tm_reader tmr (&(s[0]), N(s), version);
   return tmr.read (true);
 }
 
@@ -355,15 +524,21 @@ is_expand (tree t, string s, int n) {
   return (L(t) == EXPAND) && (N(t) == n+1) && (t[0] == s);
 }
 
+static bool
+starts (const char* s, int n, const char* what) {
+  int k= strlen (what);
+  return (n >= k) && (strncmp (s, what, k) == 0);
+}
+
 tree
-texmacs_document_to_tree (string s) {
+texmacs_document_to_tree (const char* s, int len) {
   tree error (ERROR, "bad format or data");
-  if (starts (s, "edit") ||
-      starts (s, "TeXmacs") ||
-      starts (s, "\\(\\)(TeXmacs"))
+  if (starts (s, len, "edit") ||
+      starts (s, len, "TeXmacs") ||
+      starts (s, len, "\\(\\)(TeXmacs"))
   {
     string version= "0.0.0.0";
-    tree t= string_to_tree (s, version);
+    tree t= string_to_tree (string (s, len), version);
     if (is_tuple (t) && (N(t)>0)) t= t (1, N(t));
     int n= arity (t);
 
@@ -390,12 +565,13 @@ texmacs_document_to_tree (string s) {
     return upgrade (doc, version);
   }
 
-  if (starts (s, "<TeXmacs|")) {
+  if (starts (s, len, "<TeXmacs|")) {
     int i;
-    for (i=9; i<N(s); i++)
+    for (i=9; i<len; i++)
       if (s[i] == '>') break;
-    string version= s (9, i);
-    tree doc= texmacs_to_tree (s, version);
+    string version (s + 9, i - 9);
+    tm_reader tmr (s, len, version);
+    tree doc= tmr.read (true);
     if (is_compound (doc, "TeXmacs", 1) ||
         is_expand (doc, "TeXmacs", 1) ||
         is_apply (doc, "TeXmacs", 1))
@@ -412,6 +588,41 @@ texmacs_document_to_tree (string s) {
   return error;
 }
 
+tree
+texmacs_document_to_tree (string s) {
+  return texmacs_document_to_tree (&(s[0]), N(s));
+}
+
+tree
+load_texmacs_document (url u) {
+  // large documents are parsed in place, without copying the file
+#ifndef OS_MINGW
+  url r= resolve (u);
+  if (!is_none (r) && is_rooted_name (r)) {
+    c_string _name (concretize (r));
+    int fd= ::open (_name, O_RDONLY);
+    if (fd >= 0) {
+      struct stat st;
+      void* p= MAP_FAILED;
+      int size= 0;
+      if (fstat (fd, &st) == 0 && st.st_size > 0 && st.st_size < (1 << 30)) {
+        size= (int) st.st_size;
+        p= mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+      ::close (fd);
+      if (p != MAP_FAILED) {
+        tree doc= texmacs_document_to_tree ((const char*) p, size);
+        munmap (p, size);
+        return doc;
+      }
+    }
+  }
+#endif
+  string s;
+  if (load_string (u, s, false)) return tree (ERROR, "bad format or data");
+  return texmacs_document_to_tree (s);
+}
+
 /******************************************************************************
 * Extracting attributes from a TeXmacs document tree
 ******************************************************************************/
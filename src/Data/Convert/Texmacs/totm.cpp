@@ -17,7 +17,8 @@
 ******************************************************************************/
 
 struct tm_writer {
-  string  buf;       // the resulting string
+  tm_ostream* out;   // where finished lines are written, if not NULL
+  string  buf;       // the resulting string, or the not yet written lines
   string  spc;       // "" or " "
   string  tmp;       // not yet flushed characters
   int     mode;      // normal: 0, verbatim: 1, mathematics: 2
@@ -27,8 +28,8 @@ struct tm_writer {
   bool    spc_flag;  // true if last printed character was a space or CR
   bool    ret_flag;  // true if last printed character was a CR
 
-  tm_writer ():
-    buf (""), spc (""), tmp (""), mode (0),
+  tm_writer (tm_ostream* out2= NULL):
+    out (out2), buf (""), spc (""), tmp (""), mode (0),
     tab (0), xpos (0), spc_flag (true), ret_flag (true) {}
 
   void cr ();
@@ -49,10 +50,15 @@ tm_writer::cr () {
     if ((buf[i] != ' ') || ((i>0) && (buf[i-1] == '\\')))
       break;
   if (i<n-1) {
-    buf= buf (0, i+1);
+    buf->resize (i+1);
     n  = n- N(buf);
     for (i=0; i<n; i++) buf << "\\ ";
   }
+  if ((out != NULL) && (N(buf) >= (1 << 14))) {
+    // we never look back beyond the last newline
+    *out << buf;
+    buf= "";
+  }
   buf << '\n';
   for (i=0; i<min(tab,20); i++) buf << ' ';
   xpos= min(tab,20);
@@ -316,8 +322,8 @@ tm_writer::write (tree t) {
 * Conversion of TeXmacs trees to TeXmacs strings
 ******************************************************************************/
 
-string
-tree_to_texmacs (tree t) {
+static tree
+simplify_style (tree t) {
   if (!is_snippet (t)) {
     int i, n= N(t);
     tree r (t, n);
@@ -331,9 +337,21 @@ tree_to_texmacs (tree t) {
       else r[i]= t[i];
     t= r;
   }
+  return t;
+}
 
+string
+tree_to_texmacs (tree t) {
   tm_writer tmw;
-  tmw.write (t);
+  tmw.write (simplify_style (t));
   tmw.flush ();
   return tmw.buf;
 }
+
+void
+tree_to_texmacs (tree t, tm_ostream& out) {
+  tm_writer tmw (&out);
+  tmw.write (simplify_style (t));
+  tmw.flush ();
+  out << tmw.buf;
+}
@@ -339,6 +339,94 @@ is_expand (tree t, string s, int n) {
   return is_expand (t) && (N(t) == n+1) && (t[0] == s);
 }
 
+/******************************************************************************
+* Fused upgrade passes
+******************************************************************************/
+
+// Most upgrades only rewrite individual nodes.  They are written as node
+// upgraders, which are given a node whose children have already been
+// upgraded and which return the node itself when nothing has to change.
+// The upgraders of a pass are applied in a single bottom-up traversal,
+// in the order in which they were added, and the subtrees which are left
+// unchanged are shared with the original tree instead of being copied.
+// An upgrader should only examine those parts of the children which are
+// not modified by the later upgraders of the same pass; the new subtrees
+// which it creates below the returned node are not seen by these upgraders.
+
+typedef tree (*node_upgrader) (tree t);
+
+struct upgrade_step {
+  node_upgrader fun;    // the upgrader, or NULL for a renaming
+  tree_label which;     // the renamed primitive
+  tree_label by;        // its new name
+};
+
+class upgrade_pass {
+  array<upgrade_step> steps;
+  tree apply (tree t);
+public:
+  upgrade_pass& operator << (node_upgrader fun);
+  void rename (string which, string by);
+  tree flush (tree t);
+};
+
+static tree
+copy_node (tree t) {
+  int i, n= N(t);
+  tree r (t, n);
+  for (i=0; i<n; i++) r[i]= t[i];
+  return r;
+}
+
+static bool
+is_value (tree t, string var) {
+  return is_func (t, VALUE, 1) && t[0] == var;
+}
+
+upgrade_pass&
+upgrade_pass::operator << (node_upgrader fun) {
+  upgrade_step step;
+  step.fun= fun;
+  step.which= step.by= UNKNOWN;
+  steps << step;
+  return *this;
+}
+
+void
+upgrade_pass::rename (string which, string by) {
+  upgrade_step step;
+  step.fun= NULL;
+  step.which= make_tree_label (which);
+  step.by= make_tree_label (by);
+  steps << step;
+}
+
+tree
+upgrade_pass::apply (tree t) {
+  if (is_atomic (t)) return t;
+  int i, n= N(t);
+  tree r= t;
+  for (i=0; i<n; i++) {
+    tree u= apply (t[i]);
+    if (strong_equal (u, t[i])) continue;
+    if (strong_equal (r, t)) r= copy_node (t);
+    r[i]= u;
+  }
+  for (i=0; i<N(steps) && is_compound (r); i++)
+    if (steps[i].fun != NULL) r= steps[i].fun (r);
+    else if (L(r) == steps[i].which) r= tree (steps[i].by, A(r));
+  return r;
+}
+
+tree
+upgrade_pass::flush (tree t) {
+  // apply the pending upgraders to t and start a new pass
+  if (N(steps) == 0) return t;
+  t= apply (t);
+  steps= array<upgrade_step> ();
+  return t;
+}
+
 /******************************************************************************
 * Old style conversion from TeXmacs strings to TeXmacs trees
 ******************************************************************************/
@@ -1647,7 +1735,6 @@ upgrade_mod_symbols (tree t) {
 
 static tree
 upgrade_menus_in_help (tree t) {
-  if (is_atomic (t)) return t;
   if (is_expand (t, "menu", 1) || is_expand (t, "submenu", 2) ||
       is_expand (t, "subsubmenu", 3) || is_expand (t, "subsubsubmenu", 4)) {
     int i, n= N(t);
@@ -1656,13 +1743,7 @@ upgrade_menus_in_help (tree t) {
     for (i=1; i<n; i++) r[i]= t[i];
     return r;
   }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_menus_in_help (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 static tree
@@ -1673,7 +1754,6 @@ capitalize_sub (tree t) {
 
 static tree
 upgrade_capitalize_menus (tree t) {
-  if (is_atomic (t)) return t;
   if (is_func (t, APPLY) && (t[0] == "menu")) {
     int i, n= N(t);
     tree r (APPLY, n);
@@ -1681,13 +1761,7 @@ upgrade_capitalize_menus (tree t) {
     for (i=1; i<n; i++) r[i]= capitalize_sub (t[i]);
     return r;
   }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_capitalize_menus (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -1696,17 +1770,10 @@ upgrade_capitalize_menus (tree t) {
 
 static tree
 upgrade_traverse_branch (tree t) {
-  if (is_atomic (t)) return t;
-  else if (is_expand (t, "branch", 3) ||
-           (is_func (t, APPLY, 4) && (t[0] == "branch")))
+  if (is_expand (t, "branch", 3) ||
+      (is_func (t, APPLY, 4) && (t[0] == "branch")))
     return tree (APPLY, t[0], t[1], t[3]);
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_traverse_branch (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -1715,20 +1782,13 @@ upgrade_traverse_branch (tree t) {
 
 static tree
 upgrade_session (tree t) {
-  if (is_atomic (t)) return t;
-  else if (is_expand (t, "session", 3)) {
+  if (is_expand (t, "session", 3)) {
     tree u= tree (EXPAND, "session", t[3]);
     tree w= tree (WITH);
     w << PROG_LANGUAGE << t[1] << PROG_SESSION << t[2] << u;
     return w;
   }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_session (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -1737,8 +1797,7 @@ upgrade_session (tree t) {
 
 static tree
 upgrade_formatting (tree t) {
-  if (is_atomic (t)) return t;
-  else if (is_func (t, FORMAT, 1)) {
+  if (is_func (t, FORMAT, 1)) {
     string name= replace (t[0]->label, " ", "-");
     if (name == "line-separator") name= "line-sep";
     else if (name == "no-line-break") name= "no-break";
@@ -1754,13 +1813,7 @@ upgrade_formatting (tree t) {
     else if (name == "new-double-page") name= "new-dpage";
     return tree (as_tree_label (name));
   }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_formatting (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -1769,44 +1822,42 @@ upgrade_formatting (tree t) {
 
 static tree
 upgrade_expand (tree t, tree_label WHICH_EXPAND) {
-  if (is_atomic (t)) return t;
-  else if (is_func (t, WHICH_EXPAND) && is_atomic (t[0])) {
+  if (is_func (t, WHICH_EXPAND) && is_atomic (t[0])) {
     int i, n= N(t)-1;
     string s= t[0]->label;
     if (s == "quote") s= s * "-env";
     tree_label l= make_tree_label (s);
     tree r (l, n);
     for (i=0; i<n; i++)
-      r[i]= upgrade_expand (t[i+1], WHICH_EXPAND);
+      r[i]= t[i+1];
     return r;
   }
   else if (is_func (t, ASSIGN, 2) &&
            (t[0] == "quote") &&
-           is_func (t[1], MACRO)) {
-    tree arg= upgrade_expand (t[1], WHICH_EXPAND);
-    return tree (ASSIGN, t[0]->label * "-env", arg);
-  }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_expand (t[i], WHICH_EXPAND);
-    return r;
-  }
+           is_func (t[1], MACRO))
+    return tree (ASSIGN, t[0]->label * "-env", t[1]);
+  else return t;
+}
+
+static tree
+upgrade_std_expand (tree t) {
+  return upgrade_expand (t, EXPAND);
+}
+
+static tree
+upgrade_hide_expand (tree t) {
+  return upgrade_expand (t, HIDE_EXPAND);
+}
+
+static tree
+upgrade_var_expand (tree t) {
+  return upgrade_expand (t, VAR_EXPAND);
 }
 
 static tree
 upgrade_xexpand (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    if (is_expand (t))
-      r= tree (COMPOUND, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_xexpand (t[i]);
-    return r;
-  }
+  if (is_expand (t)) return tree (COMPOUND, A(t));
+  else return t;
 }
 
 /******************************************************************************
@@ -1815,7 +1866,6 @@ upgrade_xexpand (tree t) {
 
 static tree
 upgrade_apply (tree t) {
-  if (is_atomic (t)) return t;
   /*
   if (is_func (t, APPLY))
     cout << t[0] << "\n";
@@ -1826,17 +1876,11 @@ upgrade_apply (tree t) {
     tree_label l= make_tree_label (s);
     tree r (l, n);
     for (i=0; i<n; i++)
-      r[i]= upgrade_apply (t[i+1]);
+      r[i]= t[i+1];
     return r;
   }
-
-  int i, n= N(t);
-  tree r (t, n);
-  if (is_func (t, APPLY))
-    r= tree (COMPOUND, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_apply (t[i]);
-  return r;
+  else if (is_func (t, APPLY)) return tree (COMPOUND, A(t));
+  else return t;
 }
 
 static tree
@@ -2063,42 +2107,40 @@ cached_renamer (charp* T, hashmap<string,string>& H) {
 
 static tree
 rename_vars (tree t, hashmap<string,string> H, bool flag) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    static tree_label MARKUP= make_tree_label ("markup");
-    for (i=0; i<n; i++) {
-      tree u= rename_vars (t[i], H, flag);
-      if (is_atomic (u) && H->contains (u->label))
-        if (((L(t) == WITH) && ((i%2) == 0) && (i < n-1)) ||
-            ((L(t) == ASSIGN) && (i == 0)) ||
-            ((L(t) == VALUE) && (i == 0)) ||
-            ((L(t) == CWITH) && (i == 4)) ||
-            ((L(t) == TWITH) && (i == 0)) ||
-            ((L(t) == ASSOCIATE) && (i == 0)) ||
-            ((L(t) == MARKUP) && (i == 0)))
-          u= copy (H[u->label]);
-      r[i]= u;
-    }
-    if (flag) {
-      if (H->contains (as_string (L(t)))) {
-        tree_label l= make_tree_label (H[as_string (L(t))]);
-        r= tree (l, A(r));
+  int i, n= N(t);
+  tree r= t;
+  static tree_label MARKUP= make_tree_label ("markup");
+  for (i=0; i<n; i++) {
+    tree u= t[i];
+    if (is_atomic (u) && H->contains (u->label))
+      if (((L(t) == WITH) && ((i%2) == 0) && (i < n-1)) ||
+          ((L(t) == ASSIGN) && (i == 0)) ||
+          ((L(t) == VALUE) && (i == 0)) ||
+          ((L(t) == CWITH) && (i == 4)) ||
+          ((L(t) == TWITH) && (i == 0)) ||
+          ((L(t) == ASSOCIATE) && (i == 0)) ||
+          ((L(t) == MARKUP) && (i == 0))) {
+        if (strong_equal (r, t)) r= copy_node (t);
+        r[i]= copy (H[u->label]);
       }
+  }
+  if (flag) {
+    if (H->contains (as_string (L(t)))) {
+      tree_label l= make_tree_label (H[as_string (L(t))]);
+      r= tree (l, A(r));
     }
-    else {
-      if ((n == 0) && H->contains (as_string (L(t)))) {
-        string v= H[as_string (L(t))];
-        r= tree (VALUE, copy (v));
-        if (v == "page-the-page") r= tree (make_tree_label ("page-the-page"));
-      }
+  }
+  else {
+    if ((n == 0) && H->contains (as_string (L(t)))) {
+      string v= H[as_string (L(t))];
+      r= tree (VALUE, copy (v));
+      if (v == "page-the-page") r= tree (make_tree_label ("page-the-page"));
     }
-    return r;
   }
+  return r;
 }
 
-tree
+static tree
 upgrade_env_vars (tree t) {
   return rename_vars (t, cached_renamer (var_rename, var_rename_table), false);
 }
@@ -2265,18 +2307,11 @@ static hashmap<string,string> style_rename_table ("?");
 
 static tree
 upgrade_style_rename_sub (tree t) {
-  if (is_atomic (t)) return t;
-  else if (is_func (t, MERGE, 2) && (t[0] == "the"))
+  if (is_func (t, MERGE, 2) && (t[0] == "the"))
     return tree (MERGE, "the-", t[1]);
   else if (is_func (t, MERGE, 2) && (t[1] == "nr"))
     return tree (MERGE, t[0], "-nr");
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_style_rename_sub (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 static tree
@@ -2292,39 +2327,31 @@ upgrade_style_rename (tree t) {
 
 static tree
 upgrade_item_punct (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_item_punct (t[i]);
-    if (is_compound (r, "item*", 1)) {
-      tree& item= r[0];
-      if (is_atomic (item)) {
-        string s= item->label;
-        if (ends (s, ".") || ends (s, ":") || ends (s, " "))
-          item= s (0, N(s)-1);
-      }
-      else if (is_concat (item) && is_atomic (item[N(item)-1])) {
-        string s= item [N(item)-1] -> label;
-        if ((s == ".") || (s == ":") || (s == " ")) {
-          if (N(item) == 2) item= item[0];
-          else item= item (0, N(item) - 1);
-        }
+  if (is_compound (t, "item*", 1)) {
+    tree item= t[0];
+    if (is_atomic (item)) {
+      string s= item->label;
+      if (ends (s, ".") || ends (s, ":") || ends (s, " "))
+        return tree (L(t), s (0, N(s)-1));
+    }
+    else if (is_concat (item) && is_atomic (item[N(item)-1])) {
+      string s= item [N(item)-1] -> label;
+      if ((s == ".") || (s == ":") || (s == " ")) {
+        if (N(item) == 2) return tree (L(t), item[0]);
+        else return tree (L(t), item (0, N(item) - 1));
       }
     }
-    return r;
   }
+  return t;
 }
 
 /******************************************************************************
 * Forget default page parameters
 ******************************************************************************/
 
-tree
+static tree
 upgrade_page_pars (tree t) {
-  if (is_atomic (t)) return t;
-  else if (L(t) == COLLECTION) {
+  if (L(t) == COLLECTION) {
     int i, n= N(t);
     tree r (COLLECTION);
     for (i=0; i<n; i++) {
@@ -2344,15 +2371,10 @@ upgrade_page_pars (tree t) {
       else if (u[0] == "sfactor");
       else r << u;
     }
+    if (N(r) == n) return t;
     return r;
   }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_page_pars (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -2372,6 +2394,12 @@ substitute (tree t, tree which, tree by) {
   }
 }
 
+static tree
+upgrade_hrule (tree t) {
+  if (is_value (t, "hrule")) return compound ("hrule");
+  else return t;
+}
+
 /******************************************************************************
 * Upgrading title information
 ******************************************************************************/
@@ -2531,68 +2559,58 @@ upgrade_doc_info (tree t) {
 * Upgrade bibliographies
 ******************************************************************************/
 
-tree
+static tree
 upgrade_bibliography (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_bibliography (t[i]);
-    if (is_compound (t, "bibliography") || is_compound (t, "bibliography*")) {
-      int l= N(r)-1;
-      if (is_func (r[l], DOCUMENT, 1) && is_compound (r[l][0], "bib-list"));
-      else if (is_compound (r[l], "bib-list"));
-      else r[l]= tree (DOCUMENT, compound ("bib-list", "[99]", r[l]));
+  if (is_compound (t, "bibliography") || is_compound (t, "bibliography*")) {
+    int l= N(t)-1;
+    if (is_func (t[l], DOCUMENT, 1) && is_compound (t[l][0], "bib-list"));
+    else if (is_compound (t[l], "bib-list"));
+    else {
+      tree r= copy_node (t);
+      r[l]= tree (DOCUMENT, compound ("bib-list", "[99]", t[l]));
+      return r;
     }
-    return r;
   }
+  return t;
 }
 
 /******************************************************************************
 * Upgrade switches
 ******************************************************************************/
 
-tree
+static tree
 upgrade_switch (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
+  if (is_compound (t, "switch", 2)) {
+    int i, n= N(t[1]);
+    tree u (make_tree_label ("switch"), n);
     for (i=0; i<n; i++)
-      r[i]= upgrade_switch (t[i]);
-    if (is_compound (r, "switch", 2)) {
-      int i, n= N(r[1]);
-      tree u (make_tree_label ("switch"), n);
-      for (i=0; i<n; i++)
-        if (is_compound (r[1][i], "tmarker", 0)) u[i]= r[0];
-        else u[i]= compound ("hidden", r[1][i]);
-      return u;
-    }
-    if (is_compound (r, "fold", 2))
-      return compound ("folded", r[0], r[1]);
-    if (is_compound (r, "unfold", 2))
-      return compound ("unfolded", r[0], r[1]);
-    if (is_compound (r, "fold-bpr", 2) ||
-        is_compound (r, "fold-text", 2) ||
-        is_compound (r, "fold-proof", 2) ||
-        is_compound (r, "fold-exercise", 2))
-      return compound ("summarized", r[0], r[1]);
-    if (is_compound (r, "unfold-bpr", 2) ||
-        is_compound (r, "unfold-text", 2) ||
-        is_compound (r, "unfold-proof", 2) ||
-        is_compound (r, "unfold-exercise", 2))
-      return compound ("detailed", r[0], r[1]);
-    if (is_compound (r, "fold-algorithm", 2))
-      return compound ("summarized-algorithm", r[0], r[1]);
-    if (is_compound (r, "unfold-algorithm", 2))
-      return compound ("detailed-algorithm", r[0], r[1]);
-    if (is_func (r, ASSIGN, 2) && r[0] == "fold-algorithm")
-      return tree (ASSIGN, "summarized-algorithm", r[1]);
-    if (is_func (r, ASSIGN, 2) && r[0] == "unfold-algorithm")
-      return tree (ASSIGN, "detailed-algorithm", r[1]);
-    return r;
+      if (is_compound (t[1][i], "tmarker", 0)) u[i]= t[0];
+      else u[i]= compound ("hidden", t[1][i]);
+    return u;
   }
+  if (is_compound (t, "fold", 2))
+    return compound ("folded", t[0], t[1]);
+  if (is_compound (t, "unfold", 2))
+    return compound ("unfolded", t[0], t[1]);
+  if (is_compound (t, "fold-bpr", 2) ||
+      is_compound (t, "fold-text", 2) ||
+      is_compound (t, "fold-proof", 2) ||
+      is_compound (t, "fold-exercise", 2))
+    return compound ("summarized", t[0], t[1]);
+  if (is_compound (t, "unfold-bpr", 2) ||
+      is_compound (t, "unfold-text", 2) ||
+      is_compound (t, "unfold-proof", 2) ||
+      is_compound (t, "unfold-exercise", 2))
+    return compound ("detailed", t[0], t[1]);
+  if (is_compound (t, "fold-algorithm", 2))
+    return compound ("summarized-algorithm", t[0], t[1]);
+  if (is_compound (t, "unfold-algorithm", 2))
+    return compound ("detailed-algorithm", t[0], t[1]);
+  if (is_func (t, ASSIGN, 2) && t[0] == "fold-algorithm")
+    return tree (ASSIGN, "summarized-algorithm", t[1]);
+  if (is_func (t, ASSIGN, 2) && t[0] == "unfold-algorithm")
+    return tree (ASSIGN, "detailed-algorithm", t[1]);
+  return t;
 }
 
 /******************************************************************************
@@ -2656,11 +2674,13 @@ remove_attr (tree t, string name) {
   }
 }
 
-tree
+static tree
 upgrade_fill (tree t) {
   int i;
-  if (is_atomic (t)) return t;
-  if (is_compound (t, "with")) {
+  if (is_compound (t, "with") &&
+      (find_attr (t, "gr-mode") || find_attr (t, "fill-mode") ||
+       find_attr (t, "gr-fill-mode") || find_attr (t, "fill-color"))) {
+    t= copy_node (t);
     if ((i= find_attr_pos (t, "gr-mode")) != -1
      && is_tuple (t[i+1],"edit-prop"))
       t[i+1]= tuple ("group-edit","props");
@@ -2673,11 +2693,7 @@ upgrade_fill (tree t) {
     if (fm == "inside")
       t= set_attr (t, "color", tree ("none"));
   }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_fill (t[i]);
-  return r;
+  return t;
 }
 
 static void
@@ -2737,15 +2753,13 @@ length_add (string l1, string l2) {
   }
 }
 
-tree
+static tree
 upgrade_graphics (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
   if (is_compound (t, "with") &&
       (find_attr (t, "gr-frame") || find_attr (t, "gr-clip"))) {
-    tree fr= get_attr (t, "gr-frame",
-                          tuple ("scale", "1cm",
-                                 tree (TUPLE, "0.5par", "0cm")));
+    tree fr= copy (get_attr (t, "gr-frame",
+                                tuple ("scale", "1cm",
+                                       tree (TUPLE, "0.5par", "0cm"))));
     tree clip= get_attr (t, "gr-clip",
                             tuple ("clip",
                                    tuple ("0par", "-0.3par"),
@@ -2768,97 +2782,54 @@ upgrade_graphics (tree t) {
     t= add_attr (t, "gr-geometry", geom);
     t= set_attr (t, "gr-frame", fr);
   }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_graphics (t[i]);
-  return r;
+  return t;
 }
 
-tree
+static tree
 upgrade_textat (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
   if (is_compound (t, "text-at") && N(t) == 4) {
     tree t0= t;
     t= tree (WITH, tree (TEXT_AT, t[0], t[1]));
     t= set_attr (t, "text-at-halign", t0[2]);
     t= set_attr (t, "text-at-valign", t0[3]);
   }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_textat (t[i]);
-  return r;
+  return t;
 }
 
 /******************************************************************************
 * Upgrade cell alignment
 ******************************************************************************/
 
-tree
+static tree
 upgrade_cell_alignment (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
   if (is_func (t, CWITH) && (N(t) >= 2))
     if (t[N(t)-2] == CELL_HALIGN)
       if (t[N(t)-1] == "." || t[N(t)-1] == ",") {
-        tree r= copy (t);
+        tree r= copy_node (t);
         r[N(t)-1]= "L" * t[N(t)-1]->label;
         return r;
       }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_cell_alignment (t[i]);
-  return r;
-}
-
-/******************************************************************************
-* Renaming primitives
-******************************************************************************/
-
-tree
-rename_primitive (tree t, string which, string by) {
-  int i;
-  if (is_atomic (t)) return t;
-  int n= N(t);
-  tree r (t, n);
-  if (is_compound (t, which))
-    r= tree (make_tree_label (by), n);
-  for (i=0; i<n; i++)
-    r[i]= rename_primitive (t[i], which, by);
-  return r;
+  return t;
 }
 
 /******************************************************************************
 * Upgrade label assignment
 ******************************************************************************/
 
-tree
+static tree
 upgrade_label_assignment (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  else if (is_func (t, ASSIGN, 2) && t[0] == "the-label")
+  if (is_func (t, ASSIGN, 2) && t[0] == "the-label")
     return tree (SET_BINDING, t[1]);
-  else {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_label_assignment (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
 * Upgrade scheme documentation
 ******************************************************************************/
 
-tree
+static tree
 upgrade_scheme_doc (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  else if (is_compound (t, "scm-fun", 1) ||
+  if (is_compound (t, "scm-fun", 1) ||
            is_compound (t, "scm-macro", 1))
     return compound ("scm", t[0]);
   else if (is_compound (t, "explain-scm-fun") ||
@@ -2871,44 +2842,30 @@ upgrade_scheme_doc (tree t) {
       r << ")";
       return compound ("scm", simplify_concat (r));
     }
-  else {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_scheme_doc (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
 * Upgrade Mathemagix tag
 ******************************************************************************/
 
-tree
+static tree
 upgrade_mmx (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  else if (is_compound (t, "mmx", 0) || t == tree (VALUE, "mmx"))
+  if (is_compound (t, "mmx", 0) || is_value (t, "mmx"))
     return compound ("mathemagix");
-  else if (is_compound (t, "mml", 0) || t == tree (VALUE, "mml"))
+  else if (is_compound (t, "mml", 0) || is_value (t, "mml"))
     return compound ("mmxlib");
-  else if (is_compound (t, "scheme", 0) || t == tree (VALUE, "scheme"))
+  else if (is_compound (t, "scheme", 0) || is_value (t, "scheme"))
     return compound ("scheme");
-  else if (is_compound (t, "cpp", 0) || t == tree (VALUE, "cpp"))
+  else if (is_compound (t, "cpp", 0) || is_value (t, "cpp"))
     return compound ("c++");
   else if (is_compound (t, "scheme-code", 1))
-    return compound ("scm", upgrade_mmx (t[0]));
+    return compound ("scm", t[0]);
   else if (is_compound (t, "scheme-fragment", 1))
-    return compound ("scm-fragment", upgrade_mmx (t[0]));
+    return compound ("scm-fragment", t[0]);
   else if (is_compound (t, "cpp-code", 1))
-    return compound ("cpp", upgrade_mmx (t[0]));
-  else {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_mmx (t[i]);
-    return r;
-  }
+    return compound ("cpp", t[0]);
+  else return t;
 }
 
 /******************************************************************************
@@ -2952,25 +2909,20 @@ upgrade_session (tree t, tree lan, tree ses) {
 * Upgrade presentation style
 ******************************************************************************/
 
-tree
+static tree
 upgrade_presentation (tree t) {
   int i;
-  if (is_atomic (t)) return t;
-  else if (is_compound (t, "style") || is_compound (t, "tuple")) {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      if (t[i] == "presentation") r[i]= "presentation-ridged-paper";
-      else r[i]= upgrade_presentation (t[i]);
-    return r;
-  }
-  else {
+  if (is_compound (t, "style") || is_compound (t, "tuple")) {
     int n= N(t);
-    tree r (t, n);
+    tree r= t;
     for (i=0; i<n; i++)
-      r[i]= upgrade_presentation (t[i]);
+      if (t[i] == "presentation") {
+        if (strong_equal (r, t)) r= copy_node (t);
+        r[i]= "presentation-ridged-paper";
+      }
     return r;
   }
+  else return t;
 }
 
 /******************************************************************************
@@ -3018,25 +2970,17 @@ is_non_style_document (tree doc) {
   return existing_styles->contains (ms);
 }
 
-tree
+static tree
 upgrade_math (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  else if (is_func (t, WITH, 3) && t[0] == MODE && t[1] == "math")
-    return compound ("math", upgrade_math (t[2]));
+  if (is_func (t, WITH, 3) && t[0] == MODE && t[1] == "math")
+    return compound ("math", t[2]);
   else if (is_func (t, WITH, 3) && t[0] == MODE && t[1] == "text")
-    return compound ("text", upgrade_math (t[2]));
+    return compound ("text", t[2]);
   else if (is_func (t, WITH) && N(t) >= 5 && t[0] == MODE && t[1] == "math")
     return compound ("math", upgrade_math (t (2, N(t))));
   else if (is_func (t, WITH) && N(t) >= 5 && t[0] == MODE && t[1] == "text")
     return compound ("text", upgrade_math (t (2, N(t))));
-  else {
-    int n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_math (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -3051,10 +2995,8 @@ upgrade_resize_arg (tree t) {
     tree u= upgrade_resize_arg (t[0]);
     if (is_func (u, PLUS, 2) || is_func (u, MINUS, 2) ||
         is_func (u, MINIMUM, 2) || is_func (u, MAXIMUM, 2))
-      if (u[1] == "") {
-        u[1]= upgrade_resize_arg (t[1]);
-        return u;
-      }
+      if (u[1] == "")
+        return tree (L(u), u[0], upgrade_resize_arg (t[1]));
     cout << "TeXmacs] warning, resize argument " << t << " not upgraded\n";
     return t;
   }
@@ -3086,26 +3028,19 @@ upgrade_resize_arg (tree t) {
   return t;
 }
 
-tree
+static tree
 upgrade_resize_clipped (tree t) {
-  if (is_atomic (t)) return t;
-  else if (N(t) >= 5 && (is_func (t, RESIZE) || is_func (t, CLIPPED))) {
+  if (N(t) >= 5 && (is_func (t, RESIZE) || is_func (t, CLIPPED))) {
     if (is_func (t, CLIPPED))
       t= tree (CLIPPED, t[4], t[0], t[1], t[2], t[3]);
     int i, n= 5;
     tree r (t, n);
-    r[0]= upgrade_resize_clipped (t[0]);
+    r[0]= t[0];
     for (i=1; i<n; i++)
       r[i]= upgrade_resize_arg (t[i]);
     return r;
   }
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_resize_clipped (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -3123,21 +3058,14 @@ upgrade_image_length (tree t, string unit) {
   else return t;
 }
 
-tree
+static tree
 upgrade_image (tree t) {
-  if (is_atomic (t)) return t;
-  else if (is_func (t, IMAGE, 7))
+  if (is_func (t, IMAGE, 7))
     return tree (IMAGE, t[0],
                  upgrade_image_length (t[1], "w"),
                  upgrade_image_length (t[2], "h"),
                  "", "");
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_image (t[i]);
-    return r;
-  }
+  else return t;
 }
 
 /******************************************************************************
@@ -3270,13 +3198,9 @@ upgrade_algorithm (tree t, bool flag= true) {
 * Upgrade mathematical operators
 ******************************************************************************/
 
-tree
+static tree
 upgrade_math_ops (tree t) {
-  if (is_atomic (t)) return t;
-  int i, n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_math_ops (t[i]);
+  int n= N(t);
   if (is_func (t, WITH, 3) &&
       is_atomic (t[2]) &&
       is_alpha (t[2]->label) &&
@@ -3300,7 +3224,7 @@ upgrade_math_ops (tree t) {
     if (is_compound (t, "math-rel")) return compound ("math-relation", t[0]);
     if (is_compound (t, "math-op")) return compound ("math-big", t[0]);
   }
-  return r;
+  return t;
 }
 
 /******************************************************************************
@@ -3485,9 +3409,11 @@ replace_magnification (tree& t, string var, string repl) {
 
 static tree
 upgrade_gr_attributes (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  if (is_func (t, WITH)) {
+  if (is_func (t, WITH) &&
+      (find_attr (t, "dash-style") || find_attr (t, "gr-dash-style") ||
+       find_attr (t, "line-arrows") || find_attr (t, "gr-line-arrows") ||
+       find_attr (t, "magnification"))) {
+    t= copy_node (t);
     replace_dash_style (t, "dash-style");
     replace_dash_style (t, "gr-dash-style");
     replace_line_arrows (t, "line-arrows", "arrow-begin", "arrow-end");
@@ -3495,11 +3421,7 @@ upgrade_gr_attributes (tree t) {
                             "gr-arrow-begin", "gr-arrow-end");
     replace_magnification (t, "magnification", "magnify");
   }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_gr_attributes (t[i]);
-  return r;
+  return t;
 }
 
 /******************************************************************************
@@ -3508,17 +3430,9 @@ upgrade_gr_attributes (tree t) {
 
 static tree
 upgrade_cursor (tree t) {
-  int i;
-  if (is_atomic (t)) return t;
-  if (is_func (t, VALUE)) {
-    if (t == tree (VALUE, "cursor")) return compound ("cursor");
-    if (t == tree (VALUE, "math-cursor")) return compound ("math-cursor");
-  }
-  int n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++)
-    r[i]= upgrade_cursor (t[i]);
-  return r;
+  if (is_value (t, "cursor")) return compound ("cursor");
+  if (is_value (t, "math-cursor")) return compound ("math-cursor");
+  return t;
 }
 
 /******************************************************************************
@@ -3541,7 +3455,9 @@ upgrade_cyrillic_encoding (tree t, bool cyrillic) {
     else          return t;
   }
   else {
+    // the document may share subtrees with the original one
     int i = 0;
+    tree r= t;
     if (is_func(t, WITH)) {
       for (i = 0 ; i < N(t) - 1 ; i+=2) {
         if (!cyrillic
@@ -3551,13 +3467,15 @@ upgrade_cyrillic_encoding (tree t, bool cyrillic) {
             && become_other (as_string (t[i]), as_string (t[i+1])))
           cyrillic = false;
       }
-      t[N(t)-1] = upgrade_cyrillic_encoding (t[N(t)-1], cyrillic);
+      i= N(t) - 1;
     }
-    else {
-      for (i = 0 ; i < N(t) ; i++) 
-        t[i] = upgrade_cyrillic_encoding (t[i], cyrillic);
+    for (; i < N(t) ; i++) {
+      tree u= upgrade_cyrillic_encoding (t[i], cyrillic);
+      if (strong_equal (u, t[i])) continue;
+      if (strong_equal (r, t)) r= copy_node (t);
+      r[i]= u;
     }
-    return t;
+    return r;
   }
 }
 
@@ -3741,16 +3659,16 @@ upgrade_abstract_data (tree t) {
 * Upgrade unroll
 ******************************************************************************/
 
-tree
+static tree
 upgrade_unroll (tree t) {
-  if (is_atomic (t)) return t;
+  if (!is_compound (t, "unroll")) return t;
   int i, n= N(t);
-  tree r (t, n);
-  for (i=0; i<n; i++) {
-    r[i]= upgrade_unroll (t[i]);
-    if (is_compound (t, "unroll") && is_func (r[i], HIDDEN, 1))
-      r[i]= compound ("hidden*", r[i][0]);
-  }
+  tree r= t;
+  for (i=0; i<n; i++)
+    if (is_func (t[i], HIDDEN, 1)) {
+      if (strong_equal (r, t)) r= copy_node (t);
+      r[i]= compound ("hidden*", t[i][0]);
+    }
   return r;
 }
 
@@ -4067,18 +3985,10 @@ upgrade_draw_over_under (tree t) {
 * Upgrade qed
 ******************************************************************************/
 
-tree
+static tree
 upgrade_qed (tree t) {
-  if (is_atomic (t)) return t;
-  else if (t == tree (VALUE, "qed"))
-    return compound ("qed");
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_qed (t[i]);
-    return r;
-  }
+  if (is_value (t, "qed")) return compound ("qed");
+  else return t;
 }
 
 /******************************************************************************
@@ -4146,18 +4056,16 @@ rename_style (tree t, string old_name, string new_name) {
 * Upgrade copyright dashes
 ******************************************************************************/
 
-tree
+static tree
 upgrade_copyright_dashes (tree t) {
-  if (is_atomic (t)) return t;
-  else {
-    int i, n= N(t);
-    tree r (t, n);
-    for (i=0; i<n; i++)
-      r[i]= upgrade_copyright_dashes (t[i]);
-    if (is_compound (r, "tmdoc-copyright") && N(r)>0 && is_atomic (r[0]))
-      r[0]= replace (r[0]->label, "--", "\25");
+  if (is_compound (t, "tmdoc-copyright") && N(t)>0 && is_atomic (t[0])) {
+    string s= replace (t[0]->label, "--", "\25");
+    if (s == t[0]->label) return t;
+    tree r= copy_node (t);
+    r[0]= s;
     return r;
   }
+  else return t;
 }
 
 /******************************************************************************
@@ -4189,27 +4097,22 @@ upgrade_tex (tree t) {
   t= upgrade_table (t);
   t= upgrade_split (t, false);
   t= simplify_correct (upgrade_mod_symbols (t));
-  t= upgrade_menus_in_help (t);
-  t= upgrade_capitalize_menus (t);
-  t= upgrade_formatting (t);
-  t= upgrade_expand (t, EXPAND);
-  t= upgrade_expand (t, HIDE_EXPAND);
-  t= upgrade_expand (t, VAR_EXPAND);
-  t= upgrade_xexpand (t);
+  upgrade_pass pass;
+  pass << upgrade_menus_in_help << upgrade_capitalize_menus
+       << upgrade_formatting << upgrade_std_expand << upgrade_hide_expand
+       << upgrade_var_expand << upgrade_xexpand;
+  t= pass.flush (t);
   t= upgrade_function (t);
-  t= upgrade_apply (t);
-  t= upgrade_env_vars (t);
-  t= upgrade_style_rename (t);
-  t= upgrade_item_punct (t);
-  t= substitute (t, tree (VALUE, "hrule"), compound ("hrule"));
-  t= upgrade_math (t);
-  t= upgrade_resize_clipped (t);
+  pass << upgrade_apply << upgrade_env_vars << upgrade_style_rename
+       << upgrade_item_punct << upgrade_hrule << upgrade_math
+       << upgrade_resize_clipped;
+  t= pass.flush (t);
   t= with_correct (t);
   t= superfluous_with_correct (t);
   t= upgrade_brackets (t);
   t= move_brackets (t);
-  t= upgrade_image (t);
-  t= upgrade_math_ops (t);
+  pass << upgrade_image << upgrade_math_ops;
+  t= pass.flush (t);
   t= clean_spaces (t);
   t= clean_header (t);
   t= upgrade_doc_language (t);
@@ -4252,72 +4155,79 @@ upgrade (tree t, string version) {
     t= upgrade_cas (t);
   if (version_inf_eq (version, "1.0.0.8"))
     t= simplify_correct (upgrade_mod_symbols (t));
+
+  // Consecutive node upgrades are fused into passes over the document,
+  // which are flushed before each upgrade of another kind
+  upgrade_pass pass;
   if (version_inf_eq (version, "1.0.0.11"))
-    t= upgrade_menus_in_help (t);
+    pass << upgrade_menus_in_help;
   if (version_inf_eq (version, "1.0.0.13"))
-    t= upgrade_capitalize_menus (t);
+    pass << upgrade_capitalize_menus;
   if (version_inf_eq (version, "1.0.0.19"))
-    t= upgrade_traverse_branch (t);
+    pass << upgrade_traverse_branch;
   if (version_inf_eq (version, "1.0.1.20"))
-    t= upgrade_session (t);
+    pass << upgrade_session;
   if (version_inf_eq (version, "1.0.2.0"))
-    t= upgrade_formatting (t);
+    pass << upgrade_formatting;
+  // the expanders created by upgrade_session need to be upgraded too
+  t= pass.flush (t);
   if (version_inf_eq (version, "1.0.2.3"))
-    t= upgrade_expand (t, EXPAND);
+    pass << upgrade_std_expand;
   if (version_inf_eq (version, "1.0.2.4"))
-    t= upgrade_expand (t, HIDE_EXPAND);
-  if (version_inf_eq (version, "1.0.2.5")) {
-    t= upgrade_expand (t, VAR_EXPAND);
-    t= upgrade_xexpand (t);
-  }
+    pass << upgrade_hide_expand;
+  if (version_inf_eq (version, "1.0.2.5"))
+    pass << upgrade_var_expand << upgrade_xexpand;
+  t= pass.flush (t);
   if (version_inf_eq (version, "1.0.2.6")) {
     t= upgrade_function (t);
-    t= upgrade_apply (t);
+    pass << upgrade_apply;
   }
   if (version_inf_eq (version, "1.0.2.8"))
-    t= upgrade_env_vars (t);
+    pass << upgrade_env_vars;
+  t= pass.flush (t);
   if (version_inf_eq (version, "1.0.3.3"))
     t= upgrade_use_package (t);
   if (version_inf_eq (version, "1.0.3.4"))
-    t= upgrade_style_rename (t);
-  if (version_inf_eq (version, "1.0.3.4"))
-    t= upgrade_item_punct (t);
+    pass << upgrade_style_rename << upgrade_item_punct;
   if (version_inf_eq (version, "1.0.3.7"))
-    t= upgrade_page_pars (t);
-  if (version_inf_eq (version, "1.0.4")) {
-    t= substitute (t, tree (VALUE, "hrule"), compound ("hrule"));
+    pass << upgrade_page_pars;
+  if (version_inf_eq (version, "1.0.4"))
+    pass << upgrade_hrule;
+  t= pass.flush (t);
+  if (version_inf_eq (version, "1.0.4"))
     t= upgrade_doc_info (t);
-  }
   if (version_inf_eq (version, "1.0.4.6"))
-    t= upgrade_bibliography (t);
+    pass << upgrade_bibliography;
   if (version_inf_eq (version, "1.0.5.4"))
-    t= upgrade_switch (t);
+    pass << upgrade_switch;
   if (version_inf_eq (version, "1.0.5.7"))
-    t= upgrade_fill (t);
+    pass << upgrade_fill;
   if (version_inf_eq (version, "1.0.5.8"))
-    t= upgrade_graphics (t);
+    pass << upgrade_graphics;
   if (version_inf_eq (version, "1.0.5.11"))
-    t= upgrade_textat (t);
+    pass << upgrade_textat;
   if (version_inf_eq (version, "1.0.6.1"))
-    t= upgrade_cell_alignment (t);
-  if (version_inf_eq (version, "1.0.6.2"))
-    t= rename_primitive (t, "hyper-link", "hlink");
-  if (version_inf_eq (version, "1.0.6.2"))
-    t= upgrade_label_assignment (t);
+    pass << upgrade_cell_alignment;
+  if (version_inf_eq (version, "1.0.6.2")) {
+    pass.rename ("hyper-link", "hlink");
+    pass << upgrade_label_assignment;
+  }
   if (version_inf_eq (version, "1.0.6.10"))
-    t= upgrade_scheme_doc (t);
+    pass << upgrade_scheme_doc;
   if (version_inf_eq (version, "1.0.6.14"))
-    t= upgrade_mmx (t);
+    pass << upgrade_mmx;
+  t= pass.flush (t);
   if (version_inf_eq (version, "1.0.7.1"))
     t= upgrade_session (t, "scheme", "default");
-  if (version_inf_eq (version, "1.0.7.6"))
-    t= upgrade_presentation (t);
-  if (version_inf_eq (version, "1.0.7.6") && is_non_style_document (t))
-    t= upgrade_math (t);
-  if (version_inf_eq (version, "1.0.7.7"))
-    t= upgrade_resize_clipped (t);
+  if (version_inf_eq (version, "1.0.7.6")) {
+    pass << upgrade_presentation;
+    t= pass.flush (t);
+    if (is_non_style_document (t))
+      pass << upgrade_math;
+  }
   if (version_inf_eq (version, "1.0.7.7"))
-    t= upgrade_image (t);
+    pass << upgrade_resize_clipped << upgrade_image;
+  t= pass.flush (t);
   if (version_inf_eq (version, "1.0.7.7"))
     t= upgrade_root_switch (t);
   if (version_inf_eq (version, "1.0.7.8"))
@@ -4334,14 +4244,16 @@ upgrade (tree t, string version) {
     t= move_brackets (t);
     if (is_non_style_document (t))
       t= upgrade_algorithm (t, false);
-    t= upgrade_math_ops (t);
+    pass << upgrade_math_ops;
+    t= pass.flush (t);
   }
   if (version_inf_eq (version, "1.0.7.10"))
     t= downgrade_big (t);
   if (version_inf_eq (version, "1.0.7.13"))
-    t= upgrade_gr_attributes (t);
+    pass << upgrade_gr_attributes;
   if (version_inf_eq (version, "1.0.7.14"))
-    t= upgrade_cursor (t);
+    pass << upgrade_cursor;
+  t= pass.flush (t);
   if (version_inf_eq (version, "1.0.7.15"))
     t= upgrade_cyrillic (t);
   if (version_inf_eq (version, "1.0.7.17")) {
@@ -4350,7 +4262,8 @@ upgrade (tree t, string version) {
     t= correct_metadata (t);
   }
   if (version_inf_eq (version, "1.0.7.20")) {
-    t= upgrade_unroll (t);
+    pass << upgrade_unroll;
+    t= pass.flush (t);
     t= upgrade_style (t, false);
     t= upgrade_doc_language (t);
   }
@@ -4364,11 +4277,26 @@ upgrade (tree t, string version) {
   }
   if (version_inf_eq (version, "1.99.4"))
     t= upgrade_draw_over_under (t);
-  if (version_inf_eq (version, "1.99.6")) {
-    t= upgrade_qed (t);
+  // the remaining upgrades of the body do not depend on the style
+  // and the upgrades of the style do not modify the body
+  if (version_inf_eq (version, "1.99.6"))
+    pass << upgrade_qed;
+  if (version_inf_eq (version, "1.99.9")) {
+    pass.rename ("solution", "solution*");
+    pass.rename ("answer", "answer*");
+    pass.rename ("html-div", "html-div-class");
+    pass.rename ("html-style", "html-div-style");
+  }
+  if (version_inf_eq (version, "1.99.12")) {
+    pass << upgrade_copyright_dashes;
+    pass.rename ("swell", "inflate");
+    pass.rename ("swell-top", "inflate-top");
+    pass.rename ("swell-bottom", "inflate-bottom");
+  }
+  t= pass.flush (t);
+  if (version_inf_eq (version, "1.99.6"))
     if (is_non_style_document (t))
       t= preserve_spacing (t);
-  }
   if (version_inf_eq (version, "1.99.8")) {
     if (is_non_style_document (t)) {
       t= rename_style (t, "exam", "old-exam");
@@ -4376,21 +4304,9 @@ upgrade (tree t, string version) {
       t= rename_style (t, "beamer", "old2-beamer");
     }
   }
-  if (version_inf_eq (version, "1.99.9")) {
-    t= rename_primitive (t, "solution", "solution*");
-    t= rename_primitive (t, "answer", "answer*");
-    t= rename_primitive (t, "html-div", "html-div-class");
-    t= rename_primitive (t, "html-style", "html-div-style");
-  }
   if (version_inf_eq (version, "1.99.11"))
     if (is_non_style_document (t))
       t= preserve_dots (t);
-  if (version_inf_eq (version, "1.99.12")) {
-    t= upgrade_copyright_dashes (t);
-    t= rename_primitive (t, "swell", "inflate");
-    t= rename_primitive (t, "swell-top", "inflate-top");
-    t= rename_primitive (t, "swell-bottom", "inflate-bottom");
-  }
   if (version_inf_eq (version, "1.99.13"))
     t= preserve_lengths (t);
 
@@ -39,7 +39,10 @@ scheme_tree compute_index (url u);
 /*** Texmacs ***/
 tree   texmacs_to_tree (string s);
 tree   texmacs_document_to_tree (string s);
+tree   texmacs_document_to_tree (const char* s, int len);
+tree   load_texmacs_document (url u);
 string tree_to_texmacs (tree t);
+void   tree_to_texmacs (tree t, tm_ostream& out);
 tree   extract (tree doc, string attr);
 tree   extract_document (tree doc);
 tree   change_doc_attr (tree doc, string attr, tree val);
@@ -57,6 +60,7 @@ string scheme_tree_to_string (scheme_tree t);
 string scheme_tree_to_block (scheme_tree t);
 scheme_tree tree_to_scheme_tree (tree t);
 string tree_to_scheme (tree t);
+void   tree_to_scheme (tree t, tm_ostream& out);
 scheme_tree string_to_scheme_tree (string s);
 scheme_tree block_to_scheme_tree  (string s);
 tree   scheme_tree_to_tree (scheme_tree t);
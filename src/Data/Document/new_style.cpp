@@ -13,6 +13,9 @@
 #include "file.hpp"
 #include "data_cache.hpp"
 #include "convert.hpp"
+#include "tm_timer.hpp"
+#include "iterator.hpp"
+#include "Binary/packed_tree.hpp"
 #include "../../Typeset/env.hpp"
 
 /******************************************************************************
@@ -107,19 +110,63 @@ style_invalidate_cache () {
   remove ("$TEXMACS_HOME_PATH/system/cache" * url_wildcard ("__*"));
 }
 
+static url
+cache_file_url (tree style) {
+  return url ("$TEXMACS_HOME_PATH/system/cache",
+              cache_file_name (style) * ".bin");
+}
+
+static void
+make_style_immortal (hashmap<string,tree> H, tree t) {
+  // cached style environments are shared by all documents for the rest
+  // of the session, so their constants need no reference counting
+  iterator<string> it= iterate (H);
+  while (it->busy ()) make_immortal (H[it->next ()]);
+  make_immortal (t);
+}
+
 void
 style_set_cache (tree style, hashmap<string,tree> H, tree t) {
   init_style_data ();
   // cout << "set cache " << style << LF;
+  make_style_immortal (H, t);
   sd->style_cache (copy (style))= H;
   sd->style_drd   (copy (style))= t;
-  url name ("$TEXMACS_HOME_PATH/system/cache", cache_file_name (style));
+  url name= cache_file_url (style);
   if (!exists (name)) {
-    save_string (name, tree_to_scheme (tuple ((tree) H, t)));
+    // other instances may map the cache while it is being written
+    tm_ostream out= file_ostream (name);
+    out << pack_tree (tuple (TEXMACS_VERSION, (tree) H, t));
+    (void) out->close ();
     // cout << "saved " << name << LF;
   }
 }
 
+static bool
+load_style_cache (url name, hashmap<string,tree>& H, tree& t) {
+  // The cached environment is a tuple with the version of TeXmacs,
+  // a collection of associations and the DRD. All values are decoded
+  // here, since the environment needs them anyway, but directly from the
+  // mapped file and without parsing; subtrees shared by several macros
+  // are only decoded once.
+  packed_tree p (name);
+  if (!p->ok ()) return false;
+  int r= p->root ();
+  if (p->is_atomic (r) || p->arity (r) != 3) return false;
+  int v= p->child (r, 0), c= p->child (r, 1);
+  if (!p->is_atomic (v) || p->label (v) != TEXMACS_VERSION) return false;
+  if (p->is_atomic (c)) return false;
+  H= hashmap<string,tree> (UNINIT);
+  for (int i=0; i<p->arity (c); i++) {
+    int a= p->child (c, i);
+    if (p->is_atomic (a) || p->arity (a) != 2) return false;
+    if (!p->is_atomic (p->child (a, 0))) return false;
+    H (p->label (p->child (a, 0)))= p->get (p->child (a, 1));
+  }
+  t= p->get (p->child (r, 2));
+  return true;
+}
+
 void
 style_get_cache (tree style, hashmap<string,tree>& H, tree& t, bool& f) {
   init_style_data ();
@@ -131,16 +178,18 @@ style_get_cache (tree style, hashmap<string,tree>& H, tree& t, bool& f) {
     t= sd->style_drd   [style];
   }
   else {
-    string s;
-    url name ("$TEXMACS_HOME_PATH/system/cache", cache_file_name (style));
-    if (exists (name) && (!load_string (name, s, false))) {
-      //cout << "loaded " << name << LF;
-      tree p= scheme_to_tree (s);
-      H= hashmap<string,tree> (UNINIT, p[0]);
-      t= p[1];
-      sd->style_cache (copy (style))= H;
-      sd->style_drd   (copy (style))= t;
-      f= true;
+    url name= cache_file_url (style);
+    if (exists (name)) {
+      bench_start ("load style cache");
+      f= load_style_cache (name, H, t);
+      bench_cumul ("load style cache");
+      if (f) {
+        //cout << "loaded " << name << LF;
+        make_style_immortal (H, t);
+        sd->style_cache (copy (style))= H;
+        sd->style_drd   (copy (style))= t;
+      }
+      else remove (name);
     }
   }
 }
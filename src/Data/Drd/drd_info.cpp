@@ -54,7 +54,8 @@ drd_info_rep::set_locals (tree t) {
 
 bool
 drd_info_rep::contains (string l) {
-  return existing_tree_label (l) && info->contains (as_tree_label (l));
+  int code= (int) as_tree_label (l, (tree_label) -1);
+  return code >= 0 && info->contains ((tree_label) code);
 }
 
 tm_ostream&
@@ -399,16 +400,16 @@ replace (tree t, hashmap<tree,tree> h) {
 tree
 drd_info_rep::get_syntax (tree t, path p) {
   if (is_func (t, VALUE, 1) && is_atomic (t[0])) {
-    string s= t[0]->label;
-    if (!existing_tree_label (s)) return UNINIT;
-    return get_syntax (as_tree_label (s));
+    int code= (int) as_tree_label (t[0]->label, (tree_label) -1);
+    if (code < 0) return UNINIT;
+    return get_syntax ((tree_label) code);
   }
   else if (is_func (t, OR_VALUE)) {
     for (int i=0; i<N(t); i++)
       if (is_atomic (t[i])) {
-        string s= t[i]->label;
-        if (existing_tree_label (s)) {
-          tree r= get_syntax (as_tree_label (s));
+        int code= (int) as_tree_label (t[i]->label, (tree_label) -1);
+        if (code >= 0) {
+          tree r= get_syntax ((tree_label) code);
           if (r != UNINIT) return t;
         }
       }
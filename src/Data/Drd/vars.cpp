@@ -10,6 +10,7 @@
 ******************************************************************************/
 
 #include "vars.hpp"
+#include "basic_environment.hpp"
 
 /******************************************************************************
 * Various important environment variables
@@ -345,3 +346,294 @@ string ORNAMENT_COLOR ("ornament-color");
 string ORNAMENT_EXTRA_COLOR ("ornament-extra-color");
 string ORNAMENT_SUNNY_COLOR ("ornament-sunny-color");
 string ORNAMENT_SHADOW_COLOR ("ornament-shadow-color");
+
+/******************************************************************************
+* Precomputed keys of the environment variables in basic environments
+******************************************************************************/
+
+int DPI_KEY                  = make_env_key (DPI);
+int ZOOM_FACTOR_KEY          = make_env_key (ZOOM_FACTOR);
+int PREAMBLE_KEY             = make_env_key (PREAMBLE);
+int SAVE_AUX_KEY             = make_env_key (SAVE_AUX);
+int MODE_KEY                 = make_env_key (MODE);
+int INFO_FLAG_KEY            = make_env_key (INFO_FLAG);
+int WINDOW_BARS_KEY          = make_env_key (WINDOW_BARS);
+int SCROLL_BARS_KEY          = make_env_key (SCROLL_BARS);
+int IDENTITY_KEY             = make_env_key (IDENTITY);
+int TABULAR_KEY              = make_env_key (TABULAR);
+int THE_LABEL_KEY            = make_env_key (THE_LABEL);
+int THE_TAGS_KEY             = make_env_key (THE_TAGS);
+int THE_MODULES_KEY          = make_env_key (THE_MODULES);
+int WARN_MISSING_KEY         = make_env_key (WARN_MISSING);
+int GLOBAL_TITLE_KEY         = make_env_key (GLOBAL_TITLE);
+int GLOBAL_AUTHOR_KEY        = make_env_key (GLOBAL_AUTHOR);
+int GLOBAL_SUBJECT_KEY       = make_env_key (GLOBAL_SUBJECT);
+int LENGTH_MODE_KEY          = make_env_key (LENGTH_MODE);
+int FONT_KEY                 = make_env_key (FONT);
+int FONT_FAMILY_KEY          = make_env_key (FONT_FAMILY);
+int FONT_SERIES_KEY          = make_env_key (FONT_SERIES);
+int FONT_SHAPE_KEY           = make_env_key (FONT_SHAPE);
+int FONT_SIZE_KEY            = make_env_key (FONT_SIZE);
+int FONT_BASE_SIZE_KEY       = make_env_key (FONT_BASE_SIZE);
+int FONT_EFFECTS_KEY         = make_env_key (FONT_EFFECTS);
+int MAGNIFICATION_KEY        = make_env_key (MAGNIFICATION);
+int COLOR_KEY                = make_env_key (COLOR);
+int OPACITY_KEY              = make_env_key (OPACITY);
+int BG_COLOR_KEY             = make_env_key (BG_COLOR);
+int LOCUS_COLOR_KEY          = make_env_key (LOCUS_COLOR);
+int VISITED_COLOR_KEY        = make_env_key (VISITED_COLOR);
+int NO_PATTERNS_KEY          = make_env_key (NO_PATTERNS);
+int LANGUAGE_KEY             = make_env_key (LANGUAGE);
+int SPACING_POLICY_KEY       = make_env_key (SPACING_POLICY);
+int ATOM_DECORATIONS_KEY     = make_env_key (ATOM_DECORATIONS);
+int LINE_DECORATIONS_KEY     = make_env_key (LINE_DECORATIONS);
+int PAGE_DECORATIONS_KEY     = make_env_key (PAGE_DECORATIONS);
+int XOFF_DECORATIONS_KEY     = make_env_key (XOFF_DECORATIONS);
+int YOFF_DECORATIONS_KEY     = make_env_key (YOFF_DECORATIONS);
+int MATH_LANGUAGE_KEY        = make_env_key (MATH_LANGUAGE);
+int MATH_FONT_KEY            = make_env_key (MATH_FONT);
+int MATH_FONT_FAMILY_KEY     = make_env_key (MATH_FONT_FAMILY);
+int MATH_FONT_SERIES_KEY     = make_env_key (MATH_FONT_SERIES);
+int MATH_FONT_SHAPE_KEY      = make_env_key (MATH_FONT_SHAPE);
+int MATH_FONT_SIZES_KEY      = make_env_key (MATH_FONT_SIZES);
+int MATH_LEVEL_KEY           = make_env_key (MATH_LEVEL);
+int MATH_DISPLAY_KEY         = make_env_key (MATH_DISPLAY);
+int MATH_CONDENSED_KEY       = make_env_key (MATH_CONDENSED);
+int MATH_VPOS_KEY            = make_env_key (MATH_VPOS);
+int MATH_NESTING_MODE_KEY    = make_env_key (MATH_NESTING_MODE);
+int MATH_NESTING_LEVEL_KEY   = make_env_key (MATH_NESTING_LEVEL);
+int MATH_FRAC_LIMIT_KEY      = make_env_key (MATH_FRAC_LIMIT);
+int MATH_TABLE_LIMIT_KEY     = make_env_key (MATH_TABLE_LIMIT);
+int MATH_FLATTEN_COLOR_KEY   = make_env_key (MATH_FLATTEN_COLOR);
+int MATH_TOP_SWELL_START_KEY = make_env_key (MATH_TOP_SWELL_START);
+int MATH_TOP_SWELL_END_KEY   = make_env_key (MATH_TOP_SWELL_END);
+int MATH_BOT_SWELL_START_KEY = make_env_key (MATH_BOT_SWELL_START);
+int MATH_BOT_SWELL_END_KEY   = make_env_key (MATH_BOT_SWELL_END);
+int PROG_LANGUAGE_KEY        = make_env_key (PROG_LANGUAGE);
+int PROG_SCRIPTS_KEY         = make_env_key (PROG_SCRIPTS);
+int PROG_FONT_KEY            = make_env_key (PROG_FONT);
+int PROG_FONT_FAMILY_KEY     = make_env_key (PROG_FONT_FAMILY);
+int PROG_FONT_SERIES_KEY     = make_env_key (PROG_FONT_SERIES);
+int PROG_FONT_SHAPE_KEY      = make_env_key (PROG_FONT_SHAPE);
+int PROG_SESSION_KEY         = make_env_key (PROG_SESSION);
+int PAR_MODE_KEY             = make_env_key (PAR_MODE);
+int PAR_FLEXIBILITY_KEY      = make_env_key (PAR_FLEXIBILITY);
+int PAR_HYPHEN_KEY           = make_env_key (PAR_HYPHEN);
+int PAR_MIN_PENALTY_KEY      = make_env_key (PAR_MIN_PENALTY);
+int PAR_SPACING_KEY          = make_env_key (PAR_SPACING);
+int PAR_KERNING_REDUCE_KEY   = make_env_key (PAR_KERNING_REDUCE);
+int PAR_KERNING_STRETCH_KEY  = make_env_key (PAR_KERNING_STRETCH);
+int PAR_KERNING_MARGIN_KEY   = make_env_key (PAR_KERNING_MARGIN);
+int PAR_CONTRACTION_KEY      = make_env_key (PAR_CONTRACTION);
+int PAR_EXPANSION_KEY        = make_env_key (PAR_EXPANSION);
+int PAR_WIDTH_KEY            = make_env_key (PAR_WIDTH);
+int PAR_LEFT_KEY             = make_env_key (PAR_LEFT);
+int PAR_RIGHT_KEY            = make_env_key (PAR_RIGHT);
+int PAR_FIRST_KEY            = make_env_key (PAR_FIRST);
+int PAR_NO_FIRST_KEY         = make_env_key (PAR_NO_FIRST);
+int PAR_SEP_KEY              = make_env_key (PAR_SEP);
+int PAR_HOR_SEP_KEY          = make_env_key (PAR_HOR_SEP);
+int PAR_VER_SEP_KEY          = make_env_key (PAR_VER_SEP);
+int PAR_LINE_SEP_KEY         = make_env_key (PAR_LINE_SEP);
+int PAR_PAR_SEP_KEY          = make_env_key (PAR_PAR_SEP);
+int PAR_FNOTE_SEP_KEY        = make_env_key (PAR_FNOTE_SEP);
+int PAR_COLUMNS_KEY          = make_env_key (PAR_COLUMNS);
+int PAR_COLUMNS_SEP_KEY      = make_env_key (PAR_COLUMNS_SEP);
+int PAR_SWELL_KEY            = make_env_key (PAR_SWELL);
+int PAGE_MEDIUM_KEY          = make_env_key (PAGE_MEDIUM);
+int PAGE_PRINTED_KEY         = make_env_key (PAGE_PRINTED);
+int PAGE_TYPE_KEY            = make_env_key (PAGE_TYPE);
+int PAGE_ORIENTATION_KEY     = make_env_key (PAGE_ORIENTATION);
+int PAGE_CROP_MARKS_KEY      = make_env_key (PAGE_CROP_MARKS);
+int PAGE_WIDTH_MARGIN_KEY    = make_env_key (PAGE_WIDTH_MARGIN);
+int PAGE_HEIGHT_MARGIN_KEY   = make_env_key (PAGE_HEIGHT_MARGIN);
+int PAGE_SCREEN_MARGIN_KEY   = make_env_key (PAGE_SCREEN_MARGIN);
+int PAGE_SINGLE_KEY          = make_env_key (PAGE_SINGLE);
+int PAGE_PACKET_KEY          = make_env_key (PAGE_PACKET);
+int PAGE_OFFSET_KEY          = make_env_key (PAGE_OFFSET);
+int PAGE_BORDER_KEY          = make_env_key (PAGE_BORDER);
+int PAGE_BREAKING_KEY        = make_env_key (PAGE_BREAKING);
+int PAGE_FLEXIBILITY_KEY     = make_env_key (PAGE_FLEXIBILITY);
+int PAGE_FIRST_KEY           = make_env_key (PAGE_FIRST);
+int PAGE_NR_KEY              = make_env_key (PAGE_NR);
+int PAGE_THE_PAGE_KEY        = make_env_key (PAGE_THE_PAGE);
+int PAGE_WIDTH_KEY           = make_env_key (PAGE_WIDTH);
+int PAGE_HEIGHT_KEY          = make_env_key (PAGE_HEIGHT);
+int PAGE_ODD_KEY             = make_env_key (PAGE_ODD);
+int PAGE_EVEN_KEY            = make_env_key (PAGE_EVEN);
+int PAGE_RIGHT_KEY           = make_env_key (PAGE_RIGHT);
+int PAGE_ODD_SHIFT_KEY       = make_env_key (PAGE_ODD_SHIFT);
+int PAGE_EVEN_SHIFT_KEY      = make_env_key (PAGE_EVEN_SHIFT);
+int PAGE_TOP_KEY             = make_env_key (PAGE_TOP);
+int PAGE_BOT_KEY             = make_env_key (PAGE_BOT);
+int PAGE_USER_HEIGHT_KEY     = make_env_key (PAGE_USER_HEIGHT);
+int PAGE_EXTEND_KEY          = make_env_key (PAGE_EXTEND);
+int PAGE_SHRINK_KEY          = make_env_key (PAGE_SHRINK);
+int PAGE_HEAD_SEP_KEY        = make_env_key (PAGE_HEAD_SEP);
+int PAGE_FOOT_SEP_KEY        = make_env_key (PAGE_FOOT_SEP);
+int PAGE_ODD_HEADER_KEY      = make_env_key (PAGE_ODD_HEADER);
+int PAGE_ODD_FOOTER_KEY      = make_env_key (PAGE_ODD_FOOTER);
+int PAGE_EVEN_HEADER_KEY     = make_env_key (PAGE_EVEN_HEADER);
+int PAGE_EVEN_FOOTER_KEY     = make_env_key (PAGE_EVEN_FOOTER);
+int PAGE_THIS_TOP_KEY        = make_env_key (PAGE_THIS_TOP);
+int PAGE_THIS_BOT_KEY        = make_env_key (PAGE_THIS_BOT);
+int PAGE_THIS_HEADER_KEY     = make_env_key (PAGE_THIS_HEADER);
+int PAGE_THIS_FOOTER_KEY     = make_env_key (PAGE_THIS_FOOTER);
+int PAGE_THIS_BG_COLOR_KEY   = make_env_key (PAGE_THIS_BG_COLOR);
+int PAGE_SCREEN_WIDTH_KEY    = make_env_key (PAGE_SCREEN_WIDTH);
+int PAGE_SCREEN_HEIGHT_KEY   = make_env_key (PAGE_SCREEN_HEIGHT);
+int PAGE_SCREEN_LEFT_KEY     = make_env_key (PAGE_SCREEN_LEFT);
+int PAGE_SCREEN_RIGHT_KEY    = make_env_key (PAGE_SCREEN_RIGHT);
+int PAGE_SCREEN_TOP_KEY      = make_env_key (PAGE_SCREEN_TOP);
+int PAGE_SCREEN_BOT_KEY      = make_env_key (PAGE_SCREEN_BOT);
+int PAGE_SHOW_HF_KEY         = make_env_key (PAGE_SHOW_HF);
+int PAGE_FNOTE_SEP_KEY       = make_env_key (PAGE_FNOTE_SEP);
+int PAGE_FNOTE_BARLEN_KEY    = make_env_key (PAGE_FNOTE_BARLEN);
+int PAGE_FLOAT_SEP_KEY       = make_env_key (PAGE_FLOAT_SEP);
+int PAGE_FLOAT_ENABLE_KEY    = make_env_key (PAGE_FLOAT_ENABLE);
+int PAGE_MNOTE_SEP_KEY       = make_env_key (PAGE_MNOTE_SEP);
+int PAGE_MNOTE_WIDTH_KEY     = make_env_key (PAGE_MNOTE_WIDTH);
+int TABLE_WIDTH_KEY          = make_env_key (TABLE_WIDTH);
+int TABLE_HEIGHT_KEY         = make_env_key (TABLE_HEIGHT);
+int TABLE_HMODE_KEY          = make_env_key (TABLE_HMODE);
+int TABLE_VMODE_KEY          = make_env_key (TABLE_VMODE);
+int TABLE_HALIGN_KEY         = make_env_key (TABLE_HALIGN);
+int TABLE_VALIGN_KEY         = make_env_key (TABLE_VALIGN);
+int TABLE_ROW_ORIGIN_KEY     = make_env_key (TABLE_ROW_ORIGIN);
+int TABLE_COL_ORIGIN_KEY     = make_env_key (TABLE_COL_ORIGIN);
+int TABLE_LSEP_KEY           = make_env_key (TABLE_LSEP);
+int TABLE_RSEP_KEY           = make_env_key (TABLE_RSEP);
+int TABLE_BSEP_KEY           = make_env_key (TABLE_BSEP);
+int TABLE_TSEP_KEY           = make_env_key (TABLE_TSEP);
+int TABLE_LBORDER_KEY        = make_env_key (TABLE_LBORDER);
+int TABLE_RBORDER_KEY        = make_env_key (TABLE_RBORDER);
+int TABLE_BBORDER_KEY        = make_env_key (TABLE_BBORDER);
+int TABLE_TBORDER_KEY        = make_env_key (TABLE_TBORDER);
+int TABLE_HYPHEN_KEY         = make_env_key (TABLE_HYPHEN);
+int TABLE_BLOCK_KEY          = make_env_key (TABLE_BLOCK);
+int TABLE_MIN_ROWS_KEY       = make_env_key (TABLE_MIN_ROWS);
+int TABLE_MIN_COLS_KEY       = make_env_key (TABLE_MIN_COLS);
+int TABLE_MAX_ROWS_KEY       = make_env_key (TABLE_MAX_ROWS);
+int TABLE_MAX_COLS_KEY       = make_env_key (TABLE_MAX_COLS);
+int CELL_FORMAT_KEY          = make_env_key (CELL_FORMAT);
+int CELL_DECORATION_KEY      = make_env_key (CELL_DECORATION);
+int CELL_BACKGROUND_KEY      = make_env_key (CELL_BACKGROUND);
+int CELL_ORIENTATION_KEY     = make_env_key (CELL_ORIENTATION);
+int CELL_WIDTH_KEY           = make_env_key (CELL_WIDTH);
+int CELL_HEIGHT_KEY          = make_env_key (CELL_HEIGHT);
+int CELL_HPART_KEY           = make_env_key (CELL_HPART);
+int CELL_VPART_KEY           = make_env_key (CELL_VPART);
+int CELL_HMODE_KEY           = make_env_key (CELL_HMODE);
+int CELL_VMODE_KEY           = make_env_key (CELL_VMODE);
+int CELL_HALIGN_KEY          = make_env_key (CELL_HALIGN);
+int CELL_VALIGN_KEY          = make_env_key (CELL_VALIGN);
+int CELL_LSEP_KEY            = make_env_key (CELL_LSEP);
+int CELL_RSEP_KEY            = make_env_key (CELL_RSEP);
+int CELL_BSEP_KEY            = make_env_key (CELL_BSEP);
+int CELL_TSEP_KEY            = make_env_key (CELL_TSEP);
+int CELL_LBORDER_KEY         = make_env_key (CELL_LBORDER);
+int CELL_RBORDER_KEY         = make_env_key (CELL_RBORDER);
+int CELL_BBORDER_KEY         = make_env_key (CELL_BBORDER);
+int CELL_TBORDER_KEY         = make_env_key (CELL_TBORDER);
+int CELL_VCORRECT_KEY        = make_env_key (CELL_VCORRECT);
+int CELL_HYPHEN_KEY          = make_env_key (CELL_HYPHEN);
+int CELL_BLOCK_KEY           = make_env_key (CELL_BLOCK);
+int CELL_ROW_SPAN_KEY        = make_env_key (CELL_ROW_SPAN);
+int CELL_COL_SPAN_KEY        = make_env_key (CELL_COL_SPAN);
+int CELL_ROW_NR_KEY          = make_env_key (CELL_ROW_NR);
+int CELL_COL_NR_KEY          = make_env_key (CELL_COL_NR);
+int CELL_SWELL_KEY           = make_env_key (CELL_SWELL);
+int GR_GEOMETRY_KEY          = make_env_key (GR_GEOMETRY);
+int GR_FRAME_KEY             = make_env_key (GR_FRAME);
+int GR_MODE_KEY              = make_env_key (GR_MODE);
+int GR_AUTO_CROP_KEY         = make_env_key (GR_AUTO_CROP);
+int GR_CROP_PADDING_KEY      = make_env_key (GR_CROP_PADDING);
+int GR_GRID_KEY              = make_env_key (GR_GRID);
+int GR_GRID_ASPECT_KEY       = make_env_key (GR_GRID_ASPECT);
+int GR_EDIT_GRID_KEY         = make_env_key (GR_EDIT_GRID);
+int GR_EDIT_GRID_ASPECT_KEY  = make_env_key (GR_EDIT_GRID_ASPECT);
+int GR_TRANSFORMATION_KEY    = make_env_key (GR_TRANSFORMATION);
+int GR_SNAP_DISTANCE_KEY     = make_env_key (GR_SNAP_DISTANCE);
+int GR_GID_KEY               = make_env_key (GR_GID);
+int GR_ANIM_ID_KEY           = make_env_key (GR_ANIM_ID);
+int GR_PROVISO_KEY           = make_env_key (GR_PROVISO);
+int GR_MAGNIFY_KEY           = make_env_key (GR_MAGNIFY);
+int GR_OPACITY_KEY           = make_env_key (GR_OPACITY);
+int GR_COLOR_KEY             = make_env_key (GR_COLOR);
+int GR_POINT_STYLE_KEY       = make_env_key (GR_POINT_STYLE);
+int GR_POINT_SIZE_KEY        = make_env_key (GR_POINT_SIZE);
+int GR_POINT_BORDER_KEY      = make_env_key (GR_POINT_BORDER);
+int GR_LINE_WIDTH_KEY        = make_env_key (GR_LINE_WIDTH);
+int GR_LINE_JOIN_KEY         = make_env_key (GR_LINE_JOIN);
+int GR_LINE_CAPS_KEY         = make_env_key (GR_LINE_CAPS);
+int GR_LINE_EFFECTS_KEY      = make_env_key (GR_LINE_EFFECTS);
+int GR_LINE_PORTION_KEY      = make_env_key (GR_LINE_PORTION);
+int GR_DASH_STYLE_KEY        = make_env_key (GR_DASH_STYLE);
+int GR_DASH_STYLE_UNIT_KEY   = make_env_key (GR_DASH_STYLE_UNIT);
+int GR_ARROW_BEGIN_KEY       = make_env_key (GR_ARROW_BEGIN);
+int GR_ARROW_END_KEY         = make_env_key (GR_ARROW_END);
+int GR_ARROW_LENGTH_KEY      = make_env_key (GR_ARROW_LENGTH);
+int GR_ARROW_HEIGHT_KEY      = make_env_key (GR_ARROW_HEIGHT);
+int GR_FILL_COLOR_KEY        = make_env_key (GR_FILL_COLOR);
+int GR_FILL_STYLE_KEY        = make_env_key (GR_FILL_STYLE);
+int GR_TEXT_AT_HALIGN_KEY    = make_env_key (GR_TEXT_AT_HALIGN);
+int GR_TEXT_AT_VALIGN_KEY    = make_env_key (GR_TEXT_AT_VALIGN);
+int GR_TEXT_AT_MARGIN_KEY    = make_env_key (GR_TEXT_AT_MARGIN);
+int GR_DOC_AT_VALIGN_KEY     = make_env_key (GR_DOC_AT_VALIGN);
+int GR_DOC_AT_WIDTH_KEY      = make_env_key (GR_DOC_AT_WIDTH);
+int GR_DOC_AT_HMODE_KEY      = make_env_key (GR_DOC_AT_HMODE);
+int GR_DOC_AT_PPSEP_KEY      = make_env_key (GR_DOC_AT_PPSEP);
+int GR_DOC_AT_BORDER_KEY     = make_env_key (GR_DOC_AT_BORDER);
+int GR_DOC_AT_PADDING_KEY    = make_env_key (GR_DOC_AT_PADDING);
+int GID_KEY                  = make_env_key (GID);
+int ANIM_ID_KEY              = make_env_key (ANIM_ID);
+int PROVISO_KEY              = make_env_key (PROVISO);
+int MAGNIFY_KEY              = make_env_key (MAGNIFY);
+int POINT_STYLE_KEY          = make_env_key (POINT_STYLE);
+int POINT_SIZE_KEY           = make_env_key (POINT_SIZE);
+int POINT_BORDER_KEY         = make_env_key (POINT_BORDER);
+int LINE_WIDTH_KEY           = make_env_key (LINE_WIDTH);
+int LINE_JOIN_KEY            = make_env_key (LINE_JOIN);
+int LINE_CAPS_KEY            = make_env_key (LINE_CAPS);
+int LINE_EFFECTS_KEY         = make_env_key (LINE_EFFECTS);
+int LINE_PORTION_KEY         = make_env_key (LINE_PORTION);
+int DASH_STYLE_KEY           = make_env_key (DASH_STYLE);
+int DASH_STYLE_UNIT_KEY      = make_env_key (DASH_STYLE_UNIT);
+int ARROW_BEGIN_KEY          = make_env_key (ARROW_BEGIN);
+int ARROW_END_KEY            = make_env_key (ARROW_END);
+int ARROW_LENGTH_KEY         = make_env_key (ARROW_LENGTH);
+int ARROW_HEIGHT_KEY         = make_env_key (ARROW_HEIGHT);
+int FILL_COLOR_KEY           = make_env_key (FILL_COLOR);
+int FILL_STYLE_KEY           = make_env_key (FILL_STYLE);
+int TEXT_AT_HALIGN_KEY       = make_env_key (TEXT_AT_HALIGN);
+int TEXT_AT_VALIGN_KEY       = make_env_key (TEXT_AT_VALIGN);
+int TEXT_AT_MARGIN_KEY       = make_env_key (TEXT_AT_MARGIN);
+int DOC_AT_VALIGN_KEY        = make_env_key (DOC_AT_VALIGN);
+int DOC_AT_WIDTH_KEY         = make_env_key (DOC_AT_WIDTH);
+int DOC_AT_HMODE_KEY         = make_env_key (DOC_AT_HMODE);
+int DOC_AT_PPSEP_KEY         = make_env_key (DOC_AT_PPSEP);
+int DOC_AT_BORDER_KEY        = make_env_key (DOC_AT_BORDER);
+int DOC_AT_PADDING_KEY       = make_env_key (DOC_AT_PADDING);
+int SRC_STYLE_KEY            = make_env_key (SRC_STYLE);
+int SRC_SPECIAL_KEY          = make_env_key (SRC_SPECIAL);
+int SRC_COMPACT_KEY          = make_env_key (SRC_COMPACT);
+int SRC_CLOSE_KEY            = make_env_key (SRC_CLOSE);
+int SRC_TAG_COLOR_KEY        = make_env_key (SRC_TAG_COLOR);
+int CANVAS_TYPE_KEY          = make_env_key (CANVAS_TYPE);
+int CANVAS_COLOR_KEY         = make_env_key (CANVAS_COLOR);
+int CANVAS_HPADDING_KEY      = make_env_key (CANVAS_HPADDING);
+int CANVAS_VPADDING_KEY      = make_env_key (CANVAS_VPADDING);
+int CANVAS_BAR_WIDTH_KEY     = make_env_key (CANVAS_BAR_WIDTH);
+int CANVAS_BAR_PADDING_KEY   = make_env_key (CANVAS_BAR_PADDING);
+int CANVAS_BAR_COLOR_KEY     = make_env_key (CANVAS_BAR_COLOR);
+int ORNAMENT_SHAPE_KEY       = make_env_key (ORNAMENT_SHAPE);
+int ORNAMENT_TITLE_STYLE_KEY = make_env_key (ORNAMENT_TITLE_STYLE);
+int ORNAMENT_BORDER_KEY      = make_env_key (ORNAMENT_BORDER);
+int ORNAMENT_SWELL_KEY       = make_env_key (ORNAMENT_SWELL);
+int ORNAMENT_CORNER_KEY      = make_env_key (ORNAMENT_CORNER);
+int ORNAMENT_HPADDING_KEY    = make_env_key (ORNAMENT_HPADDING);
+int ORNAMENT_VPADDING_KEY    = make_env_key (ORNAMENT_VPADDING);
+int ORNAMENT_COLOR_KEY       = make_env_key (ORNAMENT_COLOR);
+int ORNAMENT_EXTRA_COLOR_KEY = make_env_key (ORNAMENT_EXTRA_COLOR);
+int ORNAMENT_SUNNY_COLOR_KEY = make_env_key (ORNAMENT_SUNNY_COLOR);
+int ORNAMENT_SHADOW_COLOR_KEY= make_env_key (ORNAMENT_SHADOW_COLOR);
@@ -316,4 +316,295 @@ extern string ORNAMENT_EXTRA_COLOR;
 extern string ORNAMENT_SUNNY_COLOR;
 extern string ORNAMENT_SHADOW_COLOR;
 
+/******************************************************************************
+* Precomputed keys of the environment variables in basic environments
+******************************************************************************/
+
+extern int DPI_KEY;
+extern int ZOOM_FACTOR_KEY;
+extern int PREAMBLE_KEY;
+extern int SAVE_AUX_KEY;
+extern int MODE_KEY;
+extern int INFO_FLAG_KEY;
+extern int WINDOW_BARS_KEY;
+extern int SCROLL_BARS_KEY;
+extern int IDENTITY_KEY;
+extern int TABULAR_KEY;
+extern int THE_LABEL_KEY;
+extern int THE_TAGS_KEY;
+extern int THE_MODULES_KEY;
+extern int WARN_MISSING_KEY;
+extern int GLOBAL_TITLE_KEY;
+extern int GLOBAL_AUTHOR_KEY;
+extern int GLOBAL_SUBJECT_KEY;
+extern int LENGTH_MODE_KEY;
+extern int FONT_KEY;
+extern int FONT_FAMILY_KEY;
+extern int FONT_SERIES_KEY;
+extern int FONT_SHAPE_KEY;
+extern int FONT_SIZE_KEY;
+extern int FONT_BASE_SIZE_KEY;
+extern int FONT_EFFECTS_KEY;
+extern int MAGNIFICATION_KEY;
+extern int COLOR_KEY;
+extern int OPACITY_KEY;
+extern int BG_COLOR_KEY;
+extern int LOCUS_COLOR_KEY;
+extern int VISITED_COLOR_KEY;
+extern int NO_PATTERNS_KEY;
+extern int LANGUAGE_KEY;
+extern int SPACING_POLICY_KEY;
+extern int ATOM_DECORATIONS_KEY;
+extern int LINE_DECORATIONS_KEY;
+extern int PAGE_DECORATIONS_KEY;
+extern int XOFF_DECORATIONS_KEY;
+extern int YOFF_DECORATIONS_KEY;
+extern int MATH_LANGUAGE_KEY;
+extern int MATH_FONT_KEY;
+extern int MATH_FONT_FAMILY_KEY;
+extern int MATH_FONT_SERIES_KEY;
+extern int MATH_FONT_SHAPE_KEY;
+extern int MATH_FONT_SIZES_KEY;
+extern int MATH_LEVEL_KEY;
+extern int MATH_DISPLAY_KEY;
+extern int MATH_CONDENSED_KEY;
+extern int MATH_VPOS_KEY;
+extern int MATH_NESTING_MODE_KEY;
+extern int MATH_NESTING_LEVEL_KEY;
+extern int MATH_FRAC_LIMIT_KEY;
+extern int MATH_TABLE_LIMIT_KEY;
+extern int MATH_FLATTEN_COLOR_KEY;
+extern int MATH_TOP_SWELL_START_KEY;
+extern int MATH_TOP_SWELL_END_KEY;
+extern int MATH_BOT_SWELL_START_KEY;
+extern int MATH_BOT_SWELL_END_KEY;
+extern int PROG_LANGUAGE_KEY;
+extern int PROG_SCRIPTS_KEY;
+extern int PROG_FONT_KEY;
+extern int PROG_FONT_FAMILY_KEY;
+extern int PROG_FONT_SERIES_KEY;
+extern int PROG_FONT_SHAPE_KEY;
+extern int PROG_SESSION_KEY;
+extern int PAR_MODE_KEY;
+extern int PAR_FLEXIBILITY_KEY;
+extern int PAR_HYPHEN_KEY;
+extern int PAR_MIN_PENALTY_KEY;
+extern int PAR_SPACING_KEY;
+extern int PAR_KERNING_REDUCE_KEY;
+extern int PAR_KERNING_STRETCH_KEY;
+extern int PAR_KERNING_MARGIN_KEY;
+extern int PAR_CONTRACTION_KEY;
+extern int PAR_EXPANSION_KEY;
+extern int PAR_WIDTH_KEY;
+extern int PAR_LEFT_KEY;
+extern int PAR_RIGHT_KEY;
+extern int PAR_FIRST_KEY;
+extern int PAR_NO_FIRST_KEY;
+extern int PAR_SEP_KEY;
+extern int PAR_HOR_SEP_KEY;
+extern int PAR_VER_SEP_KEY;
+extern int PAR_LINE_SEP_KEY;
+extern int PAR_PAR_SEP_KEY;
+extern int PAR_FNOTE_SEP_KEY;
+extern int PAR_COLUMNS_KEY;
+extern int PAR_COLUMNS_SEP_KEY;
+extern int PAR_SWELL_KEY;
+extern int PAGE_MEDIUM_KEY;
+extern int PAGE_PRINTED_KEY;
+extern int PAGE_TYPE_KEY;
+extern int PAGE_ORIENTATION_KEY;
+extern int PAGE_CROP_MARKS_KEY;
+extern int PAGE_WIDTH_MARGIN_KEY;
+extern int PAGE_HEIGHT_MARGIN_KEY;
+extern int PAGE_SCREEN_MARGIN_KEY;
+extern int PAGE_SINGLE_KEY;
+extern int PAGE_PACKET_KEY;
+extern int PAGE_OFFSET_KEY;
+extern int PAGE_BORDER_KEY;
+extern int PAGE_BREAKING_KEY;
+extern int PAGE_FLEXIBILITY_KEY;
+extern int PAGE_FIRST_KEY;
+extern int PAGE_NR_KEY;
+extern int PAGE_THE_PAGE_KEY;
+extern int PAGE_WIDTH_KEY;
+extern int PAGE_HEIGHT_KEY;
+extern int PAGE_ODD_KEY;
+extern int PAGE_EVEN_KEY;
+extern int PAGE_RIGHT_KEY;
+extern int PAGE_ODD_SHIFT_KEY;
+extern int PAGE_EVEN_SHIFT_KEY;
+extern int PAGE_TOP_KEY;
+extern int PAGE_BOT_KEY;
+extern int PAGE_USER_HEIGHT_KEY;
+extern int PAGE_EXTEND_KEY;
+extern int PAGE_SHRINK_KEY;
+extern int PAGE_HEAD_SEP_KEY;
+extern int PAGE_FOOT_SEP_KEY;
+extern int PAGE_ODD_HEADER_KEY;
+extern int PAGE_ODD_FOOTER_KEY;
+extern int PAGE_EVEN_HEADER_KEY;
+extern int PAGE_EVEN_FOOTER_KEY;
+extern int PAGE_THIS_TOP_KEY;
+extern int PAGE_THIS_BOT_KEY;
+extern int PAGE_THIS_HEADER_KEY;
+extern int PAGE_THIS_FOOTER_KEY;
+extern int PAGE_THIS_BG_COLOR_KEY;
+extern int PAGE_SCREEN_WIDTH_KEY;
+extern int PAGE_SCREEN_HEIGHT_KEY;
+extern int PAGE_SCREEN_LEFT_KEY;
+extern int PAGE_SCREEN_RIGHT_KEY;
+extern int PAGE_SCREEN_TOP_KEY;
+extern int PAGE_SCREEN_BOT_KEY;
+extern int PAGE_SHOW_HF_KEY;
+extern int PAGE_FNOTE_SEP_KEY;
+extern int PAGE_FNOTE_BARLEN_KEY;
+extern int PAGE_FLOAT_SEP_KEY;
+extern int PAGE_FLOAT_ENABLE_KEY;
+extern int PAGE_MNOTE_SEP_KEY;
+extern int PAGE_MNOTE_WIDTH_KEY;
+extern int TABLE_WIDTH_KEY;
+extern int TABLE_HEIGHT_KEY;
+extern int TABLE_HMODE_KEY;
+extern int TABLE_VMODE_KEY;
+extern int TABLE_HALIGN_KEY;
+extern int TABLE_VALIGN_KEY;
+extern int TABLE_ROW_ORIGIN_KEY;
+extern int TABLE_COL_ORIGIN_KEY;
+extern int TABLE_LSEP_KEY;
+extern int TABLE_RSEP_KEY;
+extern int TABLE_BSEP_KEY;
+extern int TABLE_TSEP_KEY;
+extern int TABLE_LBORDER_KEY;
+extern int TABLE_RBORDER_KEY;
+extern int TABLE_BBORDER_KEY;
+extern int TABLE_TBORDER_KEY;
+extern int TABLE_HYPHEN_KEY;
+extern int TABLE_BLOCK_KEY;
+extern int TABLE_MIN_ROWS_KEY;
+extern int TABLE_MIN_COLS_KEY;
+extern int TABLE_MAX_ROWS_KEY;
+extern int TABLE_MAX_COLS_KEY;
+extern int CELL_FORMAT_KEY;
+extern int CELL_DECORATION_KEY;
+extern int CELL_BACKGROUND_KEY;
+extern int CELL_ORIENTATION_KEY;
+extern int CELL_WIDTH_KEY;
+extern int CELL_HEIGHT_KEY;
+extern int CELL_HPART_KEY;
+extern int CELL_VPART_KEY;
+extern int CELL_HMODE_KEY;
+extern int CELL_VMODE_KEY;
+extern int CELL_HALIGN_KEY;
+extern int CELL_VALIGN_KEY;
+extern int CELL_LSEP_KEY;
+extern int CELL_RSEP_KEY;
+extern int CELL_BSEP_KEY;
+extern int CELL_TSEP_KEY;
+extern int CELL_LBORDER_KEY;
+extern int CELL_RBORDER_KEY;
+extern int CELL_BBORDER_KEY;
+extern int CELL_TBORDER_KEY;
+extern int CELL_VCORRECT_KEY;
+extern int CELL_HYPHEN_KEY;
+extern int CELL_BLOCK_KEY;
+extern int CELL_ROW_SPAN_KEY;
+extern int CELL_COL_SPAN_KEY;
+extern int CELL_ROW_NR_KEY;
+extern int CELL_COL_NR_KEY;
+extern int CELL_SWELL_KEY;
+extern int GR_GEOMETRY_KEY;
+extern int GR_FRAME_KEY;
+extern int GR_MODE_KEY;
+extern int GR_AUTO_CROP_KEY;
+extern int GR_CROP_PADDING_KEY;
+extern int GR_GRID_KEY;
+extern int GR_GRID_ASPECT_KEY;
+extern int GR_EDIT_GRID_KEY;
+extern int GR_EDIT_GRID_ASPECT_KEY;
+extern int GR_TRANSFORMATION_KEY;
+extern int GR_SNAP_DISTANCE_KEY;
+extern int GR_GID_KEY;
+extern int GR_ANIM_ID_KEY;
+extern int GR_PROVISO_KEY;
+extern int GR_MAGNIFY_KEY;
+extern int GR_OPACITY_KEY;
+extern int GR_COLOR_KEY;
+extern int GR_POINT_STYLE_KEY;
+extern int GR_POINT_SIZE_KEY;
+extern int GR_POINT_BORDER_KEY;
+extern int GR_LINE_WIDTH_KEY;
+extern int GR_LINE_JOIN_KEY;
+extern int GR_LINE_CAPS_KEY;
+extern int GR_LINE_EFFECTS_KEY;
+extern int GR_LINE_PORTION_KEY;
+extern int GR_DASH_STYLE_KEY;
+extern int GR_DASH_STYLE_UNIT_KEY;
+extern int GR_ARROW_BEGIN_KEY;
+extern int GR_ARROW_END_KEY;
+extern int GR_ARROW_LENGTH_KEY;
+extern int GR_ARROW_HEIGHT_KEY;
+extern int GR_FILL_COLOR_KEY;
+extern int GR_FILL_STYLE_KEY;
+extern int GR_TEXT_AT_HALIGN_KEY;
+extern int GR_TEXT_AT_VALIGN_KEY;
+extern int GR_TEXT_AT_MARGIN_KEY;
+extern int GR_DOC_AT_VALIGN_KEY;
+extern int GR_DOC_AT_WIDTH_KEY;
+extern int GR_DOC_AT_HMODE_KEY;
+extern int GR_DOC_AT_PPSEP_KEY;
+extern int GR_DOC_AT_BORDER_KEY;
+extern int GR_DOC_AT_PADDING_KEY;
+extern int GID_KEY;
+extern int ANIM_ID_KEY;
+extern int PROVISO_KEY;
+extern int MAGNIFY_KEY;
+extern int POINT_STYLE_KEY;
+extern int POINT_SIZE_KEY;
+extern int POINT_BORDER_KEY;
+extern int LINE_WIDTH_KEY;
+extern int LINE_JOIN_KEY;
+extern int LINE_CAPS_KEY;
+extern int LINE_EFFECTS_KEY;
+extern int LINE_PORTION_KEY;
+extern int DASH_STYLE_KEY;
+extern int DASH_STYLE_UNIT_KEY;
+extern int ARROW_BEGIN_KEY;
+extern int ARROW_END_KEY;
+extern int ARROW_LENGTH_KEY;
+extern int ARROW_HEIGHT_KEY;
+extern int FILL_COLOR_KEY;
+extern int FILL_STYLE_KEY;
+extern int TEXT_AT_HALIGN_KEY;
+extern int TEXT_AT_VALIGN_KEY;
+extern int TEXT_AT_MARGIN_KEY;
+extern int DOC_AT_VALIGN_KEY;
+extern int DOC_AT_WIDTH_KEY;
+extern int DOC_AT_HMODE_KEY;
+extern int DOC_AT_PPSEP_KEY;
+extern int DOC_AT_BORDER_KEY;
+extern int DOC_AT_PADDING_KEY;
+extern int SRC_STYLE_KEY;
+extern int SRC_SPECIAL_KEY;
+extern int SRC_COMPACT_KEY;
+extern int SRC_CLOSE_KEY;
+extern int SRC_TAG_COLOR_KEY;
+extern int CANVAS_TYPE_KEY;
+extern int CANVAS_COLOR_KEY;
+extern int CANVAS_HPADDING_KEY;
+extern int CANVAS_VPADDING_KEY;
+extern int CANVAS_BAR_WIDTH_KEY;
+extern int CANVAS_BAR_PADDING_KEY;
+extern int CANVAS_BAR_COLOR_KEY;
+extern int ORNAMENT_SHAPE_KEY;
+extern int ORNAMENT_TITLE_STYLE_KEY;
+extern int ORNAMENT_BORDER_KEY;
+extern int ORNAMENT_SWELL_KEY;
+extern int ORNAMENT_CORNER_KEY;
+extern int ORNAMENT_HPADDING_KEY;
+extern int ORNAMENT_VPADDING_KEY;
+extern int ORNAMENT_COLOR_KEY;
+extern int ORNAMENT_EXTRA_COLOR_KEY;
+extern int ORNAMENT_SUNNY_COLOR_KEY;
+extern int ORNAMENT_SHADOW_COLOR_KEY;
+
 #endif // defined VARS_H
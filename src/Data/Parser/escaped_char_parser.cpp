@@ -33,7 +33,7 @@ escaped_char_parser_rep::set_sequences (array<string> p_strings) {
   for (int i=0; i<N(p_strings); i++) {
     string str= p_strings[i];
     if (N(str) == 1) {
-      m_chars << str[0];
+      m_chars << (char) str[0];
     } else {
       m_strings << str;
     }
@@ -105,7 +105,7 @@ escaped_char_parser_rep::can_parse (string s, int pos) {
     string m_string= m_strings[i];
     if (test (s, pos+1, m_string)) return true;
   }
-  return contains (s[pos+1], m_chars);
+  return contains ((char) s[pos+1], m_chars);
 }
 
 string
@@ -157,6 +157,6 @@ escaped_char_parser_rep::do_parse (string s, int& pos) {
     }
   }
 
-  if (contains (s[pos+1], m_chars))
+  if (contains ((char) s[pos+1], m_chars))
     pos= pos+2;
 }
@@ -33,7 +33,7 @@ identifier_parser_rep::can_parse (string s, int pos) {
   if (!parser_rep::can_parse (s, pos)) return false;
   
   if (start_with_alpha && is_alpha (s[pos])) return true;
-  if (contains (s[pos], start_chars)) return true;
+  if (contains ((char) s[pos], start_chars)) return true;
   return false;
 }
 
@@ -11,10 +11,12 @@
 
 #include "converter.hpp"
 #include "convert.hpp"
+#include "tm_configure.hpp"
 #ifdef USE_ICONV
 #include <iconv.h>
 #endif
 #include <errno.h>
+#include <string.h>
 
 RESOURCE_CODE (converter);
 
@@ -24,9 +26,17 @@ RESOURCE_CODE (converter);
 
 void
 operator << (converter c, string str) {
-  int index = 0;
-  while (index < N(str))
-    c->match(str, index);
+  int index = 0, n= N(str);
+  while (index < n) {
+    if (c->starts_key (str[index]))
+      c->match(str, index);
+    else {
+      // copy runs of characters which do not start any key at once
+      int start= index;
+      while (index < n && !c->starts_key (str[index])) index++;
+      if (c->copy_unmatched) c->output << str (start, index);
+    }
+  }
 }
 
 string
@@ -67,39 +77,229 @@ converter_rep::has_value(hashtree<char,string> node) {
 
 inline void
 converter_rep::match (string& str, int& index) {
+  int* b= A(base);
+  int* c= A(check);
+  int* v= A(value);
+  int s= 0, n= N(str);
   int forward = index;
   int last_match = -1;
-  string value("");
-  bool done = false;
-  hashtree<char,string> node = ht;
-  //cout << "[";
-  while (!done && forward < N(str)) {
-    if (node->contains (str[forward])) {
-      node = node(str[forward]);
-      //printf("->%x",str[forward]);
-      if (has_value(node)) {
-        last_match = forward;
-        value = node->label;
-      }
-      forward++;
+  int val = -1;
+  while (forward < n) {
+    int t= b[s] + ((unsigned char) str[forward]);
+    if (c[t] != s) break;
+    s= t;
+    if (v[s] >= 0) {
+      last_match = forward;
+      val = v[s];
     }
-    else done = true;
+    forward++;
   }
   if (last_match==-1) {
     if (copy_unmatched)
-      output << string(str[index]);
+      output << str[index];
     index++;
   }
   else {
-    //printf(":");for(int i = 0; i < N(value);i++) printf("%x ",value[i]);
-    output << value;
+    output << values[val];
     index = last_match + 1;
   }
-  //cout << "]";
+}
+
+/******************************************************************************
+* Compilation of the dictionaries into double-array tries
+******************************************************************************/
+
+static void
+reserve (array<int>& base, array<int>& check, array<int>& value, int n) {
+  int i, old= N(check);
+  if (n <= old) return;
+  n= max (n, 2*old);
+  base ->resize (n);
+  check->resize (n);
+  value->resize (n);
+  for (i=old; i<n; i++) {
+    base [i]= 0;
+    check[i]= -1;
+    value[i]= -1;
+  }
+}
+
+void
+converter_rep::compile () {
+  // states are processed in breadth first order; each state gets the first
+  // offset for which the slots of all its transitions are still free
+  base  = array<int> ();
+  check = array<int> ();
+  value = array<int> ();
+  values= array<string> ();
+  reserve (base, check, value, 257);
+  check[0]= -2;
+  array<hashtree<char,string> > todo;
+  array<int> slot;
+  todo << ht;
+  slot << 0;
+  int i, j, q, next_free= 1, m= 0;
+  for (q=0; q<N(todo); q++) {
+    hashtree<char,string> node= todo[q];
+    array<int> cs;
+    for (i=0; i<256; i++)
+      if (node->contains ((char) i)) cs << i;
+    if (N(cs) == 0) continue;
+    int b= max (1, next_free - cs[0]);
+    while (true) {
+      reserve (base, check, value, b + 256);
+      for (j=0; j<N(cs); j++)
+        if (check[b + cs[j]] != -1) break;
+      if (j == N(cs)) break;
+      b++;
+    }
+    base[slot[q]]= b;
+    m= max (m, b);
+    for (j=0; j<N(cs); j++) {
+      hashtree<char,string> child= node ((char) cs[j]);
+      int t= b + cs[j];
+      check[t]= slot[q];
+      if (has_value (child)) {
+        value[t]= N(values);
+        values << child->label;
+      }
+      todo << child;
+      slot << t;
+    }
+    while (next_free < N(check) && check[next_free] != -1) next_free++;
+  }
+  base ->resize (m + 256);
+  check->resize (m + 256);
+  value->resize (m + 256);
+  ht= hashtree<char,string> ();
+}
+
+/******************************************************************************
+* Caching compiled dictionaries on disk
+******************************************************************************/
+
+#define CONVERTER_CACHE_VERSION 2
+#define CONVERTER_CACHE_HEADER  4 // magic, version, checksum, number of words
+
+static int
+converter_magic () {
+  int m;
+  memcpy ((void*) &m, (const void*) "TMCV", 4);
+  return m;
+}
+
+static int
+converter_checksum (const int* w, int n) {
+  unsigned int h= 2166136261u;
+  for (int i=0; i<n; i++)
+    h= (h ^ ((unsigned int) w[i])) * 16777619u;
+  return (int) h;
+}
+
+static array<string> loaded_dictionaries;
+
+static int
+converter_stamp (array<string> dicts) {
+  // the cache is outdated as soon as one of its dictionaries is modified
+  int i, stamp= 0;
+  for (i=0; i<N(dicts); i++) {
+    url u ("$TEXMACS_PATH/langs/encoding", dicts[i]);
+    stamp= max (stamp, last_modified (u, false));
+  }
+  return stamp;
+}
+
+string
+converter_rep::pack () {
+  int i, n= N(check), nd= N(dicts), nv= N(values) + nd + 1;
+  array<string> strs;
+  strs << string (TEXMACS_VERSION) << dicts << values;
+  array<int> w;
+  w << converter_magic () << CONVERTER_CACHE_VERSION << 0 << 0;
+  w << converter_stamp (dicts) << nd << n << base << check << value << nv;
+  int pos= 0;
+  for (i=0; i<nv; i++) {
+    w << pos;
+    pos += N(strs[i]);
+  }
+  w << pos;
+  int start= N(w);
+  w->resize (start + ((pos + 3) >> 2));
+  for (i=start; i<N(w); i++) w[i]= 0;
+  char* pool= (char*) (A(w) + start);
+  for (i=0; i<nv; i++)
+    if (N(strs[i]) != 0) {
+      memcpy ((void*) pool, (const void*) &(strs[i][0]), N(strs[i]));
+      pool += N(strs[i]);
+    }
+  w[3]= N(w) - CONVERTER_CACHE_HEADER;
+  w[2]= converter_checksum (A(w) + CONVERTER_CACHE_HEADER, w[3]);
+  return string ((const char*) A(w), N(w) * sizeof (int));
+}
+
+bool
+converter_rep::unpack (string s) {
+  int i, nr= N(s) >> 2;
+  if ((N(s) & 3) != 0 || nr < CONVERTER_CACHE_HEADER + 4) return false;
+  array<int> w (nr);
+  memcpy ((void*) A(w), (const void*) &(s[0]), nr * sizeof (int));
+  if (w[0] != converter_magic () || w[1] != CONVERTER_CACHE_VERSION) return false;
+  if (w[3] != nr - CONVERTER_CACHE_HEADER) return false;
+  if (converter_checksum (A(w) + CONVERTER_CACHE_HEADER, w[3]) != w[2])
+    return false;
+  int pos= CONVERTER_CACHE_HEADER;
+  int stamp= w[pos++];
+  int nd= w[pos++];
+  int n= w[pos++];
+  if (n < 257 || pos + 3*n + 1 > nr) return false;
+  array<int> b (n), c (n), v (n);
+  memcpy ((void*) A(b), (const void*) (A(w) + pos), n * sizeof (int));
+  memcpy ((void*) A(c), (const void*) (A(w) + pos + n), n * sizeof (int));
+  memcpy ((void*) A(v), (const void*) (A(w) + pos + 2*n), n * sizeof (int));
+  pos += 3*n;
+  int nv= w[pos++];
+  if (nd < 0 || nv < nd + 1 || pos + nv + 1 > nr) return false;
+  const int* offs= A(w) + pos;
+  pos += nv + 1;
+  for (i=0; i<nv; i++)
+    if (offs[i] < 0 || offs[i] > offs[i+1]) return false;
+  if (((nr - pos) << 2) < offs[nv]) return false;
+  for (i=0; i<n; i++)
+    if (b[i] < 0 || b[i] > n - 256 || v[i] < -1 || v[i] >= nv - nd - 1)
+      return false;
+  const char* pool= (const char*) (A(w) + pos);
+  if (string (pool + offs[0], offs[1] - offs[0]) != TEXMACS_VERSION)
+    return false;
+  array<string> ds (nd);
+  for (i=0; i<nd; i++)
+    ds[i]= string (pool + offs[i+1], offs[i+2] - offs[i+1]);
+  if (stamp != converter_stamp (ds)) return false;
+  array<string> vs (nv - nd - 1);
+  for (i=nd+1; i<nv; i++)
+    vs[i-nd-1]= string (pool + offs[i], offs[i+1] - offs[i]);
+  base  = b;
+  check = c;
+  value = v;
+  values= vs;
+  dicts = ds;
+  return true;
 }
 
 void
 converter_rep::load () {
+  url name ("$TEXMACS_HOME_PATH/system/cache",
+            "converter_" * from * "-" * to * ".bin");
+  string s;
+  if (exists (name) && !load_string (name, s, false) && unpack (s)) return;
+  loaded_dictionaries= array<string> ();
+  load_dictionaries ();
+  dicts= loaded_dictionaries;
+  compile ();
+  if (N(values) != 0) (void) save_string (name, pack (), false);
+}
+
+void
+converter_rep::load_dictionaries () {
   // to handle each case individually seems unelegant, but there is simply more
   // to be done here than just loading a file.
   // cout << "TeXmacs] load converter " << from << " -> " << to << "\n";
@@ -315,6 +515,12 @@ utf8_to_cork (string input) {
   string output;
   for (i=0; i<n; ) {
     start= i;
+    while (i<n && ((unsigned char) input[i]) < 128 &&
+           !conv->starts_key (input[i])) i++;
+    if (i > start) {
+      output << input (start, i);
+      continue;
+    }
     unsigned int code= decode_from_utf8 (input, i);
     string s= input (start, i);
     string r= apply (conv, s);
@@ -332,6 +538,12 @@ sourcecode_to_cork (string input) {
   string output;
   for (i=0; i<n; ) {
     start= i;
+    while (i<n && ((unsigned char) input[i]) < 128 &&
+           !conv->starts_key (input[i])) i++;
+    if (i > start) {
+      output << input (start, i);
+      continue;
+    }
     unsigned int code= decode_from_utf8 (input, i);
     string s= input (start, i);
     string r= apply (conv, s);
@@ -423,8 +635,8 @@ cyrillic_subset_in_t2a_to_code_point (string input) {
       i = j;
     }
     else {
-      tmp = apply (conv, input[i]);
-      if (tmp == input[i]) r << tmp;
+      tmp = apply (conv, input (i, i+1));
+      if (tmp == input (i, i+1)) r << tmp;
       else r << '<'*tmp*'>';
     }
   }
@@ -631,6 +843,7 @@ hashtree_from_dictionary (
   if (DEBUG_CONVERT) debug_convert << "Loading dictionary " << file_name << LF;
   string key_string, val_string, file;
   file_name = file_name * ".scm";
+  loaded_dictionaries << file_name;
   if (load_string (url ("$TEXMACS_PATH/langs/encoding", file_name),
                    file, false)) {
     convert_error << "Couldn't open encoding dictionary " << file_name << LF;
@@ -23,14 +23,26 @@ RESOURCE(converter);
 * The converter class applies a dictionary to a given string.
 * It does so by iterating over a string, finding the longest matching key
 * in the dictionary and replacing the matched substring with the translation.
-* The hashtree and converter classes are used.
+* The dictionary is first read into a hashtree, which is then compiled into
+* a double-array trie: the transition of the state s for the byte c leads
+* to the state t= base[s]+c whenever check[t] == s. Bytes which do not start
+* any key are copied in runs. Compiled dictionaries are cached on disk.
 ******************************************************************************/
 
 struct converter_rep: rep<converter> {
   hashtree<char,string> ht;
   string output, nil_string, from, to;
   bool copy_unmatched;
+  array<int>    base;    // offsets of the transitions of each state
+  array<int>    check;   // the state from which each state is reached
+  array<int>    value;   // index of the translation of each state or -1
+  array<string> values;  // the translations
+  array<string> dicts;   // the dictionary files which were loaded
   void match (string& str, int& index);
+  void load_dictionaries ();
+  void compile ();
+  string pack ();
+  bool unpack (string s);
   void load ();
 
 public:
@@ -39,6 +51,8 @@ public:
     nil_string(), from(from2), to(to2), copy_unmatched(true) { load(); }
 
   inline bool has_value(hashtree<char,string> node);
+  inline bool starts_key(char c) {
+    return check[base[0] + ((unsigned char) c)] == 0; }
 
   friend struct converter;
   friend string flush (converter c);
@@ -22,6 +22,7 @@
 #include <setjmp.h>
 #include "image_files.hpp"
 #include "iterator.hpp"
+#include "tm_timer.hpp"
 
 #ifdef EXPERIMENTAL
 #include "../../Style/Memorizer/clean_copy.hpp"
@@ -257,9 +258,14 @@ edit_main_rep::print_doc (url name, bool conform, int first, int last) {
     env->write (PAGE_PRINTED, "true");
   }
 
-  // Typeset pages for printing
+  // Typeset pages for printing; when only the first pages are needed,
+  // forward references are taken from the last complete typesetting
 
-  box the_box= typeset_as_document (env, subtree (et, rp), reverse (rp));
+  int known= (medium == "paper" && !is_nil (eb)? N (eb[0]): -1);
+  bench_start ("typeset pages");
+  box the_box= typeset_as_document (env, subtree (et, rp), reverse (rp),
+                                    page_limit_for (last, known));
+  bench_end ("typeset pages");
 
   // Determine parameters for printer
 
@@ -283,6 +289,7 @@ edit_main_rep::print_doc (url name, bool conform, int first, int last) {
   }
   
   // Print pages
+  bench_start ("render pages");
   renderer ren= printer (name, dpi, pages, page_type, landsc, w/cm, h/cm);
   
   if (ren->is_started ()) {
@@ -304,6 +311,7 @@ edit_main_rep::print_doc (url name, bool conform, int first, int last) {
     }
   }
   tm_delete (ren);
+  bench_end ("render pages");
 
 #ifdef USE_GS
   if (!use_pdf () && pdf) {
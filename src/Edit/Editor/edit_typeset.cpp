@@ -1005,19 +1005,67 @@ clean_unused (hashmap<string,tree>& refs, hashmap<string,bool> used) {
     refs->reset (a[i]);
 }
 
+static bool
+is_document_ip (path ip) {
+  for (; !is_nil (ip); ip= ip->next)
+    if (ip->item < 0) return false;
+  return true;
+}
+
+bool
+ref_readers_of (hashmap<string,tree> missing, array<tree> redefined,
+                hashmap<string,list<path> > readers, path rp,
+                array<path>& ps) {
+  // Determine the bridges inside the document rp which read missing or
+  // redefined references, or return false if some reader is elsewhere
+  array<string> keys;
+  for (iterator<string> it= iterate (missing); it->busy(); )
+    keys << it->next ();
+  for (int i=0; i<N(redefined); i++)
+    keys << redefined[i][0]->label;
+  hashmap<path,bool> done (false);
+  ps= array<path> ();
+  for (int i=0; i<N(keys); i++)
+    for (list<path> l= readers[keys[i]]; !is_nil (l); l= l->next) {
+      if (done->contains (l->item)) continue;
+      if (!is_document_ip (l->item)) return false;
+      path p= reverse (l->item);
+      if (!(rp <= p) || p == rp) return false;
+      done (l->item)= true;
+      ps << p;
+    }
+  return true;
+}
+
+int
+edit_typeset_rep::typeset_invalidate_refs () {
+  // Invalidate the bridges which read missing or redefined references
+  // during the last pass and return their number, or -1 if some reader
+  // could not be located inside the document
+  array<path> ps;
+  if (!ref_readers_of (env->missing, env->redefined, env->ref_readers, rp, ps))
+    return -1;
+  for (int i=0; i<N(ps); i++)
+    ::notify_assign (ttt, ps[i] / rp, subtree (et, ps[i]));
+  return N(ps);
+}
+
 void
 edit_typeset_rep::typeset (SI& x1, SI& y1, SI& x2, SI& y2) {
   int missing_nr= INT_MAX;
   int redefined_nr= INT_MAX;
+  int passes= 0, retypeset= 0;
   x1= MAX_SI; y1= MAX_SI; x2= MIN_SI; y2= MIN_SI;
   while (true) {
     SI sx1, sy1, sx2, sy2;
     typeset_sub (sx1, sy1, sx2, sy2);
     x1= min (x1, sx1); y1= min (y1, sy1);
     x2= max (x2, sx2); y2= max (y2, sy2);
-    if (!env->complete) break;
+    passes++;
+    if (!env->complete && !env->ref_check) break;
+    if (env->complete) clean_unused (env->local_ref, env->touched);
     env->complete= false;
-    clean_unused (env->local_ref, env->touched);
+    env->ref_check= false;
     if (N(env->missing) == 0 && N(env->redefined) == 0) break;
     if ((N(env->missing) == missing_nr && N(env->redefined) == redefined_nr) ||
         (N(env->missing) > missing_nr || N(env->redefined) > redefined_nr)) {
@@ -1027,8 +1075,19 @@ edit_typeset_rep::typeset (SI& x1, SI& y1, SI& x2, SI& y2) {
     }
     missing_nr= N(env->missing);
     redefined_nr= N(env->redefined);
-    ::notify_assign (ttt, path(), ttt->br->st);
+    int nr= typeset_invalidate_refs ();
+    if (nr < 0) ::notify_assign (ttt, path(), ttt->br->st);
+    else {
+      // only retypeset the readers and check them again in the next pass
+      env->missing  = hashmap<string,tree> (UNINIT);
+      env->redefined= array<tree> ();
+      env->ref_check= true;
+      retypeset += nr;
+    }
   }
+  if (DEBUG_BENCH && passes > 1)
+    std_bench << "Typesetting took " << passes << " passes, "
+              << retypeset << " retypeset readers of references\n";
 }
 
 void
@@ -130,6 +130,7 @@ public:
   void     typeset_invalidate (path p);
   void     typeset_invalidate_all ();
   void     typeset_invalidate_players (path p, bool reattach);
+  int      typeset_invalidate_refs ();
   void     typeset_sub (SI& x1, SI& y1, SI& x2, SI& y2);
   void     typeset (SI& x1, SI& y1, SI& x2, SI& y2);
   void     typeset_forced ();
@@ -138,4 +139,8 @@ public:
   friend class tm_server_rep;
 };
 
+bool ref_readers_of (hashmap<string,tree> missing, array<tree> redefined,
+                     hashmap<string,list<path> > readers, path rp,
+                     array<path>& ps);
+
 #endif // defined EDIT_TYPESET_H
@@ -41,12 +41,17 @@ struct glyph_rep: concrete_struct {
   short lwidth;              // logical width of character
   short status;              // status for extensible characters
   short artistic;            // result of applying an artistic effect
-  QN*   raster;              // character definition
+  QN*   raster;              // character definition for depth > 1
+  DN*   bits;                // character definition for depth 1
+  int   words;               // number of words in each row of bits
 
   glyph_rep (int w, int h, int xoff, int yoff, int depth, int status=0);
   ~glyph_rep ();
   inline int  get_1 (int i, int j);
   inline void set_1 (int i, int j, int with);
+  inline DN*  row_1 (int j);
+  inline DN   get_bits (int i, int j, int n);
+  inline void or_bits (int i, int j, DN w, int n);
   int  get_x (int i, int j);
   void set_x (int i, int j, int with);
   int  get (int i, int j);
@@ -61,17 +66,82 @@ struct glyph {
 };
 CONCRETE_NULL_CODE(glyph);
 
+/******************************************************************************
+* Glyphs of depth 1 are stored row by row, using 64 pixels per word. Each
+* row starts at a new word and the bits after the end of a row are zero,
+* so that operations on glyphs may proceed word by word.
+******************************************************************************/
+
 inline int
 glyph_rep::get_1 (int i, int j) {
-  int bit= j*width+i;
-  return (raster[bit>>3] >> (bit&7)) & 1;
+  return (int) ((bits[j*words + (i>>6)] >> (i&63)) & 1);
 }
 
 inline void
 glyph_rep::set_1 (int i, int j, int with) {
-  int bit= j*width+i;
-  if (with==0) raster[bit>>3] &= ~(1 << (bit&7));
-  else raster[bit>>3] |= (1 << (bit&7));
+  DN* w= bits + j*words + (i>>6);
+  if (with==0) *w &= ~(((DN) 1) << (i&63));
+  else *w |= (((DN) 1) << (i&63));
+}
+
+inline DN*
+glyph_rep::row_1 (int j) {
+  return bits + j*words;
+}
+
+inline DN
+glyph_rep::get_bits (int i, int j, int n) {
+  // the n <= 64 pixels starting at (i, j), with i+n <= width
+  DN* r= bits + j*words + (i>>6);
+  int o= i&63;
+  DN w= r[0] >> o;
+  if (o != 0 && o + n > 64) w |= r[1] << (64 - o);
+  if (n < 64) w &= (((DN) 1) << n) - 1;
+  return w;
+}
+
+inline void
+glyph_rep::or_bits (int i, int j, DN w, int n) {
+  // add the n <= 64 pixels of w at (i, j), with i+n <= width
+  DN* r= bits + j*words + (i>>6);
+  int o= i&63;
+  r[0] |= w << o;
+  if (o != 0 && o + n > 64) r[1] |= w >> (64 - o);
+}
+
+inline int
+bit_count (DN w) {
+#if defined (__GNUC__)
+  return __builtin_popcountll (w);
+#else
+  int n= 0;
+  for (; w != 0; w &= w - 1) n++;
+  return n;
+#endif
+}
+
+inline int
+first_bit (DN w) {
+  // position of the lowest bit of w != 0
+#if defined (__GNUC__)
+  return __builtin_ctzll (w);
+#else
+  int n= 0;
+  for (; (w & 1) == 0; w >>= 1) n++;
+  return n;
+#endif
+}
+
+inline int
+last_bit (DN w) {
+  // position of the highest bit of w != 0
+#if defined (__GNUC__)
+  return 63 - __builtin_clzll (w);
+#else
+  int n= 0;
+  for (; w > 1; w >>= 1) n++;
+  return n;
+#endif
 }
 
 tm_ostream& operator << (tm_ostream& out, glyph gl);
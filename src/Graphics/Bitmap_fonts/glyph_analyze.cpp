@@ -28,8 +28,9 @@ next_column (glyph g, int x, int dx) {
 int
 next_row (glyph g, int y, int dy) {
   while (y >= 0 && y < g->height) {
-    for (int x=0; x<g->width; x++)
-      if (g->get_1 (x, y) != 0) return y;
+    DN* row= g->row_1 (y);
+    for (int k=0; k<g->words; k++)
+      if (row[k] != 0) return y;
     y += dy;
   }
   return y;
@@ -55,12 +56,14 @@ search_in_column (glyph g, int x, int what, int y, int dy) {
 
 int
 count_row_changes (glyph g, int y) {
-  int cur= 0, count= 0;
-  for (int x=0; x<g->width; x++)
-    if (g->get_1 (x, y) != cur) {
-      cur= g->get_1 (x, y);
-      if (cur == 1) count++;
-    }
+  // count the pixels which are set, while their left neighbour is not
+  DN* row= g->row_1 (y);
+  DN  prev= 0;
+  int count= 0;
+  for (int k=0; k<g->words; k++) {
+    count += bit_count (row[k] & ~((row[k] << 1) | prev));
+    prev= row[k] >> 63;
+  }
   return count;
 }
 
@@ -77,9 +80,10 @@ count_column_changes (glyph g, int x) {
 
 int
 count_row_pixels (glyph g, int y) {
+  DN* row= g->row_1 (y);
   int count= 0;
-  for (int x=0; x<g->width; x++)
-    count += g->get_1 (x, y);
+  for (int k=0; k<g->words; k++)
+    count += bit_count (row[k]);
   return count;
 }
 
@@ -109,8 +113,7 @@ int
 pixel_count (glyph g) {
   int r= 0;
   for (int y=0; y<g->height; y++)
-    for (int x=0; x<g->width; x++)
-      r += g->get_1 (x, y);
+    r += count_row_pixels (g, y);
   return r;
 }
 
@@ -12,6 +12,38 @@
 #include "bitmap_font.hpp"
 #include "renderer.hpp"
 
+/******************************************************************************
+* Word by word operations on glyphs of depth 1
+******************************************************************************/
+
+static void
+copy_bits (glyph dest, int di, int dj, glyph src, int si, int sj, int n) {
+  // add n pixels from row sj of src at (di, dj) in dest
+  for (int k=0; k<n; k+=64) {
+    int m= min (64, n-k);
+    dest->or_bits (di+k, dj, src->get_bits (si+k, sj, m), m);
+  }
+}
+
+static DN
+get_clipped (glyph gl, int i, int j, int n) {
+  // the n <= 64 pixels starting at (i, j), which are zero outside gl
+  if (j < 0 || j >= gl->height) return 0;
+  int lo= max (i, 0), hi= min (i+n, (int) gl->width);
+  if (lo >= hi) return 0;
+  return gl->get_bits (lo, j, hi-lo) << (lo-i);
+}
+
+static inline bool
+is_bit_column (glyph gl, int i) {
+  return gl->depth == 1 && i >= 0 && i < gl->width;
+}
+
+static inline bool
+is_bit_row (glyph gl, int j) {
+  return gl->depth == 1 && j >= 0 && j < gl->height;
+}
+
 /******************************************************************************
 * Information about glyphs
 ******************************************************************************/
@@ -27,6 +59,13 @@ get_bounding_box (glyph gl, SI& x1, SI& y1, SI& x2, SI& y2) {
 bool
 empty_column (glyph gl, int i) {
   int hh= gl->height;
+  if (is_bit_column (gl, i)) {
+    DN m= ((DN) 1) << (i&63);
+    for (int j=0; j<hh; j++)
+      if ((gl->row_1 (j) [i>>6] & m) != 0)
+        return false;
+    return true;
+  }
   for (int j=0; j<hh; j++)
     if (gl->get_x (i, j) != 0)
       return false;
@@ -36,6 +75,13 @@ empty_column (glyph gl, int i) {
 bool
 empty_row (glyph gl, int j) {
   int ww= gl->width;
+  if (is_bit_row (gl, j)) {
+    DN* r= gl->row_1 (j);
+    for (int k=0; k<gl->words; k++)
+      if (r[k] != 0)
+        return false;
+    return true;
+  }
   for (int i=0; i<ww; i++)
     if (gl->get_x (i, j) != 0)
       return false;
@@ -45,6 +91,13 @@ empty_row (glyph gl, int j) {
 int
 first_in_row (glyph gl, int j) {
   int ww= gl->width;
+  if (is_bit_row (gl, j)) {
+    DN* r= gl->row_1 (j);
+    for (int k=0; k<gl->words; k++)
+      if (r[k] != 0)
+        return (k<<6) + first_bit (r[k]);
+    return ww;
+  }
   for (int i=0; i<ww; i++)
     if (gl->get_x (i, j) != 0)
       return i;
@@ -62,6 +115,13 @@ first_in_rows (glyph gl, int j1, int j2) {
 int
 last_in_row (glyph gl, int j) {
   int ww= gl->width;
+  if (is_bit_row (gl, j)) {
+    DN* r= gl->row_1 (j);
+    for (int k=gl->words-1; k>=0; k--)
+      if (r[k] != 0)
+        return (k<<6) + last_bit (r[k]);
+    return -1;
+  }
   for (int i=ww-1; i>=0; i--)
     if (gl->get_x (i, j) != 0)
       return i;
@@ -79,6 +139,13 @@ last_in_rows (glyph gl, int j1, int j2) {
 int
 first_in_column (glyph gl, int i) {
   int hh= gl->height;
+  if (is_bit_column (gl, i)) {
+    DN m= ((DN) 1) << (i&63);
+    for (int j=0; j<hh; j++)
+      if ((gl->row_1 (j) [i>>6] & m) != 0)
+        return j;
+    return hh;
+  }
   for (int j=0; j<hh; j++)
     if (gl->get_x (i, j) != 0)
       return j;
@@ -88,6 +155,13 @@ first_in_column (glyph gl, int i) {
 int
 last_in_column (glyph gl, int i) {
   int hh= gl->height;
+  if (is_bit_column (gl, i)) {
+    DN m= ((DN) 1) << (i&63);
+    for (int j=hh-1; j>=0; j--)
+      if ((gl->row_1 (j) [i>>6] & m) != 0)
+        return j;
+    return -1;
+  }
   for (int j=hh-1; j>=0; j--)
     if (gl->get_x (i, j) != 0)
       return j;
@@ -101,13 +175,14 @@ collision_offset (glyph gl1, glyph gl2, bool overlap) {
   for (int j2=0; j2<h2; j2++) {
     int y = gl2->yoff - j2;
     int j1= gl1->yoff - y;
-    if (0 <= j1 && j1 < h1 &&
-        !empty_row (gl1, j1) &&
-        !empty_row (gl2, j2)) {
-      int end1  = last_in_row (gl1, j1);
-      int start2= first_in_row (gl2, j2);
-      int end2  = last_in_row (gl2, j2);
-      int di    = end1 - (overlap? end2: start2);
+    if (0 <= j1 && j1 < h1) {
+      // NOTE: empty rows are those for which last_in_row is negative
+      int end1= last_in_row (gl1, j1);
+      if (end1 < 0) continue;
+      int end2= last_in_row (gl2, j2);
+      if (end2 < 0) continue;
+      int start2= (overlap? end2: first_in_row (gl2, j2));
+      int di    = end1 - start2;
       int dx    = di - gl1->xoff + gl2->xoff;
       best= max (best, dx);
     }
@@ -151,15 +226,23 @@ join (glyph gl1, glyph gl2) {
 
   int i, j, dx, dy;
   dx= -gl1->xoff- x1, dy= y2- gl1->yoff;
-  for (j=0; j<gl1->height; j++)
-    for (i=0; i<gl1->width; i++)
-      bmr->set_x (i+dx, j+dy, gl1->get_x (i, j));
+  if (bmr->depth == 1)
+    for (j=0; j<gl1->height; j++)
+      copy_bits (bmr, dx, j+dy, gl1, 0, j, gl1->width);
+  else
+    for (j=0; j<gl1->height; j++)
+      for (i=0; i<gl1->width; i++)
+        bmr->set_x (i+dx, j+dy, gl1->get_x (i, j));
 
   dx= -gl2->xoff- x1; dy= y2- gl2->yoff;
-  for (j=0; j<gl2->height; j++)
-    for (i=0; i<gl2->width; i++)
-      bmr->set_x (i+dx, j+dy,
-		  max (bmr->get_x (i+dx, j+dy), gl2->get_x (i, j)));
+  if (bmr->depth == 1)
+    for (j=0; j<gl2->height; j++)
+      copy_bits (bmr, dx, j+dy, gl2, 0, j, gl2->width);
+  else
+    for (j=0; j<gl2->height; j++)
+      for (i=0; i<gl2->width; i++)
+        bmr->set_x (i+dx, j+dy,
+                    max (bmr->get_x (i+dx, j+dy), gl2->get_x (i, j)));
 
   int lo= min (-gl1->xoff, -gl2->xoff);
   int hi= max (gl1->lwidth - gl1->xoff, gl2->lwidth - gl2->xoff);
@@ -172,6 +255,17 @@ intersect (glyph gl1, glyph gl2) {
   int i, j;
   int ww= gl1->width, hh= gl1->height, ww2= gl2->width, hh2= gl2->height;
   glyph bmr (ww, hh, gl1->xoff, gl1->yoff, gl1->depth);
+  if (gl1->depth == 1 && gl2->depth == 1) {
+    int di= gl2->xoff - gl1->xoff, dj= gl2->yoff - gl1->yoff;
+    for (j=0; j<hh; j++)
+      for (i=0; i<ww; i+=64) {
+        int n= min (64, ww-i);
+        DN c= gl1->get_bits (i, j, n) & get_clipped (gl2, i+di, j+dj, n);
+        bmr->or_bits (i, j, c, n);
+      }
+    bmr->lwidth= gl1->lwidth;
+    return simplify (bmr);
+  }
   for (j=0; j<hh; j++)
     for (i=0; i<ww; i++) {
       int c = gl1->get_x (i, j);
@@ -191,6 +285,17 @@ exclude (glyph gl1, glyph gl2) {
   int i, j;
   int ww= gl1->width, hh= gl1->height, ww2= gl2->width, hh2= gl2->height;
   glyph bmr (ww, hh, gl1->xoff, gl1->yoff, gl1->depth);
+  if (gl1->depth == 1 && gl2->depth == 1) {
+    int di= gl2->xoff - gl1->xoff, dj= gl2->yoff - gl1->yoff;
+    for (j=0; j<hh; j++)
+      for (i=0; i<ww; i+=64) {
+        int n= min (64, ww-i);
+        DN c= gl1->get_bits (i, j, n) & ~get_clipped (gl2, i+di, j+dj, n);
+        bmr->or_bits (i, j, c, n);
+      }
+    bmr->lwidth= gl1->lwidth;
+    return simplify (bmr);
+  }
   for (j=0; j<hh; j++)
     for (i=0; i<ww; i++) {
       int c = gl1->get_x (i, j);
@@ -251,6 +356,11 @@ copy (glyph gl) {
   int i, j;
   int ww= gl->width, hh= gl->height;
   glyph bmr (ww, hh, gl->xoff, gl->yoff, gl->depth);
+  if (gl->depth == 1) {
+    for (i=0; i < hh * gl->words; i++)
+      bmr->bits[i]= gl->bits[i];
+    return bmr;
+  }
   for (j=0; j<hh; j++)
     for (i=0; i<ww; i++)
       bmr->set_x (i, j, gl->get_x (i, j));
@@ -262,15 +372,28 @@ simplify (glyph gl) {
   int i, j;
   int ww= gl->width, hh= gl->height;
   int i1= 0, i2= ww-1, j1= 0, j2= hh-1;
-  while (i1 < ww && empty_column (gl, i1)) i1++;
-  while (i2 >= 0 && empty_column (gl, i2)) i2--;
+  if (gl->depth == 1) {
+    i1= ww; i2= -1;
+    for (j=0; j<hh; j++) {
+      i1= min (i1, first_in_row (gl, j));
+      i2= max (i2, last_in_row (gl, j));
+    }
+  }
+  else {
+    while (i1 < ww && empty_column (gl, i1)) i1++;
+    while (i2 >= 0 && empty_column (gl, i2)) i2--;
+  }
   while (j1 < hh && empty_row (gl, j1)) j1++;
   while (j2 >= 0 && empty_row (gl, j2)) j2--;
   if (i1 == ww) { i1= j1= 0; i2= j2= -1; }
   glyph bmr (i2-i1+1, j2-j1+1, gl->xoff-i1, gl->yoff-j1, gl->depth);
-  for (j=j1; j<=j2; j++)
-    for (i=i1; i<=i2; i++)
-      bmr->set_x (i-i1, j-j1, gl->get_x (i, j));
+  if (gl->depth == 1)
+    for (j=j1; j<=j2; j++)
+      copy_bits (bmr, 0, j-j1, gl, i1, j, i2-i1+1);
+  else
+    for (j=j1; j<=j2; j++)
+      for (i=i1; i<=i2; i++)
+        bmr->set_x (i-i1, j-j1, gl->get_x (i, j));
   bmr->lwidth= gl->lwidth;
   return bmr;
 }
@@ -280,6 +403,12 @@ padded (glyph gl, int l, int t, int r, int b) {
   int i, j;
   int ww= gl->width, hh= gl->height;
   glyph bmr (ww+l+r, hh+t+b, gl->xoff+l, gl->yoff+t, gl->depth);
+  if (gl->depth == 1 && l >= 0 && t >= 0 && r >= 0 && b >= 0) {
+    for (j=0; j<hh; j++)
+      copy_bits (bmr, l, j + t, gl, 0, j, ww);
+    bmr->lwidth= gl->lwidth;
+    return bmr;
+  }
   for (j=0; j<hh+t+b; j++)
     for (i=0; i<ww+l+r; i++)
       bmr->set_x (i, j, 0);
@@ -298,9 +427,13 @@ move (glyph gl, SI x, SI y) {
   glyph bmr (ww, hh, gl->xoff- xx, gl->yoff+ yy, gl->depth);
 
   int i, j;
-  for (j=0; j<hh; j++)
-    for (i=0; i<ww; i++)
-      bmr->set_x (i, j, gl->get_x (i, j));
+  if (gl->depth == 1)
+    for (i=0; i < hh * gl->words; i++)
+      bmr->bits[i]= gl->bits[i];
+  else
+    for (j=0; j<hh; j++)
+      for (i=0; i<ww; i++)
+        bmr->set_x (i, j, gl->get_x (i, j));
   bmr->lwidth= gl->lwidth;
   return bmr;
 }
@@ -314,6 +447,15 @@ clip (glyph gl, SI x1, SI y1, SI x2, SI y2) {
   int i, j;
   int ww= gl->width, hh= gl->height;
   glyph bmr (ww, hh, gl->xoff, gl->yoff, gl->depth);
+  if (gl->depth == 1) {
+    int i1= max (x1 + gl->xoff, 0), i2= min (x2 + gl->xoff, ww);
+    for (j=0; j<hh; j++) {
+      bool y_ok= (gl->yoff-j >= y1) && (gl->yoff-j < y2);
+      if (y_ok && i1 < i2) copy_bits (bmr, i1, j, gl, i1, j, i2-i1);
+    }
+    bmr->lwidth= gl->lwidth;
+    return simplify (bmr);
+  }
   for (j=0; j<hh; j++)
     for (i=0; i<ww; i++) {
       bool x_ok= (i-gl->xoff >= x1) && (i-gl->xoff < x2);
@@ -341,9 +483,13 @@ ver_flip (glyph gl) {
   int i, j;
   int ww= gl->width, hh= gl->height;
   glyph bmr (ww, hh, gl->xoff, gl->yoff, gl->depth);
-  for (j=0; j<hh; j++)
-    for (i=0; i<ww; i++)
-      bmr->set_x (i, hh-1-j, gl->get_x (i, j));
+  if (gl->depth == 1)
+    for (j=0; j<hh; j++)
+      copy_bits (bmr, 0, hh-1-j, gl, 0, j, ww);
+  else
+    for (j=0; j<hh; j++)
+      for (i=0; i<ww; i++)
+        bmr->set_x (i, hh-1-j, gl->get_x (i, j));
   bmr->lwidth= gl->lwidth;
   return bmr;
 }
@@ -412,9 +558,14 @@ ver_extend (glyph gl, int pos, int by) {
   int i, j;
   int ww= gl->width, hh= gl->height;
   glyph bmr (ww, hh+by, gl->xoff, gl->yoff, gl->depth);
-  for (j=0; j<(hh+by); j++)
-    for (i=0; i<ww; i++)
-      bmr->set_x (i, j, gl->get_x (i, j<pos? j: (j<pos+by? pos: j-by)));
+  for (j=0; j<(hh+by); j++) {
+    int sj= j<pos? j: (j<pos+by? pos: j-by);
+    if (gl->depth == 1 && sj >= 0 && sj < hh)
+      copy_bits (bmr, 0, j, gl, 0, sj, ww);
+    else
+      for (i=0; i<ww; i++)
+        bmr->set_x (i, j, gl->get_x (i, sj));
+  }
   bmr->lwidth= gl->lwidth;
   return bmr;
 }
@@ -425,8 +576,11 @@ ver_take (glyph gl, int pos, int nr) {
   int ww= gl->width;
   glyph bmr (ww, nr, gl->xoff, 0, gl->depth);
   for (j=0; j<nr; j++)
-    for (i=0; i<ww; i++)
-      bmr->set_x (i, j, gl->get_x (i, pos));
+    if (gl->depth == 1 && pos >= 0 && pos < gl->height)
+      copy_bits (bmr, 0, j, gl, 0, pos, ww);
+    else
+      for (i=0; i<ww; i++)
+        bmr->set_x (i, j, gl->get_x (i, pos));
   bmr->lwidth= gl->lwidth;
   return simplify (bmr);
 }
@@ -41,13 +41,41 @@ my_norm (int a, int m) {
   else return m-a;
 }
 
+static DN
+columns_with_run (DN* c, int h, int m) {
+  // Return the bits which are set in m consecutive words among c[0..h-1].
+  // The words c[j] are replaced by the conjunctions of c[j..j+k-1] for
+  // increasing powers of two k <= m; two such windows cover c[j..j+m-1].
+  if (m > h) return 0;
+  int j, k= 1;
+  for (; 2*k <= m; k *= 2)
+    for (j=0; j + 2*k <= h; j++)
+      c[j] &= c[j+k];
+  DN r= 0;
+  for (j=0; j + m <= h; j++)
+    r |= c[j] & c[j + m - k];
+  return r;
+}
+
 int
 get_hor_shift (glyph gl, int xfactor, int tx) {
   STACK_NEW_ARRAY (flag, bool, gl->width);
 
   // cout << "[";
   int x;
-  for (x=0; x<gl->width; x++) {
+  if (gl->depth == 1) {
+    // flag the columns with more than half of the height in one stroke
+    int hh= gl->height;
+    STACK_NEW_ARRAY (col, DN, hh);
+    for (x=0; x<gl->width; x+=64) {
+      int y, n= min (64, gl->width - x);
+      for (y=0; y<hh; y++) col[y]= gl->get_bits (x, y, n);
+      DN r= columns_with_run (col, hh, (hh>>1) + 1);
+      for (int i=0; i<n; i++) flag[x+i]= ((r >> i) & 1) != 0;
+    }
+    STACK_DELETE_ARRAY (col);
+  }
+  else for (x=0; x<gl->width; x++) {
     int max_count= 0, count=0, y;
     for (y=0; y<gl->height; y++)
       if (gl->get_1 (x,y)) count++;
@@ -176,20 +204,33 @@ shrink (glyph gl, int xfactor, int yfactor,
   SI  off_x = (((-X1) *xfactor+ dx)*PIXEL + ((tx*PIXEL)>>1))/xfactor;
   SI  off_y = (((Y2-1)*yfactor- dy)*PIXEL - ((ty*PIXEL)>>1))/yfactor;
 
-  int i, j, x, y;
-  int index, indey, entry;
+  // The pixels of gl are thickened by tx pixels to the right and by ty
+  // pixels to the bottom and stored upside down into a bitmap, which is
+  // then summed block by block. Both steps proceed word by word.
+  int i, j, k, x, y;
   int ww=(X2-X1)*xfactor, hh=(Y2-Y1)*yfactor;
-  int* bitmap= tm_new_array<int> (ww*hh);
-  //STACK_NEW_ARRAY (bitmap, int, ww*hh);
-  for (i=0; i<ww*hh; i++) bitmap[i]=0;
-  for (y=0, index= ww*frac_y+ frac_x; y<gl->height; y++, index-=ww)
-    for (x=0; x<gl->width; x++)
-      if (gl->get_1(x,y))
-        for (j=0, indey=ww*ty; j<=ty; j++, indey-=ww) {
-	  entry = index+indey+x;
-	  for (i=0; i<=tx; i++, entry++)
-	    bitmap[entry]= 1;
-	}
+  glyph bitmap (ww, hh, 0, 0, 1);
+  glyph thick (ww, 1, 0, 0, 1);
+  DN* trow= thick->row_1 (0);
+  for (y=0; y<gl->height; y++) {
+    for (k=0; k<thick->words; k++) trow[k]= 0;
+    bool empty= true;
+    for (x=0; x<gl->width; x+=64) {
+      int n= min (64, gl->width - x);
+      DN  w= gl->get_bits (x, y, n);
+      if (w == 0) continue;
+      for (i=0; i<=tx; i++)
+        thick->or_bits (frac_x + x + i, 0, w, n);
+      empty= false;
+    }
+    if (empty) continue;
+    for (j=0; j<=ty; j++) {
+      int r= frac_y + ty - y - j;
+      if (r < 0 || r >= hh) continue;
+      DN* brow= bitmap->row_1 (r);
+      for (k=0; k<bitmap->words; k++) brow[k] |= trow[k];
+    }
+  }
 
   int X, Y, sum, nr= xfactor*yfactor;
   int new_depth= gl->depth+ log2i (nr);
@@ -199,17 +240,15 @@ shrink (glyph gl, int xfactor, int yfactor,
   for (Y=Y1; Y<Y2; Y++)
     for (X=X1; X<X2; X++) {
       sum=0;
-      indey= ((Y-Y1)*ww+ (X-X1))*xfactor;
-      for (j=0, index= indey; j<yfactor; j++, index+=ww)
-	for (i=0; i<xfactor; i++)
-	  sum += bitmap[index+ i];
+      int r= (Y-Y1)*xfactor, c= (X-X1)*xfactor;
+      for (j=0; j<yfactor && r+j<hh; j++)
+        for (i=0; i<xfactor; i+=64)
+          sum += bit_count (bitmap->get_bits (c+i, r+j, min (64, xfactor-i)));
       if (nr >= 64) sum= (64 * sum) / nr;
       CB->set (X, Y, sum);
     }
   xo= off_x;
   yo= off_y;
-  tm_delete_array (bitmap);
-  //STACK_DELETE_ARRAY (bitmap);
 
   // cout << CB << "\n";
   return CB;
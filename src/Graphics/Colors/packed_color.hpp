@@ -0,0 +1,81 @@
+/******************************************************************************
+* MODULE     : packed_color.hpp
+* DESCRIPTION: RGBA colors packed into 8 bits per channel
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef PACKED_COLOR_H
+#define PACKED_COLOR_H
+#include "true_color.hpp"
+
+/******************************************************************************
+* Packed colors use the same memory layout as the color type on little
+* endian machines, so that rows of packed colors can be handed directly
+* to the renderers. They are a compact alternative to true colors for
+* pictures which are only composed onto each other.
+******************************************************************************/
+
+class packed_color {
+public:
+  typedef unsigned char scalar_type;
+
+public:
+  unsigned char b;
+  unsigned char g;
+  unsigned char r;
+  unsigned char a;
+
+public:
+  inline packed_color () {}
+  inline packed_color (color c):
+    b (c & 0xff), g ((c >> 8) & 0xff),
+    r ((c >> 16) & 0xff), a ((c >> 24) & 0xff) {}
+  inline packed_color (const true_color& c) {
+    *this= packed_color ((color) c); }
+  inline operator color () const {
+    return ((color) b) + (((color) g) << 8) +
+           (((color) r) << 16) + (((color) a) << 24); }
+};
+
+inline tm_ostream&
+operator << (tm_ostream& out, const packed_color& c) {
+  return out << "[ " << ((int) c.r) << ", " << ((int) c.g) << ", "
+             << ((int) c.b) << "; " << ((int) c.a) << "]";
+}
+
+inline bool
+operator == (const packed_color& c1, const packed_color& c2) {
+  return ((color) c1) == ((color) c2);
+}
+
+inline bool
+operator != (const packed_color& c1, const packed_color& c2) {
+  return ((color) c1) != ((color) c2);
+}
+
+inline void clear (packed_color& c) { c= packed_color ((color) 0); }
+
+/******************************************************************************
+* Composition operators
+******************************************************************************/
+
+inline packed_color
+source_over (const packed_color& c1, const packed_color& c2) {
+  // NOTE: single precision, in the same order as the vectorized version
+  float a1= c1.a * (1.0f / 255.0f), a2= c2.a * (1.0f / 255.0f);
+  float a = a2 + a1 * (1.0f - a2);
+  float u = 1.0f / (a + 1.0e-6f);
+  float f1= a1 * (1.0f - a2) * u, f2= a2 * u;
+  packed_color c;
+  c.b= (unsigned char) (int) (c1.b * f1 + c2.b * f2 + 0.5f);
+  c.g= (unsigned char) (int) (c1.g * f1 + c2.g * f2 + 0.5f);
+  c.r= (unsigned char) (int) (c1.r * f1 + c2.r * f2 + 0.5f);
+  c.a= (unsigned char) (int) (a * 255.0f + 0.5f);
+  return c;
+}
+
+#endif // defined PACKED_COLOR_H
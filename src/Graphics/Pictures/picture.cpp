@@ -138,10 +138,10 @@ error_picture (int w, int h) {
 * Cached pictured loading
 ******************************************************************************/
 
-static hashmap<tree,int> picture_count (0);
-static hashmap<tree,int> picture_blacklist (0);
-static hashmap<tree,picture> picture_cache;
-static hashmap<tree,int> picture_stamp (- (int) (((unsigned int) (-1)) >> 1));
+static flat_hashmap<tree,int> picture_count (0);
+static flat_hashmap<tree,int> picture_blacklist (0);
+static flat_hashmap<tree,picture> picture_cache;
+static flat_hashmap<tree,int> picture_stamp (- (int) (((unsigned int) (-1)) >> 1));
 
 void
 picture_cache_reserve (url file_name, int w, int h, tree eff, int pixel) {
@@ -176,14 +176,14 @@ picture_cache_clean () {
       //cout << "Removed " << key << "\n";
     }
   }
-  picture_blacklist= hashmap<tree,int> ();
+  picture_blacklist= flat_hashmap<tree,int> ();
 }
 
 void
 picture_cache_reset () {
-  picture_blacklist= hashmap<tree,int> ();
-  picture_cache= hashmap<tree,picture> ();
-  picture_stamp= hashmap<tree,int> ();
+  picture_blacklist= flat_hashmap<tree,int> ();
+  picture_cache= flat_hashmap<tree,picture> ();
+  picture_stamp= flat_hashmap<tree,int> ();
 }
 
 static bool
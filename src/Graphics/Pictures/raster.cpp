@@ -0,0 +1,37 @@
+/******************************************************************************
+* MODULE     : raster.cpp
+* DESCRIPTION: Splitting raster operations between several threads
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "raster.hpp"
+#include <thread>
+
+int
+raster_threads (int n, double work) {
+  int nr= (int) std::thread::hardware_concurrency ();
+  nr= min (nr, RASTER_MAX_THREADS);
+  nr= min (nr, n);
+  if (work < nr * RASTER_MIN_WORK) nr= (int) (work / RASTER_MIN_WORK);
+  return max (nr, 1);
+}
+
+void
+raster_parallel (raster_task task, void* data, int n, int nr) {
+  // the calling thread takes the first range itself
+  if (nr <= 1 || n <= 1) {
+    task (data, 0, n);
+    return;
+  }
+  nr= min (nr, min (n, RASTER_MAX_THREADS));
+  std::thread threads[RASTER_MAX_THREADS];
+  for (int i=1; i<nr; i++)
+    threads[i]= std::thread (task, data, (i * n) / nr, ((i+1) * n) / nr);
+  task (data, 0, n / nr);
+  for (int i=1; i<nr; i++)
+    threads[i].join ();
+}
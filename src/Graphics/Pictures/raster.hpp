@@ -157,8 +157,7 @@ map (raster<C> r) {
   typedef Unary_return_type(Op,C) Ret;
   int w= r->w, h= r->h, n= w*h;
   raster<Ret> ret (w, h, r->ox, r->oy);
-  for (int i=0; i<n; i++)
-    ret->a[i]= Op::op (r->a[i]);
+  map_row<Op,C,Ret> (ret->a, r->a, n);
   return ret;
 }
 
@@ -348,8 +347,7 @@ draw_on (raster<C>& dest, raster<S> src, int x, int y) {
   if (w <= 0 || h <= 0) return;
   d += y * dw + x;
   for (int yy=0; yy<h; yy++, d += dw, s +=sw)
-    for (int xx=0; xx<w; xx++)
-      composition_op<M>::set_op (d[xx], s[xx]);
+    compose_row<M> (d, s, w);
 }
 
 template<typename C, typename S> void
@@ -718,12 +716,112 @@ gaussian_pen (double rx, double ry, double phi, double order= 2.5) {
   return pixelize<C> (fun, w, w, R, R, 1);
 }
 
+/******************************************************************************
+* Splitting loops over the rows of a raster between several threads
+******************************************************************************/
+
+#define RASTER_MAX_THREADS 8
+#define RASTER_MIN_WORK    1.0e6 // minimal number of operations per thread
+
+typedef void (*raster_task) (void* data, int start, int end);
+int  raster_threads (int n, double work);
+void raster_parallel (raster_task task, void* data, int n, int nr);
+
+template<typename T> void
+raster_run (void* data, int start, int end) {
+  ((T*) data)->run (start, end);
+}
+
+template<typename T> inline void
+raster_parallel (T& task, int n, double work) {
+  // NOTE: tasks only access raw pixel arrays and must not allocate memory
+  raster_parallel (raster_run<T>, (void*) &task, n, raster_threads (n, work));
+}
+
+/******************************************************************************
+* Fast Fourier transforms
+******************************************************************************/
+
+struct fft_table {
+  int     n;
+  double* cs;
+  double* sn;
+  inline fft_table (int n2): n (n2) {
+    cs= tm_new_array<double> (n/2 + 1);
+    sn= tm_new_array<double> (n/2 + 1);
+    for (int k=0; k <= n/2; k++) {
+      cs[k]= cos ((6.283185307179586 * k) / n);
+      sn[k]= sin ((6.283185307179586 * k) / n); } }
+  inline ~fft_table () { tm_delete_array (cs); tm_delete_array (sn); }
+};
+
+template<typename C> void
+fft (C* re, C* im, int stride, const fft_table& t, bool inverse) {
+  int n= t.n;
+  for (int i=1, j=0; i<n; i++) {
+    int bit= n >> 1;
+    for (; (j & bit) != 0; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      C tr= re[i*stride]; re[i*stride]= re[j*stride]; re[j*stride]= tr;
+      C ti= im[i*stride]; im[i*stride]= im[j*stride]; im[j*stride]= ti;
+    }
+  }
+  for (int len=2; len<=n; len <<= 1) {
+    int half= len >> 1, step= n / len;
+    for (int i=0; i<n; i+=len)
+      for (int k=0; k<half; k++) {
+        double wr= t.cs[k*step], wi= inverse? t.sn[k*step]: -t.sn[k*step];
+        int p= (i+k) * stride, q= (i+k+half) * stride;
+        C tr= wr * re[q] - wi * im[q];
+        C ti= wr * im[q] + wi * re[q];
+        re[q]= re[p] - tr;
+        im[q]= im[p] - ti;
+        re[p] += tr;
+        im[p] += ti;
+      }
+  }
+}
+
+inline int
+fft_size (int pen, int total) {
+  // transforms for blocks of about three times the size of the pen
+  int n= 32, m= 1;
+  while (n < 4 * pen) n <<= 1;
+  while (m < total + pen - 1) m <<= 1;
+  return min (n, m);
+}
+
+inline double
+fft_work (int n, int m) {
+  int l= 0;
+  for (int k= n*m; k > 1; k >>= 1) l++;
+  return 3.0 * n * m * (2*l + 2);
+}
+
 /******************************************************************************
 * Convolution and blur
 ******************************************************************************/
 
+template<typename C, typename S>
+struct convolute_task {
+  const C* src; const S* pen; C* dest;
+  int s1w, s1h, s2w, s2h, dw;
+  void run (int start, int end) {
+    for (int y=start; y<end; y++) {
+      int y1a= max (0, y - s2h + 1), y1b= min (s1h, y + 1);
+      for (int y1=y1a; y1<y1b; y1++) {
+        int o1= y1 * s1w, o2= (y - y1) * s2w, o= y * dw;
+        for (int x1=0; x1<s1w; x1++)
+          for (int x2=0; x2<s2w; x2++)
+            dest[o+x1+x2] += src[o1+x1] * pen[o2+x2];
+      }
+    }
+  }
+};
+
 template<typename C, typename S> raster<C>
-convolute (raster<C> s1, raster<S> s2) {
+direct_convolute (raster<C> s1, raster<S> s2) {
   if (s1->w * s1->h == 0) return s1;
   ASSERT (s2->w * s2->h != 0, "empty convolution argument");
   int s1w= s1->w, s1h= s1->h, s2w= s2->w, s2h= s2->h;
@@ -731,36 +829,172 @@ convolute (raster<C> s1, raster<S> s2) {
   raster<C> d (dw, dh, s1->ox + s2->ox, s1->oy + s2->oy);
   clear (d);
   raster<C> temp= mul_alpha (s1);
-  for (int y1=0; y1<s1h; y1++)
-    for (int y2=0; y2<s2h; y2++) {
-      int o1= y1 * s1w, o2= y2 * s2w, o= (y1 + y2) * dw;
-      for (int x1=0; x1<s1w; x1++)
-        for (int x2=0; x2<s2w; x2++)
-          d->a[o+x1+x2] += temp->a[o1+x1] * s2->a[o2+x2];
+  convolute_task<C,S> task= {
+    temp->a, s2->a, d->a, s1w, s1h, s2w, s2h, dw };
+  raster_parallel (task, dh, ((double) s1w * s1h) * s2w * s2h);
+  return div_alpha (d);
+}
+
+template<typename C>
+struct fft_convolute_task {
+  const C* src; C* dest;
+  int s1w, s1h, dw, dh;
+  const double* kre; const double* kim;
+  const fft_table* tx; const fft_table* ty;
+  int bx, by, nr, parity;
+  C** bufs;
+  void run (int start, int end) {
+    int rows= (s1h + by - 1) / by, cols= (s1w + bx - 1) / bx;
+    for (int t=start; t<end; t++)
+      for (int j= parity + 2*t; j < rows; j += 2*nr)
+        for (int i=0; i<cols; i+=2)
+          blocks (bufs[t], i * bx, (i+1 < cols? (i+1) * bx: -1), j * by);
+  }
+  void load (C* re, int x0, int y0) {
+    int w= min (bx, s1w - x0), h= min (by, s1h - y0);
+    for (int y=0; y<h; y++)
+      for (int x=0; x<w; x++)
+        re[y*tx->n + x]= src[(y0+y)*s1w + x0 + x];
+  }
+  void store (C* re, int x0, int y) {
+    int nx= tx->n, ow= min (nx, dw - x0);
+    C* o= dest + y*dw + x0;
+    for (int x=0; x<ow; x++) o[x] += re[x];
+  }
+  void blocks (C* re, int x0, int x1, int y0) {
+    // since the pen is real, the blocks at x0 and x1 are transformed
+    // together as the real and imaginary parts of a single signal
+    int nx= tx->n, ny= ty->n, n= nx * ny;
+    int h= min (by, s1h - y0), oh= min (ny, dh - y0);
+    C* im= re + n;
+    for (int i=0; i<n; i++) { clear (re[i]); clear (im[i]); }
+    load (re, x0, y0);
+    if (x1 >= 0) load (im, x1, y0);
+    for (int y=0; y<h; y++) fft (re + y*nx, im + y*nx, 1, *tx, false);
+    for (int x=0; x<nx; x++) fft (re + x, im + x, nx, *ty, false);
+    for (int i=0; i<n; i++) {
+      C r= re[i] * kre[i] - im[i] * kim[i];
+      im[i]= re[i] * kim[i] + im[i] * kre[i];
+      re[i]= r;
     }
+    for (int x=0; x<nx; x++) fft (re + x, im + x, nx, *ty, true);
+    for (int y=0; y<oh; y++) {
+      fft (re + y*nx, im + y*nx, 1, *tx, true);
+      store (re + y*nx, x0, y0 + y);
+      if (x1 >= 0) store (im + y*nx, x1, y0 + y);
+    }
+  }
+};
+
+template<typename C, typename S> raster<C>
+fft_convolute (raster<C> s1, raster<S> s2) {
+  // overlap-add convolution with transforms over blocks of the picture;
+  // blocks in even and odd rows are handled in two passes, since the
+  // results of blocks in consecutive rows overlap
+  if (s1->w * s1->h == 0) return s1;
+  ASSERT (s2->w * s2->h != 0, "empty convolution argument");
+  int s1w= s1->w, s1h= s1->h, s2w= s2->w, s2h= s2->h;
+  int dw= s1w + s2w - 1, dh= s1h + s2h - 1;
+  int nx= fft_size (s2w, s1w), ny= fft_size (s2h, s1h), n= nx * ny;
+  int bx= nx - s2w + 1, by= ny - s2h + 1;
+  fft_table tx (nx), ty (ny);
+  double* kre= tm_new_array<double> (n);
+  double* kim= tm_new_array<double> (n);
+  for (int i=0; i<n; i++) kre[i]= kim[i]= 0.0;
+  for (int y=0; y<s2h; y++)
+    for (int x=0; x<s2w; x++)
+      kre[y*nx + x]= ((double) s2->a[y*s2w + x]) / n;
+  for (int y=0; y<s2h; y++) fft (kre + y*nx, kim + y*nx, 1, tx, false);
+  for (int x=0; x<nx; x++) fft (kre + x, kim + x, nx, ty, false);
+
+  raster<C> d (dw, dh, s1->ox + s2->ox, s1->oy + s2->oy);
+  clear (d);
+  raster<C> temp= mul_alpha (s1);
+  int rows= (s1h + by - 1) / by, cols= (s1w + bx - 1) / bx;
+  int nr= raster_threads ((rows + 1) >> 1,
+                          rows * ((cols + 1) >> 1) * fft_work (nx, ny));
+  C** bufs= tm_new_array<C*> (nr);
+  for (int t=0; t<nr; t++) bufs[t]= tm_new_array<C> (2 * n);
+  fft_convolute_task<C> task= {
+    temp->a, d->a, s1w, s1h, dw, dh, kre, kim, &tx, &ty,
+    bx, by, nr, 0, bufs };
+  raster_task run= raster_run<fft_convolute_task<C> >;
+  for (task.parity= 0; task.parity < 2; task.parity++)
+    raster_parallel (run, (void*) &task, nr, nr);
+  for (int t=0; t<nr; t++) tm_delete_array (bufs[t]);
+  tm_delete_array (bufs);
+  tm_delete_array (kre);
+  tm_delete_array (kim);
   return div_alpha (d);
 }
 
+template<typename C, typename S> raster<C>
+convolute (raster<C> s1, raster<S> s2) {
+  if (s1->w * s1->h == 0) return s1;
+  ASSERT (s2->w * s2->h != 0, "empty convolution argument");
+  int s1w= s1->w, s1h= s1->h, s2w= s2->w, s2h= s2->h;
+  if (s2w * s2h < 64) return direct_convolute (s1, s2);
+  int nx= fft_size (s2w, s1w), ny= fft_size (s2h, s1h);
+  int bx= nx - s2w + 1, by= ny - s2h + 1;
+  double nr= ((s1w + 2*bx - 1) / (2*bx)) * ((s1h + by - 1) / by);
+  double direct= ((double) s1w * s1h) * s2w * s2h;
+  if (nr * fft_work (nx, ny) < direct) return fft_convolute (s1, s2);
+  return direct_convolute (s1, s2);
+}
+
 template<typename C> bool
 can_be_factored (raster<C> s) {
   raster<C> xs (s->w, 1, s->ox, 0);
   raster<C> ys (1, s->h, 0, s->oy);
   clear (xs);
   clear (ys);
+  double m= 0.0;
   for (int x=0; x<s->w; x++)
     for (int y=0; y<s->h; y++) {
       int o= y * s->w;
       xs->a[x] += s->a[o+x];
       ys->a[y] += s->a[o+x];
+      m= max (m, fabs (s->a[o+x]));
     }
+  // the tolerance is relative, since blur normalizes its pens
   for (int x=0; x<s->w; x++)
     for (int y=0; y<s->h; y++) {
       int o= y * s->w;
-      if (fabs (s->a[o+x] - xs->a[x] * ys->a[y]) > 0.005) return false;
+      if (fabs (s->a[o+x] - xs->a[x] * ys->a[y]) > 0.005 * m) return false;
     }
   return true;
 }
 
+template<typename C, typename S>
+struct factored_rows_task {
+  const C* src; const S* xs; C* aux;
+  int s1w, s2w, dw;
+  void run (int start, int end) {
+    for (int y1=start; y1<end; y1++) {
+      int o1= y1 * s1w, o= y1 * dw;
+      for (int x1=0; x1<s1w; x1++)
+        for (int x2=0; x2<s2w; x2++)
+          aux[o+x1+x2] += src[o1+x1] * xs[x2];
+    }
+  }
+};
+
+template<typename C, typename S>
+struct factored_columns_task {
+  const C* aux; const S* ys; C* dest;
+  int s1h, s2h, dw;
+  void run (int start, int end) {
+    for (int y=start; y<end; y++) {
+      int y1a= max (0, y - s2h + 1), y1b= min (s1h, y + 1);
+      for (int y1=y1a; y1<y1b; y1++) {
+        int o1= y1 * dw, o= y * dw;
+        for (int x1=0; x1<dw; x1++)
+          dest[o+x1] += aux[o1+x1] * ys[y - y1];
+      }
+    }
+  }
+};
+
 template<typename C, typename S> raster<C>
 factored_convolute (raster<C> s1, raster<S> s2) {
   if (s1->w * s1->h == 0) return s1;
@@ -780,20 +1014,12 @@ factored_convolute (raster<C> s1, raster<S> s2) {
   raster<C> temp= mul_alpha (s1);
   raster<C> aux (dw, s1h, s1->ox + s2->ox, s1->oy);
   clear (aux);
-  for (int y1=0; y1<s1h; y1++) {
-    int o1= y1 * s1w, o= y1 * dw;
-    for (int x1=0; x1<s1w; x1++)
-      for (int x2=0; x2<s2w; x2++)
-        aux->a[o+x1+x2] += temp->a[o1+x1] * xs->a[x2];
-  }
+  factored_rows_task<C,S> rows= { temp->a, xs->a, aux->a, s1w, s2w, dw };
+  raster_parallel (rows, s1h, ((double) s1w * s1h) * s2w);
   raster<C> d (dw, dh, s1->ox + s2->ox, s1->oy + s2->oy);
   clear (d);
-  for (int y1=0; y1<s1h; y1++)
-    for (int y2=0; y2<s2h; y2++) {
-      int o1= y1 * dw, o= (y1 + y2) * dw;
-      for (int x1=0; x1<dw; x1++)
-        d->a[o+x1] += aux->a[o1+x1] * ys->a[y2];
-    }
+  factored_columns_task<C,S> cols= { aux->a, ys->a, d->a, s1h, s2h, dw };
+  raster_parallel (cols, dh, ((double) dw * s1h) * s2h);
   return div_alpha (d);
 }
 
@@ -804,9 +1030,93 @@ blur (raster<C> ras, raster<double> pen) {
   else return convolute (ras, npen);
 }
 
+/******************************************************************************
+* Gaussian blur using cascades of box blurs
+******************************************************************************/
+
+#define BOX_PASSES     3 // number of successive box blurs
+#define BOX_MIN_RADIUS 4 // smaller gaussians are computed exactly
+
+inline void
+box_widths (double sigma, int* r) {
+  // radii of BOX_PASSES boxes whose cascade has variance sigma^2
+  int n= BOX_PASSES;
+  double ideal= sqrt ((12.0 * sigma * sigma / n) + 1.0);
+  int wl= (int) floor (ideal);
+  if ((wl & 1) == 0) wl--;
+  int wu= wl + 2;
+  double mi= (12.0 * sigma * sigma - n*wl*wl - 4.0*n*wl - 3.0*n) /
+             (-4.0*wl - 4.0);
+  int m= (int) floor (mi + 0.5);
+  for (int i=0; i<n; i++) r[i]= ((i < m? wl: wu) - 1) / 2;
+}
+
+template<typename C> inline void
+box_line (C* dest, const C* src, int n, int stride, int r) {
+  // dest[i] is the average of src[i-r..i+r], with zeros outside src
+  C sum;
+  clear (sum);
+  double f= 1.0 / (2*r + 1);
+  for (int i=0; i<r && i<n; i++) sum += src[i*stride];
+  for (int i=0; i<n; i++) {
+    if (i + r < n) sum += src[(i+r)*stride];
+    dest[i*stride]= f * sum;
+    if (i - r >= 0) sum -= src[(i-r)*stride];
+  }
+}
+
+template<typename C>
+struct box_blur_task {
+  C* a; C* b;
+  int len, step, stride;
+  int r[BOX_PASSES];
+  void run (int start, int end) {
+    for (int l=start; l<end; l++) {
+      C* x= a + l*step;
+      C* y= b + l*step;
+      box_line (y, x, len, stride, r[0]);
+      box_line (x, y, len, stride, r[1]);
+      box_line (y, x, len, stride, r[2]);
+    }
+  }
+};
+
+template<typename C> raster<C>
+box_blur (raster<C> s, double rx, double ry, int R) {
+  // approximate convolution with gaussian_pen (rx, ry, 0.0), on the same
+  // extents, by successive box blurs in both directions
+  if (s->w * s->h == 0) return s;
+  int sw= s->w, sh= s->h, dw= sw + 2*R, dh= sh + 2*R;
+  raster<C> temp= mul_alpha (s);
+  raster<C> a1 (dw, sh, s->ox + R, s->oy);
+  raster<C> b1 (dw, sh, s->ox + R, s->oy);
+  clear (a1);
+  for (int y=0; y<sh; y++)
+    for (int x=0; x<sw; x++)
+      a1->a[y*dw + R + x]= temp->a[y*sw + x];
+  box_blur_task<C> rows= { a1->a, b1->a, dw, dw, 1 };
+  box_widths (rx / sqrt (2.0), rows.r);
+  raster_parallel (rows, sh, 6.0 * dw * sh);
+  raster<C> a2 (dw, dh, s->ox + R, s->oy + R);
+  raster<C> b2 (dw, dh, s->ox + R, s->oy + R);
+  clear (a2);
+  for (int y=0; y<sh; y++)
+    for (int x=0; x<dw; x++)
+      a2->a[(y+R)*dw + x]= b1->a[y*dw + x];
+  box_blur_task<C> cols= { a2->a, b2->a, dh, 1, dw };
+  box_widths (ry / sqrt (2.0), cols.r);
+  raster_parallel (cols, dw, 6.0 * dw * dh);
+  return div_alpha (b2);
+}
+
 template<typename C> raster<C>
 gaussian_blur (raster<C> ras, double rx, double ry, double phi,
                double order= 2.5) {
+  if (min (rx, ry) >= BOX_MIN_RADIUS &&
+      (fabs (phi) <= 1.0e-6 || fabs (rx - ry) <= 1.0e-6)) {
+    int R= (int) ceil (max (rx * order, ry * order) - 0.5);
+    return box_blur (ras, rx, ry, R);
+  }
   return blur (ras, gaussian_pen<double> (rx, ry, phi, order));
 }
 
@@ -826,6 +1136,26 @@ src_over (C& a1, const C& a2) {
   //a1= max (a1, a2);
 }
 
+template<typename C, typename F, typename S>
+struct thicken_task {
+  const F* src; const S* pen; C* dest;
+  int s1w, s1h, s2w, s2h, dw;
+  void run (int start, int end) {
+    for (int y=start; y<end; y++) {
+      int y1a= max (0, y - s2h + 1), y1b= min (s1h, y + 1);
+      for (int y1=y1a; y1<y1b; y1++) {
+        int o1= y1 * s1w, o2= (y - y1) * s2w, o= y * dw;
+        for (int x1=0; x1<s1w; x1++) {
+          F t= src[o1+x1];
+          if (t == 0) continue;
+          for (int x2=0; x2<s2w; x2++)
+            src_over (get_alpha (dest[o+x1+x2]), t * pen[o2+x2]);
+        }
+      }
+    }
+  }
+};
+
 template<typename C, typename S> raster<C>
 thicken (raster<C> s1, raster<S> s2) {
   typedef typename C::scalar_type F;
@@ -835,14 +1165,8 @@ thicken (raster<C> s1, raster<S> s2) {
   int s1w= s1->w, s1h= s1->h, s2w= s2->w, s2h= s2->h, dw= d->w;
   raster<F> temp= get_alpha (s1);
   clear_alpha (d);
-  for (int y1=0; y1<s1h; y1++)
-    for (int y2=0; y2<s2h; y2++) {
-      int o1= y1 * s1w, o2= y2 * s2w, o= (y1 + y2) * dw;
-      for (int x1=0; x1<s1w; x1++)
-        for (int x2=0; x2<s2w; x2++)
-          src_over (get_alpha (d->a[o+x1+x2]),
-                    temp->a[o1+x1] * s2->a[o2+x2]);
-    }
+  thicken_task<C,F,S> task= { temp->a, s2->a, d->a, s1w, s1h, s2w, s2h, dw };
+  raster_parallel (task, d->h, ((double) s1w * s1h) * s2w * s2h);
   return d;
 }
 
@@ -869,6 +1193,30 @@ erode (C& dest_a, const C& src_a, const C& pen_a) {
   dest_a= min (dest_a, a);
 }
 
+template<typename C, typename F, typename S>
+struct erode_task {
+  const F* src; const S* pen; C* dest;
+  int s1w, s1h, s2w, s2h, s2ox, s2oy, dw;
+  void run (int start, int end) {
+    for (int yd=start; yd<end; yd++)
+      for (int y2=0; y2<s2h; y2++) {
+        int y1= yd + s2oy - y2;
+        if (y1 < 0 || y1 >= s1h) continue;
+        int o1= y1 * s1w, o2= y2 * s2w, o= yd * dw;
+        for (int x1=0; x1<s1w; x1++) {
+          // opaque pixels and empty parts of the pen do not erode
+          F t= src[o1+x1];
+          if (t == 1) continue;
+          for (int x2=0; x2<s2w; x2++) {
+            int xd= x1 + x2 - s2ox;
+            if (xd < 0 || xd >= s1w || pen[o2+x2] == 0) continue;
+            erode (get_alpha (dest[o+xd]), t, (F) pen[o2+x2]);
+          }
+        }
+      }
+  }
+};
+
 template<typename C, typename S> raster<C>
 erode (raster<C> s1, raster<S> s2) {
   typedef typename C::scalar_type F;
@@ -879,18 +1227,9 @@ erode (raster<C> s1, raster<S> s2) {
   raster<F> temp= get_alpha (s1);
   //for (int i=0; i<dw*dh; i++)
   //  get_alpha (d->a[i])= F (1.0);
-  for (int y1=0; y1<s1h; y1++)
-    for (int y2=0; y2<s2h; y2++) {
-      int yd= y1 + y2 - s2->oy;
-      if (yd < 0 || yd >= s1h) continue;
-      int o1= y1 * s1w, o2= y2 * s2w, o= yd * dw;
-      for (int x1=0; x1<s1w; x1++)
-        for (int x2=0; x2<s2w; x2++) {
-          int xd= x1 + x2 - s2->ox;
-          if (xd < 0 || xd >= s1w) continue;
-          erode (get_alpha (d->a[o+xd]), temp->a[o1+x1], s2->a[o2+x2]);
-        } 
-    }
+  erode_task<C,F,S> task= {
+    temp->a, s2->a, d->a, s1w, s1h, s2w, s2h, s2->ox, s2->oy, dw };
+  raster_parallel (task, s1h, ((double) s1w * s1h) * s2w * s2h);
   return d;
 }
 
@@ -898,6 +1237,30 @@ erode (raster<C> s1, raster<S> s2) {
 * Inner variation
 ******************************************************************************/
 
+template<typename C, typename F, typename S>
+struct variation_task {
+  raster_rep<F>* src; const S* pen; C* dest;
+  int s2w, s2h, s2ox, s2oy, dw;
+  void run (int start, int end) {
+    for (int y0=start; y0<end; y0++)
+      for (int x0=0; x0<dw; x0++) {
+        int x1= x0 - s2ox, y1= y0 - s2oy;
+        F ref= src->internal_get_pixel (x1, y1);
+        F min_v= 0, max_v= 0;
+        for (int y2=0; y2<s2h; y2++)
+          for (int x2=0; x2<s2w; x2++) {
+            S p= pen[y2*s2w + x2];
+            if (p == 0) continue;
+            F cur= src->internal_get_pixel (x1 - (x2 - s2ox), y1 - (y2 - s2oy));
+            F v= (cur - ref) * p;
+            max_v= max (max_v, v);
+            min_v= min (min_v, v);
+          }
+        get_alpha (dest[y0*dw + x0]) = max_v - min_v;
+      }
+  }
+};
+
 template<typename C, typename S> raster<C>
 variation (raster<C> s1, raster<S> s2) {
   typedef typename C::scalar_type F;
@@ -905,22 +1268,10 @@ variation (raster<C> s1, raster<S> s2) {
   ASSERT (s2->w * s2->h != 0, "empty pen");
   raster<C> d= convolute (s1, s2);
   int s2w= s2->w, s2h= s2->h, dw= d->w, dh= d->h;
-  int s2ox= s2->ox, s2oy= s2->oy;
   raster<F> temp= get_alpha (s1);
-  for (int y0=0; y0<dh; y0++)
-    for (int x0=0; x0<dw; x0++) {
-      int x1= x0 - s2ox, y1= y0 - s2oy;
-      F ref= temp->internal_get_pixel (x1, y1);
-      F min_v= 0, max_v= 0;
-      for (int y2=0; y2<s2h; y2++)
-        for (int x2=0; x2<s2w; x2++) {
-          F cur= temp->internal_get_pixel (x1 - (x2 - s2ox), y1 - (y2 - s2oy));
-          F v= (cur - ref) * s2->a[y2*s2w + x2];
-          max_v= max (max_v, v);
-          min_v= min (min_v, v);
-        }
-      get_alpha (d->a[y0*dw + x0]) = max_v - min_v;
-    }
+  variation_task<C,F,S> task= {
+    temp.operator-> (), s2->a, d->a, s2w, s2h, s2->ox, s2->oy, dw };
+  raster_parallel (task, dh, ((double) dw * dh) * s2w * s2h);
   return d;
 }
 
@@ -1095,6 +1446,15 @@ turbulence (raster<true_color> ras, long seed,
             double wavelen_x, double wavelen_y,
             int nNumOctaves, bool bFractalSum);
 
+/******************************************************************************
+* Conversions between true colors and packed colors
+******************************************************************************/
+
+class packed_color;
+
+raster<packed_color> as_packed (raster<true_color> r);
+raster<true_color> as_true_color (raster<packed_color> r);
+
 /******************************************************************************
 * Degrading
 ******************************************************************************/
@@ -208,4 +208,49 @@ typedef composition_op<compose_source_over> source_over_op;
 typedef composition_op<compose_towards_source> towards_source_op;
 typedef composition_op<compose_alpha_distance> alpha_distance_op;
 
+/******************************************************************************
+* Operations on rows of pixels
+******************************************************************************/
+
+template<typename Op, typename C, typename R> inline void
+map_row (R* d, const C* s, int n) {
+  for (int i=0; i<n; i++)
+    d[i]= Op::op (s[i]);
+}
+
+template<composition_mode M, typename C, typename S> inline void
+compose_row (C* d, const S* s, int n) {
+  for (int i=0; i<n; i++)
+    composition_op<M>::set_op (d[i], s[i]);
+}
+
+// Vectorized specializations for the most common pixels (raster_simd.cpp)
+class true_color;
+class packed_color;
+
+#define RASTER_MAP_ROW(Op,C) \
+  template<> void map_row<Op,C,C> (C* d, const C* s, int n);
+#define RASTER_COMPOSE_ROW(M,C) \
+  template<> void compose_row<M,C,C> (C* d, const C* s, int n);
+
+RASTER_MAP_ROW (mul_alpha_op, true_color)
+RASTER_MAP_ROW (div_alpha_op, true_color)
+RASTER_MAP_ROW (normalize_op, true_color)
+RASTER_COMPOSE_ROW (compose_source_over, true_color)
+RASTER_COMPOSE_ROW (compose_towards_source, true_color)
+RASTER_COMPOSE_ROW (compose_alpha_distance, true_color)
+RASTER_COMPOSE_ROW (compose_add, true_color)
+RASTER_COMPOSE_ROW (compose_sub, true_color)
+RASTER_COMPOSE_ROW (compose_mul, true_color)
+RASTER_COMPOSE_ROW (compose_min, true_color)
+RASTER_COMPOSE_ROW (compose_add, double)
+RASTER_COMPOSE_ROW (compose_sub, double)
+RASTER_COMPOSE_ROW (compose_mul, double)
+RASTER_COMPOSE_ROW (compose_min, double)
+RASTER_COMPOSE_ROW (compose_max, double)
+RASTER_COMPOSE_ROW (compose_source_over, packed_color)
+
+#undef RASTER_MAP_ROW
+#undef RASTER_COMPOSE_ROW
+
 #endif // RASTER_OPERATORS_H
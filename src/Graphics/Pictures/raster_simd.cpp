@@ -0,0 +1,432 @@
+/******************************************************************************
+* MODULE     : raster_simd.cpp
+* DESCRIPTION: Vectorized operations on rows of pixels
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "raster.hpp"
+#include "true_color.hpp"
+#include "packed_color.hpp"
+
+// The instruction set is chosen at compile time; without SSE2 or AVX,
+// the kernels below reduce to the scalar operators. The vectorized code
+// performs the same operations in the same order as the scalar code,
+// so that both give the same results.
+
+#if defined (__AVX__)
+#include <immintrin.h>
+#define RASTER_SIMD 4
+#elif defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define RASTER_SIMD 2
+#else
+#define RASTER_SIMD 1
+#endif
+
+static_assert (sizeof (true_color) == 4 * sizeof (double),
+               "true colors should be packed");
+static_assert (sizeof (packed_color) == 4,
+               "packed colors should take four bytes");
+
+/******************************************************************************
+* Vectors of doubles
+******************************************************************************/
+
+#if RASTER_SIMD == 4
+typedef __m256d vdouble;
+static inline vdouble v_set (double x) { return _mm256_set1_pd (x); }
+static inline vdouble v_load (const double* p) { return _mm256_loadu_pd (p); }
+static inline void v_store (double* p, vdouble x) { _mm256_storeu_pd (p, x); }
+static inline vdouble v_add (vdouble x, vdouble y) {
+  return _mm256_add_pd (x, y); }
+static inline vdouble v_sub (vdouble x, vdouble y) {
+  return _mm256_sub_pd (x, y); }
+static inline vdouble v_mul (vdouble x, vdouble y) {
+  return _mm256_mul_pd (x, y); }
+static inline vdouble v_div (vdouble x, vdouble y) {
+  return _mm256_div_pd (x, y); }
+static inline vdouble v_min (vdouble x, vdouble y) {
+  return _mm256_min_pd (x, y); }
+static inline vdouble v_max (vdouble x, vdouble y) {
+  return _mm256_max_pd (x, y); }
+static inline vdouble v_abs (vdouble x) {
+  return _mm256_andnot_pd (_mm256_set1_pd (-0.0), x); }
+static inline vdouble v_inside (vdouble x, vdouble lo, vdouble hi) {
+  return _mm256_and_pd (_mm256_cmp_pd (x, hi, _CMP_LT_OQ),
+                        _mm256_cmp_pd (x, lo, _CMP_GT_OQ)); }
+static inline vdouble v_select (vdouble m, vdouble x, vdouble y) {
+  return _mm256_blendv_pd (y, x, m); }
+
+#elif RASTER_SIMD == 2
+typedef __m128d vdouble;
+static inline vdouble v_set (double x) { return _mm_set1_pd (x); }
+static inline vdouble v_load (const double* p) { return _mm_loadu_pd (p); }
+static inline void v_store (double* p, vdouble x) { _mm_storeu_pd (p, x); }
+static inline vdouble v_add (vdouble x, vdouble y) {
+  return _mm_add_pd (x, y); }
+static inline vdouble v_sub (vdouble x, vdouble y) {
+  return _mm_sub_pd (x, y); }
+static inline vdouble v_mul (vdouble x, vdouble y) {
+  return _mm_mul_pd (x, y); }
+static inline vdouble v_div (vdouble x, vdouble y) {
+  return _mm_div_pd (x, y); }
+static inline vdouble v_min (vdouble x, vdouble y) {
+  return _mm_min_pd (x, y); }
+static inline vdouble v_max (vdouble x, vdouble y) {
+  return _mm_max_pd (x, y); }
+static inline vdouble v_abs (vdouble x) {
+  return _mm_andnot_pd (_mm_set1_pd (-0.0), x); }
+static inline vdouble v_inside (vdouble x, vdouble lo, vdouble hi) {
+  return _mm_and_pd (_mm_cmplt_pd (x, hi), _mm_cmpgt_pd (x, lo)); }
+static inline vdouble v_select (vdouble m, vdouble x, vdouble y) {
+  return _mm_or_pd (_mm_and_pd (m, x), _mm_andnot_pd (m, y)); }
+#endif
+
+/******************************************************************************
+* Vectors of true colors, with one vector for each channel
+******************************************************************************/
+
+#if RASTER_SIMD > 1
+struct vcolor {
+  vdouble b, g, r, a;
+};
+
+static inline void
+v_load (vcolor& c, const true_color* p) {
+  const double* q= (const double*) p;
+#if RASTER_SIMD == 4
+  vdouble x0= v_load (q), x1= v_load (q + 4);
+  vdouble x2= v_load (q + 8), x3= v_load (q + 12);
+  vdouble t0= _mm256_unpacklo_pd (x0, x1), t1= _mm256_unpackhi_pd (x0, x1);
+  vdouble t2= _mm256_unpacklo_pd (x2, x3), t3= _mm256_unpackhi_pd (x2, x3);
+  c.b= _mm256_permute2f128_pd (t0, t2, 0x20);
+  c.r= _mm256_permute2f128_pd (t0, t2, 0x31);
+  c.g= _mm256_permute2f128_pd (t1, t3, 0x20);
+  c.a= _mm256_permute2f128_pd (t1, t3, 0x31);
+#else
+  vdouble x0= v_load (q), y0= v_load (q + 2);
+  vdouble x1= v_load (q + 4), y1= v_load (q + 6);
+  c.b= _mm_unpacklo_pd (x0, x1);
+  c.g= _mm_unpackhi_pd (x0, x1);
+  c.r= _mm_unpacklo_pd (y0, y1);
+  c.a= _mm_unpackhi_pd (y0, y1);
+#endif
+}
+
+static inline void
+v_store (true_color* p, const vcolor& c) {
+  double* q= (double*) p;
+#if RASTER_SIMD == 4
+  vdouble t0= _mm256_permute2f128_pd (c.b, c.r, 0x20);
+  vdouble t2= _mm256_permute2f128_pd (c.b, c.r, 0x31);
+  vdouble t1= _mm256_permute2f128_pd (c.g, c.a, 0x20);
+  vdouble t3= _mm256_permute2f128_pd (c.g, c.a, 0x31);
+  v_store (q     , _mm256_unpacklo_pd (t0, t1));
+  v_store (q +  4, _mm256_unpackhi_pd (t0, t1));
+  v_store (q +  8, _mm256_unpacklo_pd (t2, t3));
+  v_store (q + 12, _mm256_unpackhi_pd (t2, t3));
+#else
+  v_store (q    , _mm_unpacklo_pd (c.b, c.g));
+  v_store (q + 2, _mm_unpacklo_pd (c.r, c.a));
+  v_store (q + 4, _mm_unpackhi_pd (c.b, c.g));
+  v_store (q + 6, _mm_unpackhi_pd (c.r, c.a));
+#endif
+}
+#endif
+
+/******************************************************************************
+* Operations which act in the same way on all channels
+******************************************************************************/
+
+struct lane_add {
+  static inline double op (double x, double y) { return x + y; }
+#if RASTER_SIMD > 1
+  static inline vdouble op (vdouble x, vdouble y) { return v_add (x, y); }
+#endif
+};
+
+struct lane_sub {
+  static inline double op (double x, double y) { return x - y; }
+#if RASTER_SIMD > 1
+  static inline vdouble op (vdouble x, vdouble y) { return v_sub (x, y); }
+#endif
+};
+
+struct lane_mul {
+  static inline double op (double x, double y) { return x * y; }
+#if RASTER_SIMD > 1
+  static inline vdouble op (vdouble x, vdouble y) { return v_mul (x, y); }
+#endif
+};
+
+struct lane_min {
+  static inline double op (double x, double y) { return min (x, y); }
+#if RASTER_SIMD > 1
+  static inline vdouble op (vdouble x, vdouble y) { return v_min (x, y); }
+#endif
+};
+
+struct lane_max {
+  static inline double op (double x, double y) { return max (x, y); }
+#if RASTER_SIMD > 1
+  static inline vdouble op (vdouble x, vdouble y) { return v_max (x, y); }
+#endif
+};
+
+struct lane_normalize {
+  static inline double op (double x) { return max (min (x, 1.0), 0.0); }
+#if RASTER_SIMD > 1
+  static inline vdouble op (vdouble x) {
+    return v_max (v_min (x, v_set (1.0)), v_set (0.0)); }
+#endif
+};
+
+template<typename Op> static inline void
+map_lanes (double* d, const double* s, int n) {
+  int i= 0;
+#if RASTER_SIMD > 1
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD)
+    v_store (d + i, Op::op (v_load (s + i)));
+#endif
+  for (; i<n; i++)
+    d[i]= Op::op (s[i]);
+}
+
+template<typename Op> static inline void
+compose_lanes (double* d, const double* s, int n) {
+  int i= 0;
+#if RASTER_SIMD > 1
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD)
+    v_store (d + i, Op::op (v_load (d + i), v_load (s + i)));
+#endif
+  for (; i<n; i++)
+    d[i]= Op::op (d[i], s[i]);
+}
+
+#define COMPOSE_LANES(M,C,Op,k) \
+  template<> void \
+  compose_row<M,C,C> (C* d, const C* s, int n) { \
+    compose_lanes<Op> ((double*) d, (const double*) s, k * n); }
+
+COMPOSE_LANES (compose_add, double, lane_add, 1)
+COMPOSE_LANES (compose_sub, double, lane_sub, 1)
+COMPOSE_LANES (compose_mul, double, lane_mul, 1)
+COMPOSE_LANES (compose_min, double, lane_min, 1)
+COMPOSE_LANES (compose_max, double, lane_max, 1)
+COMPOSE_LANES (compose_add, true_color, lane_add, 4)
+COMPOSE_LANES (compose_sub, true_color, lane_sub, 4)
+COMPOSE_LANES (compose_mul, true_color, lane_mul, 4)
+COMPOSE_LANES (compose_min, true_color, lane_min, 4)
+
+template<> void
+map_row<normalize_op,true_color,true_color>
+  (true_color* d, const true_color* s, int n)
+{
+  map_lanes<lane_normalize> ((double*) d, (const double*) s, 4 * n);
+}
+
+/******************************************************************************
+* Alpha channel operations on true colors
+******************************************************************************/
+
+template<> void
+map_row<mul_alpha_op,true_color,true_color>
+  (true_color* d, const true_color* s, int n)
+{
+  int i= 0;
+#if RASTER_SIMD > 1
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD) {
+    vcolor c;
+    v_load (c, s + i);
+    c.r= v_mul (c.r, c.a);
+    c.g= v_mul (c.g, c.a);
+    c.b= v_mul (c.b, c.a);
+    v_store (d + i, c);
+  }
+#endif
+  for (; i<n; i++)
+    d[i]= mul_alpha (s[i]);
+}
+
+template<> void
+map_row<div_alpha_op,true_color,true_color>
+  (true_color* d, const true_color* s, int n)
+{
+  int i= 0;
+#if RASTER_SIMD > 1
+  vdouble lo= v_set (-0.00390625), hi= v_set (0.00390625);
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD) {
+    vcolor c;
+    v_load (c, s + i);
+    vdouble m= v_inside (c.a, lo, hi);
+    c.r= v_select (m, c.r, v_div (c.r, c.a));
+    c.g= v_select (m, c.g, v_div (c.g, c.a));
+    c.b= v_select (m, c.b, v_div (c.b, c.a));
+    v_store (d + i, c);
+  }
+#endif
+  for (; i<n; i++)
+    d[i]= div_alpha (s[i]);
+}
+
+/******************************************************************************
+* Compositions of true colors
+******************************************************************************/
+
+template<> void
+compose_row<compose_source_over,true_color,true_color>
+  (true_color* d, const true_color* s, int n)
+{
+  int i= 0;
+#if RASTER_SIMD > 1
+  vdouble one= v_set (1.0), eps= v_set (1.0e-6);
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD) {
+    vcolor c1, c2;
+    v_load (c1, d + i);
+    v_load (c2, s + i);
+    vdouble a1= c1.a, a2= c2.a, t= v_sub (one, a2);
+    vdouble a = v_add (a2, v_mul (a1, t));
+    vdouble u = v_div (one, v_add (a, eps));
+    vdouble f1= v_mul (v_mul (a1, t), u), f2= v_mul (a2, u);
+    c1.r= v_add (v_mul (c1.r, f1), v_mul (c2.r, f2));
+    c1.g= v_add (v_mul (c1.g, f1), v_mul (c2.g, f2));
+    c1.b= v_add (v_mul (c1.b, f1), v_mul (c2.b, f2));
+    c1.a= a;
+    v_store (d + i, c1);
+  }
+#endif
+  for (; i<n; i++)
+    d[i]= source_over (d[i], s[i]);
+}
+
+template<> void
+compose_row<compose_towards_source,true_color,true_color>
+  (true_color* d, const true_color* s, int n)
+{
+  int i= 0;
+#if RASTER_SIMD > 1
+  vdouble one= v_set (1.0);
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD) {
+    vcolor c1, c2;
+    v_load (c1, d + i);
+    v_load (c2, s + i);
+    vdouble a2= c2.a, a1= v_sub (one, a2);
+    c1.r= v_add (v_mul (c1.r, a1), v_mul (c2.r, a2));
+    c1.g= v_add (v_mul (c1.g, a1), v_mul (c2.g, a2));
+    c1.b= v_add (v_mul (c1.b, a1), v_mul (c2.b, a2));
+    v_store (d + i, c1);
+  }
+#endif
+  for (; i<n; i++)
+    d[i]= towards_source (d[i], s[i]);
+}
+
+template<> void
+compose_row<compose_alpha_distance,true_color,true_color>
+  (true_color* d, const true_color* s, int n)
+{
+  int i= 0;
+#if RASTER_SIMD > 1
+  vdouble eps= v_set (1.0e-6);
+  for (; i + RASTER_SIMD <= n; i += RASTER_SIMD) {
+    vcolor c1, c2;
+    v_load (c1, d + i);
+    v_load (c2, s + i);
+    vdouble a1= c1.a, a2= c2.a;
+    vdouble t = v_add (v_add (a1, a2), eps);
+    vdouble f1= v_div (a1, t), f2= v_div (a2, t);
+    c1.r= v_add (v_mul (c1.r, f1), v_mul (c2.r, f2));
+    c1.g= v_add (v_mul (c1.g, f1), v_mul (c2.g, f2));
+    c1.b= v_add (v_mul (c1.b, f1), v_mul (c2.b, f2));
+    c1.a= v_abs (v_sub (a1, a2));
+    v_store (d + i, c1);
+  }
+#endif
+  for (; i<n; i++)
+    d[i]= alpha_distance (d[i], s[i]);
+}
+
+/******************************************************************************
+* Compositions of packed colors
+******************************************************************************/
+
+#if RASTER_SIMD > 1
+static inline void
+packed_load (__m128& b, __m128& g, __m128& r, __m128& a,
+             const packed_color* p) {
+  // four pixels, with one vector for each channel
+  __m128i z= _mm_setzero_si128 ();
+  __m128i x= _mm_loadu_si128 ((const __m128i*) p);
+  __m128i l= _mm_unpacklo_epi8 (x, z), h= _mm_unpackhi_epi8 (x, z);
+  b= _mm_cvtepi32_ps (_mm_unpacklo_epi16 (l, z));
+  g= _mm_cvtepi32_ps (_mm_unpackhi_epi16 (l, z));
+  r= _mm_cvtepi32_ps (_mm_unpacklo_epi16 (h, z));
+  a= _mm_cvtepi32_ps (_mm_unpackhi_epi16 (h, z));
+  _MM_TRANSPOSE4_PS (b, g, r, a);
+}
+
+static inline void
+packed_store (packed_color* p, __m128 b, __m128 g, __m128 r, __m128 a) {
+  _MM_TRANSPOSE4_PS (b, g, r, a);
+  __m128i l= _mm_packs_epi32 (_mm_cvttps_epi32 (b), _mm_cvttps_epi32 (g));
+  __m128i h= _mm_packs_epi32 (_mm_cvttps_epi32 (r), _mm_cvttps_epi32 (a));
+  _mm_storeu_si128 ((__m128i*) p, _mm_packus_epi16 (l, h));
+}
+#endif
+
+template<> void
+compose_row<compose_source_over,packed_color,packed_color>
+  (packed_color* d, const packed_color* s, int n)
+{
+  int i= 0;
+#if RASTER_SIMD > 1
+  __m128 one = _mm_set1_ps (1.0f), eps= _mm_set1_ps (1.0e-6f);
+  __m128 half= _mm_set1_ps (0.5f), full= _mm_set1_ps (255.0f);
+  __m128 inv = _mm_set1_ps (1.0f / 255.0f);
+  for (; i+4 <= n; i += 4) {
+    __m128 b1, g1, r1, a1, b2, g2, r2, a2;
+    packed_load (b1, g1, r1, a1, d + i);
+    packed_load (b2, g2, r2, a2, s + i);
+    a1= _mm_mul_ps (a1, inv);
+    a2= _mm_mul_ps (a2, inv);
+    __m128 t = _mm_sub_ps (one, a2);
+    __m128 a = _mm_add_ps (a2, _mm_mul_ps (a1, t));
+    __m128 u = _mm_div_ps (one, _mm_add_ps (a, eps));
+    __m128 f1= _mm_mul_ps (_mm_mul_ps (a1, t), u), f2= _mm_mul_ps (a2, u);
+    b1= _mm_add_ps (_mm_mul_ps (b1, f1), _mm_mul_ps (b2, f2));
+    g1= _mm_add_ps (_mm_mul_ps (g1, f1), _mm_mul_ps (g2, f2));
+    r1= _mm_add_ps (_mm_mul_ps (r1, f1), _mm_mul_ps (r2, f2));
+    a = _mm_mul_ps (a, full);
+    packed_store (d + i, _mm_add_ps (b1, half), _mm_add_ps (g1, half),
+                  _mm_add_ps (r1, half), _mm_add_ps (a, half));
+  }
+#endif
+  for (; i<n; i++)
+    d[i]= source_over (d[i], s[i]);
+}
+
+/******************************************************************************
+* Conversions between true colors and packed colors
+******************************************************************************/
+
+raster<packed_color>
+as_packed (raster<true_color> r) {
+  int w= r->w, h= r->h, n= w*h;
+  raster<packed_color> ret (w, h, r->ox, r->oy);
+  for (int i=0; i<n; i++)
+    ret->a[i]= packed_color (r->a[i]);
+  return ret;
+}
+
+raster<true_color>
+as_true_color (raster<packed_color> r) {
+  int w= r->w, h= r->h, n= w*h;
+  raster<true_color> ret (w, h, r->ox, r->oy);
+  for (int i=0; i<n; i++)
+    ret->a[i]= true_color ((color) r->a[i]);
+  return ret;
+}
@@ -169,20 +169,66 @@ void tm_sleep ();
 #endif
 #endif
 
+/******************************************************************************
+* reference counters
+******************************************************************************/
+
+// Structures whose reference counter exceeds IMMORTAL_COUNT are never
+// destroyed.  In the thread safe mode, their reference counters are not
+// even updated, so that they can be shared between threads at no cost.
+#define IMMORTAL_COUNT 0x40000000
+
+#ifdef ATOMIC_REFCOUNT
+#include <atomic>
+
+struct ref_counter {
+  std::atomic<int> n;
+  inline ref_counter (int i= 0): n (i) {}
+  inline ref_counter (const ref_counter& c): n ((int) c) {}
+  inline ref_counter& operator = (int i) {
+    n.store (i, std::memory_order_relaxed); return *this; }
+  inline operator int () const {
+    return n.load (std::memory_order_relaxed); }
+  inline int operator ++ () {
+    int i= n.load (std::memory_order_relaxed);
+    if (i >= IMMORTAL_COUNT) return i;
+    return n.fetch_add (1, std::memory_order_relaxed) + 1; }
+  inline int operator -- () {
+    int i= n.load (std::memory_order_relaxed);
+    if (i >= IMMORTAL_COUNT) return i;
+    i= n.fetch_sub (1, std::memory_order_release) - 1;
+    if (i == 0) std::atomic_thread_fence (std::memory_order_acquire);
+    return i; }
+  inline int operator ++ (int) { return (++(*this)) - 1; }
+  inline int operator -- (int) { return (--(*this)) + 1; }
+  inline ref_counter& operator += (int i) {
+    n.fetch_add (i, std::memory_order_acq_rel); return *this; }
+  inline ref_counter& operator -= (int i) {
+    n.fetch_sub (i, std::memory_order_acq_rel); return *this; }
+};
+#else
+typedef int ref_counter;
+#endif
+
+inline void make_immortal_count (ref_counter& c) {
+  if (c < IMMORTAL_COUNT) c += IMMORTAL_COUNT; }
+inline bool is_immortal_count (const ref_counter& c) {
+  return c >= IMMORTAL_COUNT; }
+
 /******************************************************************************
 * concrete and abstract base structures
 ******************************************************************************/
 
 extern int concrete_count;
 struct concrete_struct {
-  int ref_count;
+  ref_counter ref_count;
   inline concrete_struct (): ref_count (1) { TM_DEBUG(concrete_count++); }
   virtual inline ~concrete_struct () { TM_DEBUG(concrete_count--); }
 };
 
 extern int abstract_count;
 struct abstract_struct {
-  int ref_count;
+  ref_counter ref_count;
   inline abstract_struct (): ref_count (0) { TM_DEBUG(abstract_count++); }
   virtual inline ~abstract_struct () { TM_DEBUG(abstract_count--); }
 };
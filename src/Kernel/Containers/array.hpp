@@ -19,6 +19,8 @@ template<class T> class array;
 template<class T> int N (array<T> a);
 template<class T> T*  A (array<T> a);
 template<class T> array<T> copy (array<T> x);
+template<class T> void make_immortal (array<T> x);
+template<class T> bool is_immortal (array<T> x);
 
 template<class T> class array_rep: concrete_struct {
   int n;
@@ -33,6 +35,8 @@ public:
   friend int N LESSGTR (array<T> a);
   friend T*  A LESSGTR (array<T> a);
   friend array<T> copy LESSGTR (array<T> a);
+  friend void make_immortal LESSGTR (array<T> a);
+  friend bool is_immortal LESSGTR (array<T> a);
 };
 
 template<class T> class array {
@@ -53,6 +57,10 @@ TMPL inline int N (array<T> a) { return a->n; }
 TMPL inline T*  A (array<T> a) { return a->a; }
 TMPL inline array<T> copy (array<T> a) {
   return array<T> (a->a, a->n); }
+TMPL inline void make_immortal (array<T> a) {
+  make_immortal_count (a->ref_count); }
+TMPL inline bool is_immortal (array<T> a) {
+  return is_immortal_count (a->ref_count); }
 TMPL tm_ostream& operator << (tm_ostream& out, array<T> a);
 TMPL array<T>& operator << (array<T>& a, T x);
 TMPL array<T>& operator << (array<T>& a, array<T> b);
@@ -0,0 +1,291 @@
+/******************************************************************************
+* MODULE     : flat_hashmap.cpp
+* DESCRIPTION: open addressing hashmaps with reference counting
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef FLAT_HASHMAP_CC
+#define FLAT_HASHMAP_CC
+#include "flat_hashmap.hpp"
+#define TMPL template<class T, class U>
+#define H hashentry<T,U>
+
+#define FLAT_MIN_SLOTS 8
+#define FLAT_OVERLOADED(size,n) (5 * (size) > 4 * (n))
+
+/******************************************************************************
+* Low level routines on slots
+******************************************************************************/
+
+TMPL
+flat_hashmap_rep<T,U>::~flat_hashmap_rep () {
+  if (n == 0) return;
+  for (int i=0; i<n; i++)
+    if (dist[i] != 0) a[i].~H ();
+  fast_free ((void*) a, n * sizeof (H));
+  fast_free ((void*) dist, n * sizeof (int));
+}
+
+TMPL int
+flat_hashmap_rep<T,U>::find (int hv, const T& x) {
+  if (size == 0) return -1;
+  int i= slot (hv), d= 1;
+  while (dist[i] >= d) {
+    if (a[i].code == hv && a[i].key == x) return i;
+    i= (i+1) & (n-1); d++;
+  }
+  return -1;
+}
+
+TMPL int
+flat_hashmap_rep<T,U>::insert (int hv, const T& x) {
+  // x should not yet be present and there should be room left
+  int i= slot (hv), d= 1, pos= -1;
+  H cur (hv, x, init);
+  while (dist[i] != 0) {
+    if (dist[i] < d) {
+      // steal the slot from a richer entry and move on with the latter
+      H tmp= a[i]; a[i]= cur; cur= tmp;
+      int tmpd= dist[i]; dist[i]= d; d= tmpd;
+      if (pos < 0) pos= i;
+    }
+    i= (i+1) & (n-1); d++;
+  }
+  new ((void*) (a + i)) H (cur);
+  dist[i]= d;
+  size ++;
+  return pos < 0? i: pos;
+}
+
+TMPL void
+flat_hashmap_rep<T,U>::remove (int i) {
+  // shift the following entries of the cluster one slot backwards
+  int j= (i+1) & (n-1);
+  while (dist[j] > 1) {
+    a[i]= a[j];
+    dist[i]= dist[j] - 1;
+    i= j; j= (j+1) & (n-1);
+  }
+  a[i].~H ();
+  dist[i]= 0;
+  size --;
+}
+
+/******************************************************************************
+* Routines for flat hashmaps
+******************************************************************************/
+
+TMPL void
+flat_hashmap_rep<T,U>::resize (int n2) {
+  int i, oldn= n, newn= FLAT_MIN_SLOTS;
+  while (newn < n2 || FLAT_OVERLOADED (size, newn)) newn <<= 1;
+  if (newn == n) return;
+  int* oldd= dist;
+  H*   olda= a;
+  n= newn;
+  shift= 32;
+  for (i=n; i>1; i>>=1) shift--;
+  dist= (int*) fast_alloc (n * sizeof (int));
+  a   = (H*) fast_alloc (n * sizeof (H));
+  for (i=0; i<n; i++) dist[i]= 0;
+  size= 0;
+  for (i=0; i<oldn; i++)
+    if (oldd[i] != 0) {
+      H& e= olda[i];
+      a[insert (e.code, e.key)].im= e.im;
+      e.~H ();
+    }
+  if (oldn != 0) {
+    fast_free ((void*) olda, oldn * sizeof (H));
+    fast_free ((void*) oldd, oldn * sizeof (int));
+  }
+}
+
+TMPL bool
+flat_hashmap_rep<T,U>::contains (T x) {
+  return find (hash (x), x) >= 0;
+}
+
+TMPL bool
+flat_hashmap_rep<T,U>::empty () {
+  return size==0;
+}
+
+TMPL U&
+flat_hashmap_rep<T,U>::bracket_rw (T x) {
+  int hv= hash (x);
+  int i= find (hv, x);
+  if (i >= 0) return a[i].im;
+  if (n == 0 || FLAT_OVERLOADED (size + 1, n)) resize (n<<1);
+  return a[insert (hv, x)].im;
+}
+
+TMPL U
+flat_hashmap_rep<T,U>::bracket_ro (T x) {
+  int i= find (hash (x), x);
+  if (i >= 0) return a[i].im;
+  return init;
+}
+
+TMPL void
+flat_hashmap_rep<T,U>::reset (T x) {
+  int i= find (hash (x), x);
+  if (i < 0) return;
+  remove (i);
+  if (n > FLAT_MIN_SLOTS && (size << 3) < n) resize (n>>2);
+}
+
+TMPL void
+flat_hashmap_rep<T,U>::generate (void (*routine) (T)) {
+  int i;
+  for (i=0; i<n; i++)
+    if (dist[i] != 0) routine (a[i].key);
+}
+
+TMPL tm_ostream&
+operator << (tm_ostream& out, flat_hashmap<T,U> h) {
+  int i= 0, j= 0, n= h->n, size= h->size;
+  out << "{ ";
+  for (; i<n; i++)
+    if (h->dist[i] != 0) {
+      out << h->a[i];
+      if (j != size-1) out << ", ";
+      j++;
+    }
+  out << " }";
+  return out;
+}
+
+TMPL flat_hashmap<T,U>::operator tree () {
+  int i=0, j=0, n=rep->n, size=rep->size;
+  tree t (COLLECTION, size);
+  for (; i<n; i++)
+    if (rep->dist[i] != 0)
+      t[j++]= (tree) rep->a[i];
+  return t;
+}
+
+TMPL void
+flat_hashmap_rep<T,U>::join (flat_hashmap<T,U> h) {
+  int i= 0, n= h->n;
+  for (; i<n; i++)
+    if (h->dist[i] != 0)
+      bracket_rw (h->a[i].key)= copy (h->a[i].im);
+}
+
+TMPL bool
+operator == (flat_hashmap<T,U> h1, flat_hashmap<T,U> h2) {
+  if (h1->size != h2->size) return false;
+  int i= 0, n= h1->n;
+  for (; i<n; i++)
+    if (h1->dist[i] != 0)
+      if (h2[h1->a[i].key] != h1->a[i].im) return false;
+  return true;
+}
+
+TMPL bool
+operator != (flat_hashmap<T,U> h1, flat_hashmap<T,U> h2) {
+  return !(h1 == h2);
+}
+
+/******************************************************************************
+* Extra routines for flat_hashmap<string,tree>
+******************************************************************************/
+
+TMPL void
+flat_hashmap_rep<T,U>::write_back (T x, flat_hashmap<T,U> base) {
+  int hv= hash (x);
+  if (find (hv, x) >= 0) return;
+  if (n == 0 || FLAT_OVERLOADED (size + 1, n)) resize (n<<1);
+  int i= insert (hv, x);
+  int j= base->find (hv, x);
+  a[i].im= (j >= 0? base->a[j].im: base->init);
+}
+
+TMPL void
+flat_hashmap_rep<T,U>::pre_patch (flat_hashmap<T,U> patch,
+                                  flat_hashmap<T,U> base) {
+  int i= 0, n= patch->n;
+  for (; i<n; i++)
+    if (patch->dist[i] != 0) {
+      T x= patch->a[i].key;
+      U y= contains (x)? bracket_ro (x): patch->a[i].im;
+      if (base[x] == y) reset (x);
+      else bracket_rw (x)= y;
+    }
+}
+
+TMPL void
+flat_hashmap_rep<T,U>::post_patch (flat_hashmap<T,U> patch,
+                                   flat_hashmap<T,U> base) {
+  int i= 0, n= patch->n;
+  for (; i<n; i++)
+    if (patch->dist[i] != 0) {
+      T x= patch->a[i].key;
+      U y= patch->a[i].im;
+      if (base[x] == y) reset (x);
+      else bracket_rw (x)= y;
+    }
+}
+
+TMPL flat_hashmap<T,U>
+copy (flat_hashmap<T,U> h) {
+  int i, n= h->n;
+  flat_hashmap<T,U> h2 (h->init);
+  if (n == 0) return h2;
+  h2->n= n;
+  h2->shift= h->shift;
+  h2->size= h->size;
+  h2->dist= (int*) fast_alloc (n * sizeof (int));
+  h2->a   = (H*) fast_alloc (n * sizeof (H));
+  for (i=0; i<n; i++) {
+    h2->dist[i]= h->dist[i];
+    if (h->dist[i] != 0) new ((void*) (h2->a + i)) H (h->a[i]);
+  }
+  return h2;
+}
+
+TMPL flat_hashmap<T,U>
+changes (flat_hashmap<T,U> patch, flat_hashmap<T,U> base) {
+  int i;
+  flat_hashmap<T,U> h (base->init);
+  for (i=0; i<patch->n; i++)
+    if (patch->dist[i] != 0) {
+      H& e= patch->a[i];
+      if (e.im != base [e.key])
+        h (e.key)= e.im;
+    }
+  return h;
+}
+
+TMPL flat_hashmap<T,U>
+invert (flat_hashmap<T,U> patch, flat_hashmap<T,U> base) {
+  int i;
+  flat_hashmap<T,U> h (base->init);
+  for (i=0; i<patch->n; i++)
+    if (patch->dist[i] != 0) {
+      H& e= patch->a[i];
+      if (e.im != base [e.key])
+        h (e.key)= base [e.key];
+    }
+  return h;
+}
+
+TMPL flat_hashmap<T,U>::flat_hashmap (U init, tree t):
+  rep (tm_new<flat_hashmap_rep<T,U> > (init, 1))
+{
+  int i, n= arity (t);
+  for (i=0; i<n; i++)
+    if (is_func (t[i], ASSOCIATE, 2))
+      rep->bracket_rw (get_label (t[i][0]))= copy (t[i][1]);
+}
+
+#undef FLAT_OVERLOADED
+#undef FLAT_MIN_SLOTS
+#undef H
+#undef TMPL
+#endif // defined FLAT_HASHMAP_CC
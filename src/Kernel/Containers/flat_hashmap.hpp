@@ -0,0 +1,104 @@
+/******************************************************************************
+* MODULE     : flat_hashmap.hpp
+* DESCRIPTION: open addressing hashmaps with reference counting
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef FLAT_HASHMAP_H
+#define FLAT_HASHMAP_H
+#include "hashmap.hpp"
+#include <new>
+
+/******************************************************************************
+* A flat_hashmap<T,U> offers the same interface as hashmap<T,U>, but stores
+* its entries inline in a single array using Robin Hood linear probing.
+* Lookups therefore touch one or two cache lines instead of chasing list
+* nodes. Contrary to hashmap<T,U>, references returned by operator () are
+* invalidated by subsequent insertions or removals, and the map should not
+* be modified while it is being iterated over.
+******************************************************************************/
+
+template<class T,class U> class flat_hashmap;
+template<class T,class U> class flat_hashmap_iterator_rep;
+
+template<class T,class U> int N (flat_hashmap<T,U> a);
+template<class T,class U> tm_ostream& operator << (tm_ostream& out, flat_hashmap<T,U> h);
+template<class T,class U> flat_hashmap<T,U> copy (flat_hashmap<T,U> h);
+template<class T,class U> flat_hashmap<T,U> changes (flat_hashmap<T,U> p, flat_hashmap<T,U> b);
+template<class T,class U> flat_hashmap<T,U> invert (flat_hashmap<T,U> p, flat_hashmap<T,U> b);
+template<class T,class U> bool operator == (flat_hashmap<T,U> h1, flat_hashmap<T,U> h2);
+template<class T,class U> bool operator != (flat_hashmap<T,U> h1, flat_hashmap<T,U> h2);
+
+template<class T, class U> class flat_hashmap_rep: concrete_struct {
+  int size;                  // size of hashmap (nr of entries)
+  int n;                     // nr of slots (zero or a power of two)
+  int shift;                 // 32 - log2 (n)
+  U   init;                  // default entry
+  int* dist;                 // probe distance plus one, or zero if empty
+  hashentry<T,U>* a;         // the slots, only constructed if occupied
+
+  inline int slot (int hv) {
+    return (int) ((((unsigned int) hv) * 2654435769U) >> shift); }
+  int  find (int hv, const T& x);
+  int  insert (int hv, const T& x);
+  void remove (int i);
+
+public:
+  inline flat_hashmap_rep<T,U> (U init2, int n2=1):
+    size (0), n (0), shift (32), init (init2), dist (NULL), a (NULL) {
+      if (n2 > 1) resize (n2); }
+  ~flat_hashmap_rep<T,U> ();
+  void resize (int n);
+  void reset (T x);
+  void generate (void (*routine) (T));
+  bool contains (T x);
+  bool empty ();
+  U    bracket_ro (T x);
+  U&   bracket_rw (T x);
+  void join (flat_hashmap<T,U> H);
+
+  friend class flat_hashmap<T,U>;
+  friend class flat_hashmap_iterator_rep<T,U>;
+  friend int N LESSGTR (flat_hashmap<T,U> h);
+  friend tm_ostream& operator << LESSGTR (tm_ostream& out, flat_hashmap<T,U> h);
+
+  // only for flat_hashmap<string,tree>
+  void write_back (T x, flat_hashmap<T,U> base);
+  void pre_patch (flat_hashmap<T,U> patch, flat_hashmap<T,U> base);
+  void post_patch (flat_hashmap<T,U> patch, flat_hashmap<T,U> base);
+  friend flat_hashmap<T,U> copy LESSGTR (flat_hashmap<T,U> h);
+  friend flat_hashmap<T,U> changes LESSGTR (flat_hashmap<T,U> patch, flat_hashmap<T,U> base);
+  friend flat_hashmap<T,U> invert LESSGTR (flat_hashmap<T,U> patch, flat_hashmap<T,U> base);
+  // end only for flat_hashmap<string,tree>
+
+  friend bool operator == LESSGTR (flat_hashmap<T,U> h1, flat_hashmap<T,U> h2);
+  friend bool operator != LESSGTR (flat_hashmap<T,U> h1, flat_hashmap<T,U> h2);
+};
+
+template<class T, class U> class flat_hashmap {
+CONCRETE_TEMPLATE_2(flat_hashmap,T,U);
+  inline flat_hashmap ():
+    rep (tm_new<flat_hashmap_rep<T,U> > (type_helper<U>::init_val (), 1)) {}
+  // the maximal bucket length is ignored, but accepted for compatibility
+  inline flat_hashmap (U init, int n=1, int max=1):
+    rep (tm_new<flat_hashmap_rep<T,U> > (init, n * max)) {}
+  // only for flat_hashmap<string,tree>
+  flat_hashmap (U init, tree t);
+  // end only for flat_hashmap<string,tree>
+  inline U  operator [] (T x) { return rep->bracket_ro (x); }
+  inline U& operator () (T x) { return rep->bracket_rw (x); }
+  operator tree ();
+};
+CONCRETE_TEMPLATE_2_CODE(flat_hashmap,class,T,class,U);
+
+#define TMPL template<class T, class U>
+TMPL inline int N (flat_hashmap<T,U> h) { return h->size; }
+#undef TMPL
+
+#include "flat_hashmap.cpp"
+
+#endif // defined FLAT_HASHMAP_H
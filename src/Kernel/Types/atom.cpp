@@ -0,0 +1,38 @@
+/******************************************************************************
+* MODULE     : atom.cpp
+* DESCRIPTION: tables of interned strings with dense integer codes
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "atom.hpp"
+
+atom_table::atom_table (int first, string undef):
+  names (), codes (-1), next (first), undefined (undef) {}
+
+void
+atom_table::set (int code, string s) {
+  ASSERT (code >= 0, "invalid atom code");
+  int i, n= N(names);
+  if (code >= n) {
+    names->resize (code + 1);
+    for (i=n; i<code; i++) names[i]= undefined;
+  }
+  (void) hash (s);
+  make_immortal (s);
+  names[code]= s;
+  codes (s)= code;
+  if (code >= next) next= code + 1;
+}
+
+int
+atom_table::make (string s) {
+  int code= codes[s];
+  if (code >= 0) return code;
+  code= next;
+  set (code, s);
+  return code;
+}
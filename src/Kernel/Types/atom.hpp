@@ -0,0 +1,43 @@
+/******************************************************************************
+* MODULE     : atom.hpp
+* DESCRIPTION: tables of interned strings with dense integer codes
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef ATOM_H
+#define ATOM_H
+#include "array.hpp"
+#include "flat_hashmap.hpp"
+
+/******************************************************************************
+* An atom table associates dense integer codes to strings and vice versa.
+* Conversion from codes to strings is an array access. The interned strings
+* are made immortal and their hash codes are computed when they are entered,
+* so that conversion from strings to codes costs a single probe into a flat
+* hashmap when the same string handles are used over and over again.
+******************************************************************************/
+
+class atom_table {
+  array<string> names;            // the string associated to each code
+  flat_hashmap<string,int> codes; // the code associated to each string
+  int next;                       // first code for new atoms
+  string undefined;               // name of codes without a string
+
+public:
+  atom_table (int first= 0, string undef= "?");
+  void set (int code, string s);
+  int  make (string s);
+  inline int find (string s) { return codes[s]; }
+  inline bool contains (string s) { return codes->contains (s); }
+  inline string operator [] (int code) {
+    return (code >= 0 && code < N(names))? names[code]: undefined; }
+  friend int N (atom_table& t);
+};
+
+inline int N (atom_table& t) { return N(t.codes); }
+
+#endif // defined ATOM_H
@@ -28,24 +28,29 @@ round_length (int n) {
   return i;
 }
 
+static inline int
+round_alloc (int n) {
+  // size of the allocated storage, or zero for inline storage
+  return n <= STRING_INLINE? 0: round_length (n);
+}
+
 string_rep::string_rep (int n2):
-  n(n2), a ((n==0)?((char*) NULL):tm_new_array<char> (round_length(n))) {}
+  n(n2), a ((n<=STRING_INLINE)? buf: tm_new_array<char> (round_length(n))),
+  h(0) {}
 
 void
 string_rep::resize (int m) {
-  int nn= round_length (n);
-  int mm= round_length (m);
+  int nn= round_alloc (n);
+  int mm= round_alloc (m);
   if (mm != nn) {
-    if (mm != 0) {
-      int i, k= (m<n? m: n);
-      char* b= tm_new_array<char> (mm);
-      for (i=0; i<k; i++) b[i]= a[i];
-      if (nn != 0) tm_delete_array (a);
-      a= b;
-    }
-    else if (nn != 0) tm_delete_array (a);
+    int i, k= (m<n? m: n);
+    char* b= (mm == 0? buf: tm_new_array<char> (mm));
+    for (i=0; i<k; i++) b[i]= a[i];
+    if (nn != 0) tm_delete_array (a);
+    a= b;
   }
   n= m;
+  h= 0;
 }
 
 string::string (char c) {
@@ -102,7 +107,9 @@ string::operator != (const char* s) {
 bool
 string::operator == (string a) {
   int i;
+  if (rep == a.rep) return true;
   if (rep->n!=a->n) return false;
+  if (rep->h != 0 && a->h != 0 && rep->h != a->h) return false;
   for (i=0; i<rep->n; i++)
     if (rep->a[i]!=a->a[i]) return false;
   return true;
@@ -111,7 +118,9 @@ string::operator == (string a) {
 bool
 string::operator != (string a) {
   int i;
+  if (rep == a.rep) return false;
   if (rep->n!=a->n) return true;
+  if (rep->h != 0 && a->h != 0 && rep->h != a->h) return true;
   for (i=0; i<rep->n; i++)
     if (rep->a[i]!=a->a[i]) return true;
   return false;
@@ -130,7 +139,7 @@ string::operator () (int begin, int end) {
 }
 
 string
-copy (string s) {
+copy (const string s) {
   int i, n=N(s);
   string r (n);
   for (i=0; i<n; i++) r[i]=s[i];
@@ -145,7 +154,7 @@ operator << (string& a, char x) {
 }
 
 string&
-operator << (string& a, string b) {
+operator << (string& a, const string b) {
   int i, k1= N(a), k2=N(b);
   a->resize (k1+k2);
   for (i=0; i<k2; i++) a[i+k1]= b[i];
@@ -153,7 +162,7 @@ operator << (string& a, string b) {
 }
 
 string
-operator * (string a, string b) {
+operator * (const string a, const string b) {
   int i, n1=N(a), n2=N(b);
   string c(n1+n2);
   for (i=0; i<n1; i++) c[i]=a[i];
@@ -172,7 +181,7 @@ operator * (string a, const char* b) {
 }
 
 bool
-operator < (string s1, string s2) {
+operator < (const string s1, const string s2) {
   int i;
   for (i=0; i<N(s1); i++) {
     if (i>=N(s2)) return false;
@@ -183,7 +192,7 @@ operator < (string s1, string s2) {
 }
 
 bool
-operator <= (string s1, string s2) {
+operator <= (const string s1, const string s2) {
   int i;
   for (i=0; i<N(s1); i++) {
     if (i>=N(s2)) return false;
@@ -195,19 +204,23 @@ operator <= (string s1, string s2) {
 
 tm_ostream&
 operator << (tm_ostream& out, string a) {
-  int i, n=N(a);
+  // only file streams keep null characters, as for binary caches
+  int n=N(a);
   if (n==0) return out;
-  for (i=0; i<n; i++) out << a[i];
+  out->write (a->a, n);
   return out;
 }
 
 int
 hash (string s) {
-  int i, h=0, n=N(s);
+  if (s->h != 0) return s->h;
+  int i, h=0, n=s->n;
+  char* a= s->a;
   for (i=0; i<n; i++) {
     h=(h<<9)+(h>>23);
-    h=h+((int) s[i]);
+    h=h+((int) a[i]);
   }
+  s->h= h;
   return h;
 }
 
@@ -221,7 +234,7 @@ as_bool (string s) {
 }
 
 int
-as_int (string s) {
+as_int (const string s) {
   int i=0, n=N(s), val=0;
   if (n==0) return 0;
   if (s[0]=='-') i++;
@@ -238,7 +251,7 @@ as_int (string s) {
 
 
 long int
-as_long_int (string s) {
+as_long_int (const string s) {
   int i=0, n=N(s);
   long int val=0;
   if (n==0) return 0;
@@ -255,7 +268,7 @@ as_long_int (string s) {
 }
 
 double
-as_double (string s) {
+as_double (const string s) {
   double x= 0.0;
   {
     int i, n= N(s);
@@ -269,7 +282,7 @@ as_double (string s) {
 }
 
 char*
-as_charp (string s) {
+as_charp (const string s) {
   int i, n= N(s);
   char *s2= tm_new_array<char> (n+1);
   for (i=0; i<n; i++) s2[i]=s[i];
@@ -351,7 +364,7 @@ is_bool (string s) {
 }
 
 bool
-is_int (string s) {
+is_int (const string s) {
   int i=0, n=N(s);
   if (n==0) return false;
   if (s[i]=='+') i++;
@@ -363,7 +376,7 @@ is_int (string s) {
 }
 
 bool
-is_double (string s) {
+is_double (const string s) {
   int i=0, n=N(s);
   if (n==0) return false;
   if (s[i]=='+') i++;
@@ -394,13 +407,13 @@ is_charp (string s) { (void) s;
 }
 
 bool
-is_quoted (string s) {
+is_quoted (const string s) {
   int n=N(s);
   return (n>=2) && (s[0]=='\"') && (s[n-1]=='\"');
 }
 
 bool
-is_id (string s) {
+is_id (const string s) {
   int i=0, n=N(s);
   if (n==0) return false;
   for (i=0; i< n; i++) {
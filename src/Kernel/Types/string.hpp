@@ -14,19 +14,57 @@
 #define STRING_H
 #include "basic.hpp"
 
+#define STRING_INLINE 12
+
 class string;
 class string_rep: concrete_struct {
-  int n;
-  char* a;
+  int n;                      // length
+  char* a;                    // the characters, in buf for short strings
+  int h;                      // cached hash code or zero if not computed
+  char buf[STRING_INLINE];    // inline storage for short strings
 
 public:
-  inline string_rep (): n(0), a(NULL) {}
+  inline string_rep (): n(0), a(buf), h(0) {}
          string_rep (int n);
-  inline ~string_rep () { if (n!=0) tm_delete_array (a); }
+  inline ~string_rep () { if (a != buf) tm_delete_array (a); }
   void resize (int n);
 
   friend class string;
+  friend class string_char;
   friend inline int N (string a);
+  friend int hash (string s);
+  friend tm_ostream& operator << (tm_ostream& out, string a);
+  friend inline void make_immortal (string s);
+  friend inline bool is_immortal (string s);
+};
+
+class string_char {
+  // writable reference to a character of a string, which invalidates
+  // the cached hash code of the string whenever the character is modified
+  string_rep* rep;
+  int i;
+public:
+  inline string_char (string_rep* rep2, int i2): rep (rep2), i (i2) {}
+  inline operator char () const { return rep->a[i]; }
+  inline string_char& operator = (char c) {
+    rep->h= 0; rep->a[i]= c; return *this; }
+  inline string_char& operator = (const string_char& c) {
+    return *this= (char) c; }
+  inline string_char& operator += (int d) {
+    rep->h= 0; rep->a[i] += d; return *this; }
+  inline string_char& operator -= (int d) {
+    rep->h= 0; rep->a[i] -= d; return *this; }
+  inline string_char& operator |= (int d) {
+    rep->h= 0; rep->a[i] |= d; return *this; }
+  inline string_char& operator &= (int d) {
+    rep->h= 0; rep->a[i] &= d; return *this; }
+  inline string_char& operator ++ () { return *this += 1; }
+  inline string_char& operator -- () { return *this -= 1; }
+  inline char operator ++ (int) { char c= rep->a[i]; *this += 1; return c; }
+  inline char operator -- (int) { char c= rep->a[i]; *this -= 1; return c; }
+  inline char* operator & () {
+    // the characters may be written through the pointer at any time
+    rep->h= 0; return rep->a + i; }
 };
 
 class string {
@@ -37,7 +75,8 @@ class string {
   string (char c, int n);
   string (const char *s);
   string (const char *s, int n);
-  inline char& operator [] (int i) { return rep->a[i]; }
+  inline char operator [] (int i) const { return rep->a[i]; }
+  inline string_char operator [] (int i) { return string_char (rep, i); }
   bool operator == (const char* s);
   bool operator != (const char* s);
   bool operator == (string s);
@@ -47,6 +86,8 @@ class string {
 CONCRETE_CODE(string);
 
 extern inline int N (string a) { return a->n; }
+inline void make_immortal (string s) { make_immortal_count (s->ref_count); }
+inline bool is_immortal (string s) { return is_immortal_count (s->ref_count); }
 string   copy (string a);
 tm_ostream& operator << (tm_ostream& out, string a);
 string&  operator << (string& a, char);
@@ -154,6 +154,28 @@ freeze (tree t) {
   }
 }
 
+void
+make_immortal (tree t) {
+  // trees such as style constants which are never destroyed
+  // and which can be shared between threads without reference counting;
+  // immortal subtrees were already handled, which avoids exponential
+  // running times on trees with many shared subtrees
+  if (is_immortal_count (t.rep->ref_count)) return;
+  make_immortal_count (t.rep->ref_count);
+  if (is_atomic (t)) make_immortal (t->label);
+  else {
+    int i, n= N(t);
+    make_immortal (A(t));
+    for (i=0; i<n; i++)
+      make_immortal (t[i]);
+  }
+}
+
+bool
+is_immortal (tree t) {
+  return is_immortal_count (t.rep->ref_count);
+}
+
 tree
 operator * (tree t1, tree t2) {
   int i;
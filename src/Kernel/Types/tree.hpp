@@ -78,6 +78,8 @@ public:
 
   friend tree copy (tree t);
   friend tree freeze (tree t);
+  friend void make_immortal (tree t);
+  friend bool is_immortal (tree t);
   friend bool operator == (tree t, tree u);
   friend bool operator != (tree t, tree u);
   friend tree& operator << (tree& t, tree t2);
@@ -105,6 +107,8 @@ public:
   observer obs;
   inline tree_rep (tree_label op2): op (op2) {}
   friend class tree;
+  friend void make_immortal (tree t);
+  friend bool is_immortal (tree t);
 };
 
 class atomic_rep: public tree_rep {
@@ -10,31 +10,22 @@
 ******************************************************************************/
 
 #include "tree_label.hpp"
-#include "hashmap.hpp"
+#include "atom.hpp"
 
-hashmap<int,string> CONSTRUCTOR_NAME ("?");
-hashmap<string,int> CONSTRUCTOR_CODE (UNKNOWN);
+static atom_table CONSTRUCTOR (START_EXTENSIONS, "?");
 
 /******************************************************************************
 * Setting up the conversion tables
 ******************************************************************************/
 
-static tree_label next_tree_label= START_EXTENSIONS;
-
 void
 make_tree_label (tree_label l, string s) {
-  CONSTRUCTOR_NAME ((int) l) = s;
-  CONSTRUCTOR_CODE (s)       = (int) l;
+  CONSTRUCTOR.set ((int) l, s);
 }
 
 tree_label
 make_tree_label (string s) {
-  if (CONSTRUCTOR_CODE->contains (s))
-    return (tree_label) CONSTRUCTOR_CODE[s];
-  tree_label l= next_tree_label;
-  next_tree_label= (tree_label) (((int) next_tree_label) + 1);
-  make_tree_label (l, s);
-  return l;
+  return (tree_label) CONSTRUCTOR.make (s);
 }
 
 /******************************************************************************
@@ -43,15 +34,22 @@ make_tree_label (string s) {
 
 string
 as_string (tree_label l) {
-  return CONSTRUCTOR_NAME[(int) l];
+  return CONSTRUCTOR[(int) l];
 }
 
 tree_label
 as_tree_label (string s) {
-  return (tree_label) CONSTRUCTOR_CODE[s];
+  int code= CONSTRUCTOR.find (s);
+  return code < 0? UNKNOWN: (tree_label) code;
+}
+
+tree_label
+as_tree_label (string s, tree_label undef) {
+  int code= CONSTRUCTOR.find (s);
+  return code < 0? undef: (tree_label) code;
 }
 
 bool
 existing_tree_label (string s) {
-  return CONSTRUCTOR_CODE->contains (s);
+  return CONSTRUCTOR.contains (s);
 }
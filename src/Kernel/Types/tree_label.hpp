@@ -161,6 +161,7 @@ void make_tree_label (tree_label l, string s);
 tree_label make_tree_label (string s); // for extensions
 string as_string (tree_label l);
 tree_label as_tree_label (string s);
+tree_label as_tree_label (string s, tree_label undef);
 bool existing_tree_label (string s);
 
 
@@ -177,26 +177,20 @@ pk_loader::realfunc () {
 struct char_bitstream {
   glyph& gl;
   int x, y;
-  QN* pos;
-  int bit;
 
   char_bitstream (glyph& gl2):
-    gl (gl2), x(0), y(0), pos (gl->raster), bit (0) {}
+    gl (gl2), x(0), y(0) {}
   void write (int num, int times=1, int repeat=0) {
     int i, j;
     for (i=0; i<times; i++) {
-      (*pos) += (num<<bit);
-      bit= (bit+1)&7;
-      if (bit==0) pos++;
+      if (num != 0 && y < gl->height) gl->set_1 (x, y, 1);
       x++;
       if (x==gl->width) {
 	x=0; y++;
 	while (repeat>0) {
-	  for (j=0; j<gl->width; j++) {
-	    (*pos) += ((gl->get_1 (j, y-1))<<bit);
-	    bit= (bit+1)&7;
-	    if (bit==0) pos++;
-	  }
+	  if (y < gl->height)
+	    for (j=0; j<gl->words; j++)
+	      gl->row_1 (y) [j]= gl->row_1 (y-1) [j];
 	  y++;
 	  repeat--;
 	}
@@ -504,7 +504,7 @@ tex_font_rep::accented_get_extents (string s, metric& ex) {
       char c= acc[i];
       metric ey, ez;
       get_extents (s(0,i+1), ey); xx= ey->x2;
-      get_extents (s[i], ey);
+      get_extents (s (i, i+1), ey);
       get_extents (c, ez);
       xx -= (((ey->x2 - ey->x1) + (ez->x2 - ez->x1)) >> 1);
       yy  = ey->y2- yx;
@@ -551,7 +551,7 @@ tex_font_rep::accented_draw (renderer ren, string s, SI x, SI y) {
       char c= acc[i];
       metric ey, ez;
       get_extents (s(0,i+1), ey); xx= ey->x2;
-      get_extents (s[i], ey);
+      get_extents (s (i, i+1), ey);
       get_extents (c, ez);
       xx -= (((ey->x2 - ey->x1) + (ez->x2 - ez->x1)) >> 1);
       yy  = ey->y2- yx;
@@ -10,9 +10,36 @@
 ******************************************************************************/
 
 #include "basic_environment.hpp"
+#include "atom.hpp"
 
 tree hash_node::uninit (UNINIT);
 tree basic_environment_rep::uninit (UNINIT);
+DI   basic_environment_rep::last_stamp= 0;
+
+/******************************************************************************
+* String keys
+******************************************************************************/
+
+static atom_table&
+env_keys () {
+  static atom_table keys (0, "?");
+  return keys;
+}
+
+int
+make_env_key (const string& s) {
+  return env_keys ().make (s);
+}
+
+int
+find_env_key (const string& s) {
+  return env_keys ().find (s);
+}
+
+string
+env_key_name (int key) {
+  return env_keys () [key];
+}
 
 /******************************************************************************
 * Raw access methods which assume an appropriate size for the hash table
@@ -28,6 +55,8 @@ basic_environment_rep::raw_insert (int key, const tree& val) {
   a[f].next = a[h].start;
   a[h].start= f;
   size++;
+  hv ^= weak_node_hash (key, val);
+  stamp= ++last_stamp;
 }
 
 void
@@ -36,7 +65,10 @@ basic_environment_rep::raw_write (int key, const tree& val) {
   int h= key & (n-1), i= a[h].start;
   while (i >= 0) {
     if (a[i].key == key) {
+      if (weak_equal (a[i].val, val)) return;
+      hv ^= weak_node_hash (key, a[i].val) ^ weak_node_hash (key, val);
       a[i].val= val;
+      stamp= ++last_stamp;
       return;
     }
     i= a[i].next;
@@ -48,6 +80,8 @@ basic_environment_rep::raw_write (int key, const tree& val) {
   a[f].next = a[h].start;
   a[h].start= f;
   size++;
+  hv ^= weak_node_hash (key, val);
+  stamp= ++last_stamp;
 }
 
 tree*
@@ -68,6 +102,8 @@ basic_environment_rep::raw_remove (int key) {
   int h= key & (n-1), i= a[h].start, p= -1;
   while (i >= 0) {
     if (a[i].key == key) {
+      hv ^= weak_node_hash (key, a[i].val);
+      stamp= ++last_stamp;
       a[i].val= uninit;
       if (p >= 0) a[p].next= a[i].next;
       else a[h].start= a[i].next;
@@ -122,7 +158,8 @@ void
 basic_environment_rep::resize (int new_n) {
   //cout << "Resize " << n << " -> " << new_n << " (" << size << ")\n";
   ASSERT (new_n >= size, "too small number of bags");
-  int old_n= n;
+  int old_n= n, old_hv= hv;
+  DI  old_stamp= stamp;
   hash_node* old_a= a;
   n= new_n;
   a= tm_new_array<hash_node> (n);
@@ -131,6 +168,38 @@ basic_environment_rep::resize (int new_n) {
   for (int i=0; i<n; i++)
     a[i].next= i+1;
   multiple_insert (old_a, old_n);
+  tm_delete_array (old_a);
+  hv= old_hv;
+  stamp= old_stamp;
+}
+
+bool
+basic_environment_rep::same_contents (basic_environment env) {
+  // values are compared physically, as for weak_equal
+  if (stamp == env->stamp) return true;
+  if (size != env->size || hv != env->hv) return false;
+  for (int h=0; h<n; h++)
+    for (int i= a[h].start; i >= 0; i= a[i].next) {
+      tree* ptr= env->raw_read (a[i].key);
+      if (ptr == NULL || !weak_equal (*ptr, a[i].val)) return false;
+    }
+  return true;
+}
+
+/******************************************************************************
+* Copying
+******************************************************************************/
+
+basic_environment
+copy (basic_environment env) {
+  basic_environment ret (env->n);
+  for (int i=0; i<env->n; i++)
+    ret->a[i]= env->a[i];
+  ret->size = env->size;
+  ret->free = env->free;
+  ret->hv   = env->hv;
+  ret->stamp= env->stamp;
+  return ret;
 }
 
 /******************************************************************************
@@ -150,3 +219,17 @@ basic_environment_rep::print (const string& prefix) {
     }
   }
 }
+
+tm_ostream&
+operator << (tm_ostream& out, basic_environment env) {
+  int i, h, k= 0;
+  hash_node* a= env->a;
+  out << "{ ";
+  for (h=0; h<env->n; h++)
+    for (i= a[h].start; i >= 0; i= a[i].next) {
+      if (k++ != 0) out << ", ";
+      out << env_key_name (a[i].key) << "->" << a[i].val;
+    }
+  out << " }";
+  return out;
+}
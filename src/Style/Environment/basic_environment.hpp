@@ -23,6 +23,7 @@
 ******************************************************************************/
 
 class basic_environment_rep;
+class basic_environment;
 class hash_node {
   static tree uninit;
 public:
@@ -34,21 +35,40 @@ public:
   inline hash_node (): val (uninit), start (-1) {}
 };
 
+/******************************************************************************
+* String keys are coded by their own atom table, and not as tree labels,
+* so that the names of variables and macro arguments of the typesetter do
+* not pollute the table of tree labels
+******************************************************************************/
+
+int    make_env_key (const string& s);
+int    find_env_key (const string& s);
+string env_key_name (int key);
+
 /******************************************************************************
 * Basic environments
 ******************************************************************************/
 
+inline int
+weak_node_hash (int key, const tree& val) {
+  return ((unsigned int) key * 2654435769U) ^ weak_hash (val);
+}
+
 class basic_environment_rep: public environment_rep {
   static tree uninit;
+  static DI   last_stamp;
 public:
   int size;      // total number of elements
   int n;         // allocated number of bags (power of two and size <= n)
   hash_node* a;  // the nodes, which are bags at the same time
   int free;      // index of free space
+  int hv;        // xor of the weak hashes of all key-value pairs
+  DI  stamp;     // changes whenever the contents of the table change
 
 public:
   inline basic_environment_rep (int n2):
-    size (0), n (n2), a (tm_new_array<hash_node> (n)), free (0) {
+    size (0), n (n2), a (tm_new_array<hash_node> (n)), free (0),
+    hv (0), stamp (++last_stamp) {
       for (int i=0; i<n; i++) a[i].next= i+1; }
   inline ~basic_environment_rep () {
     tm_delete_array (a); }
@@ -74,12 +94,29 @@ public:
     raw_remove (key);
     if (size < (n>>2)) resize (n>>1); }
   void print (const string& prefix);
+  bool same_contents (basic_environment env);
+
+  // string keys which were never written are absent from the atom table
+  inline bool contains (const string& key) {
+    int l= find_env_key (key);
+    return l >= 0 && raw_read (l) != NULL; }
+  inline tree read (const string& key) {
+    int l= find_env_key (key);
+    tree* ptr= (l < 0? (tree*) NULL: raw_read (l));
+    return ptr==NULL? uninit: *ptr; }
+  inline void write (const string& key, const tree& val) {
+    write (make_env_key (key), val); }
+  inline void remove (const string& key) {
+    int l= find_env_key (key);
+    if (l >= 0) remove (l); }
 };
 
 class basic_environment {
   ABSTRACT_NULL(basic_environment);
   inline tree operator [] (int key) {
     return rep->read (key); }
+  inline tree operator [] (const string& key) {
+    return rep->read (key); }
   inline basic_environment (int n):
     rep (tm_new<basic_environment_rep> (n)) {}
   inline basic_environment (assoc_environment env):
@@ -93,4 +130,7 @@ class basic_environment {
 };
 ABSTRACT_NULL_CODE(basic_environment);
 
+basic_environment copy (basic_environment env);
+tm_ostream& operator << (tm_ostream& out, basic_environment env);
+
 #endif // defined BASIC_ENVIRONMENT_H
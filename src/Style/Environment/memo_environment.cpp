@@ -0,0 +1,75 @@
+/******************************************************************************
+* MODULE     : memo_environment.cpp
+* DESCRIPTION: memorizing computations for environments which come back
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "memo_environment.hpp"
+
+#define MEMO_MAX_SEEN 4096
+
+memo_environment_rep::memo_environment_rep (int states2):
+  states (max (states2, 1)), index (-1), seen (0), next (0) {}
+
+/******************************************************************************
+* Finding the slot of an environment
+******************************************************************************/
+
+bool
+memo_environment_rep::matches (int i, basic_environment env) {
+  // the contents of env are those of slot i (and then share its stamp) ?
+  if (envs[i]->stamp == env->stamp) return true;
+  if (envs[i]->hv != env->hv || !envs[i]->same_contents (env)) return false;
+  env->stamp= envs[i]->stamp;
+  return true;
+}
+
+int
+memo_environment_rep::find (basic_environment env) {
+  int i= index[env->hv];
+  if (i < 0 || !matches (i, env)) return -1;
+  return i;
+}
+
+int
+memo_environment_rep::enter (basic_environment env) {
+  if (!seen->contains (env->hv)) {
+    if (N(seen) >= MEMO_MAX_SEEN) seen= flat_hashmap<int,int> (0);
+    seen (env->hv)= 1;
+    return -1;
+  }
+  int i= N(envs);
+  if (i < states) {
+    envs << copy (env);
+    vals << hashmap<tree,tree> (UNINIT);
+  }
+  else {
+    i= next;
+    next= (next + 1) % states;
+    if (index[envs[i]->hv] == i) index->reset (envs[i]->hv);
+    envs[i]= copy (env);
+    vals[i]= hashmap<tree,tree> (UNINIT);
+  }
+  index (env->hv)= i;
+  return i;
+}
+
+/******************************************************************************
+* Memorized expansions
+******************************************************************************/
+
+tree
+memo_environment_rep::get (int i, tree t) {
+  return vals[i][t];
+}
+
+void
+memo_environment_rep::set (int i, tree t, tree r, int capacity) {
+  if (N(vals[i]) >= max (capacity, 1))
+    vals[i]= hashmap<tree,tree> (UNINIT);
+  vals[i] (t)= r;
+}
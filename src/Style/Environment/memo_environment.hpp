@@ -0,0 +1,101 @@
+/******************************************************************************
+* MODULE     : memo_environment.hpp
+* DESCRIPTION: memorizing computations for environments which come back
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef MEMO_ENVIRONMENT_H
+#define MEMO_ENVIRONMENT_H
+#include "basic_environment.hpp"
+#include "flat_hashmap.hpp"
+#include "hashmap.hpp"
+#include "path.hpp"
+
+/******************************************************************************
+* A small number of environments which keep coming back are copied into
+* slots, together with the expansions computed in them.  An environment is
+* looked up through its weak hash and identified with a slot by its stamp
+* or, when the stamp changed, by a physical comparison of the contents.
+* Only environments whose weak hash occurred before are given a slot.
+******************************************************************************/
+
+class memo_environment;
+class memo_environment_rep: concrete_struct {
+  int                        states;  // maximal number of slots
+  array<basic_environment>   envs;    // the memorized environments
+  array<hashmap<tree,tree> > vals;    // memorized expansions for each slot
+  flat_hashmap<int,int>      index;   // slot of an environment by weak hash
+  flat_hashmap<int,int>      seen;    // weak hashes of recent environments
+  int                        next;    // next slot to be replaced
+
+public:
+  memo_environment_rep (int states);
+  bool matches (int i, basic_environment env);
+  int  find (basic_environment env);
+  int  enter (basic_environment env);
+  tree get (int i, tree t);
+  void set (int i, tree t, tree r, int capacity);
+
+  friend class memo_environment;
+  friend int N (memo_environment memo);
+};
+
+class memo_environment {
+  CONCRETE(memo_environment);
+  inline memo_environment (int states= 16):
+    rep (tm_new<memo_environment_rep> (states)) {}
+};
+CONCRETE_CODE(memo_environment);
+
+inline int N (memo_environment memo) { return N(memo->envs); }
+
+/******************************************************************************
+* Results memorized by position in a document.  Each position keeps the
+* result of its most recent computation, together with the stamp of the
+* environment and a copy of the source tree for which it was computed.
+******************************************************************************/
+
+template<class T>
+class memo_positions {
+  hashmap<path,int> slot;    // the entry for each position
+  array<DI>         stamps;  // stamp of the environment of each entry
+  array<tree>       srcs;    // source tree of each entry
+  array<T>          vals;    // memorized result of each entry
+
+public:
+  int capacity;              // maximal number of entries
+  inline memo_positions (int cap): slot (-1), capacity (cap) {}
+
+  inline bool get (path ip, DI stamp, tree t, T& r) {
+    int i= slot[ip];
+    if (i < 0 || stamps[i] != stamp || srcs[i] != t) return false;
+    r= vals[i];
+    return true; }
+  inline void set (path ip, DI stamp, tree t, T r) {
+    int i= slot[ip];
+    if (i < 0) {
+      if (N(vals) >= capacity) {
+        slot= hashmap<path,int> (-1);
+        stamps= array<DI> ();
+        srcs= array<tree> ();
+        vals= array<T> ();
+      }
+      i= N(vals);
+      slot (ip)= i;
+      stamps << stamp;
+      srcs << copy (t);
+      vals << r;
+    }
+    else {
+      stamps[i]= stamp;
+      srcs[i]= copy (t);
+      vals[i]= r;
+    } }
+  inline int size () { return N(vals); }
+};
+
+#endif // defined MEMO_ENVIRONMENT_H
@@ -414,26 +414,33 @@ evaluate_string (tree t) {
 tree
 evaluate (tree t) {
   if (is_atomic (t)) return t;
+  if (!memorize_mode) {
+    tree r= evaluate_impl (t);
+    decorate_ip (t, r);
+    return r;
+  }
+  /*
   cout << "Evaluate "
-    // << obtain_ip (t) << " "
        << "[" << (t.operator -> ())
        << ", " << (std_env.operator -> ()) << "] "
        << t << INDENT << LF;
+  */
   memorizer mem= evaluate_memorizer (std_env, t);
   if (is_memorized (mem)) {
-    cout << UNINDENT << "Memorized " << mem->get_tree () << LF;
+    //cout << UNINDENT << "Memorized " << mem->get_tree () << LF;
+    memorize_hits++;
     std_env= mem->get_environment ();
     return mem->get_tree ();
   }
+  memorize_misses++;
   memorize_start ();
   tree r= evaluate_impl (t);
   decorate_ip (t, r);
   mem->set_tree (r);
   mem->set_environment (std_env);
   memorize_end ();
-  cout << UNINDENT << "Computed " << mem->get_tree ()
-    // << " at " << obtain_ip (r);
-       << LF;
+  memorize_retain (mem);
+  //cout << UNINDENT << "Computed " << mem->get_tree () << LF;
   return mem->get_tree ();
 }
 
@@ -120,7 +120,7 @@ double_size (T*& in, int& size) {
 
 void
 memorize_initialize () {
-  cout << "Memorize initialize" << INDENT << LF;
+  //cout << "Memorize initialize" << INDENT << LF;
   mem_max_pos  = 16;
   mem_pos      = tm_new_array<int> (mem_max_pos);
   mem_max_stack= 16;
@@ -131,7 +131,7 @@ memorize_initialize () {
 
 memorizer
 memorize_finalize () {
-  cout << UNINDENT << "Memorize finalize" << LF;
+  //cout << UNINDENT << "Memorize finalize" << LF;
   memorizer mem= mem_stack[0];
   tm_delete_array (mem_pos);
   tm_delete_array (mem_stack);
@@ -331,3 +331,42 @@ memorizer::operator = (memorizer mem) {
   if (rep != NULL) rep->ref_count++;
   return *this;
 }
+
+/******************************************************************************
+* Retaining recent computations and statistics
+******************************************************************************/
+
+bool memorize_mode    = false;
+int  memorize_capacity= 4096;
+int  memorize_hits    = 0;
+int  memorize_misses  = 0;
+
+static int mem_retained_max= 0;
+static int mem_retained_pos= 0;
+static memorizer* mem_retained= NULL;
+
+void
+memorize_retain (memorizer mem) {
+  // Computations are only found back as long as some memorizer refers
+  // to them. We keep the memorize_capacity most recent ones alive.
+  if (mem_retained_max != memorize_capacity) {
+    if (mem_retained_max != 0) tm_delete_array (mem_retained);
+    mem_retained_max= max (memorize_capacity, 0);
+    mem_retained_pos= 0;
+    mem_retained= NULL;
+    if (mem_retained_max != 0)
+      mem_retained= tm_new_array<memorizer> (mem_retained_max);
+  }
+  if (mem_retained_max == 0) return;
+  mem_retained[mem_retained_pos]= mem;
+  mem_retained_pos= (mem_retained_pos + 1) % mem_retained_max;
+}
+
+void
+memorize_statistics (tm_ostream& out) {
+  int total= memorize_hits + memorize_misses;
+  out << "Memorized " << memorize_hits << " out of " << total
+      << " computations";
+  if (total != 0) out << " (" << ((100 * (DI) memorize_hits) / total) << "%)";
+  out << ", " << bigmem_size << " in memory" << LF;
+}
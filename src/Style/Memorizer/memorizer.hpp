@@ -97,9 +97,16 @@ void print_tree (memorizer mem);
 * Public interface
 ******************************************************************************/
 
+extern bool memorize_mode;     // memorize evaluations and macro expansions ?
+extern int  memorize_capacity; // maximal number of retained computations
+extern int  memorize_hits;     // number of reused computations
+extern int  memorize_misses;   // number of performed computations
+
 void memorize_initialize ();
 memorizer memorize_finalize ();
 void memorize_start ();
 void memorize_end ();
+void memorize_retain (memorizer mem);
+void memorize_statistics (tm_ostream& out);
 
 #endif // defined MEMORIZER_H
@@ -29,6 +29,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <string.h>  // strerror
+#include <limits.h>
 #if defined (OS_MINGW)
 #include "Windows/win-utf8-compat.hpp"
 #else
@@ -189,10 +190,10 @@ save_string (url u, string s, bool fatal) {
     bool file_flag= do_cache_file (name);
     bool doc_flag= do_cache_doc (name);
     string cache_type= doc_flag? string ("doc_cache"): string ("file_cache");
+    declare_modified (r);
     if (!err && N(s) <= 10000)
       if (file_flag || doc_flag)
         cache_set (cache_type, name, s);
-    declare_out_of_date (url_parent (r));
     // End caching
   }
 
@@ -245,7 +246,7 @@ append_string (url u, string s, bool fatal) {
       }
     }
     // Cache file contents
-    declare_out_of_date (url_parent (r));
+    declare_modified (r);
     // End caching
   }
 
@@ -256,6 +257,123 @@ append_string (url u, string s, bool fatal) {
   return err;
 }
 
+/******************************************************************************
+* Writing files in chunks
+******************************************************************************/
+
+class file_ostream_rep: public tm_ostream_rep {
+  url    u;            // the file being written
+  url    r;            // its resolved name
+  string name;         // its concrete name, or "" for remote files
+  string target;       // the file which is replaced, after symbolic links
+  string tmp;          // the file which is renamed into target when atomic
+  bool   sync;         // flush the file to the disk before renaming it
+  FILE*  fout;         // the file actually being written
+  string buf;          // the contents of remote files
+  bool   is_w;         // no errors occurred so far
+  bool   closed;
+
+public:
+  file_ostream_rep (url u, bool atomic, bool sync);
+  ~file_ostream_rep ();
+
+  bool is_writable () const;
+  void write (const char* s);
+  void write (const char* s, int n);
+  bool close ();
+};
+
+file_ostream_rep::file_ostream_rep (url u2, bool atomic, bool sync2):
+  u (u2), r (u2), name (""), target (""), tmp (""), sync (sync2),
+  fout (NULL), buf (""), is_w (true), closed (false)
+{
+  if (!is_rooted_name (r)) r= resolve (r, "");
+  if (is_rooted_tmfs (u) || !is_rooted_name (r)) return;
+  name= concretize (r);
+  target= name;
+  c_string _name (name);
+#ifndef OS_MINGW
+  // replace the target of symbolic links, not the links themselves
+  char real[PATH_MAX];
+  if (realpath (_name, real) != NULL) target= string (real);
+#endif
+  tmp= atomic? target * ".tmp" * as_string ((int) getpid ()): target;
+  c_string _tmp (tmp);
+  fout= fopen (_tmp, "wb");
+  if (fout == NULL) {
+    is_w= false;
+    std_warning << "Save error for " << name << ", "
+                << strerror(errno) << "\n";
+    return;
+  }
+  setvbuf (fout, NULL, _IOFBF, 1 << 16);
+#ifndef OS_MINGW
+  struct stat st;
+  if (atomic && stat (_name, &st) == 0)
+    (void) fchmod (fileno (fout), st.st_mode & 07777);
+#endif
+}
+
+file_ostream_rep::~file_ostream_rep () {
+  (void) close ();
+}
+
+bool
+file_ostream_rep::is_writable () const {
+  return is_w && !closed;
+}
+
+void
+file_ostream_rep::write (const char* s) {
+  write (s, strlen (s));
+}
+
+void
+file_ostream_rep::write (const char* s, int n) {
+  if (closed || !is_w) return;
+  if (name == "") buf << string (s, n);
+  else if (fwrite (s, 1, n, fout) != (size_t) n) is_w= false;
+}
+
+bool
+file_ostream_rep::close () {
+  if (closed) return !is_w;
+  closed= true;
+  if (name == "") {
+    is_w= !save_string (u, buf, false);
+    buf= "";
+    return !is_w;
+  }
+  if (fout == NULL) return true;
+  if (fflush (fout) != 0) is_w= false;
+#ifndef OS_MINGW
+  if (sync && is_w && fsync (fileno (fout)) != 0) is_w= false;
+#endif
+  if (fclose (fout) != 0) is_w= false;
+  fout= NULL;
+  c_string _target (target);
+  c_string _tmp (tmp);
+  if (tmp != target) {
+#ifdef OS_MINGW
+    if (is_w) (void) ::remove (_target);
+#endif
+    if (is_w && rename (_tmp, _target) != 0) is_w= false;
+    if (!is_w) (void) ::remove (_tmp);
+  }
+  if (!is_w)
+    std_warning << "Save error for " << name << ", "
+                << strerror(errno) << "\n";
+  // Cache file contents
+  declare_modified (r);
+  // End caching
+  return !is_w;
+}
+
+tm_ostream
+file_ostream (url u, bool atomic, bool sync) {
+  return (tm_ostream_rep*) tm_new<file_ostream_rep> (u, atomic, sync);
+}
+
 /******************************************************************************
 * Getting attributes of a file
 ******************************************************************************/
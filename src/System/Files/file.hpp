@@ -25,6 +25,14 @@ bool load_string (url file_name, string& s, bool fatal);
 bool save_string (url file_name, string s, bool fatal=false);
 bool append_string (url u, string s, bool fatal= false);
 
+/**
+ * Open a stream for writing a file in chunks; the stream should be closed
+ * with out->close (), which returns true if there were errors
+ * @param atomic write to a temporary file which replaces u when closed
+ * @param sync flush the file to the disk before it replaces u
+ */
+tm_ostream file_ostream (url u, bool atomic= true, bool sync= false);
+
 bool is_of_type (url name, string filter);
 bool is_regular (url name);
 bool is_directory (url name);
@@ -11,6 +11,7 @@
 
 #include "tm_ostream.hpp"
 #include "tree.hpp"
+#include <string.h>
 #ifdef OS_MINGW
 #include "Windows/win-utf8-compat.hpp"
 #include "Windows/nowide/iostream.hpp"
@@ -29,6 +30,21 @@ void tm_ostream_rep::clear () {}
 bool tm_ostream_rep::is_writable () const { return false; }
 void tm_ostream_rep::write (const char*) {}
 void tm_ostream_rep::write (tree t) { (void) t; }
+bool tm_ostream_rep::close () { flush (); return !is_writable (); }
+
+void
+tm_ostream_rep::write (const char* s, int n) {
+  // pass the characters in null terminated pieces
+  char buf[256];
+  int i= 0;
+  while (i < n) {
+    int k= 0;
+    for (; i < n && k < 255; i++)
+      if (s[i] != '\0') buf[k++]= s[i];
+    buf[k]= '\0';
+    write ((const char*) buf);
+  }
+}
 
 /******************************************************************************
 * Standard streams
@@ -47,6 +63,7 @@ public:
 
   bool is_writable () const;
   void write (const char*);
+  void write (const char*, int);
   void flush ();
 };
 
@@ -116,6 +133,26 @@ std_ostream_rep::write (const char* s) {
   }
 }
 
+void
+std_ostream_rep::write (const char* s, int n) {
+#ifdef OS_MINGW
+  if (file == fstdout || file == fstderr) {
+    tm_ostream_rep::write (s, n);
+    return;
+  }
+#endif
+  if (memchr (s, '\0', n) != NULL) {
+    tm_ostream_rep::write (s, n);
+    return;
+  }
+  if (file && is_w) {
+    if (fwrite (s, 1, n, file) == (size_t) n) {
+      if (memchr (s, '\n', n) != NULL) flush ();
+    }
+    else is_w= false;
+  }
+}
+
 void
 std_ostream_rep::flush () {
   if (file && is_w) fflush (file);
@@ -136,6 +173,7 @@ public:
 
   bool is_writable () const;
   void write (const char*);
+  void write (const char*, int);
 };
 
 buffered_ostream_rep::buffered_ostream_rep (tm_ostream_rep* master2):
@@ -153,6 +191,12 @@ buffered_ostream_rep::write (const char* s) {
   buf << s;
 }
 
+void
+buffered_ostream_rep::write (const char* s, int n) {
+  if (memchr (s, '\0', n) != NULL) tm_ostream_rep::write (s, n);
+  else buf << string (s, n);
+}
+
 /******************************************************************************
 * Streams for debugging purposes
 ******************************************************************************/
@@ -28,9 +28,11 @@ public:
 
   virtual bool is_writable () const;
   virtual void write (const char*);
+  virtual void write (const char*, int);  // by default without nulls
   virtual void write (tree);
   virtual void flush ();
   virtual void clear ();
+  virtual bool close ();
 
   friend class tm_ostream;
 };
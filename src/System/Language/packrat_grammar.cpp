@@ -172,7 +172,10 @@ singleton (C c) {
 packrat_grammar_rep::packrat_grammar_rep (string s):
   rep<packrat_grammar> (s),
   grammar (singleton (PACKRAT_TM_FAIL)),
-  productions (packrat_uninit)
+  productions (packrat_uninit),
+  stamp (0),
+  compiled (-1),
+  nr_firsts (0)
 {
   grammar (PACKRAT_TM_OPEN)= singleton (PACKRAT_TM_OPEN);
   grammar (PACKRAT_TM_ANY )= singleton (PACKRAT_TM_ANY );
@@ -311,6 +314,7 @@ packrat_grammar_rep::define (string s, tree t) {
     array<C> def= define (t);
     grammar (sym)= def;
   }
+  stamp++;
 }
 
 void
@@ -320,6 +324,157 @@ packrat_grammar_rep::set_property (string s, string var, string val) {
   C prop= encode_symbol (compound ("property", var));
   D key = (((D) prop) << 32) + ((D) (sym ^ prop));
   properties (key)= val;
+  stamp++;
+}
+
+/******************************************************************************
+* Compilation
+******************************************************************************/
+
+struct packrat_firsts {
+  int                 w;         // number of words in each bit set
+  array<int>          rows;      // row of each defined symbol, or -1
+  array<bool>         nullable;  // may the symbol match the empty string?
+  array<bool>         any;       // may a match start with an unknown token?
+  array<unsigned int> bits;      // bit sets of the possible first tokens
+  bool                changed;
+
+  void set (int i, C c) {
+    unsigned int& word= bits [rows[i] * w + (c >> 5)];
+    unsigned int  mask= 1u << (c & 31);
+    if ((word & mask) == 0) { word |= mask; changed= true; }
+  }
+  void set_nullable (int i) {
+    if (!nullable[i]) { nullable[i]= true; changed= true; } }
+  void set_any (int i) {
+    if (!any[i]) { any[i]= true; changed= true; } }
+  bool defined (C x) {
+    C j= x - PACKRAT_TM_OPEN;
+    return j < N(rows) && rows[j] >= 0; }
+  bool is_nullable (C x) {
+    return x >= PACKRAT_TM_OPEN && defined (x) &&
+           nullable [x - PACKRAT_TM_OPEN]; }
+  void add (int i, C x) {
+    // matches of the i-th symbol may start like those of x
+    if (x < PACKRAT_TM_OPEN) set (i, x);
+    else if (defined (x)) {
+      int j= x - PACKRAT_TM_OPEN;
+      for (int k=0; k<w; k++) {
+        unsigned int& word= bits [rows[i] * w + k];
+        unsigned int  more= bits [rows[j] * w + k] & ~word;
+        if (more != 0) { word |= more; changed= true; }
+      }
+      if (any[j]) set_any (i);
+    }
+  }
+};
+
+void
+packrat_grammar_rep::compile () {
+  // The instructions of all symbols are stored consecutively in a single
+  // array, indexed by the symbols.  For the symbols which never match the
+  // empty string, we also compute the sets of tokens by which their matches
+  // may start, so that the parser can reject most alternatives at once.
+  if (compiled == stamp) return;
+  int nr= PACKRAT_SYMBOLS - PACKRAT_TM_OPEN + packrat_nr_symbols;
+  packrat_firsts fs;
+  fs.w       = (packrat_nr_tokens + 31) >> 5;
+  fs.rows    = array<int> (nr);
+  fs.nullable= array<bool> (nr);
+  fs.any     = array<bool> (nr);
+  code       = array<C> ();
+  code_pos   = array<int> (nr);
+  int rows= 0;
+  for (int i=0; i<nr; i++) {
+    C sym= PACKRAT_TM_OPEN + i;
+    fs.nullable[i]= fs.any[i]= false;
+    if (grammar->contains (sym)) {
+      array<C> inst= grammar [sym];
+      code_pos[i]= N(code);
+      code << ((C) N(inst)) << inst;
+      fs.rows[i]= rows++;
+    }
+    else code_pos[i]= fs.rows[i]= -1;
+  }
+  fs.bits= array<unsigned int> (rows * fs.w);
+  for (int k=0; k<N(fs.bits); k++) fs.bits[k]= 0;
+
+  fs.changed= true;
+  while (fs.changed) {
+    fs.changed= false;
+    for (int i=0; i<nr; i++) {
+      if (code_pos[i] < 0) continue;
+      int n   = code [code_pos[i]];
+      C*  inst= A(code) + code_pos[i] + 1;
+      switch (inst[0]) {
+      case PACKRAT_OR:
+        for (int k=1; k<n; k++) {
+          fs.add (i, inst[k]);
+          if (fs.is_nullable (inst[k])) fs.set_nullable (i);
+        }
+        break;
+      case PACKRAT_CONCAT: {
+        int k;
+        for (k=1; k<n; k++) {
+          fs.add (i, inst[k]);
+          if (!fs.is_nullable (inst[k])) break;
+        }
+        if (k == n) fs.set_nullable (i);
+        break;
+      }
+      case PACKRAT_WHILE:
+        fs.add (i, inst[1]);
+        fs.set_nullable (i);
+        break;
+      case PACKRAT_REPEAT:
+      case PACKRAT_EXCEPT:
+        fs.add (i, inst[1]);
+        if (fs.is_nullable (inst[1])) fs.set_nullable (i);
+        break;
+      case PACKRAT_RANGE:
+        for (C c= inst[1]; c <= inst[2]; c++) fs.set (i, c);
+        break;
+      case PACKRAT_NOT:
+      case PACKRAT_TM_CURSOR:
+        fs.set_nullable (i);
+        break;
+      case PACKRAT_TM_OPEN:
+      case PACKRAT_TM_CHAR:
+        fs.set_any (i);
+        break;
+      case PACKRAT_TM_ANY:
+      case PACKRAT_TM_ARGS:
+      case PACKRAT_TM_LEAF:
+        fs.set_any (i);
+        fs.set_nullable (i);
+        break;
+      case PACKRAT_TM_FAIL:
+        break;
+      default:
+        if (inst[0] < PACKRAT_OR || inst[0] >= PACKRAT_TM_OPEN) {
+          fs.add (i, inst[0]);
+          if (fs.is_nullable (inst[0])) fs.set_nullable (i);
+        }
+        else {
+          fs.set_any (i);
+          fs.set_nullable (i);
+        }
+        break;
+      }
+    }
+  }
+
+  first_pos   = array<int> (nr);
+  first_tokens= array<unsigned int> ();
+  nr_firsts   = fs.w << 5;
+  for (int i=0; i<nr; i++)
+    if (code_pos[i] < 0 || fs.nullable[i] || fs.any[i]) first_pos[i]= -1;
+    else {
+      first_pos[i]= N(first_tokens);
+      for (int k=0; k<fs.w; k++)
+        first_tokens << fs.bits [fs.rows[i] * fs.w + k];
+    }
+  compiled= stamp;
 }
 
 /******************************************************************************
@@ -405,6 +560,7 @@ packrat_inherit (string lan, string from) {
     //cout << "Inherit " << p << " -> " << inh->properties (p) << LF;
     gr->properties (p)= inh->properties (p);
   }
+  gr->stamp++;
 }
 
 int
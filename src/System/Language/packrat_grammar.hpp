@@ -73,6 +73,14 @@ struct packrat_grammar_rep: rep<packrat_grammar> {
   hashmap<C,array<C> >   grammar;
   hashmap<C,tree>        productions;
   hashmap<D,string>      properties;
+  int                    stamp;     // increased at each modification
+
+  int                    compiled;  // stamp of the compiled form below
+  array<C>               code;      // instructions preceded by their length
+  array<int>             code_pos;  // start of the instruction of a symbol
+  array<int>             first_pos; // start of the first tokens of a symbol
+  array<unsigned int>    first_tokens; // bit sets of possible first tokens
+  int                    nr_firsts; // number of tokens in the bit sets
 
   packrat_grammar_rep (string s);
 
@@ -82,6 +90,7 @@ struct packrat_grammar_rep: rep<packrat_grammar> {
   void set_property (string s, string var, string val);
   bool has_property (string s, string var);
   string get_property (string s, string var);
+  void compile ();
 
   string decode_as_string (C sym);
   array<string> decode_as_array_string (C sym);
@@ -34,37 +34,55 @@ packrat_parser_rep::packrat_parser_rep (packrat_grammar gr):
   current_pos_path (-1),
   current_cursor (-1),
   current_input (),
-  current_cache (PACKRAT_UNDEFINED),
-  current_production (packrat_uninit) {}
+  current_offsets (),
+  current_memo (1024),
+  current_entries (0),
+  current_production (packrat_uninit),
+  current_ids (1),
+  current_extents (1),
+  last_id (1),
+  current_dropped (0),
+  current_examined (0),
+  grammar_stamp (gr->stamp),
+  input_copy (packrat_uninit),
+  input_pos (path ())
+{
+  gr->compile ();
+  code        = gr->code;
+  code_pos    = gr->code_pos;
+  first_pos   = gr->first_pos;
+  first_tokens= gr->first_tokens;
+  nr_firsts   = gr->nr_firsts;
+  current_ids[0]= 0;
+  current_extents[0]= 0;
+  for (int i=0; i<N(current_memo); i++) current_memo[i].id= -1;
+}
+
+static packrat_parser
+make_packrat_parser (hashmap<string,packrat_parser>& parsers,
+                     string lan, tree in, path in_pos) {
+  // One parser is kept alive for each language, so that the results
+  // which were memoized for previous versions of the input can be reused
+  packrat_grammar gr = find_packrat_grammar (lan);
+  packrat_parser  par= parsers [lan];
+  if (is_nil (par) || par->grammar_stamp != gr->stamp) {
+    par= packrat_parser (gr, in, in_pos);
+    parsers (lan)= par;
+  }
+  else par->update_input (in, in_pos);
+  return par;
+}
 
 packrat_parser
 make_packrat_parser (string lan, tree in) {
-  static string         last_lan   = "";
-  static tree           last_in    = "";
-  static packrat_parser last_par;
-  if (lan != last_lan || in != last_in) {
-    packrat_grammar gr= find_packrat_grammar (lan);
-    last_lan   = lan;
-    last_in    = copy (in);
-    last_par   = packrat_parser (gr, last_in);
-  }
-  return last_par;
+  static hashmap<string,packrat_parser> parsers;
+  return make_packrat_parser (parsers, lan, in, path ());
 }
 
 packrat_parser
 make_packrat_parser (string lan, tree in, path in_pos) {
-  static string         last_lan   = "";
-  static tree           last_in    = "";
-  static path           last_in_pos= path ();
-  static packrat_parser last_par;
-  if (lan != last_lan || in != last_in || in_pos != last_in_pos) {
-    packrat_grammar gr= find_packrat_grammar (lan);
-    last_lan   = lan;
-    last_in    = copy (in);
-    last_in_pos= copy (in_pos);
-    last_par   = packrat_parser (gr, last_in, last_in_pos);
-  }
-  return last_par;
+  static hashmap<string,packrat_parser> parsers;
+  return make_packrat_parser (parsers, lan, in, in_pos);
 }
 
 /******************************************************************************
@@ -73,12 +91,21 @@ make_packrat_parser (string lan, tree in, path in_pos) {
 
 void
 packrat_parser_rep::set_input (tree t) {
-  current_string= "";
-  current_tree  = t;
+  current_string  = "";
+  current_tree    = t;
+  current_start   = hashmap<path,int> (-1);
+  current_end     = hashmap<path,int> (-1);
+  current_path_pos= hashmap<path,int> (-1);
+  current_pos_path= hashmap<int,path> (-1);
+  input_copy      = copy (t);
   serialize (t, path ());
   if (DEBUG_FLATTEN)
     debug_packrat << "Input " << current_string << "\n";
   current_input= encode_tokens (current_string);
+  current_offsets= array<int> ();
+  for (int i=0; i<N(current_string); tm_char_forwards (current_string, i))
+    current_offsets << i;
+  current_offsets << N(current_string);
 }
 
 void
@@ -86,6 +113,86 @@ packrat_parser_rep::set_cursor (path p) {
   if (is_nil (p)) current_cursor= -1;
   else current_cursor= encode_tree_position (p);
   //cout << current_input << ", " << current_cursor << "\n";
+  input_pos= p;
+}
+
+/******************************************************************************
+* Incremental parsing
+******************************************************************************/
+
+void
+packrat_parser_rep::update_input (tree t, path t_pos) {
+  if (t == input_copy) {
+    // highlighting applies to the given tree and not to a copy
+    current_tree= t;
+    if (t_pos == input_pos) return;
+  }
+  array<C> old_input = current_input;
+  C        old_cursor= current_cursor;
+  if (t != input_copy) set_input (t);
+  set_cursor (t_pos);
+  update_cache (old_input, old_cursor);
+}
+
+void
+packrat_parser_rep::forget (C pos) {
+  // forget all results at pos by giving a new identifier to it
+  current_ids[pos]= last_id++;
+  current_extents[pos]= 0;
+  current_dropped++;
+}
+
+void
+packrat_parser_rep::forget_around (C pos) {
+  // forget the results which examined the token at pos
+  for (C p=0; p <= pos && p < N(current_ids); p++)
+    if (p + current_extents[p] > pos) forget (p);
+}
+
+void
+packrat_parser_rep::update_cache (array<C> old_input, C old_cursor) {
+  // The results are memoized for stable identifiers of the positions in
+  // the input and each result records the end of the portion of the input
+  // which was examined in order to obtain it.  After a modification, the
+  // positions in the unchanged prefix and suffix of the input keep their
+  // identifiers, except those with results which examined modified tokens.
+  // Similarly, we forget the results which examined the cursor whenever
+  // the cursor moves.
+  int n1= N(old_input), n2= N(current_input), a= 0, b= 0;
+  while (a < n1 && a < n2 && old_input[a] == current_input[a]) a++;
+  if (a == n1 && a == n2) a++;
+  else while (a + b < n1 && a + b < n2 &&
+              old_input[n1-1-b] == current_input[n2-1-b]) b++;
+  if (old_cursor >= 0) forget_around (old_cursor);
+  if (a <= n1) {
+    array<int> ids (n2 + 1);
+    array<C>   extents (n2 + 1);
+    for (C p=0; p<a; p++) {
+      ids[p]= current_ids[p];
+      extents[p]= current_extents[p];
+    }
+    for (C p=a; p<n2-b; p++) {
+      ids[p]= last_id++;
+      extents[p]= 0;
+    }
+    for (C p=n2-b; p<=n2; p++) {
+      ids[p]= current_ids[p+n1-n2];
+      extents[p]= current_extents[p+n1-n2];
+    }
+    current_ids= ids;
+    current_extents= extents;
+    current_dropped += n1 - b - a;
+    for (C p=0; p<a; p++)
+      if (p + current_extents[p] > a) forget (p);
+  }
+  if (current_cursor >= 0) forget_around (current_cursor);
+  if (current_dropped > N(current_input)) {
+    // too many forgotten results: start afresh
+    for (int i=0; i<N(current_memo); i++) current_memo[i].id= -1;
+    for (C p=0; p<=n2; p++) current_extents[p]= 0;
+    current_entries= 0;
+    current_dropped= 0;
+  }
 }
 
 /******************************************************************************
@@ -94,14 +201,15 @@ packrat_parser_rep::set_cursor (path p) {
 
 C
 packrat_parser_rep::encode_string_position (int i) {
+  // first token which does not start before i
   if (i < 0) return PACKRAT_FAILED;
-  int j=0;
-  C k=0;
-  while (j<i && j<N(current_string)) {
-    tm_char_forwards (current_string, j);
-    k++;
+  C lo= 0, hi= N(current_input);
+  while (lo < hi) {
+    C mid= (lo + hi) >> 1;
+    if (current_offsets[mid] < i) lo= mid + 1;
+    else hi= mid;
   }
-  return k;
+  return lo;
 }
 
 int
@@ -134,13 +242,7 @@ int
 packrat_parser_rep::decode_string_position (C pos) {
   //cout << "Decode " << pos << "\n";
   if (pos == PACKRAT_FAILED) return -1;
-  int i=0;
-  C k=0;
-  while (i<N(current_string) && k<pos) {
-    tm_char_forwards (current_string, i);
-    k++;
-  }
-  return i;
+  return current_offsets [max (0, min (pos, N(current_input)))];
 }
 
 path
@@ -153,9 +255,22 @@ packrat_parser_rep::decode_path (tree t, path p, int pos) {
     else return p * (pos - current_start[p]);
   }
   else {
-    for (int i=0; i<N(t); i++)
-      if (pos >= current_start[p*i] && pos <= current_end[p*i])
-        return decode_path (t[i], p * i, pos);
+    if (is_func (t, DOCUMENT) || is_func (t, PARA) || is_func (t, CONCAT)) {
+      // the children are serialized in order, so that we may search
+      // for the first child which ends after pos by dichotomy
+      int lo= 0, hi= N(t);
+      while (lo < hi) {
+        int mid= (lo + hi) >> 1;
+        if (current_end[p*mid] < pos) lo= mid + 1;
+        else hi= mid;
+      }
+      if (lo < N(t) && current_start[p*lo] <= pos)
+        return decode_path (t[lo], p * lo, pos);
+    }
+    else
+      for (int i=0; i<N(t); i++)
+        if (pos >= current_start[p*i] && pos <= current_end[p*i])
+          return decode_path (t[i], p * i, pos);
     if (pos <= current_start[p]) return p * 0;
     if (pos >= current_end[p]) return p * 1;
     return p * 0;
@@ -178,130 +293,212 @@ starts (tree t, string s) {
   return is_atomic (t) && starts (t->label, s);
 }
 
+inline void
+packrat_parser_rep::examine (C pos) {
+  // the result being computed depends on the token at pos,
+  // or on the end of the input when pos is N(current_input)
+  current_examined= max (current_examined, pos + 1);
+}
+
+static C packrat_fail_instruction[1]= { PACKRAT_TM_FAIL };
+
+inline C*
+packrat_parser_rep::instruction (C sym, int& n) {
+  // the compiled instruction for a symbol sym >= PACKRAT_TM_OPEN
+  C i= sym - PACKRAT_TM_OPEN;
+  if (i >= N(code_pos) || code_pos[i] < 0) {
+    n= 1;
+    return packrat_fail_instruction;
+  }
+  n= code [code_pos[i]];
+  return A(code) + code_pos[i] + 1;
+}
+
+inline int
+packrat_parser_rep::memo_slot (C sym, int id) {
+  // open addressing with linear probing: the slot of the result for sym
+  // at the position with the given identifier, or the empty slot for it.
+  // The results at a same position are stored close to each other.
+  int mask= N(current_memo) - 1;
+  int i= (int) ((((unsigned int) id) << 3) +
+                ((((unsigned int) sym) * 2654435761u) >> 29)) & mask;
+  while (current_memo[i].id != -1 &&
+         (current_memo[i].id != id || current_memo[i].sym != sym))
+    i= (i + 1) & mask;
+  return i;
+}
+
+void
+packrat_parser_rep::memo_resize (int size) {
+  array<packrat_memo> old= current_memo;
+  current_memo= array<packrat_memo> (size);
+  for (int i=0; i<size; i++) current_memo[i].id= -1;
+  for (int i=0; i<N(old); i++)
+    if (old[i].id != -1)
+      current_memo[memo_slot (old[i].sym, old[i].id)]= old[i];
+}
+
 C
 packrat_parser_rep::parse (C sym, C pos) {
-  D key= (((D) sym) << 32) + ((D) (sym^pos));
-  C im = current_cache [key];
-  if (im != PACKRAT_UNDEFINED) {
-    //cout << "Cached " << sym << " at " << pos << " -> " << im << LF;
-    return im;
+  if (pos < 0) return PACKRAT_FAILED;
+  if (sym < PACKRAT_TM_OPEN) {
+    examine (pos);
+    if (pos < N (current_input) && current_input[pos] == sym) return pos + 1;
+    else return PACKRAT_FAILED;
+  }
+  C i= sym - PACKRAT_TM_OPEN;
+  if (i < N(first_pos) && first_pos[i] >= 0) {
+    // quickly reject symbols which cannot start with the next token
+    examine (pos);
+    if (pos >= N (current_input)) return PACKRAT_FAILED;
+    C c= current_input[pos];
+    if (c >= nr_firsts ||
+        (first_tokens [first_pos[i] + (c >> 5)] & (1u << (c & 31))) == 0)
+      return PACKRAT_FAILED;
+  }
+  int n;
+  C*  inst= instruction (sym, n);
+  C   im;
+  switch (inst[0]) {
+  case PACKRAT_RANGE:
+    examine (pos);
+    if (pos < N (current_input) &&
+        current_input [pos] >= inst[1] &&
+        current_input [pos] <= inst[2])
+      return pos + 1;
+    else return PACKRAT_FAILED;
+  case PACKRAT_TM_OPEN:
+    examine (pos);
+    if (pos < N (current_input) &&
+        starts (packrat_decode[current_input[pos]], "<\\"))
+      return pos + 1;
+    else return PACKRAT_FAILED;
+  case PACKRAT_TM_CHAR:
+    examine (pos);
+    if (pos >= N (current_input)) return PACKRAT_FAILED;
+    else {
+      tree t= packrat_decode[current_input[pos]];
+      if (starts (t, "<\\") || t == "<|>" || t == "</>")
+        return PACKRAT_FAILED;
+      else return pos + 1;
+    }
+  case PACKRAT_TM_CURSOR:
+    examine (pos);
+    if (pos == current_cursor) return pos;
+    else return PACKRAT_FAILED;
+  case PACKRAT_TM_FAIL:
+    return PACKRAT_FAILED;
+  default:
+    break;
+  }
+
+  // the other results are memoized relative to their position
+  int id  = current_ids[pos];
+  int slot= memo_slot (sym, id);
+  if (current_memo[slot].id != -1) {
+    //cout << "Cached " << sym << " at " << pos << LF;
+    current_examined= max (current_examined, pos + current_memo[slot].reach);
+    im= current_memo[slot].im;
+    return (im == PACKRAT_FAILED? im: pos + im);
+  }
+  if (2 * (current_entries + 1) > N(current_memo)) {
+    memo_resize (2 * N(current_memo));
+    slot= memo_slot (sym, id);
   }
-  current_cache (key)= PACKRAT_FAILED;
+  current_memo[slot].id   = id;
+  current_memo[slot].sym  = sym;
+  current_memo[slot].im   = PACKRAT_FAILED;
+  current_memo[slot].reach= 0;
+  current_entries++;
+  C examined= current_examined;
+  current_examined= pos;
   if (DEBUG_PACKRAT)
     debug_packrat << "Parse " << packrat_decode[sym]
                   << " at " << pos << INDENT << LF;
-  if (sym >= PACKRAT_TM_OPEN) {
-    array<C> inst= grammar [sym];
-    //cout << "Parse " << inst << " at " << pos << LF;
-    switch (inst[0]) {
-    case PACKRAT_OR:
-      im= PACKRAT_FAILED;
-      for (int i=1; i<N(inst); i++) {
-        im= parse (inst[i], pos);
-        if (im != PACKRAT_FAILED) break;
-      }
-      break;
-    case PACKRAT_CONCAT:
-      im= pos;
-      for (int i=1; i<N(inst); i++) {
-        im= parse (inst[i], im);
-        if (im == PACKRAT_FAILED) break;
-      }
-      break;
-    case PACKRAT_WHILE:
-      im= pos;
+  //cout << "Parse " << inst << " at " << pos << LF;
+  switch (inst[0]) {
+  case PACKRAT_OR:
+    im= PACKRAT_FAILED;
+    for (int i=1; i<n; i++) {
+      im= parse (inst[i], pos);
+      if (im != PACKRAT_FAILED) break;
+    }
+    break;
+  case PACKRAT_CONCAT:
+    im= pos;
+    for (int i=1; i<n; i++) {
+      im= parse (inst[i], im);
+      if (im == PACKRAT_FAILED) break;
+    }
+    break;
+  case PACKRAT_WHILE:
+    im= pos;
+    while (true) {
+      C next= parse (inst[1], im);
+      if (next == PACKRAT_FAILED || (next >= 0 && next <= im)) break;
+      im= next;
+    }
+    break;
+  case PACKRAT_REPEAT:
+    im= parse (inst[1], pos);
+    if (im != PACKRAT_FAILED)
       while (true) {
         C next= parse (inst[1], im);
         if (next == PACKRAT_FAILED || (next >= 0 && next <= im)) break;
         im= next;
       }
-      break;
-    case PACKRAT_REPEAT:
-      im= parse (inst[1], pos);
-      if (im != PACKRAT_FAILED)
-        while (true) {
-          C next= parse (inst[1], im);
-          if (next == PACKRAT_FAILED || (next >= 0 && next <= im)) break;
-          im= next;
-        }
-      break;
-    case PACKRAT_RANGE:
-      if (pos < N (current_input) &&
-          current_input [pos] >= inst[1] &&
-          current_input [pos] <= inst[2])
-        im= pos + 1;
-      else im= PACKRAT_FAILED;
-      break;
-    case PACKRAT_NOT:
-      if (parse (inst[1], pos) == PACKRAT_FAILED) im= pos;
-      else im= PACKRAT_FAILED;
-      break;
-    case PACKRAT_EXCEPT:
-      im= parse (inst[1], pos);
-      if (im != PACKRAT_FAILED)
-        if (parse (inst[2], pos) != PACKRAT_FAILED)
-          im= PACKRAT_FAILED;
-      break;
-    case PACKRAT_TM_OPEN:
-      if (pos < N (current_input) &&
-          starts (packrat_decode[current_input[pos]], "<\\"))
-        im= pos + 1;
-      else im= PACKRAT_FAILED;
-      break;
-    case PACKRAT_TM_ANY:
-      im= pos;
-      while (true) {
-        C old= im;
-        im= parse (PACKRAT_TM_OPEN, old);
-        if (im == PACKRAT_FAILED)
-          im= parse (PACKRAT_TM_LEAF, old);
-        else {
-          im= parse (PACKRAT_TM_ARGS, im);
-          if (im != PACKRAT_FAILED)
-            im= parse (encode_token ("</>"), im);
-        }
-        if (old == im) break;
-      }
-      break;
-    case PACKRAT_TM_ARGS:
-      im= parse (PACKRAT_TM_ANY, pos);
-      while (im < N (current_input))
-        if (current_input[im] != encode_token ("<|>")) break;
-        else im= parse (PACKRAT_TM_ANY, im + 1);
-      break;
-    case PACKRAT_TM_LEAF:
-      im= pos;
-      while (im < N (current_input)) {
-        tree t= packrat_decode[current_input[im]];
-        if (starts (t, "<\\") || t == "<|>" || t == "</>") break;
-        else im++;
-      }
-      break;
-    case PACKRAT_TM_CHAR:
-      if (pos >= N (current_input)) im= PACKRAT_FAILED;
+    break;
+  case PACKRAT_NOT:
+    if (parse (inst[1], pos) == PACKRAT_FAILED) im= pos;
+    else im= PACKRAT_FAILED;
+    break;
+  case PACKRAT_EXCEPT:
+    im= parse (inst[1], pos);
+    if (im != PACKRAT_FAILED)
+      if (parse (inst[2], pos) != PACKRAT_FAILED)
+        im= PACKRAT_FAILED;
+    break;
+  case PACKRAT_TM_ANY:
+    im= pos;
+    while (true) {
+      C old= im;
+      im= parse (PACKRAT_TM_OPEN, old);
+      if (im == PACKRAT_FAILED)
+        im= parse (PACKRAT_TM_LEAF, old);
       else {
-        tree t= packrat_decode[current_input[pos]];
-        if (starts (t, "<\\") || t == "<|>" || t == "</>") im= PACKRAT_FAILED;
-        else im= pos + 1;
+        im= parse (PACKRAT_TM_ARGS, im);
+        if (im != PACKRAT_FAILED)
+          im= parse (encode_token ("</>"), im);
       }
-      break;
-    case PACKRAT_TM_CURSOR:
-      if (pos == current_cursor) im= pos;
-      else im= PACKRAT_FAILED;
-      break;
-    case PACKRAT_TM_FAIL:
-      im= PACKRAT_FAILED;
-      break;
-    default:
-      im= parse (inst[0], pos);
-      break;
+      if (old == im) break;
     }
+    break;
+  case PACKRAT_TM_ARGS:
+    im= parse (PACKRAT_TM_ANY, pos);
+    while (im < N (current_input))
+      if (current_input[im] != encode_token ("<|>")) break;
+      else im= parse (PACKRAT_TM_ANY, im + 1);
+    examine (im);
+    break;
+  case PACKRAT_TM_LEAF:
+    im= pos;
+    while (im < N (current_input)) {
+      tree t= packrat_decode[current_input[im]];
+      if (starts (t, "<\\") || t == "<|>" || t == "</>") break;
+      else im++;
+    }
+    examine (im);
+    break;
+  default:
+    im= parse (inst[0], pos);
+    break;
   }
-  else {
-    if (pos < N (current_input) && current_input[pos] == sym) im= pos + 1;
-    else im= PACKRAT_FAILED;
-  }
-  current_cache (key)= im;
+  // the table may have been enlarged in the meantime
+  slot= memo_slot (sym, id);
+  current_memo[slot].im   = (im == PACKRAT_FAILED? im: im - pos);
+  current_memo[slot].reach= current_examined - pos;
+  current_extents[pos]= max (current_extents[pos], current_examined - pos);
+  current_examined= max (examined, current_examined);
   if (DEBUG_PACKRAT)
     debug_packrat << UNINDENT << "Parsed " << packrat_decode[sym]
                   << " at " << pos << " -> " << im << LF;
@@ -319,18 +516,18 @@ packrat_parser_rep::inspect (C sym, C pos, array<C>& syms, array<C>& poss) {
   C next= parse (sym, pos);
   if (next == PACKRAT_FAILED) return;
   if (sym >= PACKRAT_TM_OPEN) {
-    array<C> inst= grammar [sym];
-    //cout << "Parse " << inst << " at " << pos << LF;
+    int n;
+    C*  inst= instruction (sym, n);
     switch (inst[0]) {
     case PACKRAT_OR:
-      for (int i=1; i<N(inst); i++)
+      for (int i=1; i<n; i++)
         if (parse (inst[i], pos) != PACKRAT_FAILED) {
           inspect (inst[i], pos, syms, poss);
           break;
         }
       break;
     case PACKRAT_CONCAT:
-      for (int i=1; i<N(inst); i++) {
+      for (int i=1; i<n; i++) {
         next= parse (inst[i], pos);
         if (next == PACKRAT_FAILED) break;
         syms << inst[i];
@@ -372,8 +569,9 @@ packrat_parser_rep::inspect (C sym, C pos, array<C>& syms, array<C>& poss) {
 bool
 packrat_parser_rep::is_left_recursive (C sym) {
   if (sym < PACKRAT_TM_OPEN) return false;
-  array<C> inst= grammar [sym];
-  if (inst[0] != PACKRAT_CONCAT || N(inst) != 3) return false;
+  int n;
+  C*  inst= instruction (sym, n);
+  if (inst[0] != PACKRAT_CONCAT || n != 3) return false;
   if (inst[1] < PACKRAT_TM_OPEN) return false;
   tree t= packrat_decode[inst[1]];
   return is_compound (t, "symbol", 1) && ends (t[0]->label, "-head");
@@ -459,7 +657,8 @@ packrat_parser_rep::context
   }
 
   if (is_left_recursive (sym) && mode == 0) {
-    array<C> inst= grammar [sym];
+    int n;
+    C*  inst= instruction (sym, n);
     C before= pos;
     C middle= parse (inst[1], before);
     if (middle == PACKRAT_FAILED) return;
@@ -506,18 +705,18 @@ packrat_parser_rep::context
   }
 
   if (sym >= PACKRAT_TM_OPEN) {
-    array<C> inst= grammar [sym];
-    //cout << "Context " << inst << " at " << pos << LF;
+    int n;
+    C*  inst= instruction (sym, n);
     switch (inst[0]) {
     case PACKRAT_OR:
-      for (int i=1; i<N(inst); i++)
+      for (int i=1; i<n; i++)
         if (parse (inst[i], pos) != PACKRAT_FAILED) {
           context (inst[i], pos, w1, w2, mode, kind, begin, end);
           break;
         }
       break;
     case PACKRAT_CONCAT:
-      for (int i=1; i<N(inst); i++) {
+      for (int i=1; i<n; i++) {
         next= parse (inst[i], pos);
         if (next == PACKRAT_FAILED) break;
         if (pos <= w1 && w2 <= next)
@@ -626,18 +825,18 @@ packrat_parser_rep::highlight (C sym, C pos) {
   }
 
   if (sym >= PACKRAT_TM_OPEN) {
-    array<C> inst= grammar [sym];
-    //cout << "Parse " << inst << " at " << pos << LF;
+    int n;
+    C*  inst= instruction (sym, n);
     switch (inst[0]) {
     case PACKRAT_OR:
-      for (int i=1; i<N(inst); i++)
+      for (int i=1; i<n; i++)
         if (parse (inst[i], pos) != PACKRAT_FAILED) {
           highlight (inst[i], pos);
           break;
         }
       break;
     case PACKRAT_CONCAT:
-      for (int i=1; i<N(inst); i++) {
+      for (int i=1; i<n; i++) {
         next= parse (inst[i], pos);
         highlight (inst[i], pos);
         pos= next;
@@ -16,6 +16,13 @@
 #define PACKRAT_UNDEFINED ((C) (-2))
 #define PACKRAT_FAILED    ((C) (-1))
 
+struct packrat_memo {
+  int id;     // identifier of the position, or -1 for an empty slot
+  C   sym;    // the parsed symbol
+  C   im;     // end of the match relative to the position, or failure
+  C   reach;  // end of the examined input relative to the position
+};
+
 class packrat_parser_rep: concrete_struct {
 public:
   string                    lan_name;
@@ -23,6 +30,11 @@ public:
   hashmap<C,array<C> >      grammar;
   hashmap<C,tree>           productions;
   hashmap<D,string>         properties;
+  array<C>                  code;
+  array<int>                code_pos;
+  array<int>                first_pos;
+  array<unsigned int>       first_tokens;
+  int                       nr_firsts;
 
   tree                      current_tree;
   string                    current_string;
@@ -34,8 +46,19 @@ public:
   int                       current_hl_lan;
 
   array<C>                  current_input;
-  hashmap<D,C>              current_cache;
+  array<int>                current_offsets;
+  array<packrat_memo>       current_memo;
+  int                       current_entries;
   hashmap<D,tree>           current_production;
+  array<int>                current_ids;
+  array<C>                  current_extents;
+  int                       last_id;
+  int                       current_dropped;
+  C                         current_examined;
+
+  int                       grammar_stamp;
+  tree                      input_copy;
+  path                      input_pos;
 
 protected:
   void serialize_atomic (tree t, path p);
@@ -43,11 +66,19 @@ protected:
   void serialize (tree t, path p);
   void set_input (tree t);
   void set_cursor (path t_pos);
+  void forget (C pos);
+  void forget_around (C pos);
+  void update_cache (array<C> old_input, C old_cursor);
   path decode_path (tree t, path p, int pos);
   int  encode_path (tree t, path p, path pos);
+  void examine (C pos);
+  C*   instruction (C sym, int& n);
+  int  memo_slot (C sym, int id);
+  void memo_resize (int size);
 
 public:
   packrat_parser_rep (packrat_grammar gr);
+  void update_input (tree t, path t_pos);
 
   int  decode_string_position (C pos);
   C    encode_string_position (int i);
@@ -79,7 +110,6 @@ CONCRETE_NULL_CODE (packrat_parser);
 inline packrat_parser::packrat_parser
   (packrat_grammar gr, tree t, path t_pos):
     rep (tm_new<packrat_parser_rep> (gr)) {
-      rep->set_input (t);
-      rep->set_cursor (t_pos); }
+      rep->update_input (t, t_pos); }
 
 #endif // PACKRAT_PARSER_H
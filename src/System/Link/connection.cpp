@@ -333,13 +333,16 @@ connection_retrieve (string name, string session) {
   connection con= connection (name * "-" * session);
   if (is_nil (con)) return "";
   tree doc (DOCUMENT);
+  bool idle= false;
   while (true) {
     con->forced_eval= true;
 #ifndef QTTEXMACS
-    perform_select ();
+    // sleep until the plug-in sends something instead of polling
+    perform_select (idle? 10: 0);
 #endif
     con->forced_eval= false;
     tree next= connection_read (name, session);
+    idle= (next == "");
     if (next == "");
     else if (is_document (next)) doc << A (next);
     else doc << next;
@@ -27,8 +27,11 @@
 //#undef PATTERN
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <sys/ioctl.h>
 #endif
 #if !defined(__APPLE__) && !defined(__FreeBSD__)
 #include <malloc.h>
@@ -175,6 +178,8 @@ pipe_link_rep::start () {
     close (pp_out [OUT]);
     err= pp_err [IN ];
     close (pp_err [OUT]);
+    fcntl (out, F_SETFL, fcntl (out, F_GETFL) | O_NONBLOCK);
+    fcntl (err, F_SETFL, fcntl (err, F_GETFL) | O_NONBLOCK);
 
     alive= true;
     snout = socket_notifier (out, &pipe_callback, this, NULL);
@@ -233,19 +238,56 @@ pipe_link_rep::write (string s, int channel) {
 #endif
 }
 
+#ifndef OS_MINGW
+static int
+read_available (int fd, string& buf) {
+  // Read all pending data directly behind the contents of buf
+  int n= N(buf), avail= 0;
+  if (ioctl (fd, FIONREAD, &avail) == -1 || avail <= 0) {
+    // nothing announced: either end of file, or no data after all
+    char c;
+    int r= ::read (fd, &c, 1);
+    if (r == 1) buf << c;
+    return r;
+  }
+  buf->resize (n + avail);
+  int r= ::read (fd, &(buf[n]), avail);
+  if (r != avail) buf->resize (n + max (r, 0));
+  return r;
+}
+
+static int
+drain (int fd, string& buf) {
+  // Returns 1 once all data has been read, 0 at end of file, -1 on errors
+  while (true) {
+    int n= N(buf);
+    int r= read_available (fd, buf);
+    if (r > 0) {
+      if (DEBUG_IO) debug_io << debug_io_string (buf (n, N(buf)));
+    }
+    else if (r == 0) return 0;
+    else if (errno == EINTR) continue;
+    else if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+    else return -1;
+  }
+}
+#endif
+
 void
 pipe_link_rep::feed (int channel) {
 #ifndef OS_MINGW
   if ((!alive) || ((channel != LINK_OUT) && (channel != LINK_ERR))) return;
   int r;
-  char tempout[1024];
-  if (channel == LINK_OUT) r = ::read (out, tempout, 1024);
-  else r = ::read (err, tempout, 1024);
+  if (channel == LINK_OUT) r= drain (out, outbuf);
+  else r= drain (err, errbuf);
   if (r == -1) {
     io_error << "Read failed for '" << cmd << "'\n";
     wait (NULL);
   }
   else if (r == 0) {
+    // collect the last words on the other channel before closing down
+    if (channel == LINK_OUT) drain (err, errbuf);
+    else drain (out, outbuf);
     if (-1 != killpg(pid,SIGTERM)) {
       sleep(2);
       killpg(pid,SIGKILL);
@@ -255,11 +297,6 @@ pipe_link_rep::feed (int channel) {
     remove_notifier (snout);      
     remove_notifier (snerr);      
   }
-  else {
-    if (DEBUG_IO) debug_io << debug_io_string (string (tempout, r));
-    if (channel == LINK_OUT) outbuf << string (tempout, r);
-    else errbuf << string (tempout, r);
-  }
 #endif
 }
 
@@ -290,18 +327,20 @@ void
 pipe_link_rep::listen (int msecs) {
   if (!alive) return;
   time_t wait_until= texmacs_time () + msecs;
-  while ((outbuf == "") && (errbuf == "")) {
+  while (alive && (outbuf == "") && (errbuf == "")) {
+    time_t left= wait_until - texmacs_time ();
+    if (left < 0) break;
     fd_set rfds;
     FD_ZERO (&rfds);
     FD_SET (out, &rfds);
     FD_SET (err, &rfds);
     struct timeval tv;
-    tv.tv_sec  = msecs / 1000;
-    tv.tv_usec = 1000 * (msecs % 1000);
+    tv.tv_sec  = left / 1000;
+    tv.tv_usec = 1000 * (left % 1000);
     int nr= select (max (out, err) + 1, &rfds, NULL, NULL, &tv);
-    if (nr != 0 && FD_ISSET (out, &rfds)) feed (LINK_OUT);
-    if (nr != 0 && FD_ISSET (err, &rfds)) feed (LINK_ERR);
-    if (texmacs_time () - wait_until > 0) break;
+    if (nr == -1 && errno != EINTR) break;
+    if (nr > 0 && FD_ISSET (out, &rfds)) feed (LINK_OUT);
+    if (nr > 0 && FD_ISSET (err, &rfds)) feed (LINK_ERR);
   }
 }
 
@@ -339,32 +378,13 @@ void pipe_callback (void *obj, void *info) {
 #ifndef OS_MINGW
   (void) info;
   pipe_link_rep* con= (pipe_link_rep*) obj;  
-  bool busy= true;
-  bool news= false;
-  while (busy) {
-    fd_set rfds;
-    FD_ZERO (&rfds);
-    int max_fd= max (con->err, con->out) + 1;
-    FD_SET (con->out, &rfds);
-    FD_SET (con->err, &rfds);
-  
-    struct timeval tv;
-    tv.tv_sec  = 0;
-    tv.tv_usec = 0;
-    select (max_fd, &rfds, NULL, NULL, &tv);
-
-    busy= false;
-    if (con->alive && FD_ISSET (con->out, &rfds)) {
-      //cout << "pipe_callback OUT" << LF;
-      con->feed (LINK_OUT);
-      busy= news= true;
-    }
-    if (con->alive && FD_ISSET (con->err, &rfds)) {
-      //cout << "pipe_callback ERR" << LF;
-      con->feed (LINK_ERR);
-      busy= news= true;
-    }
-  }
+  // both channels are drained, since the notifiers are edge triggered
+  int  nout= N(con->outbuf), nerr= N(con->errbuf);
+  bool was_alive= con->alive;
+  con->feed (LINK_OUT);
+  con->feed (LINK_ERR);
+  bool news= (N(con->outbuf) != nout || N(con->errbuf) != nerr ||
+              con->alive != was_alive);
   /* FIXME: find out the appropriate place to call the callback
      Currently, the callback is called in tm_server_rep::interpose_handler */
   if (!is_nil (con->feed_cmd) && news) {
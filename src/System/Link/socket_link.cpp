@@ -24,6 +24,7 @@
 #ifndef OS_MINGW
 #include <sys/wait.h>
 #include <sys/types.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netdb.h>
@@ -50,6 +51,13 @@ socket_link_rep::socket_link_rep (string host2, int port2, int type2, int fd):
   outbuf = "";
   alive  = (fd != -1);
   if (type == SOCKET_SERVER) {
+    // the notifier is edge triggered, so reads must never block
+#ifdef OS_MINGW
+    unsigned long flags = -1;
+    wsoc::ioctlsocket (io, FIONBIO, &flags);
+#else
+    fcntl (io, F_SETFL, fcntl (io, F_GETFL) | O_NONBLOCK);
+#endif
     sn = socket_notifier (io, &socket_callback, this, NULL);  
     add_notifier (sn);
     call ("server-add", object (io));
@@ -211,6 +219,15 @@ debug_io_string (string s) {
   return r;
 }
 
+static bool
+would_block () {
+#ifdef OS_MINGW
+  return wsoc::WSAGetLastError () == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
 static int
 send_all (int s, char *buf, int *len) {
 #ifdef OS_MINGW
@@ -222,6 +239,17 @@ send_all (int s, char *buf, int *len) {
 
   while (total < *len) {
     n= send (s, buf + total, bytes_left, 0);
+    if (n == -1 && would_block ()) {
+      // the socket is non blocking: wait until there is room again
+      fd_set wfds;
+      FD_ZERO (&wfds);
+      FD_SET (s, &wfds);
+      select (s+1, NULL, &wfds, NULL, NULL);
+      continue;
+    }
+#ifndef OS_MINGW
+    if (n == -1 && errno == EINTR) continue;
+#endif
     if (n == -1) break;
     total += n;
     bytes_left -= n;
@@ -243,27 +271,53 @@ socket_link_rep::write (string s, int channel) {
   }
 }
 
-void
-socket_link_rep::feed (int channel) {
+static int
+recv_available (int io, string& buf) {
+  // Receive all pending data directly behind the contents of buf
 #ifdef OS_MINGW
   using namespace wsoc;
+  unsigned long avail= 0;
+  if (ioctlsocket (io, FIONREAD, &avail) != 0) avail= 0;
+#else
+  int avail= 0;
+  if (ioctl (io, FIONREAD, &avail) == -1) avail= 0;
 #endif
+  if (avail <= 0) {
+    // nothing announced: either a hang up, or no data after all
+    char c;
+    int r= recv (io, &c, 1, 0);
+    if (r == 1) buf << c;
+    return r;
+  }
+  int n= N(buf), len= (int) avail;
+  buf->resize (n + len);
+  int r= recv (io, &(buf[n]), len, 0);
+  if (r != len) buf->resize (n + max (r, 0));
+  return r;
+}
+
+void
+socket_link_rep::feed (int channel) {
   if ((!alive) || (channel != LINK_OUT)) return;
-  char tempout[1024];
-  int r= recv (io, tempout, 1024, 0);
-  if (r <= 0) {
+  while (alive) {
+    int n= N(outbuf);
+    int r= recv_available (io, outbuf);
+    if (r > 0) {
+      if (DEBUG_IO) debug_io << debug_io_string (outbuf (n, N(outbuf)));
+#ifdef QT_CPU_FIX
+      tm_wake_up ();
+#endif
+      continue;
+    }
+    if (r == -1 && would_block ()) break;
+#ifndef OS_MINGW
+    if (r == -1 && errno == EINTR) continue;
+#endif
     if (r == 0) debug_io << host << ":" << port << "' hung up\n";
     else io_warning << "TeXmacs] read failed from '" << host
                     << ":" << port << "'\n";
     stop ();
   }
-  else if (r != 0) {
-    if (DEBUG_IO) debug_io << debug_io_string (string (tempout, r));
-    outbuf << string (tempout, r);
-#ifdef QT_CPU_FIX
-    tm_wake_up ();
-#endif
-  }
 }
 
 string&
@@ -342,27 +396,10 @@ socket_callback (void *obj, void* info) {
     io_warning << "invalid callback invocation of deleted socket link\n";
     return;
   }
-  bool busy= true;
-  bool news= false;
-  while (busy) {
-    fd_set rfds;
-    FD_ZERO (&rfds);
-    int max_fd= con->io + 1;
-    FD_SET (con->io, &rfds);
-  
-    struct timeval tv;
-    tv.tv_sec  = 0;
-    tv.tv_usec = 0;
-    select (max_fd, &rfds, NULL, NULL, &tv);
-
-    busy= false;
-    if (con->alive && FD_ISSET (con->io, &rfds)) {
-      //cout << "socket_callback OUT" << LF;
-      con->feed (LINK_OUT);
-      busy= news= true;
-      if (!con->alive) break;
-    }
-  }
+  // the notifier is edge triggered, so the socket is drained completely
+  int  n= N(con->outbuf);
+  con->feed (LINK_OUT);
+  bool news= (N(con->outbuf) != n || !con->alive);
   if (!is_nil (con->feed_cmd) && news)
     con->feed_cmd->apply ();
 }
@@ -22,11 +22,14 @@
 #include <netdb.h>
 #endif
 #include <errno.h>
-
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 
 #include "socket_notifier.hpp"
 #include "list.hpp"
 #include "iterator.hpp"
+#include "hashmap.hpp"
 
 static hashset<socket_notifier> notifiers;
 
@@ -35,6 +38,75 @@ socket_notifier_rep::notify () {
   if (!is_nil (cmd)) cmd->apply ();
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+
+/******************************************************************************
+* Edge triggered event loop
+******************************************************************************/
+
+// NOTE: readiness is only reported when new data arrives, so callbacks
+// are required to drain their file descriptors until EAGAIN.
+
+#define MAX_EVENTS 64
+
+static int epoll_fd= -1;
+static hashmap<int,socket_notifier> watched;
+
+static bool
+epoll_ready () {
+  if (epoll_fd == -1) epoll_fd= epoll_create1 (EPOLL_CLOEXEC);
+  return epoll_fd != -1;
+}
+
+void
+add_notifier (socket_notifier sn)  {
+  notifiers->insert (sn);
+  if (!epoll_ready ()) return;
+  struct epoll_event ev;
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.fd= sn->fd;
+  if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, sn->fd, &ev) == -1 &&
+      errno == EEXIST)
+    epoll_ctl (epoll_fd, EPOLL_CTL_MOD, sn->fd, &ev);
+  watched (sn->fd)= sn;
+}
+
+void
+remove_notifier (socket_notifier sn)  {
+  notifiers->remove (sn);
+  if (is_nil (sn) || !watched->contains (sn->fd)) return;
+  if (!(watched [sn->fd] == sn)) return;
+  watched->reset (sn->fd);
+  // fails harmlessly if the descriptor has already been closed
+  epoll_ctl (epoll_fd, EPOLL_CTL_DEL, sn->fd, NULL);
+}
+
+void
+perform_select (int msecs) {
+  if (N(notifiers) == 0 || !epoll_ready ()) return;
+  struct epoll_event events[MAX_EVENTS];
+  int timeout= max (msecs, 0);
+  while (true) {
+    int nr= epoll_wait (epoll_fd, events, MAX_EVENTS, timeout);
+    if (nr == -1 && errno == EINTR) continue;
+    if (nr <= 0) break;
+    for (int i=0; i<nr; i++) {
+      // callbacks may remove notifiers which are still in this batch
+      if (!watched->contains (events[i].data.fd)) continue;
+      socket_notifier sn= watched [events[i].data.fd];
+      sn->notify ();
+    }
+    if (nr < MAX_EVENTS) break;
+    timeout= 0;
+  }
+}
+
+#else
+
+/******************************************************************************
+* Polling event loop
+******************************************************************************/
+
 void
 add_notifier (socket_notifier sn)  {
   //cout << "enable notifier " << LF;
@@ -48,9 +120,9 @@ remove_notifier (socket_notifier sn)  {
 }
 
 void 
-perform_select () {
+perform_select (int msecs) {
 #ifndef OS_MINGW
-  //FIXME: this can be optimizied
+  int timeout= max (msecs, 0);
   while (true) {
     fd_set rfds;
     FD_ZERO (&rfds);
@@ -64,10 +136,15 @@ perform_select () {
     if (max_fd == 0) break;
     
     struct timeval tv;
-    tv.tv_sec  = 0;
-    tv.tv_usec = 0;
+    tv.tv_sec  = timeout / 1000;
+    tv.tv_usec = 1000 * (timeout % 1000);
     int nr = select (max_fd, &rfds, NULL, NULL, &tv);
     if (nr==0) break;
+    if (nr==-1) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    timeout= 0;
     
     it = iterate (notifiers);
     while (it->busy ()) {
@@ -75,6 +152,10 @@ perform_select () {
       if (FD_ISSET (sn->fd, &rfds)) sn->notify ();
     }
   }  
+#else
+  (void) msecs;
 #endif  
 }
+
+#endif
 #endif
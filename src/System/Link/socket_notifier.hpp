@@ -43,7 +43,7 @@ inline tm_ostream& operator << (tm_ostream& out, socket_notifier sn) {
 else return out << "some socket_notifier"; }
 
 
-void perform_select ();
+void perform_select (int msecs= 0);
 void add_notifier (socket_notifier);
 void remove_notifier (socket_notifier);
 
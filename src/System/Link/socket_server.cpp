@@ -17,6 +17,8 @@
 #include <string.h>
 #ifndef OS_MINGW
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -135,6 +137,15 @@ socket_server_rep::start () {
 #endif
     return "Error: call to 'listen' failed";
 
+  // the notifier is edge triggered, so 'accept' must never block
+#ifdef OS_MINGW
+  unsigned long flags = -1;
+  if (ioctlsocket (server, FIONBIO, &flags) == SOCKET_ERROR)
+#else
+  if (fcntl (server, F_SETFL, fcntl (server, F_GETFL) | O_NONBLOCK) == -1)
+#endif
+    return "Error: call to 'fcntl' failed";
+
   alive= true;
   
   sn = socket_notifier (server, &socket_server_callback, this, NULL);
@@ -144,7 +155,7 @@ socket_server_rep::start () {
 
 }
 
-void
+bool
 socket_server_rep::start_client () {
 #ifdef OS_MINGW
   using namespace wsoc;
@@ -152,7 +163,15 @@ socket_server_rep::start_client () {
   struct sockaddr_in remote_address;
   socklen_t addrlen= sizeof (remote_address);
   int client= accept (server, (struct sockaddr *) &remote_address, &addrlen);
-  if (client == -1) io_warning << "Call to 'accept' failed\n";
+  if (client == -1) {
+#ifdef OS_MINGW
+    if (WSAGetLastError () != WSAEWOULDBLOCK)
+#else
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+#endif
+      io_warning << "Call to 'accept' failed\n";
+    return false;
+  }
   else {
     string addr= inet_ntoa (remote_address.sin_addr);
     debug_io << "Opened connection from '" << addr << "'\n";
@@ -163,6 +182,7 @@ socket_server_rep::start_client () {
     incoming= update;
     tm_link new_ln= make_socket_link (addr, -1, SOCKET_SERVER, client);
     incoming << new_ln;
+    return true;
   }
 }
 
@@ -222,26 +242,9 @@ socket_server_callback (void *obj, void *info) {
 #endif
   (void) info;
   socket_server_rep* ss = (socket_server_rep*) obj;
-  bool busy= true;
+  // accept all pending connections, since the notifier is edge triggered
   bool news= false;
-  while (busy) {
-    fd_set rfds;
-    FD_ZERO (&rfds);
-    int max_fd= ss->server + 1;
-    FD_SET (ss->server, &rfds);
-  
-    struct timeval tv;
-    tv.tv_sec  = 0;
-    tv.tv_usec = 0;
-    select (max_fd, &rfds, NULL, NULL, &tv);
-
-    busy= false;
-    if (ss->alive && FD_ISSET (ss->server, &rfds)) {
-      //cout << "server_callback" << LF;
-      ss->start_client ();
-      busy= news= true;
-    }
-  }
+  while (ss->alive && ss->start_client ()) news= true;
   
   if (!is_nil (ss->feed_cmd) && news)
     ss->feed_cmd->apply (); // call the data processor
@@ -38,7 +38,7 @@ public:
   void    interrupt ();
   void    stop ();
 
-  void    start_client ();
+  bool    start_client ();
 };
 
 #endif // SOCKET_SERVER_H
@@ -0,0 +1,622 @@
+/******************************************************************************
+* MODULE     : worker_server.cpp
+* DESCRIPTION: Servers which handle requests in a pool of worker processes
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "worker_server.hpp"
+#include "hashmap.hpp"
+
+#ifndef OS_MINGW
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#define WORKER_READ_SIZE 65536
+
+/******************************************************************************
+* Clients and workers
+******************************************************************************/
+
+struct worker_client_rep {
+  int    id;                  // identifier, file descriptors are reused
+  int    fd;                  // socket, or -1 once closed
+  string in;                  // incoming data which has not been framed yet
+  string out;                 // replies which have not been sent yet
+  int    next;                // rank of the next request
+  int    flushed;             // rank of the next reply to be sent
+  hashmap<int,string> ready;  // replies waiting for earlier replies
+  bool   closing;             // the client will not send any more requests
+
+  worker_client_rep (int id2, int fd2):
+    id (id2), fd (fd2), in (""), out (""), next (0), flushed (0),
+    ready (""), closing (false) {}
+};
+
+struct worker_process_rep {
+  int        pid;             // process identifier, or -1 if not running
+  int        fd;              // socket to the worker process
+  string     in;              // incoming part of the reply
+  bool       busy;            // whether the worker handles a request
+  worker_job job;             // the request being handled
+  time_t     started;         // time when the worker received the request
+
+  worker_process_rep ():
+    pid (-1), fd (-1), in (""), busy (false), started (0) {}
+};
+
+/******************************************************************************
+* Low level routines
+******************************************************************************/
+
+static string
+as_packet (string s) {
+  return (as_string (N(s)) * "\n") * s;
+}
+
+static int
+next_packet (string s, int& pos, string& packet) {
+  // Returns 1 if a packet was read, 0 if it is incomplete and -1 on errors
+  int i, n= N(s), len= 0;
+  for (i=pos; i<n && s[i] != '\n'; i++) {
+    if (s[i] < '0' || s[i] > '9' || i - pos >= 9) return -1;
+    len= 10 * len + (s[i] - '0');
+  }
+  if (i == n) return 0;
+  if (i == pos) return -1;
+  if (n - (i+1) < len) return 0;
+  packet= s (i+1, i+1+len);
+  pos= i+1+len;
+  return 1;
+}
+
+#ifndef OS_MINGW
+static void
+set_non_blocking (int fd) {
+  fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK);
+  fcntl (fd, F_SETFD, FD_CLOEXEC);
+}
+
+static int
+read_available (int fd, string& buf) {
+  // Returns 0 at end of file, -1 on errors and 1 otherwise
+  char tmp[WORKER_READ_SIZE];
+  while (true) {
+    int r= ::read (fd, tmp, WORKER_READ_SIZE);
+    if (r > 0) buf << string (tmp, r);
+    else if (r == 0) return 0;
+    else if (errno == EINTR) continue;
+    else if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+    else return -1;
+  }
+}
+
+static bool
+write_all (int fd, string s) {
+  int done= 0, n= N(s);
+  while (done < n) {
+    int r= ::write (fd, &(s[done]), n - done);
+    if (r > 0) done += r;
+    else if (r == -1 && errno == EINTR) continue;
+    else if (r == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      struct pollfd p;
+      p.fd= fd;
+      p.events= POLLOUT;
+      p.revents= 0;
+      poll (&p, 1, -1);
+    }
+    else return false;
+  }
+  return true;
+}
+
+#endif
+
+/******************************************************************************
+* Answering requests inside the workers
+******************************************************************************/
+
+void
+worker_main (int fd, worker_handler handler) {
+#ifndef OS_MINGW
+  string buf= "";
+  int pos= 0;
+  while (true) {
+    string request;
+    int status= next_packet (buf, pos, request);
+    if (status < 0) return;
+    if (status > 0) {
+      if (!write_all (fd, as_packet (handler (request)))) return;
+      continue;
+    }
+    buf= buf (pos, N(buf));
+    pos= 0;
+    char tmp[WORKER_READ_SIZE];
+    int r= ::read (fd, tmp, WORKER_READ_SIZE);
+    if (r == -1 && errno == EINTR) continue;
+    if (r <= 0) return;
+    buf << string (tmp, r);
+  }
+#else
+  (void) fd; (void) handler;
+#endif
+}
+
+/******************************************************************************
+* Constructors and destructors
+******************************************************************************/
+
+worker_server_rep::worker_server_rep (worker_handler h, int nr_workers,
+                                      int msecs):
+  handler (h), server (-1), port (-1), last_id (0), head (0),
+  timeout (max (msecs, 0)), received (0), served (0), failed (0),
+  timed_out (0), handled (0), max_queue (0),
+  wait_time (0.0), work_time (0.0), max_latency (0)
+{
+  for (int k=0; k<max (nr_workers, 1); k++)
+    workers << tm_new<worker_process_rep> ();
+}
+
+worker_server_rep::worker_server_rep (array<string> cmd, int nr_workers,
+                                      int msecs):
+  handler (NULL), command (cmd), server (-1), port (-1), last_id (0),
+  head (0), timeout (max (msecs, 0)), received (0), served (0), failed (0),
+  timed_out (0), handled (0), max_queue (0),
+  wait_time (0.0), work_time (0.0), max_latency (0)
+{
+  for (int k=0; k<max (nr_workers, 1); k++)
+    workers << tm_new<worker_process_rep> ();
+}
+
+worker_server_rep::~worker_server_rep () {
+  stop ();
+  cleanup ();
+  for (int k=0; k<N(workers); k++)
+    tm_delete (workers[k]);
+}
+
+string
+worker_server_rep::start (int port2, string address) {
+#ifndef OS_MINGW
+  if (server != -1) return "busy";
+  struct sockaddr_in local_address;
+  memset (&local_address, 0, sizeof (local_address));
+  local_address.sin_family = AF_INET;
+  local_address.sin_port = htons (port2);
+  if (address == "")
+    local_address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  else {
+    c_string _address (address);
+    if (inet_pton (AF_INET, _address, &local_address.sin_addr) != 1)
+      return "Error: invalid address " * address;
+  }
+  signal (SIGPIPE, SIG_IGN);
+  server= socket (AF_INET, SOCK_STREAM, 0);
+  if (server == -1) return "Error: call to 'socket' failed";
+  int yes= 1;
+  setsockopt (server, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof (int));
+  socklen_t len= sizeof (local_address);
+  if (bind (server, (struct sockaddr*) &local_address, len) == -1 ||
+      ::listen (server, 64) == -1 ||
+      getsockname (server, (struct sockaddr*) &local_address, &len) == -1) {
+    close (server);
+    server= -1;
+    return "Error: could not listen on port " * as_string (port2);
+  }
+  port= ntohs (local_address.sin_port);
+  set_non_blocking (server);
+  for (int k=0; k<N(workers); k++)
+    if (!spawn (workers[k])) {
+      stop ();
+      return "Error: could not start worker processes";
+    }
+  return "ok";
+#else
+  (void) port2;
+  return "Error: worker servers are not implemented";
+#endif
+}
+
+void
+worker_server_rep::stop () {
+#ifndef OS_MINGW
+  if (server != -1) close (server);
+  server= -1;
+  for (int k=0; k<N(workers); k++) {
+    worker_process_rep* w= workers[k];
+    if (w->pid == -1) continue;
+    close (w->fd);
+    kill (w->pid, SIGTERM);
+    waitpid (w->pid, NULL, 0);
+    w->pid= w->fd= -1;
+    w->busy= false;
+  }
+  for (int i=0; i<N(clients); i++)
+    close_client (clients[i]);
+  queue= array<worker_job> ();
+  head= 0;
+#endif
+}
+
+/******************************************************************************
+* Workers
+******************************************************************************/
+
+bool
+worker_server_rep::spawn (worker_process_rep* w) {
+#ifndef OS_MINGW
+  int fds[2];
+  if (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) == -1) return false;
+  fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+  // the arguments are prepared before forking, since the child process
+  // of a program with several threads should only call exec
+  int i, n= N(command);
+  char** argv= NULL;
+  if (n > 0) {
+    argv= tm_new_array<char*> (n + 2);
+    for (i=0; i<n; i++) argv[i]= as_charp (command[i]);
+    argv[n]= as_charp (as_string (fds[1]));
+    argv[n+1]= NULL;
+  }
+  pid_t pid= fork ();
+  if (pid == 0 && n > 0) {
+    signal (SIGINT, SIG_IGN);
+    execv (argv[0], argv);
+    _exit (127);
+  }
+  if (n > 0) {
+    for (i=0; i<=n; i++) tm_delete_array (argv[i]);
+    tm_delete_array (argv);
+  }
+  if (pid < 0) {
+    close (fds[0]);
+    close (fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // the worker only talks to the server
+    signal (SIGSEGV, SIG_DFL);
+    signal (SIGTERM, SIG_DFL);
+    signal (SIGINT, SIG_IGN);
+    close (fds[0]);
+    if (server != -1) close (server);
+    for (i=0; i<N(clients); i++)
+      if (clients[i]->fd != -1) close (clients[i]->fd);
+    for (int k=0; k<N(workers); k++)
+      if (workers[k]->fd != -1) close (workers[k]->fd);
+    srandom ((unsigned int) getpid ());
+    worker_main (fds[1], handler);
+    _exit (0);
+  }
+  close (fds[1]);
+  set_non_blocking (fds[0]);
+  w->pid = (int) pid;
+  w->fd  = fds[0];
+  w->in  = "";
+  w->busy= false;
+  return true;
+#else
+  (void) w;
+  return false;
+#endif
+}
+
+void
+worker_server_rep::worker_died (worker_process_rep* w, string why) {
+#ifndef OS_MINGW
+  close (w->fd);
+  if (waitpid (w->pid, NULL, WNOHANG) == 0) {
+    kill (w->pid, SIGKILL);
+    waitpid (w->pid, NULL, 0);
+  }
+  w->pid= w->fd= -1;
+  if (w->busy) {
+    // a new worker is spawned by the next dispatch
+    failed++;
+    reply (w->job.client, w->job.seq, "error\n" * why);
+    w->busy= false;
+    w->job = worker_job ();
+  }
+#endif
+}
+
+void
+worker_server_rep::receive (worker_process_rep* w) {
+#ifndef OS_MINGW
+  int status= read_available (w->fd, w->in);
+  int pos= 0;
+  string answer;
+  if (w->busy && next_packet (w->in, pos, answer) > 0) {
+    time_t now= texmacs_time ();
+    handled++;
+    wait_time  += (double) (w->started - w->job.queued);
+    work_time  += (double) (now - w->started);
+    if (now - w->job.queued > max_latency) max_latency= now - w->job.queued;
+    if (N(answer) >= 3 && answer (0, 3) == "ok\n") served++;
+    else failed++;
+    reply (w->job.client, w->job.seq, answer);
+    w->in  = w->in (pos, N(w->in));
+    w->busy= false;
+    w->job = worker_job ();
+  }
+  if (status <= 0) worker_died (w);
+#else
+  (void) w;
+#endif
+}
+
+int
+worker_server_rep::check_timeouts () {
+  // Kills the workers whose request takes too long; a new worker is spawned
+  // by the next dispatch. Returns the time until the next timeout or -1
+  if (timeout == 0) return -1;
+  int left= -1;
+  time_t now= texmacs_time ();
+  for (int k=0; k<N(workers); k++) {
+    worker_process_rep* w= workers[k];
+    if (w->pid == -1 || !w->busy) continue;
+    time_t elapsed= now - w->started;
+    if (elapsed >= timeout) {
+      timed_out++;
+#ifndef OS_MINGW
+      kill (w->pid, SIGKILL);
+#endif
+      worker_died (w, "the request timed out");
+    }
+    else if (left == -1 || timeout - elapsed < left)
+      left= (int) (timeout - elapsed);
+  }
+  return left;
+}
+
+void
+worker_server_rep::dispatch () {
+  for (int k=0; k<N(workers) && head < N(queue); k++) {
+    worker_process_rep* w= workers[k];
+    if (w->busy) continue;
+    if (w->pid == -1 && !spawn (w)) continue;
+    while (head < N(queue) && find_client (queue[head].client) == NULL)
+      queue[head++]= worker_job ();
+    if (head == N(queue)) break;
+    w->job= queue[head];
+    queue[head++]= worker_job ();
+    w->busy= true;
+    w->started= texmacs_time ();
+#ifndef OS_MINGW
+    if (!write_all (w->fd, as_packet (w->job.request))) worker_died (w);
+#endif
+  }
+  if (head == N(queue)) {
+    queue= array<worker_job> ();
+    head= 0;
+  }
+  else if (head >= 1024 && 2 * head >= N(queue)) {
+    queue= range (queue, head, N(queue));
+    head= 0;
+  }
+}
+
+int
+worker_server_rep::pending () {
+  return N(queue) - head;
+}
+
+/******************************************************************************
+* Clients
+******************************************************************************/
+
+worker_client_rep*
+worker_server_rep::find_client (int id) {
+  for (int i=0; i<N(clients); i++)
+    if (clients[i]->id == id && clients[i]->fd != -1) return clients[i];
+  return NULL;
+}
+
+void
+worker_server_rep::accept_clients () {
+#ifndef OS_MINGW
+  while (server != -1) {
+    int fd= accept (server, NULL, NULL);
+    if (fd == -1) {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        io_warning << "Call to 'accept' failed\n";
+      break;
+    }
+    set_non_blocking (fd);
+    clients << tm_new<worker_client_rep> (++last_id, fd);
+  }
+#endif
+}
+
+void
+worker_server_rep::close_client (worker_client_rep* c) {
+  // the client is only deleted by cleanup, since it may still be referred to
+#ifndef OS_MINGW
+  if (c->fd != -1) close (c->fd);
+#endif
+  c->fd= -1;
+}
+
+void
+worker_server_rep::cleanup () {
+  array<worker_client_rep*> alive;
+  for (int i=0; i<N(clients); i++) {
+    worker_client_rep* c= clients[i];
+    if (c->fd != -1 && c->closing && c->flushed == c->next && N(c->out) == 0)
+      close_client (c);
+    if (c->fd != -1) alive << c;
+    else tm_delete (c);
+  }
+  clients= alive;
+}
+
+void
+worker_server_rep::flush (worker_client_rep* c) {
+#ifndef OS_MINGW
+  int done= 0, n= N(c->out);
+  while (done < n && c->fd != -1) {
+    int r= ::write (c->fd, &(c->out[done]), n - done);
+    if (r > 0) done += r;
+    else if (r == -1 && errno == EINTR) continue;
+    else if (r == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    else close_client (c);
+  }
+  if (c->fd == -1) c->out= "";
+  else if (done > 0) c->out= c->out (done, n);
+#else
+  (void) c;
+#endif
+}
+
+void
+worker_server_rep::reply (int id, int seq, string answer) {
+  worker_client_rep* c= find_client (id);
+  if (c == NULL) return;
+  if (seq != c->flushed) {
+    c->ready (seq)= answer;
+    return;
+  }
+  c->out << as_packet (answer);
+  c->flushed++;
+  while (c->ready->contains (c->flushed)) {
+    c->out << as_packet (c->ready [c->flushed]);
+    c->ready->reset (c->flushed);
+    c->flushed++;
+  }
+  flush (c);
+}
+
+void
+worker_server_rep::receive (worker_client_rep* c) {
+#ifndef OS_MINGW
+  int status= read_available (c->fd, c->in);
+  if (status < 0) {
+    close_client (c);
+    return;
+  }
+  int pos= 0;
+  string request;
+  while (true) {
+    int r= next_packet (c->in, pos, request);
+    if (r == 0) break;
+    int seq= c->next++;
+    received++;
+    if (r < 0) {
+      // we can no longer find the start of the next request
+      failed++;
+      reply (c->id, seq, "error\nmalformed request");
+      c->closing= true;
+      pos= N(c->in);
+      break;
+    }
+    if (request == "statistics") {
+      reply (c->id, seq, statistics ());
+      served++;
+    }
+    else {
+      worker_job job;
+      job.client = c->id;
+      job.seq    = seq;
+      job.queued = texmacs_time ();
+      job.request= request;
+      queue << job;
+      max_queue= max (max_queue, pending ());
+    }
+  }
+  c->in= c->in (pos, N(c->in));
+  if (status == 0) c->closing= true;
+#else
+  (void) c;
+#endif
+}
+
+/******************************************************************************
+* Event loop
+******************************************************************************/
+
+void
+worker_server_rep::listen (int msecs) {
+#ifndef OS_MINGW
+  if (server == -1) return;
+  dispatch ();
+  int left= check_timeouts ();
+  if (left >= 0 && (msecs < 0 || left < msecs)) msecs= left;
+  int nw= N(workers), nc= N(clients), n= 1 + nw + nc;
+  struct pollfd* fds= tm_new_array<struct pollfd> (n);
+  fds[0].fd= server;
+  fds[0].events= POLLIN;
+  for (int k=0; k<nw; k++) {
+    fds[1+k].fd= workers[k]->fd;
+    fds[1+k].events= POLLIN;
+  }
+  array<worker_client_rep*> cs= copy (clients);
+  for (int i=0; i<nc; i++) {
+    fds[1+nw+i].fd= cs[i]->fd;
+    fds[1+nw+i].events= (cs[i]->closing? 0: POLLIN);
+    if (N(cs[i]->out) > 0) fds[1+nw+i].events |= POLLOUT;
+  }
+  for (int i=0; i<n; i++) fds[i].revents= 0;
+  int nr= poll (fds, n, msecs);
+  if (nr > 0) {
+    if (fds[0].revents & POLLIN) accept_clients ();
+    for (int k=0; k<nw; k++)
+      if (workers[k]->pid != -1 && fds[1+k].revents != 0)
+        receive (workers[k]);
+    for (int i=0; i<nc; i++) {
+      worker_client_rep* c= cs[i];
+      short ev= fds[1+nw+i].revents;
+      if (c->fd == -1 || ev == 0) continue;
+      if (ev & (POLLIN | POLLHUP)) receive (c);
+      if (c->fd != -1 && (ev & POLLERR)) close_client (c);
+      if (c->fd != -1 && N(c->out) > 0) flush (c);
+    }
+  }
+  tm_delete_array (fds);
+  check_timeouts ();
+  dispatch ();
+  cleanup ();
+#else
+  (void) msecs;
+#endif
+}
+
+/******************************************************************************
+* Statistics
+******************************************************************************/
+
+string
+worker_server_rep::statistics () {
+  int busy= 0;
+  for (int k=0; k<N(workers); k++)
+    if (workers[k]->busy) busy++;
+  string r= "ok\n";
+  r << "clients " << as_string (N(clients)) << "\n";
+  r << "workers " << as_string (N(workers)) << "\n";
+  r << "busy " << as_string (busy) << "\n";
+  r << "queue " << as_string (pending ()) << "\n";
+  r << "max-queue " << as_string (max_queue) << "\n";
+  r << "received " << as_string (received) << "\n";
+  r << "served " << as_string (served) << "\n";
+  r << "failed " << as_string (failed) << "\n";
+  r << "timed-out " << as_string (timed_out) << "\n";
+  r << "handled " << as_string (handled) << "\n";
+  double n= (double) max (handled, 1);
+  r << "mean-wait " << as_string (wait_time / n) << "\n";
+  r << "mean-work " << as_string (work_time / n) << "\n";
+  r << "max-latency " << as_string ((long int) max_latency) << "\n";
+  return r;
+}
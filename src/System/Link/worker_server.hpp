@@ -0,0 +1,98 @@
+/******************************************************************************
+* MODULE     : worker_server.hpp
+* DESCRIPTION: Servers which handle requests in a pool of worker processes
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef WORKER_SERVER_H
+#define WORKER_SERVER_H
+#include "string.hpp"
+#include "array.hpp"
+#include "tm_timer.hpp"
+
+/******************************************************************************
+* Requests and replies are exchanged as packets "<length>\n<data>", in the
+* same way as for tm_links. The server itself only frames and queues the
+* packets; each request is parsed and handled by a worker process, so that
+* slow or crashing requests neither block the server nor the other clients.
+* Workers are either forked from the server, which then calls the handler,
+* or separately executed programs, whose last argument is the descriptor of
+* the socket to the server, and which should answer through worker_main.
+* Servers with threads or an opened display must use the latter kind,
+* since only the forking thread survives in the child.
+* Replies to the requests of a client are sent back in the order of the
+* requests. Replies start with a line "ok" or "error", followed by the data.
+* The request "statistics" is answered by the server itself.
+* By default, the server only listens on the loopback interface, and
+* workers which exceed the timeout are killed and replaced.
+******************************************************************************/
+
+typedef string (*worker_handler) (string request);
+
+struct worker_client_rep;
+struct worker_process_rep;
+
+struct worker_job {
+  int    client;         // identifier of the requesting client
+  int    seq;            // rank of the request for this client
+  time_t queued;         // time when the request arrived
+  string request;
+};
+
+struct worker_server_rep {
+  worker_handler handler;             // handler of forked workers
+  array<string>  command;             // program of executed workers
+  int    server;                      // listening socket descriptor
+  int    port;                        // port of the listening socket
+  int    last_id;                     // identifier of the last client
+  array<worker_client_rep*>  clients;
+  array<worker_process_rep*> workers;
+  array<worker_job>          queue;   // requests waiting for a worker
+  int    head;                        // first pending request in queue
+  time_t timeout;                     // maximal time per request, or 0
+
+  int    received;                    // number of requests received
+  int    served;                      // number of successful replies
+  int    failed;                      // number of failed requests
+  int    timed_out;                   // number of interrupted requests
+  int    handled;                     // number of requests seen by workers
+  int    max_queue;                   // maximal number of pending requests
+  double wait_time;                   // total time spent in the queue
+  double work_time;                   // total time spent in the workers
+  time_t max_latency;                 // maximal total handling time
+
+public:
+  worker_server_rep (worker_handler h, int nr_workers, int msecs= 0);
+  worker_server_rep (array<string> cmd, int nr_workers, int msecs= 0);
+  ~worker_server_rep ();
+
+  string start (int port, string address= "");
+                                      // port 0 picks any free port and
+                                      // "" only accepts local clients
+  void   listen (int msecs);          // handle events during at most msecs
+  void   stop ();
+  int    pending ();
+  string statistics ();
+
+  worker_client_rep* find_client (int id);
+  void   accept_clients ();
+  void   receive (worker_client_rep* c);
+  void   flush (worker_client_rep* c);
+  void   close_client (worker_client_rep* c);
+  void   cleanup ();
+  void   reply (int id, int seq, string answer);
+  void   dispatch ();
+  bool   spawn (worker_process_rep* w);
+  void   receive (worker_process_rep* w);
+  void   worker_died (worker_process_rep* w,
+                      string why= "the worker process died");
+  int    check_timeouts ();
+};
+
+void worker_main (int fd, worker_handler handler);
+
+#endif // WORKER_SERVER_H
@@ -0,0 +1,311 @@
+/******************************************************************************
+* MODULE     : cache_store.cpp
+* DESCRIPTION: append-only logs for storing cached data on disk
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "cache_store.hpp"
+#include "file.hpp"
+#include "convert.hpp"
+#include "iterator.hpp"
+
+#define CACHE_STORE_MAGIC "TeXmacs cache log 1"
+#define CACHE_SET         1
+#define CACHE_RESET       2
+#define CACHE_DROP        3
+#define CACHE_MIN_GARBAGE 256
+
+/******************************************************************************
+* Marshalling and unmarshalling
+******************************************************************************/
+
+static void
+marshall_number (string& s, unsigned int i) {
+  if (i < 248) s << ((char) ((unsigned char) (i + 8)));
+  else {
+    int l= 0;
+    for (unsigned int j= i; j != 0; j >>= 8) l++;
+    s << ((char) l);
+    while (i != 0) {
+      s << ((char) ((unsigned char) (i & 0xff)));
+      i >>= 8;
+    }
+  }
+}
+
+static void
+marshall_string (string& s, string x) {
+  marshall_number (s, N(x));
+  s << x;
+}
+
+static void
+marshall_tree (string& s, tree t) {
+  if (is_atomic (t)) {
+    s << 'a';
+    marshall_string (s, t->label);
+  }
+  else {
+    s << 'c';
+    marshall_string (s, tree_to_scheme (t));
+  }
+}
+
+static bool
+unmarshall_number (string s, int& pos, int& r) {
+  if (pos >= N(s)) return false;
+  int n= (int) ((unsigned char) s[pos++]);
+  if (n >= 8) { r= n - 8; return true; }
+  if (n > 4 || pos + n > N(s)) return false;
+  unsigned int x= 0;
+  for (int k=0; k<n; k++)
+    x |= ((unsigned int) ((unsigned char) s[pos++])) << (8*k);
+  if (x > 0x7fffffff) return false;
+  r= (int) x;
+  return true;
+}
+
+static bool
+unmarshall_string (string s, int& pos, string& r) {
+  int n;
+  if (!unmarshall_number (s, pos, n) || n > N(s) - pos) return false;
+  r= s (pos, pos+n);
+  pos += n;
+  return true;
+}
+
+static bool
+unmarshall_tree (string s, int& pos, tree& t) {
+  if (pos >= N(s)) return false;
+  char c= s[pos++];
+  string r;
+  if (!unmarshall_string (s, pos, r)) return false;
+  if (c == 'a') t= tree (r);
+  else if (c == 'c') t= scheme_to_tree (r);
+  else return false;
+  return true;
+}
+
+static bool
+skip_tree (string s, int& pos) {
+  int n;
+  if (pos >= N(s) || (s[pos] != 'a' && s[pos] != 'c')) return false;
+  pos++;
+  if (!unmarshall_number (s, pos, n) || n > N(s) - pos) return false;
+  pos += n;
+  return true;
+}
+
+/******************************************************************************
+* Constructors and routines for directories
+******************************************************************************/
+
+cache_store_rep::cache_store_rep (url name2, int mode2):
+  name (name2), mode (mode2), loaded (false), fresh (false),
+  log (""), pending (""), garbage (0),
+  raw (-1), data ("?"), dirs (list<tree> ()) {}
+
+cache_store::cache_store (url name, int mode):
+  rep (tm_new<cache_store_rep> (name, mode)) {}
+
+string
+cache_store_rep::get_dir (tree key) {
+  if (mode == CACHE_NO_DIR || !is_atomic (key)) return "";
+  string s= key->label;
+  if (mode == CACHE_BY_KEY) return s;
+  int i= N(s) - 1;
+  while (i > 0 && s[i] != '/' && s[i] != '\\') i--;
+  if (i < 0 || (s[i] != '/' && s[i] != '\\')) return "";
+  return s (0, max (i, 1));
+}
+
+void
+cache_store_rep::attach (tree key) {
+  string dir= get_dir (key);
+  if (dir != "") dirs (dir)= list<tree> (key, dirs [dir]);
+}
+
+/******************************************************************************
+* Reading the log
+******************************************************************************/
+
+bool
+cache_store_rep::parse (string s) {
+  int pos= 0;
+  string magic;
+  if (!unmarshall_string (s, pos, magic) || magic != CACHE_STORE_MAGIC)
+    return false;
+  log= s;
+  while (pos < N(s)) {
+    int cmd= (int) ((unsigned char) s[pos++]);
+    tree key;
+    if (cmd == CACHE_SET) {
+      if (!unmarshall_tree (s, pos, key)) return false;
+      int start= pos;
+      if (!skip_tree (s, pos)) return false;
+      if (data->contains (key)) garbage++;
+      else {
+        if (raw->contains (key)) garbage++;
+        else attach (key);
+        raw (key)= start;
+      }
+    }
+    else if (cmd == CACHE_RESET) {
+      if (!unmarshall_tree (s, pos, key)) return false;
+      if (raw->contains (key)) {
+        raw->reset (key);
+        garbage++;
+      }
+      garbage++;
+    }
+    else if (cmd == CACHE_DROP) {
+      string dir;
+      if (!unmarshall_string (s, pos, dir)) return false;
+      for (list<tree> l= dirs [dir]; !is_nil (l); l= l->next)
+        if (raw->contains (l->item)) {
+          raw->reset (l->item);
+          garbage++;
+        }
+      garbage++;
+    }
+    else return false;
+  }
+  return true;
+}
+
+void
+cache_store_rep::load () {
+  if (loaded) return;
+  loaded= true;
+  string s;
+  if (is_none (name) || !exists (name) || load_string (name, s, false)) {
+    fresh= true;
+    return;
+  }
+  // NOTE: entries before a corrupted or truncated record are kept
+  if (!parse (s)) fresh= true;
+}
+
+/******************************************************************************
+* Writing the log
+******************************************************************************/
+
+string
+cache_store_rep::compact () {
+  string s;
+  marshall_string (s, CACHE_STORE_MAGIC);
+  hashmap<tree,int> new_raw (-1);
+  iterator<tree> it= iterate (raw);
+  while (it->busy ()) {
+    tree key= it->next ();
+    int start= raw [key], end= start;
+    (void) skip_tree (log, end);
+    s << ((char) CACHE_SET);
+    marshall_tree (s, key);
+    new_raw (key)= N(s);
+    s << log (start, end);
+  }
+  it= iterate (data);
+  while (it->busy ()) {
+    tree key= it->next ();
+    s << ((char) CACHE_SET);
+    marshall_tree (s, key);
+    marshall_tree (s, data [key]);
+  }
+  raw    = new_raw;
+  log    = s;
+  pending= "";
+  garbage= 0;
+  fresh  = false;
+  return s;
+}
+
+void
+cache_store_rep::save () {
+  if (is_none (name) || (!loaded && pending == "")) return;
+  load ();
+  if (fresh || garbage > max (N(raw) + N(data), CACHE_MIN_GARBAGE)) {
+    // Rewrite the log with the live entries only, using an atomic move
+    tm_ostream out= file_ostream (name);
+    out << compact ();
+    (void) out->close ();
+  }
+  else if (pending != "") {
+    string s= pending;
+    if (!exists (name)) {
+      string h;
+      marshall_string (h, CACHE_STORE_MAGIC);
+      s= h * s;
+    }
+    (void) append_string (name, s, false);
+  }
+  // NOTE: writing the log modifies the caches for its own directory;
+  // these changes are not saved, in order to avoid endless writing
+  pending= "";
+}
+
+/******************************************************************************
+* Accessing and modifying entries
+******************************************************************************/
+
+bool
+cache_store_rep::contains (tree key) {
+  return data->contains (key) || raw->contains (key);
+}
+
+tree
+cache_store_rep::get (tree key) {
+  if (data->contains (key)) return data [key];
+  if (!raw->contains (key)) return data [key];
+  int pos= raw [key];
+  tree t;
+  if (!unmarshall_tree (log, pos, t)) t= "?";
+  raw->reset (key);
+  data (key)= t;
+  return t;
+}
+
+void
+cache_store_rep::set (tree key, tree val) {
+  if (!contains (key)) attach (key);
+  else if (get (key) == val) return;
+  else garbage++;
+  data (key)= val;
+  pending << ((char) CACHE_SET);
+  marshall_tree (pending, key);
+  marshall_tree (pending, val);
+}
+
+void
+cache_store_rep::reset (tree key) {
+  load ();
+  if (!contains (key)) return;
+  data->reset (key);
+  raw->reset (key);
+  pending << ((char) CACHE_RESET);
+  marshall_tree (pending, key);
+  garbage += 2;
+}
+
+void
+cache_store_rep::drop (string dir) {
+  load ();
+  if (!dirs->contains (dir)) return;
+  bool found= false;
+  for (list<tree> l= dirs [dir]; !is_nil (l); l= l->next)
+    if (contains (l->item)) {
+      data->reset (l->item);
+      raw->reset (l->item);
+      garbage++;
+      found= true;
+    }
+  dirs->reset (dir);
+  if (!found) return;
+  pending << ((char) CACHE_DROP);
+  marshall_string (pending, dir);
+  garbage++;
+}
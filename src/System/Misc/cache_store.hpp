@@ -0,0 +1,64 @@
+/******************************************************************************
+* MODULE     : cache_store.hpp
+* DESCRIPTION: append-only logs for storing cached data on disk
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#ifndef CACHE_STORE_H
+#define CACHE_STORE_H
+#include "url.hpp"
+#include "hashmap.hpp"
+
+#define CACHE_NO_DIR     0  // entries are not attached to directories
+#define CACHE_BY_PARENT  1  // keys are files, attached to their directory
+#define CACHE_BY_KEY     2  // keys are directories
+
+/******************************************************************************
+* A cache store keeps the entries of a cache buffer in an append-only log.
+* Loading the log only builds an index from the keys to the positions of
+* their values, which are decoded when they are needed for the first time.
+* Modifications are appended to the log as small records, and the log is
+* only rewritten when most of its records have become obsolete. Entries may
+* be attached to directories, so that the entries for a modified directory
+* can be dropped without going through the other entries.
+******************************************************************************/
+
+class cache_store;
+struct cache_store_rep: concrete_struct {
+  url     name;                   // the log on disk
+  int     mode;                   // how entries are attached to directories
+  bool    loaded;                 // has the log been loaded?
+  bool    fresh;                  // should the log be rewritten entirely?
+  string  log;                    // the loaded contents of the log
+  string  pending;                // records which have not yet been saved
+  int     garbage;                // number of obsolete records
+  hashmap<tree,int>  raw;         // positions of values in the loaded log
+  hashmap<tree,tree> data;        // decoded or modified values
+  hashmap<string,list<tree> > dirs; // the keys attached to each directory
+
+  cache_store_rep (url name, int mode);
+  string get_dir (tree key);
+  void   attach (tree key);
+  bool   parse (string s);
+  string compact ();
+
+  void load ();
+  void save ();
+  bool contains (tree key);
+  tree get (tree key);
+  void set (tree key, tree val);
+  void reset (tree key);
+  void drop (string dir);
+};
+
+class cache_store {
+  CONCRETE_NULL(cache_store);
+  cache_store (url name, int mode= CACHE_NO_DIR);
+};
+CONCRETE_NULL_CODE(cache_store);
+
+#endif // defined CACHE_STORE_H
@@ -10,45 +10,59 @@
 ******************************************************************************/
 
 #include "data_cache.hpp"
+#include "cache_store.hpp"
 #include "file.hpp"
-#include "convert.hpp"
 #include "iterator.hpp"
 
 /******************************************************************************
 * Caching routines
 ******************************************************************************/
 
-static hashmap<tree,tree> cache_data ("?");
-static hashset<string> cache_loaded;
-static hashset<string> cache_changed;
+static hashmap<string,cache_store> cache_stores;
 static hashmap<string,bool> cache_valid (false);
+static url cache_file (string buffer);
+
+static int
+cache_mode (string buffer) {
+  if (buffer == "dir_cache.scm") return CACHE_BY_KEY;
+  if (buffer == "file_cache" || buffer == "doc_cache" ||
+      buffer == "stat_cache.scm") return CACHE_BY_PARENT;
+  return CACHE_NO_DIR;
+}
+
+static cache_store
+get_store (string buffer) {
+  if (!cache_stores->contains (buffer))
+    cache_stores (buffer)= cache_store (cache_file (buffer),
+                                        cache_mode (buffer));
+  return cache_stores [buffer];
+}
 
 void
 cache_set (string buffer, tree key, tree t) {
-  tree ckey= tuple (buffer, key);
-  if (cache_data[ckey] != t) {
-    cache_data (ckey)= t;
-    cache_changed->insert (buffer);
-  }
+  get_store (buffer)->set (key, t);
 }
 
 void
 cache_reset (string buffer, tree key) {
-  tree ckey= tuple (buffer, key);
-  cache_data->reset (ckey);
-  cache_changed->insert (buffer);
+  get_store (buffer)->reset (key);
 }
 
 bool
 is_cached (string buffer, tree key) {
-  tree ckey= tuple (buffer, key);
-  return cache_data->contains (ckey);
+  return get_store (buffer)->contains (key);
 }
 
 tree
 cache_get (string buffer, tree key) {
-  tree ckey= tuple (buffer, key);
-  return cache_data [ckey];
+  return get_store (buffer)->get (key);
+}
+
+static void
+cache_drop (string name_dir) {
+  iterator<string> it= iterate (cache_stores);
+  while (it->busy ())
+    cache_stores [it->next ()]->drop (name_dir);
 }
 
 bool
@@ -68,13 +82,9 @@ is_up_to_date (url dir) {
   //else cout << name_dir << " not up to date " << l << "\n";
   cache_set ("validate_cache.scm", name_dir, as_string (l));
   cache_valid (name_dir)= false;
-  // FIXME: we should explicitly remove all data concerning files in 'dir'
-  // from the various caches.  Indeed, at a next run of TeXmacs, the directory
-  // will be regarded as up to date, but the other caches may still contain
-  // outdated data.  Careful: invalidating the cache lines should not
-  // give rise to a performance penaly (e.g. go through all entries of
-  // 'cache_data', or reloading unchanged files many times).
-  // See also 'declare_out_of_date'.
+  // Remove the data concerning files in 'dir' from the other caches,
+  // since the directory will be regarded as up to date at the next run
+  cache_drop (name_dir);
   return false;
 }
 
@@ -99,7 +109,22 @@ declare_out_of_date (url dir) {
   int l= last_modified (dir, false);
   cache_set ("validate_cache.scm", name_dir, as_string (l));
   cache_valid (name_dir)= false;
-  // FIXME: see 'FIXME' in 'is_up_to_date'.
+  cache_drop (name_dir);
+}
+
+void
+declare_modified (url file) {
+  // Only the entries for 'file' and the listing of its directory become
+  // obsolete; the cached data of the other files in the directory is kept
+  string name= concretize (file);
+  string name_dir= concretize (url_parent (file));
+  int l= last_modified (url_parent (file), false);
+  cache_set ("validate_cache.scm", name_dir, as_string (l));
+  cache_valid (name_dir)= false;
+  cache_reset ("file_cache", name);
+  cache_reset ("doc_cache", name);
+  cache_reset ("stat_cache.scm", name);
+  cache_reset ("dir_cache.scm", name_dir);
 }
 
 /******************************************************************************
@@ -115,6 +140,12 @@ static string texmacs_doc_path_string;
 static string texmacs_home_path_string;
 static string texmacs_font_path_string;
 
+static url
+cache_file (string buffer) {
+  if (is_none (texmacs_home_path)) return url_none ();
+  return texmacs_home_path * url ("system/cache/" * buffer);
+}
+
 bool
 do_cache_dir (string name) {
   return
@@ -157,69 +188,13 @@ do_cache_doc (string name) {
 
 void
 cache_save (string buffer) {
-  if (cache_changed->contains (buffer)) {
-    url cache_file= texmacs_home_path * url ("system/cache/" * buffer);
-    string cached;
-    iterator<tree> it= iterate (cache_data);
-    if (buffer == "file_cache" || buffer == "doc_cache") {
-      while (it->busy ()) {
-        tree ckey= it->next ();
-        if (ckey[0] == buffer) {
-          cached << ckey[1]->label << "\n";
-          cached << cache_data [ckey]->label << "\n";
-          cached << "%-%-tm-cache-%-%\n";
-        }
-      }
-    }
-    else {
-      cached << "(tuple\n";
-      while (it->busy ()) {
-        tree ckey= it->next ();
-        if (ckey[0] == buffer) {
-          cached << tree_to_scheme (ckey[1]) << " ";
-          cached << tree_to_scheme (cache_data [ckey]) << "\n";
-        }
-      }
-      cached << ")";
-    }
-    (void) save_string (cache_file, cached);
-    cache_changed->remove (buffer);
-  }
+  if (cache_stores->contains (buffer))
+    cache_stores [buffer]->save ();
 }
 
 void
 cache_load (string buffer) {
-  if (!cache_loaded->contains (buffer)) {
-    url cache_file = texmacs_home_path * url ("system/cache/" * buffer);
-    //cout << "cache_file "<< cache_file << LF;
-    string cached;
-    if (!load_string (cache_file, cached, false)) {
-      if (buffer == "file_cache" || buffer == "doc_cache") {
-        int i=0, n= N(cached);
-        while (i<n) {
-          int start= i;
-          while (i<n && cached[i] != '\n') i++;
-          string key= cached (start, i);
-          i++; start= i;
-          while (i<n && (cached[i] != '\n' ||
-                         !test (cached, i+1, "%-%-tm-cache-%-%"))) i++;
-          string im= cached (start, i);
-          i++;
-          while (i<n && cached[i] != '\n') i++;
-          i++;
-          //cout << "key= " << key << "\n----------------------\n";
-          //cout << "im= " << im << "\n----------------------\n";
-          cache_data (tuple (buffer, key))= im;
-        }
-      }
-      else {
-        tree t= scheme_to_tree (cached);
-        for (int i=0; i<N(t)-1; i+=2)
-          cache_data (tuple (buffer, t[i]))= t[i+1];
-      }
-    }
-    cache_loaded->insert (buffer);
-  }
+  get_store (buffer)->load ();
 }
 
 void
@@ -234,9 +209,7 @@ cache_memorize () {
 
 void
 cache_refresh () {
-  cache_data   = hashmap<tree,tree> ("?");
-  cache_loaded = hashset<string> ();
-  cache_changed= hashset<string> ();
+  cache_stores= hashmap<string,cache_store> ();
   cache_load ("file_cache");
   cache_load ("dir_cache.scm");
   cache_load ("stat_cache.scm");
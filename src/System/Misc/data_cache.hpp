@@ -20,6 +20,7 @@ tree cache_get (string buffer, tree key);
 bool is_up_to_date (url dir);
 bool is_recursively_up_to_date (url dir);
 void declare_out_of_date (url dir);
+void declare_modified (url file);
 
 bool do_cache_dir (string name);
 bool do_cache_stat_fail (string name);
@@ -1,12 +1,14 @@
 
 /******************************************************************************
 * MODULE     : Fast memory allocation
-* DESCRIPTION: Fast allocations is realized by using a linked list
-*              of allocations for each fixed size divisible by
-*              a word legth up to MAX_FAST. Otherwise,
-*              usual memory allocation is used.
-* ASSUMPTIONS: The word size of the computer is 4.
-*              Otherwise, change WORD_LENGTH.
+* DESCRIPTION: Fast allocations is realized by using size classes
+*              for each fixed size divisible by a word length up to MAX_FAST.
+*              Each size class is fed from aligned slabs of BLOCK_SIZE bytes
+*              which are shared between all threads and given back to the
+*              operating system once they become empty.  Every thread
+*              keeps a small cache of free objects for each size class,
+*              so that the common case does not require any locking.
+*              Otherwise, usual memory allocation is used.
 * COPYRIGHT  : (C) 1999  Joris van der Hoeven
 *******************************************************************************
 * This software falls under the GNU general public license version 3 or later.
@@ -15,23 +17,96 @@
 ******************************************************************************/
 
 #include "fast_alloc.hpp"
+#include <atomic>
+#include <thread>
 
-void*   alloc_table[MAX_FAST]; // Static declaration initializes with NULL's
-char*  alloc_mem=NULL;
-#ifdef DEBUG_ON
-char*  alloc_mem_top=NULL;
-char*  alloc_mem_bottom=(char*)((unsigned long long)-1);
+#if defined(OS_MINGW)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <pthread.h>
 #endif
-size_t alloc_remains=0;
-int    allocated=0;
-int    fast_chunks=0;
-int    large_uses=0;
-int    MEM_DEBUG=0;
-int    mem_used ();
 
-/*****************************************************************************/
-// General purpose fast allocation routines
-/*****************************************************************************/
+#define FAST_CLASSES   ((MAX_FAST / WORD_LENGTH) + 1)
+#define CACHE_BYTES    32768 // maximal number of free bytes in a cache
+#define SLAB_RETAIN    64    // number of empty slabs kept for later reuse
+#define SLAB_MAGIC     0x51AB51AB
+#define LOCK_SPINS     64    // busy waiting rounds before yielding
+#define SLAB_HEADER    ((sizeof (fast_slab) + 63) & ~((size_t) 63))
+
+#define ind(ptr) (*((void **) ptr))
+#define slab_of(ptr) ((fast_slab*) (((size_t) (ptr)) & ~((size_t) (BLOCK_SIZE-1))))
+
+int MEM_DEBUG=0;
+
+/******************************************************************************
+* Data structures
+******************************************************************************/
+
+struct fast_slab {
+  int        magic;     // SLAB_MAGIC for sanity checks
+  int        sz;        // size of the objects in this slab
+  int        capacity;  // number of objects which fit into the slab
+  int        live;      // number of objects handed out to thread caches
+  void*      free_list; // objects which were given back to the slab
+  int        nr_free;   // number of objects in free_list
+  char*      bump;      // start of the never used part of the slab
+  char*      bump_end;  // end of the slab
+  fast_slab* next;      // next slab with available objects
+  fast_slab* prev;      // previous slab with available objects
+  bool       partial;   // whether the slab is in the list of its class
+};
+
+struct fast_class {
+  // the initializers make the construction of the classes constant,
+  // so that they can be used by the constructors of other static objects
+  std::atomic_flag lock= ATOMIC_FLAG_INIT;
+  fast_slab* partial= NULL;   // slabs with available objects
+  int        slabs= 0;        // number of slabs currently mapped
+  long       taken= 0;        // number of objects handed out to thread caches
+};
+
+struct fast_cache {
+  void* head;
+  int   count;
+  int   limit;      // number of objects above which the cache is flushed
+};
+
+struct fast_thread {
+  fast_cache   cache[FAST_CLASSES];
+  fast_thread* next;
+  bool         registered;
+  bool         exited;
+};
+
+static fast_class classes[FAST_CLASSES];
+static thread_local fast_thread tls;
+static fast_thread* threads= NULL;
+static std::atomic_flag threads_lock= ATOMIC_FLAG_INIT;
+static std::atomic<long> large_uses (0);
+static std::atomic<long> mapped_slabs (0);
+static fast_slab* empty_slabs= NULL;
+static int empty_count= 0;
+static std::atomic_flag empty_lock= ATOMIC_FLAG_INIT;
+
+static inline void
+lock (std::atomic_flag& l) {
+  int spins= 0;
+  while (l.test_and_set (std::memory_order_acquire))
+    if (++spins == LOCK_SPINS) {
+      std::this_thread::yield ();
+      spins= 0;
+    }
+}
+
+static inline void
+unlock (std::atomic_flag& l) {
+  l.clear (std::memory_order_release);
+}
+
+/******************************************************************************
+* Obtaining and releasing aligned slabs from the operating system
+******************************************************************************/
 
 void*
 safe_malloc (size_t sz) {
@@ -43,35 +118,331 @@ safe_malloc (size_t sz) {
   return ptr;
 }
 
-void*
-enlarge_malloc (size_t sz) {
-  if (alloc_remains<sz) {
-    alloc_mem    = (char *) safe_malloc (BLOCK_SIZE);
-    #ifdef DEBUG_ON
-    alloc_mem_top=alloc_mem_top>=alloc_mem+BLOCK_SIZE?alloc_mem_top:(alloc_mem +BLOCK_SIZE);
-    alloc_mem_bottom=alloc_mem_bottom>alloc_mem?alloc_mem:alloc_mem_bottom;
-    #endif
-    alloc_remains= BLOCK_SIZE;
-    fast_chunks++;
+static void
+out_of_memory () {
+  cerr << "Fatal error: out of memory\n";
+  abort ();
+}
+
+#if defined(OS_MINGW)
+
+static void*
+slab_map () {
+  void* ptr= _aligned_malloc (BLOCK_SIZE, BLOCK_SIZE);
+  if (ptr == NULL) out_of_memory ();
+  return ptr;
+}
+
+static void
+slab_unmap (void* ptr) {
+  _aligned_free (ptr);
+}
+
+#else
+
+static void*
+slab_map () {
+  // map twice the needed size and trim to obtain a BLOCK_SIZE alignment
+  size_t sz= 2 * BLOCK_SIZE;
+  char* ptr= (char*) mmap (NULL, sz, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANON, -1, 0);
+  if (ptr == (char*) MAP_FAILED) out_of_memory ();
+  char* start= (char*) ((((size_t) ptr) + BLOCK_SIZE - 1) &
+                        ~((size_t) (BLOCK_SIZE - 1)));
+  if (start > ptr) munmap (ptr, start - ptr);
+  if (start + BLOCK_SIZE < ptr + sz)
+    munmap (start + BLOCK_SIZE, (ptr + sz) - (start + BLOCK_SIZE));
+  return (void*) start;
+}
+
+static void
+slab_unmap (void* ptr) {
+  munmap (ptr, BLOCK_SIZE);
+}
+
+#endif
+
+static fast_slab*
+slab_new (int sz) {
+  // reuse a retained empty slab if possible and map a new one otherwise
+  lock (empty_lock);
+  fast_slab* slab= empty_slabs;
+  if (slab != NULL) {
+    empty_slabs= slab->next;
+    empty_count--;
+  }
+  unlock (empty_lock);
+  if (slab == NULL) {
+    slab= (fast_slab*) slab_map ();
+    mapped_slabs++;
   }
-  void* ptr= alloc_mem;
-  alloc_mem    += sz;
-  alloc_remains-= sz;
+  slab->magic    = SLAB_MAGIC;
+  slab->sz       = sz;
+  slab->capacity = (int) ((BLOCK_SIZE - SLAB_HEADER) / sz);
+  slab->live     = 0;
+  slab->free_list= NULL;
+  slab->nr_free  = 0;
+  slab->bump     = ((char*) slab) + SLAB_HEADER;
+  slab->bump_end = slab->bump + slab->capacity * sz;
+  slab->next     = NULL;
+  slab->prev     = NULL;
+  slab->partial  = false;
+  return slab;
+}
+
+static void
+slab_delete (fast_slab* slab) {
+  // retain a limited number of empty slabs for all size classes,
+  // so that alternating allocation and release does not thrash
+  slab->magic= 0;
+  lock (empty_lock);
+  if (empty_count < SLAB_RETAIN) {
+    slab->next= empty_slabs;
+    empty_slabs= slab;
+    empty_count++;
+    slab= NULL;
+  }
+  unlock (empty_lock);
+  if (slab != NULL) {
+    slab_unmap ((void*) slab);
+    mapped_slabs--;
+  }
+}
+
+/******************************************************************************
+* Central size classes (always called with the lock of the class held)
+******************************************************************************/
+
+static inline void
+partial_insert (fast_class& c, fast_slab* slab) {
+  slab->prev= NULL;
+  slab->next= c.partial;
+  if (c.partial != NULL) c.partial->prev= slab;
+  c.partial= slab;
+  slab->partial= true;
+}
+
+static inline void
+partial_remove (fast_class& c, fast_slab* slab) {
+  if (slab->prev != NULL) slab->prev->next= slab->next;
+  else c.partial= slab->next;
+  if (slab->next != NULL) slab->next->prev= slab->prev;
+  slab->next= slab->prev= NULL;
+  slab->partial= false;
+}
+
+static int
+class_take (fast_class& c, int sz, void*& head, int n) {
+  // move up to n objects from the slabs of the class to the list head
+  int got= 0;
+  while (got < n) {
+    fast_slab* slab= c.partial;
+    if (slab == NULL) {
+      slab= slab_new (sz);
+      c.slabs++;
+      partial_insert (c, slab);
+    }
+    if (head == NULL && slab->free_list != NULL) {
+      // splice the entire free list without touching the objects
+      head= slab->free_list;
+      got += slab->nr_free;
+      slab->live += slab->nr_free;
+      slab->free_list= NULL;
+      slab->nr_free= 0;
+    }
+    while (got < n && slab->free_list != NULL) {
+      void* ptr= slab->free_list;
+      slab->free_list= ind (ptr);
+      ind (ptr)= head; head= ptr;
+      slab->nr_free--;
+      slab->live++; got++;
+    }
+    while (got < n && slab->bump < slab->bump_end) {
+      void* ptr= (void*) slab->bump;
+      slab->bump += sz;
+      ind (ptr)= head; head= ptr;
+      slab->live++; got++;
+    }
+    if (slab->live == slab->capacity) partial_remove (c, slab);
+  }
+  c.taken += got;
+  return got;
+}
+
+static void
+class_give (fast_class& c, void* ptr) {
+  // give one object back to its slab and release the slab if it is empty
+  fast_slab* slab= slab_of (ptr);
+  ind (ptr)= slab->free_list;
+  slab->free_list= ptr;
+  slab->nr_free++;
+  slab->live--;
+  c.taken--;
+  if (!slab->partial) partial_insert (c, slab);
+  if (slab->live == 0) {
+    partial_remove (c, slab);
+    slab_delete (slab);
+    c.slabs--;
+  }
+}
+
+/******************************************************************************
+* Forking
+******************************************************************************/
+
+#if !defined(OS_MINGW)
+
+static void
+fork_prepare () {
+  // no other thread may hold a lock of the allocator when forking,
+  // since the child process would never see it released
+  lock (threads_lock);
+  for (int i=0; i<FAST_CLASSES; i++) lock (classes[i].lock);
+  lock (empty_lock);
+}
+
+static void
+fork_parent () {
+  unlock (empty_lock);
+  for (int i=FAST_CLASSES-1; i>=0; i--) unlock (classes[i].lock);
+  unlock (threads_lock);
+}
+
+static void
+fork_child () {
+  // only the forking thread survives; the objects in the caches
+  // of the other threads are lost for the child process
+  threads= NULL;
+  if (tls.registered) {
+    tls.next= NULL;
+    threads= &tls;
+  }
+  fork_parent ();
+}
+
+#endif
+
+static bool
+install_fork_handlers () {
+#if !defined(OS_MINGW)
+  pthread_atfork (fork_prepare, fork_parent, fork_child);
+#endif
+  return true;
+}
+
+/******************************************************************************
+* Thread caches
+******************************************************************************/
+
+static void thread_register ();
+
+static inline int
+cache_limit (size_t sz) {
+  int n= (int) (CACHE_BYTES / sz);
+  return n < 64? 64: n;
+}
+
+static void*
+cache_refill (size_t sz) {
+  if (!tls.registered && !tls.exited) thread_register ();
+  int i= (int) (sz / WORD_LENGTH);
+  fast_cache& tc= tls.cache[i];
+  fast_class& c = classes[i];
+  if (tc.limit == 0) tc.limit= cache_limit (sz);
+  lock (c.lock);
+  tc.count += class_take (c, (int) sz, tc.head, tc.limit >> 2);
+  unlock (c.lock);
+  void* ptr= tc.head;
+  tc.head= ind (ptr);
+  tc.count--;
+  return ptr;
+}
+
+static void
+cache_flush (size_t sz, int n) {
+  int i= (int) (sz / WORD_LENGTH);
+  fast_cache& tc= tls.cache[i];
+  fast_class& c = classes[i];
+  lock (c.lock);
+  while (n > 0 && tc.head != NULL) {
+    void* ptr= tc.head;
+    tc.head= ind (ptr);
+    tc.count--; n--;
+    class_give (c, ptr);
+  }
+  unlock (c.lock);
+}
+
+static inline void*
+cache_alloc (size_t sz) {
+  if (sz == 0) sz= WORD_LENGTH;
+  fast_cache& tc= tls.cache[sz / WORD_LENGTH];
+  void* ptr= tc.head;
+  if (ptr == NULL) return cache_refill (sz);
+  tc.head= ind (ptr);
+  tc.count--;
+  #ifdef DEBUG_ON
+  break_stub (ptr);
+  #endif
   return ptr;
 }
 
+static inline void
+cache_free (void* ptr, size_t sz) {
+  if (sz == 0) sz= WORD_LENGTH;
+  #ifdef DEBUG_ON
+  break_stub (ptr);
+  #endif
+  fast_cache& tc= tls.cache[sz / WORD_LENGTH];
+  ind (ptr)= tc.head;
+  tc.head= ptr;
+  if (++tc.count > tc.limit) {
+    if (tc.limit == 0) tc.limit= cache_limit (sz);
+    if (tc.count > tc.limit) cache_flush (sz, tc.count - (tc.limit >> 1));
+  }
+}
+
+void
+fast_alloc_thread_exit () {
+  for (int i=1; i<FAST_CLASSES; i++)
+    if (tls.cache[i].count > 0)
+      cache_flush (i * WORD_LENGTH, tls.cache[i].count);
+  if (!tls.registered) return;
+  lock (threads_lock);
+  fast_thread** p= &threads;
+  while (*p != NULL && *p != &tls) p= &((*p)->next);
+  if (*p != NULL) *p= tls.next;
+  unlock (threads_lock);
+  tls.next= NULL;
+  tls.registered= false;
+}
+
+struct fast_thread_guard {
+  ~fast_thread_guard () { tls.exited= true; fast_alloc_thread_exit (); }
+};
+
+static void
+thread_register () {
+  // The guard has a non trivial destructor, so its construction is only
+  // triggered here on the slow path and not for each allocation
+  static thread_local fast_thread_guard guard;
+  static bool forking= install_fork_handlers ();
+  (void) guard; (void) forking;
+  lock (threads_lock);
+  tls.next= threads;
+  threads= &tls;
+  unlock (threads_lock);
+  tls.registered= true;
+}
+
+/******************************************************************************
+* General purpose fast allocation routines
+******************************************************************************/
+
 void*
 fast_alloc (size_t sz) {
   sz= (sz+WORD_LENGTH_INC)&WORD_MASK;
-  if (sz<MAX_FAST) {
-    void *ptr= alloc_ptr (sz);
-    if (ptr==NULL) return enlarge_malloc (sz);
-    alloc_ptr (sz)= ind (ptr);
-    #ifdef DEBUG_ON
-    break_stub(ptr);
-    #endif
-    return ptr;
-  }
+  if (sz<MAX_FAST) return cache_alloc (sz);
   else {
     if (MEM_DEBUG>=3) cout << "Big alloc of " << sz << " bytes\n";
     if (MEM_DEBUG>=3) cout << "Memory used: " << mem_used () << " bytes\n";
@@ -83,17 +454,10 @@ fast_alloc (size_t sz) {
 void
 fast_free (void* ptr, size_t sz) {
   sz=(sz+WORD_LENGTH_INC)&WORD_MASK;
-  if (sz<MAX_FAST) {
-    #ifdef DEBUG_ON
-    break_stub(ptr);
-    break_stub(alloc_ptr (sz));
-    #endif
-    ind (ptr)     = alloc_ptr (sz);
-    alloc_ptr (sz)= ptr;
-  }
+  if (sz<MAX_FAST) cache_free (ptr, sz);
   else {
     if (MEM_DEBUG>=3) cout << "Big free of " << sz << " bytes\n";
-    large_uses -= sz;    
+    large_uses -= sz;
     free (ptr);
     if (MEM_DEBUG>=3) cout << "Memory used: " << mem_used () << " bytes\n";
   }
@@ -107,14 +471,7 @@ fast_new (size_t s) {
   #else
   s= (s+ WORD_LENGTH+ WORD_LENGTH_INC)&WORD_MASK;
   #endif
-  if (s<MAX_FAST) {
-    ptr= alloc_ptr(s);
-    if (ptr==NULL) ptr= enlarge_malloc (s);
-    else alloc_ptr(s)= ind(ptr);
-    #ifdef DEBUG_ON
-    break_stub(ptr);
-    #endif
-  }
+  if (s<MAX_FAST) ptr= cache_alloc (s);
   else {
     if (MEM_DEBUG>=3) cout << "Big alloc of " << s << " bytes\n";
     if (MEM_DEBUG>=3) cout << "Memory used: " << mem_used () << " bytes\n";
@@ -168,14 +525,7 @@ fast_delete (void* ptr) {
   ptr= (void*) (((char*) ptr)- WORD_LENGTH);
   size_t s= *((size_t *) ptr);
   #endif
-  if (s<MAX_FAST) {
-    #ifdef DEBUG_ON
-    break_stub(ptr);
-    break_stub(alloc_ptr(s));
-    #endif
-    ind(ptr)    = alloc_ptr(s);
-    alloc_ptr(s)= ptr;
-  }
+  if (s<MAX_FAST) cache_free (ptr, s);
   else {
     if (MEM_DEBUG>=3) cout << "Big free of " << s << " bytes\n";
     //if ((((int) ptr) & 15) != 0) cout << "Unaligned delete " << ptr << "\n";
@@ -192,22 +542,14 @@ fast_delete (void* ptr) {
 void*
 fast_alloc_mw (size_t s)
 {
-  if (s<MAX_FAST) {
-    void *ptr= alloc_ptr(s);
-    if (ptr==NULL) return enlarge_malloc (s);
-    alloc_ptr(s)= ind(ptr);
-    return ptr;
-  }
+  if (s<MAX_FAST) return cache_alloc (s);
   else return safe_malloc (s);
 }
 
 void
 fast_free_mw (void* ptr, size_t s)
 {
-  if (s<MAX_FAST) {
-    ind(ptr)    = alloc_ptr(s);
-    alloc_ptr(s)= ptr;
-  }
+  if (s<MAX_FAST) cache_free (ptr, s);
   else free (ptr);
 }
 
@@ -215,54 +557,84 @@ fast_free_mw (void* ptr, size_t s)
 * Statistics
 ******************************************************************************/
 
-int
-compute_free (void* ptr) {
-  int i=-1;
-  while (ptr!=NULL) {
-    i++;
-    ptr= ind (ptr);
-  }
-  return i;
+struct fast_stats {
+  long slabs;   // number of slabs of the size class
+  long live;    // bytes in use by the program
+  long free;    // bytes in the free lists of the slabs and the thread caches
+  long frag;    // bytes which cannot be used for objects of this size
+};
+
+static void
+compute_stats (int i, fast_stats& st) {
+  long sz= i * WORD_LENGTH;
+  long cached= 0;
+  lock (threads_lock);
+  for (fast_thread* t= threads; t != NULL; t= t->next)
+    cached += t->cache[i].count;
+  unlock (threads_lock);
+  fast_class& c= classes[i];
+  lock (c.lock);
+  long slabs= c.slabs;
+  long taken= c.taken;
+  long capacity= 0;
+  for (fast_slab* s= c.partial; s != NULL; s= s->next)
+    capacity += s->capacity - s->live;
+  unlock (c.lock);
+  // objects in full slabs are all taken, hence the capacity of the slabs
+  // equals the taken objects plus the free objects of the partial slabs
+  st.slabs= slabs;
+  st.live = sz * (taken - cached);
+  st.free = sz * (capacity + cached);
+  st.frag = slabs * BLOCK_SIZE - st.live - st.free;
 }
 
 int
 mem_used () {
-  int free_bytes= alloc_remains;
-  int chunks_use= BLOCK_SIZE*fast_chunks;
-  int i;
-  for (i=WORD_LENGTH; i<MAX_FAST; i+=WORD_LENGTH)
-    free_bytes += i*compute_free (alloc_table+i);
-  int small_uses= chunks_use- free_bytes;
-  return small_uses+ large_uses;
+  long small_uses= 0;
+  for (int i=1; i<FAST_CLASSES; i++) {
+    fast_stats st;
+    compute_stats (i, st);
+    small_uses += st.live;
+  }
+  return (int) (small_uses + large_uses);
 }
 
 void
 mem_info () {
   cout << "\n---------------- memory statistics ----------------\n";
-  int free_bytes= alloc_remains;
-  int chunks_use= BLOCK_SIZE*fast_chunks;
-  int i;
-  for (i=WORD_LENGTH; i<MAX_FAST; i+=WORD_LENGTH)
-    free_bytes += i*compute_free (alloc_table+i);
-  int small_uses= chunks_use- free_bytes;
-  int total_uses= small_uses+ large_uses;
-  // cout << "Fast chunks   : " << chunks_use << " bytes\n";
-  // cout << "Free on chunks: " << alloc_remains << " bytes\n";
+  long small_uses= 0, free_bytes= 0, frag_bytes= 0;
+  cout << "Size      Slabs        Live        Free  Fragmented\n";
+  for (int i=1; i<FAST_CLASSES; i++) {
+    fast_stats st;
+    compute_stats (i, st);
+    small_uses += st.live;
+    free_bytes += st.free;
+    frag_bytes += st.frag;
+    if (st.slabs == 0) continue;
+    char buf[128];
+    snprintf (buf, 128, "%4d %10ld %11ld %11ld %11ld\n",
+              (int) (i * WORD_LENGTH), st.slabs, st.live, st.free, st.frag);
+    cout << buf;
+  }
+  long chunks_use= BLOCK_SIZE * mapped_slabs;
+  long total_uses= small_uses + large_uses;
   cout << "User          : " << total_uses << " bytes\n";
-  cout << "Allocator     : " << chunks_use+ large_uses << " bytes\n";
+  cout << "Allocator     : " << chunks_use + large_uses << " bytes\n";
+  cout << "Free on slabs : " << free_bytes << " bytes\n";
+  cout << "Retained slabs: " << BLOCK_SIZE * empty_count << " bytes\n";
+  cout << "Fragmented    : " << frag_bytes << " bytes\n";
   cout << "Small mallocs : "
        << ((100*((float) small_uses))/((float) total_uses)) << "%\n";
 }
 
-#ifdef DEBUG_ON
-bool break_stub(void *ptr) {
-  if(ptr && (ptr > (void*)alloc_mem_top || ptr < (void*)alloc_mem_bottom)) {
-    printf("Bad pointer in fast_alloc:%p %p:%p\n",ptr,alloc_mem_bottom,alloc_mem_top);
+bool
+break_stub (void* ptr) {
+  if (ptr != NULL && slab_of (ptr)->magic != SLAB_MAGIC) {
+    printf ("Bad pointer in fast_alloc:%p\n", ptr);
     return true;
   }
   return false;
 }
-#endif
 
 /******************************************************************************
 * Redefine standard new and delete
@@ -274,11 +646,7 @@ void*
 operator new (size_t s) {
   void* ptr;
   s= (s+ WORD_LENGTH+ WORD_LENGTH_INC)&WORD_MASK;
-  if (s<MAX_FAST) {
-    ptr= alloc_ptr(s);
-    if (ptr==NULL) ptr= enlarge_malloc (s);
-    else alloc_ptr(s)= ind(ptr);
-  }
+  if (s<MAX_FAST) ptr= cache_alloc (s);
   else {
     ptr= safe_malloc (s);
     large_uses += s;
@@ -291,10 +659,7 @@ void
 operator delete (void* ptr) {
   ptr= (void*) (((char*) ptr)- WORD_LENGTH);
   size_t s= *((size_t *) ptr);
-  if (s<MAX_FAST) {
-    ind(ptr)    = alloc_ptr(s);
-    alloc_ptr(s)= ptr;
-  }
+  if (s<MAX_FAST) cache_free (ptr, s);
   else {
     free (ptr);
     large_uses -= s;
@@ -305,11 +670,7 @@ void*
 operator new[] (size_t s) {
   void* ptr;
   s= (s+ WORD_LENGTH+ WORD_LENGTH_INC)&WORD_MASK;
-  if (s<MAX_FAST) {
-    ptr= alloc_ptr(s);
-    if (ptr==NULL) ptr= enlarge_malloc (s);
-    else alloc_ptr(s)= ind(ptr);
-  }
+  if (s<MAX_FAST) ptr= cache_alloc (s);
   else {
     ptr= safe_malloc (s);
     large_uses += s;
@@ -322,10 +683,7 @@ void
 operator delete[] (void* ptr) {
   ptr= (void*) (((char*) ptr)- WORD_LENGTH);
   size_t s= *((size_t *) ptr);
-  if (s<MAX_FAST) {
-    ind(ptr)    = alloc_ptr(s);
-    alloc_ptr(s)= ptr;
-  }
+  if (s<MAX_FAST) cache_free (ptr, s);
   else {
     free (ptr);
     large_uses -= s;
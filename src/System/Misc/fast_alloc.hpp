@@ -18,36 +18,24 @@
 
 #include "tm_ostream.hpp"
 
-#define BLOCK_SIZE 65536 // should be >>> MAX_FAST
+#define BLOCK_SIZE 65536 // size of the slabs, should be >>> MAX_FAST
 
 /******************************************************************************
 * Globals
 ******************************************************************************/
 
-extern void*   alloc_table[MAX_FAST]; // Static declaration initializes with NULL's
-extern char*  alloc_mem;
-#ifdef DEBUG_ON
-extern char*  alloc_mem_top;
-extern char*  alloc_mem_bottom;
-#endif
 bool break_stub(void* ptr);
-extern size_t alloc_remains;
-extern int    allocated;
-extern int    large_uses;
-
-#define alloc_ptr(i) alloc_table[i]
-#define ind(ptr) (*((void **) ptr))
 
 /******************************************************************************
 * General purpose fast allocation routines
 ******************************************************************************/
 
 extern void* safe_malloc (size_t s);
-extern void* enlarge_malloc (size_t s);
 extern void* fast_alloc (size_t s);
 extern void  fast_free (void* ptr, size_t s);
 extern void* fast_new (size_t s);
 extern void  fast_delete (void* ptr);
+extern void  fast_alloc_thread_exit ();
 
 extern int   mem_used ();
 extern void  mem_info ();
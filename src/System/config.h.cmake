@@ -1,5 +1,8 @@
 /* src/System/config.h.cmake */
 
+/* Use thread safe reference counting */
+#cmakedefine ATOMIC_REFCOUNT 1
+
 /* check assertions in code */
 #cmakedefine DEBUG_ASSERT 1
 
@@ -62,6 +65,9 @@
 /* Define to 1 if you have the <string.h> header file. */
 #cmakedefine HAVE_STRING_H 1
 
+/* Define to 1 if you have the <sys/epoll.h> header file. */
+#cmakedefine HAVE_SYS_EPOLL_H 1
+
 /* Define to 1 if you have the <sys/stat.h> header file. */
 #cmakedefine HAVE_SYS_STAT_H 1
 
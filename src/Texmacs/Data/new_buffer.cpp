@@ -441,6 +441,14 @@ attach_subformat (tree t, url u, string fm) {
   return change_doc_attr (t, "initial", make_collection (h));
 }
 
+static tree
+import_parsed_tree (tree t, url u, string fm) {
+  tree links= extract (t, "links");
+  if (N (links) != 0)
+    (void) call ("register-link-locations", object (u), object (links));
+  return attach_subformat (t, u, fm);
+}
+
 tree
 import_loaded_tree (string s, url u, string fm) {
   set_file_focus (u);
@@ -449,16 +457,18 @@ import_loaded_tree (string s, url u, string fm) {
   if (fm == "texmacs" && starts (s, "(document (TeXmacs")) fm= "stm";
   if (fm == "verbatim" && starts (s, "(document (TeXmacs")) fm= "stm";
   tree t= generic_to_tree (s, fm * "-document");
-  tree links= extract (t, "links");
-  if (N (links) != 0)
-    (void) call ("register-link-locations", object (u), object (links));
-  return attach_subformat (t, u, fm);
+  return import_parsed_tree (t, u, fm);
 }
 
 tree
 import_tree (url u, string fm) {
   u= resolve (u, "fr");
   set_file_focus (u);
+  if (fm == "texmacs" && !is_none (u)) {
+    // parse the file in place instead of passing it through the converters
+    tree t= load_texmacs_document (u);
+    if (!is_func (t, ERROR)) return import_parsed_tree (t, u, fm);
+  }
   string s;
   if (is_none (u) || load_string (u, s, false)) return "error";
   return import_loaded_tree (s, u, fm);
@@ -532,6 +542,12 @@ export_tree (tree doc, url u, string fm) {
       }
   // END hook
   if (fm == "generic") fm= "verbatim";
+  if (fm == "texmacs") {
+    // write the document in chunks and only replace the file when done
+    tm_ostream out= file_ostream (u, true, true);
+    tree_to_texmacs (aux, out);
+    return out->close ();
+  }
   string s= tree_to_generic (aux, fm * "-document");
   if (s == "* error: unknown format *") return true;
   return save_string (u, s);
@@ -0,0 +1,106 @@
+/******************************************************************************
+* MODULE     : tm_conversion.cpp
+* DESCRIPTION: Serving document conversions to several clients at once
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "worker_server.hpp"
+#include "convert.hpp"
+#include "new_buffer.hpp"
+#include "file.hpp"
+#include "analyze.hpp"
+#include "scheme.hpp"
+#include <signal.h>
+
+/******************************************************************************
+* Handling requests, inside the worker processes
+******************************************************************************/
+
+static string
+export_suffix (string fm) {
+  if (fm == "postscript") return "ps";
+  if (fm == "verbatim") return "txt";
+  return fm;
+}
+
+static string
+conversion_request (string request) {
+  // Requests are of the form "convert <from> <to>\n<data>", for conversions
+  // between formats, or "export <from> <to>\n<data>", for conversions which
+  // typeset the document in the current buffer, like those to pdf.
+  int i= search_forwards ("\n", request);
+  if (i < 0) i= N(request);
+  array<string> args= tokenize (request (0, i), " ");
+  string data= (i < N(request)? request (i+1, N(request)): string (""));
+  if (N(args) != 3 || (args[0] != "convert" && args[0] != "export"))
+    return "error\ninvalid request";
+
+  tree doc= generic_to_tree (data, args[1] * "-document");
+  if (args[0] == "convert") {
+    string s= tree_to_generic (doc, args[2] * "-document");
+    if (s == "* error: unknown format *")
+      return "error\nunknown format " * args[2];
+    return "ok\n" * s;
+  }
+
+  // each request is typeset in a fresh buffer, so that no state is
+  // passed on from one request to the next one
+  url name= make_new_buffer ();
+  set_buffer_tree (name, doc);
+  url out= url_temp ("." * export_suffix (args[2]));
+  string s;
+  bool err= buffer_export (name, out, args[2]) || load_string (out, s, false);
+  remove_buffer (name);
+  if (exists (out)) remove (out);
+  if (err) return "error\ncould not export to " * args[2];
+  return "ok\n" * s;
+}
+
+/******************************************************************************
+* The server
+******************************************************************************/
+
+static volatile sig_atomic_t conversions_stopped= 0;
+
+static void
+stop_conversions (int sig_num) {
+  (void) sig_num;
+  conversions_stopped= 1;
+}
+
+void
+conversion_server (int port, int workers, string address, int timeout,
+                   array<string> worker_cmd) {
+  // The server runs before the display is opened and scheme is started;
+  // its workers are new processes, started with the option -cw
+  worker_server_rep* srv=
+    tm_new<worker_server_rep> (worker_cmd, workers, 1000 * timeout);
+  string r= srv->start (port, address);
+  if (r != "ok") std_error << r << "\n";
+  else {
+    cout << "TeXmacs] Serving conversions on "
+         << (address == ""? string ("localhost"): address)
+         << ":" << srv->port << " with " << workers << " workers\n";
+    signal (SIGINT, stop_conversions);
+    signal (SIGTERM, stop_conversions);
+    while (!conversions_stopped) srv->listen (1000);
+    if (DEBUG_BENCH) cout << srv->statistics ();
+  }
+  tm_delete (srv);
+}
+
+/******************************************************************************
+* The workers
+******************************************************************************/
+
+void
+conversion_worker (int fd) {
+  // Once initialized, the worker answers the requests on the socket fd
+  // until the server closes it
+  exec_pending_commands ();
+  worker_main (fd, conversion_request);
+}
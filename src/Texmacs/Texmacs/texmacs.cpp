@@ -25,6 +25,7 @@
 #include "server.hpp"
 #include "tm_timer.hpp"
 #include "data_cache.hpp"
+#include "memorizer.hpp"
 #include "tm_window.hpp"
 #ifdef AQUATEXMACS
 void mac_fix_paths ();
@@ -60,11 +61,20 @@ extern int geometry_x, geometry_y;
 
 extern tree the_et;
 extern bool texmacs_started;
+extern bool disable_boot_lock;
 
 bool disable_error_recovery= false;
 bool start_server_flag= false;
+int  conversion_port= 0;
+int  conversion_workers= 1;
+int  conversion_timeout= 60;
+string conversion_address= "";
+int  conversion_socket= -1;
 string extra_init_cmd;
 void server_start ();
+void conversion_server (int port, int workers, string address, int timeout,
+                        array<string> worker_cmd);
+void conversion_worker (int fd);
 
 /******************************************************************************
 * For testing
@@ -341,6 +351,11 @@ TeXmacs_main (int argc, char** argv) {
         if (i<argc) my_init_cmds= (my_init_cmds * " ") * argv[i];
       }
       else if (s == "-server") start_server_flag= true;
+      else if ((s == "-cs") || (s == "-conversion-server") ||
+               (s == "-cw") || (s == "-conversion-worker") ||
+               (s == "-sw") || (s == "-server-workers") ||
+               (s == "-sa") || (s == "-server-address") ||
+               (s == "-st") || (s == "-server-timeout")) i++;
       else if (s == "-log-file") i++;
       else if ((s == "-Oc") || (s == "-no-char-clipping")) char_clip= false;
       else if ((s == "+Oc") || (s == "-char-clipping")) char_clip= true;
@@ -370,6 +385,7 @@ TeXmacs_main (int argc, char** argv) {
         cout << "Options for TeXmacs:\n\n";
         cout << "  -b [file]  Specify scheme buffers initialization file\n";
         cout << "  -c [i] [o] Convert file 'i' into file 'o'\n";
+        cout << "  -cs [port] Serve document conversions on 'port'\n";
         cout << "  -d         For debugging purposes\n";
         cout << "  -fn [font] Set the default TeX font\n";
         cout << "  -g [geom]  Set geometry of window in pixels\n";
@@ -380,6 +396,9 @@ TeXmacs_main (int argc, char** argv) {
         cout << "  -r         Reverse video mode\n";
         cout << "  -s         Suppress information messages\n";
         cout << "  -S         Rerun TeXmacs setup program before starting\n";
+        cout << "  -sa [addr] Accept conversion clients on 'addr'\n";
+        cout << "  -st [s]    Interrupt conversions after 's' seconds\n";
+        cout << "  -sw [n]    Serve conversions with 'n' processes\n";
         cout << "  -v         Display current TeXmacs version\n";
         cout << "  -V         Show some informative messages\n";
         cout << "  -x [cmd]   Execute scheme command\n";
@@ -420,6 +439,13 @@ TeXmacs_main (int argc, char** argv) {
     retina_iman  = true;
     retina_icons = 2;
   }
+  if (get_env ("TEXMACS_MEMORIZE") != "" &&
+      get_env ("TEXMACS_MEMORIZE") != "off") {
+    // "on" or the maximal number of memorized computations
+    memorize_mode= true;
+    int cap= as_int (get_env ("TEXMACS_MEMORIZE"));
+    if (cap > 0) memorize_capacity= cap;
+  }
   // End options via environment variables
 
   // Further user preferences
@@ -461,6 +487,11 @@ TeXmacs_main (int argc, char** argv) {
     else if ((s == "-b") || (s == "-initialize-buffer") ||
              (s == "-fn") || (s == "-font") ||
              (s == "-i") || (s == "-initialize") ||
+             (s == "-cs") || (s == "-conversion-server") ||
+             (s == "-cw") || (s == "-conversion-worker") ||
+             (s == "-sw") || (s == "-server-workers") ||
+             (s == "-sa") || (s == "-server-address") ||
+             (s == "-st") || (s == "-server-timeout") ||
              (s == "-g") || (s == "-geometry") ||
              (s == "-x") || (s == "-execute") ||
              (s == "-log-file") ||
@@ -497,13 +528,15 @@ TeXmacs_main (int argc, char** argv) {
   if (start_server_flag) server_start ();
   release_boot_lock ();
   if (N(extra_init_cmd) > 0) exec_delayed (scheme_cmd (extra_init_cmd));
-  gui_start_loop ();
+  if (conversion_socket >= 0) conversion_worker (conversion_socket);
+  else gui_start_loop ();
 
   if (DEBUG_STD) debug_boot << "Stopping server...\n";
   } // ending scope for server sv
 
   if (DEBUG_STD) debug_boot << "Closing display...\n";
   gui_close ();
+  if (DEBUG_BENCH && memorize_mode) memorize_statistics (std_bench);
   
 #if defined(X11TEXMACS) && defined(MACOSX_EXTENSIONS)
   finalize_mac_application ();
@@ -610,6 +643,16 @@ immediate_options (int argc, char** argv) {
       system ("rm -rf", url ("$TEXMACS_HOME_PATH/system/database"));
       system ("rm -rf", url ("$TEXMACS_HOME_PATH/users"));
     }
+    else if (((s == "-cs") || (s == "-conversion-server")) && i + 1 < argc)
+      conversion_port= max (1, as_int (string (argv[++i])));
+    else if (((s == "-sw") || (s == "-server-workers")) && i + 1 < argc)
+      conversion_workers= max (1, as_int (string (argv[++i])));
+    else if (((s == "-sa") || (s == "-server-address")) && i + 1 < argc)
+      conversion_address= argv[++i];
+    else if (((s == "-st") || (s == "-server-timeout")) && i + 1 < argc)
+      conversion_timeout= max (0, as_int (string (argv[++i])));
+    else if (((s == "-cw") || (s == "-conversion-worker")) && i + 1 < argc)
+      conversion_socket= as_int (string (argv[++i]));
     else if (s == "-log-file" && i + 1 < argc) {
       i++;
       char* log_file = argv[i];
@@ -622,6 +665,18 @@ immediate_options (int argc, char** argv) {
   }
 }
 
+static array<string>
+conversion_worker_command (char* argv0) {
+  // Workers are new instances of this program, so that the server never
+  // has to fork a process with threads or an opened display
+  url exe= url_system (argv0);
+  if (search_forwards ("/", string (argv0)) < 0) exe= resolve_in_path (exe);
+  else if (!is_rooted (exe)) exe= url_pwd () * exe;
+  array<string> cmd;
+  cmd << as_string (exe) << string ("-s") << string ("-cw");
+  return cmd;
+}
+
 #include <cstdio>
 
 int
@@ -648,13 +703,24 @@ main (int argc, char** argv) {
   boot_hacks ();
   windows_delayed_refresh (1000000000);
   immediate_options (argc, argv);
+  if (conversion_port > 0) {
+    // the server only dispatches the requests to its workers
+    conversion_server (conversion_port, conversion_workers,
+                       conversion_address, conversion_timeout,
+                       conversion_worker_command (argv[0]));
+    return 0;
+  }
 #ifndef OS_MINGW
   set_env ("LC_NUMERIC", "POSIX");
 #ifndef OS_MACOS
   set_env ("QT_QPA_PLATFORM", "xcb");
   set_env ("XDG_SESSION_TYPE", "x11");
 #endif
+  if (conversion_socket >= 0) set_env ("QT_QPA_PLATFORM", "offscreen");
 #endif
+  // conversion workers boot concurrently, so that the boot lock of one
+  // worker would be mistaken for a crash during the boot of another one
+  if (conversion_socket >= 0) disable_boot_lock= true;
 #ifdef MACOSX_EXTENSIONS
   // Reset TeXmacs if Alt is pressed during startup
   if (mac_alternate_startup()) {
@@ -311,10 +311,12 @@ bridge_rep::typeset (int desired_status) {
   else {
     // cout << "Typesetting " << st << ", " << desired_status << LF << INDENT;
     //cout << "recomputing" << LF;
-    hashmap<string,tree> prev_back (UNINIT);
+    basic_environment prev_back;
     my_clean_links ();
     link_repository old_link_env= env->link_env;
+    path old_ref_ip= env->ref_ip;
     env->link_env= link_env;
+    env->ref_ip= ip;
     ttt->local_start (l, sb);
     env->local_start (prev_back);
     if (env->hl_lan != 0) env->lan->highlight (st);
@@ -323,6 +325,7 @@ bridge_rep::typeset (int desired_status) {
     env->local_end (prev_back);
     ttt->local_end (l, sb);
     env->link_env= old_link_env;
+    env->ref_ip= old_ref_ip;
     status= desired_status;
     // cout << "old_patch     = " << ttt->old_patch << LF;
     // cout << "changes       = " << changes << LF;
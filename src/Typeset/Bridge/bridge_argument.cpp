@@ -99,7 +99,7 @@ bridge_argument_rep::notify_macro (int tp, string var, int l, path p, tree u) {
       else flag= false;
     }
     else {
-      list<hashmap<string,tree> > old_var= env->macro_arg;
+      list<basic_environment> old_var= env->macro_arg;
       list<hashmap<string,path> > old_src= env->macro_src;
       if (!is_nil (env->macro_arg)) env->macro_arg= env->macro_arg->next;
       if (!is_nil (env->macro_src)) env->macro_src= env->macro_src->next;
@@ -174,7 +174,7 @@ bridge_argument_rep::my_typeset (int desired_status) {
   initialize (name, prefix, attach_here (value, valip));
 
   ttt->insert_marker (body->st, ip);
-  list<hashmap<string,tree> > old_var= env->macro_arg;
+  list<basic_environment> old_var= env->macro_arg;
   list<hashmap<string,path> > old_src= env->macro_src;
   if (!is_nil (env->macro_arg)) env->macro_arg= env->macro_arg->next;
   if (!is_nil (env->macro_src)) env->macro_src= env->macro_src->next;
@@ -118,12 +118,12 @@ bridge_auto_rep::notify_macro (
 
   bool flag;
   if (valid) {
-    env->macro_arg= list<hashmap<string,tree> > (
-      hashmap<string,tree> (UNINIT), env->macro_arg);
+    env->macro_arg= list<basic_environment> (
+      basic_environment (1), env->macro_arg);
     env->macro_src= list<hashmap<string,path> > (
       hashmap<string,path> (path (DECORATION)), env->macro_src);
     string var= f[0]->label;
-    env->macro_arg->item (var)= st;
+    env->macro_arg->item->write (var, st);
     env->macro_src->item (var)= ip;
     flag= body->notify_macro (type, var, l+1, p, u);
     env->macro_arg= env->macro_arg->next;
@@ -146,12 +146,12 @@ bridge_auto_rep::notify_change () {
 
 void
 bridge_auto_rep::my_exec_until (path p) {
-  env->macro_arg= list<hashmap<string,tree> >
-    (hashmap<string,tree> (UNINIT), env->macro_arg);
+  env->macro_arg= list<basic_environment> (
+    basic_environment (1), env->macro_arg);
   env->macro_src= list<hashmap<string,path> >
     (hashmap<string,path> (path (DECORATION)), env->macro_src);
   string var= f[0]->label;
-  env->macro_arg->item (var)= st;
+  env->macro_arg->item->write (var, st);
   (void) env->exec_until (f[1], p, var, 0);
   env->macro_arg= env->macro_arg->next;
   env->macro_src= env->macro_src->next;
@@ -179,19 +179,19 @@ bridge_auto_rep::my_typeset_will_be_complete () {
 
 void
 bridge_auto_rep::my_typeset (int desired_status) {
-  env->macro_arg= list<hashmap<string,tree> > (
-    hashmap<string,tree> (UNINIT), env->macro_arg);
+  env->macro_arg= list<basic_environment> (
+    basic_environment (1), env->macro_arg);
   env->macro_src= list<hashmap<string,path> > (
     hashmap<string,path> (path (DECORATION)), env->macro_src);
   string var= f[0]->label;
-  env->macro_arg->item (var)= st;
+  env->macro_arg->item->write (var, st);
   env->macro_src->item (var)= ip;
-  tree oldv= env->read (PREAMBLE);
-  env->write_update (PREAMBLE, "false");
+  tree oldv= env->read (PREAMBLE_KEY);
+  env->write_update (PREAMBLE_KEY, "false");
   initialize ();
   if (border) ttt->insert_marker (st, ip);
   body->typeset (desired_status);
-  env->write_update (PREAMBLE, oldv);
+  env->write_update (PREAMBLE_KEY, oldv);
   env->macro_arg= env->macro_arg->next;
   env->macro_src= env->macro_src->next;
 }
@@ -129,23 +129,23 @@ bridge_compound_rep::notify_macro (
   bool flag;
   if (valid) {
     int i, n=N(fun)-1, m=N(st);
-    env->macro_arg= list<hashmap<string,tree> > (
-      hashmap<string,tree> (UNINIT), env->macro_arg);
+    env->macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), env->macro_arg);
     env->macro_src= list<hashmap<string,path> > (
       hashmap<string,path> (path (DECORATION)), env->macro_src);
     if (L(fun) == XMACRO) {
       if (is_atomic (fun[0])) {
         string var= fun[0]->label;
-        env->macro_arg->item (var)= st;
+        env->macro_arg->item->write (var, st);
         env->macro_src->item (var)= ip;
       }
     }
     else for (i=0; i<n; i++)
       if (is_atomic (fun[i])) {
         string var= fun[i]->label;
-        env->macro_arg->item (var)=
+        env->macro_arg->item->write (var,
         i+delta<m? st[i+delta]:
-        attach_dip (tree (UNINIT), decorate_right (ip));
+        attach_dip (tree (UNINIT), decorate_right (ip)));
         env->macro_src->item (var)=
         i+delta<m? descend (ip,i+delta):
         decorate_right(ip);
@@ -196,22 +196,22 @@ bridge_compound_rep::my_typeset (int desired_status) {
 
   if (is_applicable (f)) {
     int i, n=N(f)-1, m=N(st)-d;
-    env->macro_arg= list<hashmap<string,tree> > (
-      hashmap<string,tree> (UNINIT), env->macro_arg);
+    env->macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), env->macro_arg);
     env->macro_src= list<hashmap<string,path> > (
       hashmap<string,path> (path (DECORATION)), env->macro_src);
     if (L(f) == XMACRO) {
       if (is_atomic (f[0])) {
         string var= f[0]->label;
-        env->macro_arg->item (var)= st;
+        env->macro_arg->item->write (var, st);
         env->macro_src->item (var)= ip;
       }
     }
     else for (i=0; i<n; i++)
       if (is_atomic (f[i])) {
         string var= f[i]->label;
-        env->macro_arg->item (var)=
-        i<m? st[i+d]: attach_dip (tree (UNINIT), decorate_right (ip));
+        env->macro_arg->item->write (var,
+        i<m? st[i+d]: attach_dip (tree (UNINIT), decorate_right (ip)));
         env->macro_src->item (var)=
         i<m? descend (ip,i+d): decorate_right(ip);
       }
@@ -207,6 +207,8 @@ bridge_document_rep::my_typeset (int desired_status) {
       ttt->a= (i==0  ? a: array<line_item> ());
       ttt->b= (i==n-1? b: array<line_item> ());
       brs[i]->typeset (PROCESSED+ wanted);
+      if (ttt->page_limit >= 0 && ip == ttt->br->ip &&
+          ttt->page_limit_reached ()) break;
     }
   }
   else acc->my_typeset (desired_status);
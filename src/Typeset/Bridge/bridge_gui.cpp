@@ -226,8 +226,8 @@ bridge_canvas_rep::my_typeset (int desired_status) {
       delta= max (0, w + pad);
     delta += 2 * bor + 2 * hpad;
   }
-  SI l= env->get_length (PAR_LEFT);
-  SI r= env->get_length (PAR_RIGHT) + delta;
+  SI l= env->get_length (PAR_LEFT_KEY);
+  SI r= env->get_length (PAR_RIGHT_KEY) + delta;
   with= tuple (PAR_LEFT, tree (TMLEN, as_string (0))) *
         tuple (PAR_RIGHT, tree (TMLEN, as_string (l + r)));
 
@@ -263,7 +263,7 @@ void
 bridge_ornament_rep::my_typeset (int desired_status) {
   ornament_parameters ps= env->get_ornament_parameters ();
   SI   l = env->get_length (PAR_LEFT ) + ps->lpad;
-  SI   r = env->get_length (PAR_RIGHT) + ps->rpad;
+  SI   r = env->get_length (PAR_RIGHT_KEY) + ps->rpad;
   with   = tuple (PAR_LEFT , tree (TMLEN, as_string (l))) *
            tuple (PAR_RIGHT, tree (TMLEN, as_string (r)));
   box  b = typeset_ornament (desired_status);
@@ -294,7 +294,7 @@ void
 bridge_art_box_rep::my_typeset (int desired_status) {
   art_box_parameters ps= env->get_art_box_parameters (st);
   SI   l = env->get_length (PAR_LEFT ) + ps->lpad;
-  SI   r = env->get_length (PAR_RIGHT) + ps->rpad;
+  SI   r = env->get_length (PAR_RIGHT_KEY) + ps->rpad;
   with   = tuple (PAR_LEFT , tree (TMLEN, as_string (l))) *
            tuple (PAR_RIGHT, tree (TMLEN, as_string (r)));
   box  b = typeset_ornament (desired_status);
@@ -141,9 +141,9 @@ bridge_locus_rep::my_typeset (int desired_status) {
   string col;
   bool ok= build_locus (env, st, ids, col);
   if (!ok) typeset_warning << "Ignored unaccessible loci\n";
-  tree old_col= env->read (COLOR);
-  env->write_update (COLOR, col);
+  tree old_col= env->read (COLOR_KEY);
+  env->write_update (COLOR_KEY, col);
   ttt->insert_marker (st, ip);
   body->typeset (desired_status);
-  env->write_update (COLOR, old_col);
+  env->write_update (COLOR_KEY, old_col);
 }
@@ -161,7 +161,7 @@ bridge_surround_rep::my_typeset_will_be_complete () {
 void
 bridge_surround_rep::my_typeset (int desired_status) {
   if (corrupted || (N(ttt->old_patch) != 0)) {
-    hashmap<string,tree> prev_back (UNINIT);
+    basic_environment prev_back;
     env->local_start (prev_back);
     /*
     cout << st[0] << "\n";
@@ -126,13 +126,12 @@ void
 bridge_with_rep::my_exec_until (path p) {
   int i, k= last>>1; // is k=0 allowed ?
   if (((last&1) != 0) || (p->item != last)) return;
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= env->exec (st[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
+      vars[i]= make_env_key (var_t->label);
       newv[i]= env->exec (st[(i<<1)+1]);
     }
     else {
@@ -158,17 +157,17 @@ bridge_with_rep::my_typeset (int desired_status) {
   int i, k= last>>1; // is k=0 allowed ?
   // if ((last&1) != 0) return;
   
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(oldv,tree,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= env->exec (st[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
-      oldv[i]= env->read (var);
+      vars[i]= make_env_key (var_t->label);
+      oldv[i]= env->read (vars[i]);
       newv[i]= env->exec (st[(i<<1)+1]);
     }
+    else vars[i]= make_env_key ("");
     /*
     else {
       STACK_DELETE_ARRAY(vars);
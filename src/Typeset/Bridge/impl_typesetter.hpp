@@ -29,6 +29,10 @@ public:
   hashmap<string,tree> old_patch;
   bool paper;
 
+  int    page_limit;       // stop typesetting after so many pages or -1
+  int    limit_done;       // number of lines whose height has been counted
+  double limit_height;     // total height of these lines
+
 public:
   typesetter_rep (edit_env& env, tree et, path ip);
 
@@ -41,6 +45,7 @@ public:
   void local_start   (array<page_item>& l, stack_border& sb);
   void local_end     (array<page_item>& l, stack_border& sb);
 
+  bool page_limit_reached ();
   void determine_page_references (box b);
   box  typeset ();
   box  typeset (SI& x1, SI& y1, SI& x2, SI& y2);
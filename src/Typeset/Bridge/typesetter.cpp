@@ -12,14 +12,17 @@
 #include "Bridge/impl_typesetter.hpp"
 #include "iterator.hpp"
 
+#define PAGE_LIMIT_SLACK 2
+
 /******************************************************************************
 * Constructor and destructor
 ******************************************************************************/
 
 typesetter_rep::typesetter_rep (edit_env& env2, tree et, path ip):
-  env (env2), old_patch (UNINIT)
+  env (env2), old_patch (UNINIT),
+  page_limit (-1), limit_done (0), limit_height (0.0)
 {
-  paper= (env->get_string (PAGE_MEDIUM) == "paper");
+  paper= (env->get_string (PAGE_MEDIUM_KEY) == "paper");
   br= make_bridge (this, et, ip);
   x1= y1= x2= y2=0;
 }
@@ -119,6 +122,27 @@ requires_update (rectangles log) {
   return reverse (rs);
 }
 
+/******************************************************************************
+* Typesetting only the first pages of a document
+******************************************************************************/
+
+bool
+typesetter_rep::page_limit_reached () {
+  // Lines are only accumulated until they fill the requested number of
+  // pages and a few more, so that the page breaks inside the range are
+  // the same as for the complete document. Floats, columns and explicit
+  // page breaks only make us typeset more than necessary.
+  if (page_limit < 0 || !paper || env->page_user_height <= 0) return false;
+  for (; limit_done < N(l); limit_done++) {
+    page_item item= l[limit_done];
+    limit_height += ((double) item->b->h ()) / max (item->nr_cols, 1);
+    limit_height += (double) item->spc->def;
+  }
+  double max_height= ((double) env->page_user_height) *
+                     ((double) (page_limit + PAGE_LIMIT_SLACK));
+  return limit_height > max_height;
+}
+
 void
 typesetter_rep::determine_page_references (box b) {
   hashmap<string,tree> h ("?");
@@ -144,7 +168,7 @@ typesetter_rep::typeset () {
   sb       = stack_border ();
   a        = array<line_item> ();
   b        = array<line_item> ();
-  paper    = (env->get_string (PAGE_MEDIUM) == "paper");
+  paper    = (env->get_string (PAGE_MEDIUM_KEY) == "paper");
 
   // Test whether we are doing a complete typesetting
   env->complete= br->my_typeset_will_be_complete ();
@@ -157,12 +181,16 @@ typesetter_rep::typeset () {
     if (!is_compound (st[i], "show-part")) break;
   }
 
+  // Page references are only determined for complete documents
+  if (page_limit >= 0) env->complete= false;
+
   // Typeset
   if (env->complete) {
     env->local_aux= hashmap<string,tree> (UNINIT);
     env->missing  = hashmap<string,tree> (UNINIT);
     env->redefined= array<tree> ();
     env->touched  = hashmap<string,bool> (false);
+    env->ref_readers= hashmap<string,list<path> > (list<path> ());
   }
   br->typeset (PROCESSED+ WANTED_PARAGRAPH);
   pager ppp= tm_new<pager_rep> (br->ip, env, l);
@@ -274,11 +302,21 @@ typeset (typesetter ttt, SI& x1, SI& y1, SI& x2, SI& y2) {
   return ttt->typeset (x1, y1, x2, y2);
 }
 
+int
+page_limit_for (int last, int nr_pages) {
+  // Ranges which extend to the end of the document are typeset as
+  // complete documents, so that page references are determined
+  if (last < 0 || last >= ALL_PAGES) return -1;
+  if (nr_pages >= 0 && last >= nr_pages) return -1;
+  return last;
+}
+
 box
-typeset_as_document (edit_env env, tree t, path ip) {
+typeset_as_document (edit_env env, tree t, path ip, int pages) {
   env->style_init_env ();
   env->update ();
   typesetter ttt= new_typesetter (env, t, ip);
+  ttt->page_limit= page_limit_for (pages);
   box b= ttt->typeset ();
   delete_typesetter (ttt);
   return b;
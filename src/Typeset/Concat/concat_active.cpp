@@ -139,10 +139,10 @@ build_locus (edit_env env, tree t, list<string>& ids, string& col, string &ref,
     }
   }
 
-  bool on_paper= (env->get_string (PAGE_PRINTED) == "true");
+  bool on_paper= (env->get_string (PAGE_PRINTED_KEY) == "true");
   bool preserve= (get_locus_rendering ("locus-on-paper") == "preserve");
   string var= (visited? VISITED_COLOR: LOCUS_COLOR);
-  string current_col= env->get_string (COLOR);
+  string current_col= env->get_string (COLOR_KEY);
   string locus_col= env->get_string (var);
   if (on_paper) visited= false;
   if (locus_col == "preserve") col= current_col;
@@ -186,7 +186,7 @@ concater_rep::typeset_locus (tree t, path ip) {
   string col, ref, anchor;
   bool ok= build_locus (env, t, ids, col, ref, anchor);
   marker (descend (ip, 0));
-  tree old= env->local_begin (COLOR, col);
+  tree old= env->local_begin (COLOR_KEY, col);
   int pos= N(a);
   typeset (t[last], descend (ip, last));
   if (!ok) {
@@ -231,7 +231,7 @@ concater_rep::typeset_locus (tree t, path ip) {
     a->resize (pos);
     a << new_a;
   }
-  env->local_end (COLOR, old);
+  env->local_end (COLOR_KEY, old);
   marker (descend (ip, 1));
 }
 
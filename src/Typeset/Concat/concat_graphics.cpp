@@ -19,12 +19,12 @@
 
 #define BEGIN_MAGNIFY                                           \
   tree new_mag= as_string (env->magn * env->mgfy);              \
-  tree old_mfy= env->local_begin (MAGNIFY, "1");                \
-  tree old_mag= env->local_begin (MAGNIFICATION, new_mag);
+  tree old_mfy= env->local_begin (MAGNIFY_KEY, "1");            \
+  tree old_mag= env->local_begin (MAGNIFICATION_KEY, new_mag);
 
 #define END_MAGNIFY                             \
-  env->local_end (MAGNIFICATION, old_mag);      \
-  env->local_end (MAGNIFY, old_mfy);
+  env->local_end (MAGNIFICATION_KEY, old_mag);  \
+  env->local_end (MAGNIFY_KEY, old_mfy);
 
 /******************************************************************************
 * Typesetting graphics
@@ -73,16 +73,16 @@ concater_rep::typeset_graphics (tree t, path ip) {
 BEGIN_MAGNIFY
   env->update_color ();
   env->update_dash_style_unit ();
-  grid gr= as_grid (env->read (GR_GRID));
+  grid gr= as_grid (env->read (GR_GRID_KEY));
   array<box> bs;
-  gr->set_aspect (env->read (GR_GRID_ASPECT));
+  gr->set_aspect (env->read (GR_GRID_ASPECT_KEY));
   bs << grid_box (ip, gr, env->fr, env->as_length ("2ln"),
                   env->clip_lim1, env->clip_lim2);
   typeset_graphical (bs, t, ip);
 
   point lim1= env->clip_lim1;
   point lim2= env->clip_lim2;
-  if (env->get_bool (GR_AUTO_CROP)) {
+  if (env->get_bool (GR_AUTO_CROP_KEY)) {
     SI x1= MAX_SI, y1= MAX_SI, x2= -MAX_SI, y2= -MAX_SI;
     for (int i=1; i<N(bs); i++) {
       box b= bs[i];
@@ -92,14 +92,14 @@ BEGIN_MAGNIFY
       x1= min (x1, b->x3); y1= min (y1, b->y3);
       x2= max (x2, b->x4); y2= max (y2, b->y4);
     }
-    SI pad= env->get_length (GR_CROP_PADDING);
+    SI pad= env->get_length (GR_CROP_PADDING_KEY);
     lim1= env->fr [point (x1 - pad, y1 - pad)];
     lim2= env->fr [point (x2 + pad, y2 + pad)];
     //cout << lim1 << " -- " << lim2 << "\n";
   }
 
-  gr= as_grid (env->read (GR_EDIT_GRID));
-  gr->set_aspect (env->read (GR_EDIT_GRID_ASPECT));
+  gr= as_grid (env->read (GR_EDIT_GRID_KEY));
+  gr->set_aspect (env->read (GR_EDIT_GRID_ASPECT_KEY));
   box b= graphics_box (ip, bs, env->fr, gr, lim1, lim2);
   print (b);
 
@@ -228,7 +228,7 @@ BEGIN_MAGNIFY
       }
       else if (valign == "center") y -= ((b->y1 + b->y2) >> 1);
       else if (valign == "top") y -= b->y2;
-      SI pad= env->get_length (TEXT_AT_MARGIN);
+      SI pad= env->get_length (TEXT_AT_MARGIN_KEY);
       print (text_at_box (ip, b, x, y, axis, pad));
     }
   }
@@ -531,17 +531,16 @@ typeset_gr_item (edit_env env, tree t, path ip, bool& ok) {
     int i, n= N(t), k= (n-1)>>1; // is k=0 allowed ?
     if ((n&1) != 1) return empty_box (ip);
 
-    STACK_NEW_ARRAY(vars,string,k);
+    STACK_NEW_ARRAY(vars,int,k);
     STACK_NEW_ARRAY(oldv,tree,k);
     STACK_NEW_ARRAY(newv,tree,k);
     for (i=0; i<k; i++) {
       tree var_t= env->exec (t[i<<1]);
       if (is_atomic (var_t)) {
-        string var= var_t->label;
-        vars[i]= var;
-        oldv[i]= env->read (var);
+        vars[i]= make_env_key (var_t->label);
+        oldv[i]= env->read (vars[i]);
         newv[i]= env->exec (t[(i<<1)+1]);
-        if (var == PROVISO && newv[i] == "false") {
+        if (vars[i] == PROVISO_KEY && newv[i] == "false") {
           STACK_DELETE_ARRAY(vars);
           STACK_DELETE_ARRAY(oldv);
           STACK_DELETE_ARRAY(newv);
@@ -700,7 +699,7 @@ BEGIN_MAGNIFY
   vt (3, 3)= 1.0;
   vt (0, 3)= o[0];
   vt (1, 3)= o[1];
-  vt= vt * as_matrix<double> (env->read (GR_TRANSFORMATION));
+  vt= vt * as_matrix<double> (env->read (GR_TRANSFORMATION_KEY));
   tree u= env->exec (t);
   spacial obj= as_spacial (u);
   if (is_nil (obj))
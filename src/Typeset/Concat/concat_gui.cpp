@@ -66,8 +66,8 @@ resize (edit_env env, SI old, SI minimum, SI maximum, tree new_size) {
 
 canvas_properties
 get_canvas_properties (edit_env env, tree t) {
-  bool printed= (env->get_string (PAGE_PRINTED) == "true");
-  SI   border = env->get_length (ORNAMENT_BORDER);
+  bool printed= (env->get_string (PAGE_PRINTED_KEY) == "true");
+  SI   border = env->get_length (ORNAMENT_BORDER_KEY);
   if (!printed) {
     SI pixel= env->pixel;
     border= max (pixel, ((border + pixel/2) / pixel) * pixel);
@@ -75,7 +75,7 @@ get_canvas_properties (edit_env env, tree t) {
 
   canvas_properties props;
   props->env        = env;
-  props->type       = env->get_string (CANVAS_TYPE);
+  props->type       = env->get_string (CANVAS_TYPE_KEY);
   props->x1         = env->exec (t[0]);
   props->y1         = env->exec (t[1]);
   props->x2         = env->exec (t[2]);
@@ -84,17 +84,17 @@ get_canvas_properties (edit_env env, tree t) {
   props->yt         = env->expand (t[5]);
   props->scx        = env->exec (props->xt);
   props->scy        = env->exec (props->yt);
-  props->hpadding   = env->get_length (CANVAS_HPADDING);
-  props->vpadding   = env->get_length (CANVAS_VPADDING);
+  props->hpadding   = env->get_length (CANVAS_HPADDING_KEY);
+  props->vpadding   = env->get_length (CANVAS_VPADDING_KEY);
   props->border     = border;
-  props->bg         = env->read (CANVAS_COLOR);
+  props->bg         = env->read (CANVAS_COLOR_KEY);
   props->alpha      = env->alpha;
-  props->sunny      = env->get_color (ORNAMENT_SUNNY_COLOR);
-  props->shadow     = env->get_color (ORNAMENT_SHADOW_COLOR);
-  props->bar_width  = env->get_length (CANVAS_BAR_WIDTH);
-  props->bar_padding= env->get_length (CANVAS_BAR_PADDING);
-  props->bar_bg     = env->read (CANVAS_BAR_COLOR);
-  props->bar_button = env->read (ORNAMENT_COLOR);
+  props->sunny      = env->get_color (ORNAMENT_SUNNY_COLOR_KEY);
+  props->shadow     = env->get_color (ORNAMENT_SHADOW_COLOR_KEY);
+  props->bar_width  = env->get_length (CANVAS_BAR_WIDTH_KEY);
+  props->bar_padding= env->get_length (CANVAS_BAR_PADDING_KEY);
+  props->bar_bg     = env->read (CANVAS_BAR_COLOR_KEY);
+  props->bar_button = env->read (ORNAMENT_COLOR_KEY);
   return props;
 }
 
@@ -263,7 +263,7 @@ concater_rep::typeset_canvas (tree t, path ip) {
   SI x1, y1, x2, y2, scx, scy;
   get_canvas_horizontal (props, b->x1, b->x2, x1, x2, scx);
   get_canvas_vertical (props, b->y1, b->y2, y1, y2, scy);
-  string type= env->get_string (CANVAS_TYPE);
+  string type= env->get_string (CANVAS_TYPE_KEY);
   path dip= (type == "plain"? ip: decorate (ip));
   box cb= clip_box (dip, b, x1, y1, x2, y2, props->xt, props->yt, scx, scy);
   if (type != "plain") cb= put_scroll_bars (props, cb, ip, b, scx, scy);
@@ -18,13 +18,13 @@
 
 void
 concater_rep::typeset_blue (tree t, path ip) {
-  tree old_mode= env->local_begin (MODE, "src");
-  tree old_col = env->local_begin (COLOR, env->src_tag_color);
-  tree old_fam = env->local_begin (FONT_FAMILY, "ss");
+  tree old_mode= env->local_begin (MODE_KEY, "src");
+  tree old_col = env->local_begin (COLOR_KEY, env->src_tag_color);
+  tree old_fam = env->local_begin (FONT_FAMILY_KEY, "ss");
   typeset (t, ip);
-  env->local_end (FONT_FAMILY, old_fam);
-  env->local_end (COLOR, old_col);
-  env->local_end (MODE, old_mode);
+  env->local_end (FONT_FAMILY_KEY, old_fam);
+  env->local_end (COLOR_KEY, old_col);
+  env->local_end (MODE_KEY, old_mode);
 }
 
 /******************************************************************************
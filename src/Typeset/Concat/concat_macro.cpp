@@ -10,6 +10,7 @@
 ******************************************************************************/
 
 #include "concater.hpp"
+#include "memorizer.hpp"
 
 /******************************************************************************
 * Typesetting environment changes
@@ -21,11 +22,12 @@ concater_rep::typeset_assign (tree t, path ip) {
   tree r= env->exec (t[0]);
   if (!is_atomic (r)) return;
   string var= r->label;
-  env->assign (var, copy (t[1]));
-  if (env->var_type [var] == Env_Paragraph)
-    control (tuple ("env_par", var, env->read (var)), ip);
-  else if (env->var_type [var] == Env_Page)
-    control (tuple ("env_page", var, env->read (var)), ip);
+  int    key= make_env_key (var);
+  env->assign (key, copy (t[1]));
+  if (env->get_var_type (key) == Env_Paragraph)
+    control (tuple ("env_par", var, env->read (key)), ip);
+  else if (env->get_var_type (key) == Env_Page)
+    control (tuple ("env_page", var, env->read (key)), ip);
   else control (t, ip);
 }
 
@@ -35,11 +37,12 @@ concater_rep::typeset_provide (tree t, path ip) {
   tree r= env->exec (t[0]);
   if (!is_atomic (r)) return;
   string var= r->label;
-  if (!env->provides (var)) env->assign (var, copy (t[1]));
-  if (env->var_type [var] == Env_Paragraph)
-    control (tuple ("env_par", var, env->read (var)), ip);
-  else if (env->var_type [var] == Env_Page)
-    control (tuple ("env_page", var, env->read (var)), ip);
+  int    key= make_env_key (var);
+  if (!env->provides (key)) env->assign (key, copy (t[1]));
+  if (env->get_var_type (key) == Env_Paragraph)
+    control (tuple ("env_par", var, env->read (key)), ip);
+  else if (env->get_var_type (key) == Env_Page)
+    control (tuple ("env_page", var, env->read (key)), ip);
   else control (t, ip);
 }
 
@@ -48,15 +51,14 @@ concater_rep::typeset_with (tree t, path ip) {
   int i, n= N(t), k= (n-1)>>1; // is k=0 allowed ?
   if ((n&1) != 1) { typeset_error (t, ip); return; }
 
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(oldv,tree,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= env->exec (t[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
-      oldv[i]= env->read (var);
+      vars[i]= make_env_key (var_t->label);
+      oldv[i]= env->read (vars[i]);
       newv[i]= env->exec (t[(i<<1)+1]);
     }
     else {
@@ -80,6 +82,14 @@ concater_rep::typeset_with (tree t, path ip) {
 
 void
 concater_rep::typeset_compound (tree t, path ip) {
+  if (memorize_mode && !rigid && !is_nil (ip) && is_accessible (ip) &&
+      env->hl_lan == 0 && N(env->decorated_boxes) == 0 && is_memo_closed (t))
+    typeset_memorized (t, ip);
+  else typeset_macro (t, ip);
+}
+
+void
+concater_rep::typeset_macro (tree t, path ip) {
   int d; tree f;
   if (L(t) == COMPOUND) {
     if (N(t) == 0) { typeset_error (t, ip); return; }
@@ -107,22 +117,22 @@ concater_rep::typeset_compound (tree t, path ip) {
 
   if (is_applicable (f)) {
     int i, n=N(f)-1, m=N(t)-d;
-    env->macro_arg= list<hashmap<string,tree> > (
-      hashmap<string,tree> (UNINIT), env->macro_arg);
+    env->macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), env->macro_arg);
     env->macro_src= list<hashmap<string,path> > (
       hashmap<string,path> (path (DECORATION)), env->macro_src);
     if (L(f) == XMACRO) {
       if (is_atomic (f[0])) {
         string var= f[0]->label;
-        env->macro_arg->item (var)= t;
+        env->macro_arg->item->write (var, t);
         env->macro_src->item (var)= ip;
       }
     }
     else for (i=0; i<n; i++)
       if (is_atomic (f[i])) {
         string var= f[i]->label;
-        env->macro_arg->item (var)=
-          i<m? t[i+d]: attach_dip (tree (UNINIT), decorate_right(ip));
+        env->macro_arg->item->write (var,
+          i<m? t[i+d]: attach_dip (tree (UNINIT), decorate_right(ip)));
         env->macro_src->item (var)= i<m? descend (ip,i+d): decorate_right(ip);
       }
     if (is_decoration (ip))
@@ -147,12 +157,12 @@ concater_rep::typeset_compound (tree t, path ip) {
 
 void
 concater_rep::typeset_auto (tree t, path ip, tree f) {
-  env->macro_arg= list<hashmap<string,tree> > (
-    hashmap<string,tree> (UNINIT), env->macro_arg);
+  env->macro_arg= list<basic_environment> (
+    basic_environment (1), env->macro_arg);
   env->macro_src= list<hashmap<string,path> > (
     hashmap<string,path> (path (DECORATION)), env->macro_src);
   string var= f[0]->label;
-  env->macro_arg->item (var)= t;
+  env->macro_arg->item->write (var, t);
   env->macro_src->item (var)= ip;
   typeset (attach_right (f[1], ip));
   env->macro_arg= env->macro_arg->next;
@@ -245,7 +255,7 @@ concater_rep::typeset_argument (tree t, path ip) {
   // cout << "Src   " << name << "=\t " << valip << "\n";
 
   marker (descend (ip, 0));
-  list<hashmap<string,tree> > old_var= env->macro_arg;
+  list<basic_environment> old_var= env->macro_arg;
   list<hashmap<string,path> > old_src= env->macro_src;
   if (!is_nil (env->macro_arg)) env->macro_arg= env->macro_arg->next;
   if (!is_nil (env->macro_src)) env->macro_src= env->macro_src->next;
@@ -433,3 +443,74 @@ concater_rep::typeset_range (tree t, path ip) {
     }
   }
 }
+
+/******************************************************************************
+* Memorized macro applications
+* The line items of a macro application are remembered for its position
+* in the document and its environment, so that retypesetting a paragraph
+* reuses the boxes of unchanged applications.  Applications are only
+* memorized when they leave the environment unchanged, have no side effects
+* (see is_memo_barrier) and do not touch the line items before them.
+******************************************************************************/
+
+static memo_positions<array<line_item> > typeset_memo (0);
+
+static line_item
+copy (line_item item) {
+  line_item r (item->type, item->op_type, item->b, item->penalty, item->t);
+  r->spc   = item->spc;
+  r->limits= item->limits;
+  r->lan   = item->lan;
+  return r;
+}
+
+static bool
+same_item (line_item item, int penalty, bool limits, space spc) {
+  return item->penalty == penalty && item->limits == limits &&
+         item->spc->min == spc->min && item->spc->def == spc->def &&
+         item->spc->max == spc->max;
+}
+
+void
+concater_rep::typeset_memorized (tree t, path ip) {
+  bool found;
+  int  i= env->memo_slot (found);
+  if (found) {
+    array<line_item> items;
+    if (typeset_memo.get (ip, env->memo_stamp (), t, items)) {
+      memorize_hits++;
+      for (int j=0; j<N(items); j++) a << copy (items[j]);
+      return;
+    }
+  }
+  memorize_misses++;
+
+  int       start  = N(a);
+  line_item prev   = (start == 0? line_item (): a[start-1]);
+  int       penalty= (start == 0? 0: prev->penalty);
+  bool      limits = (start == 0? false: prev->limits);
+  space     spc    = (start == 0? space (0): prev->spc);
+  DI   old_stamp = env->memo_stamp ();
+  bool old_impure= env->memo_impure;
+  env->memo_impure= false;
+  env->memo_depth++;
+  typeset_macro (t, ip);
+  env->memo_depth--;
+  bool pure= !env->memo_impure;
+  env->memo_impure= old_impure || env->memo_impure;
+  if (!pure || i < 0 || N(a) < start) return;
+  if (start > 0 && (a[start-1] != prev ||
+                    !same_item (prev, penalty, limits, spc))) return;
+  // the application should leave the environment unchanged
+  if (!env->memo_unchanged (i, old_stamp)) return;
+
+  array<line_item> items;
+  for (int j=start; j<N(a); j++) {
+    int type= a[j]->type;
+    if (type == FLOAT_ITEM || type == NOTE_LINE_ITEM ||
+        type == NOTE_PAGE_ITEM) return;
+    items << copy (a[j]);
+  }
+  typeset_memo.capacity= memorize_capacity;
+  typeset_memo.set (ip, env->memo_stamp (), t, items);
+}
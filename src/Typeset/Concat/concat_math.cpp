@@ -222,23 +222,23 @@ concater_rep::typeset_rprime (tree t, path ip) {
 void
 concater_rep::typeset_long_arrow (tree t, path ip) {
   if (N(t) != 2 && N(t) != 3) { typeset_error (t, ip); return; }
-  tree old_ds= env->local_begin (MATH_DISPLAY, "false");
-  tree old_mc= env->local_begin (MATH_CONDENSED, "true");
+  tree old_ds= env->local_begin (MATH_DISPLAY_KEY, "false");
+  tree old_mc= env->local_begin (MATH_CONDENSED_KEY, "true");
   tree old_il= env->local_begin_script ();
   box sup_b, sub_b;
   if (N(t) >= 2) {
-    tree old_vp= env->local_begin (MATH_VPOS, "-1");
+    tree old_vp= env->local_begin (MATH_VPOS_KEY, "-1");
     sup_b= typeset_as_concat (env, t[1], descend (ip, 1));
-    env->local_end (MATH_VPOS, old_vp);
+    env->local_end (MATH_VPOS_KEY, old_vp);
   }
   if (N(t) >= 3) {
-    tree old_vp= env->local_begin (MATH_VPOS, "1");
+    tree old_vp= env->local_begin (MATH_VPOS_KEY, "1");
     sub_b= typeset_as_concat (env, t[2], descend (ip, 2));
-    env->local_end (MATH_VPOS, old_vp);
+    env->local_end (MATH_VPOS_KEY, old_vp);
   }
   env->local_end_script (old_il);
-  env->local_end (MATH_CONDENSED, old_mc);
-  env->local_end (MATH_DISPLAY, old_ds);
+  env->local_end (MATH_CONDENSED_KEY, old_mc);
+  env->local_end (MATH_DISPLAY_KEY, old_ds);
 
   string s= env->exec_string (t[0]);
   SI w= sup_b->w();
@@ -258,13 +258,13 @@ void
 concater_rep::typeset_below (tree t, path ip) {
   if (N(t) != 2) { typeset_error (t, ip); return; }
   box b1= typeset_as_concat (env, t[0], descend (ip, 0));
-  tree old_ds= env->local_begin (MATH_DISPLAY, "false");
-  tree old_mc= env->local_begin (MATH_CONDENSED, "true");
+  tree old_ds= env->local_begin (MATH_DISPLAY_KEY, "false");
+  tree old_mc= env->local_begin (MATH_CONDENSED_KEY, "true");
   tree old_il= env->local_begin_script ();
   box b2= typeset_as_concat (env, t[1], descend (ip, 1));
   env->local_end_script (old_il);
-  env->local_end (MATH_CONDENSED, old_mc);
-  env->local_end (MATH_DISPLAY, old_ds);
+  env->local_end (MATH_CONDENSED_KEY, old_mc);
+  env->local_end (MATH_DISPLAY_KEY, old_ds);
   print (limit_box (ip, b1, b2, box (), env->fn, false));
 }
 
@@ -272,13 +272,13 @@ void
 concater_rep::typeset_above (tree t, path ip) {
   if (N(t) != 2) { typeset_error (t, ip); return; }
   box b1= typeset_as_concat (env, t[0], descend (ip, 0));
-  tree old_ds= env->local_begin (MATH_DISPLAY, "false");
-  tree old_mc= env->local_begin (MATH_CONDENSED, "true");
+  tree old_ds= env->local_begin (MATH_DISPLAY_KEY, "false");
+  tree old_mc= env->local_begin (MATH_CONDENSED_KEY, "true");
   tree old_il= env->local_begin_script ();
   box b2= typeset_as_concat (env, t[1], descend (ip, 1));
   env->local_end_script (old_il);
-  env->local_end (MATH_CONDENSED, old_mc);
-  env->local_end (MATH_DISPLAY, old_ds);
+  env->local_end (MATH_CONDENSED_KEY, old_mc);
+  env->local_end (MATH_DISPLAY_KEY, old_ds);
   // NOTE: start dirty hack to get scripts above ... right
   if ((t[0] == "<ldots>" && env->read ("low-dots") != UNINIT) ||
       (t[0] == "<cdots>" && env->read ("center-dots") != UNINIT)) {
@@ -295,24 +295,24 @@ concater_rep::typeset_script (tree t, path ip, bool right) {
   if (N(t) != 1) { typeset_error (t, ip); return; }
   int type= RSUP_ITEM;
   box b1, b2;
-  tree old_ds= env->local_begin (MATH_DISPLAY, "false");
-  tree old_mc= env->local_begin (MATH_CONDENSED, "true");
+  tree old_ds= env->local_begin (MATH_DISPLAY_KEY, "false");
+  tree old_mc= env->local_begin (MATH_CONDENSED_KEY, "true");
   tree old_il= env->local_begin_script ();
   if (is_func (t, SUB (right))) {
-    tree old_vp= env->local_begin (MATH_VPOS, "-1");
+    tree old_vp= env->local_begin (MATH_VPOS_KEY, "-1");
     b1= typeset_as_concat (env, t[0], descend (ip, 0));
     type= right? RSUB_ITEM: LSUB_ITEM;
-    env->local_end (MATH_VPOS, old_vp);
+    env->local_end (MATH_VPOS_KEY, old_vp);
   }
   if (is_func (t, SUP (right))) {
-    tree old_vp= env->local_begin (MATH_VPOS, "1");
+    tree old_vp= env->local_begin (MATH_VPOS_KEY, "1");
     b2= typeset_as_concat (env, t[0], descend (ip, 0));
     type= right? RSUP_ITEM: LSUP_ITEM;
-    env->local_end (MATH_VPOS, old_vp);
+    env->local_end (MATH_VPOS_KEY, old_vp);
   }
   env->local_end_script (old_il);
-  env->local_end (MATH_CONDENSED, old_mc);
-  env->local_end (MATH_DISPLAY, old_ds);
+  env->local_end (MATH_CONDENSED_KEY, old_mc);
+  env->local_end (MATH_DISPLAY_KEY, old_ds);
   if (right) penalty_max (HYPH_INVALID);
   a << line_item (type, OP_SKIP,
                   script_box (ip, b1, b2, env->fn), HYPH_INVALID);
@@ -370,15 +370,15 @@ concater_rep::typeset_frac (tree t, path ip) {
   if (N(t) != 2) { typeset_error (t, ip); return; }
   bool disp= env->display_style;
   tree old;
-  if (disp) old= env->local_begin (MATH_DISPLAY, "false");
+  if (disp) old= env->local_begin (MATH_DISPLAY_KEY, "false");
   else old= env->local_begin_script ();
-  tree old_vp= env->local_begin (MATH_VPOS, "1");
+  tree old_vp= env->local_begin (MATH_VPOS_KEY, "1");
   box num= typeset_as_concat (env, t[0], descend (ip, 0));
-  env->local_end (MATH_VPOS, "-1");
+  env->local_end (MATH_VPOS_KEY, "-1");
   box den= typeset_as_concat (env, t[1], descend (ip, 1));
-  env->local_end (MATH_VPOS, old_vp);
+  env->local_end (MATH_VPOS_KEY, old_vp);
   font sfn= env->fn;
-  if (disp) env->local_end (MATH_DISPLAY, old);
+  if (disp) env->local_end (MATH_DISPLAY_KEY, old);
   else env->local_end_script (old);
   if (num->w() <= env->frac_max && den->w () <= env->frac_max)
     print (frac_box (ip, num, den, env->fn, sfn, env->pen));
@@ -406,7 +406,7 @@ concater_rep::typeset_wide_sqrt (tree t, path ip) {
 
   bool disp= env->display_style;
   tree old;
-  if (disp) old= env->local_begin (MATH_DISPLAY, "false");
+  if (disp) old= env->local_begin (MATH_DISPLAY_KEY, "false");
   tree old_il= env->local_begin_script ();
   env->pen= env->flatten_pen;
   box num= typeset_as_concat (env, "1", decorate_middle (ip));
@@ -420,7 +420,7 @@ concater_rep::typeset_wide_sqrt (tree t, path ip) {
   box fr= frac_box (decorate_middle (ip), num, den, env->fn, env->fn, env->pen);
   env->pen= old_pen;
   env->local_end_script (old_il);
-  if (disp) env->local_end (MATH_DISPLAY, old);
+  if (disp) env->local_end (MATH_DISPLAY_KEY, old);
   penalty_max (HYPH_INVALID);
   a << line_item (RSUP_ITEM, OP_SKIP,
                   script_box (ip, box (), fr, env->fn), HYPH_INVALID);
@@ -439,11 +439,11 @@ concater_rep::typeset_sqrt (tree t, path ip) {
   if (N(t)==2) {
     bool disp= env->display_style;
     tree old;
-    if (disp) old= env->local_begin (MATH_DISPLAY, "false");
+    if (disp) old= env->local_begin (MATH_DISPLAY_KEY, "false");
     tree old_il= env->local_begin_script ();
     ind= typeset_as_concat (env, t[1], descend (ip, 1));
     env->local_end_script (old_il);
-    if (disp) env->local_end (MATH_DISPLAY, old);
+    if (disp) env->local_end (MATH_DISPLAY_KEY, old);
   }
   SI sep= env->fn->sep;
   font lfn= env->fn;
@@ -519,11 +519,13 @@ make_large (tree_label l, tree t) {
 void
 concater_rep::typeset_around (tree t, path ip, bool colored) {
   tree old_nl=
-    env->local_begin (MATH_NESTING_LEVEL, as_string (env->nesting_level + 1));
+    env->local_begin (MATH_NESTING_LEVEL_KEY,
+                      as_string (env->nesting_level + 1));
   if (colored) {
-    tree old_col= env->local_begin (COLOR, bracket_color (env->nesting_level));
+    tree old_col=
+      env->local_begin (COLOR_KEY, bracket_color (env->nesting_level));
     typeset_around (t, ip, false);
-    env->local_end (COLOR, old_col);
+    env->local_end (COLOR_KEY, old_col);
   }
   else {
     marker (descend (ip, 0));
@@ -570,7 +572,7 @@ concater_rep::typeset_around (tree t, path ip, bool colored) {
     }
     marker (descend (ip, 1));
   }
-  env->local_end (MATH_NESTING_LEVEL, old_nl);
+  env->local_end (MATH_NESTING_LEVEL_KEY, old_nl);
 }
 
 void
@@ -586,7 +588,7 @@ void
 concater_rep::typeset_table (tree t, path ip) {
   box b= typeset_as_table (env, t, ip);
   if (b->w () <= env->table_max) { print (b); return; }
-  if (env->read (TABLE_WIDTH) != "") { print (b); return; }
+  if (env->read (TABLE_WIDTH_KEY) != "") { print (b); return; }
   path ip1= ip;
   tree t1 = t;
   while (is_func (t1, TFORMAT)) {
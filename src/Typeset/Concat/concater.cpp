@@ -184,6 +184,7 @@ concater_rep::typeset (tree t, path ip) {
     return;
   }
 
+  if (env->memo_depth > 0 && is_memo_barrier (L(t))) env->memo_impure= true;
   switch (L (t)) {
   case UNINIT:
   case ERROR:
@@ -320,7 +321,7 @@ concater_rep::typeset (tree t, path ip) {
     break;
   case YES_INDENT:
     flag ("yes-first-indent", ip, brown);
-    control (tuple ("env_par", PAR_FIRST, env->read (PAR_FIRST)), ip);
+    control (tuple ("env_par", PAR_FIRST, env->read (PAR_FIRST_KEY)), ip);
     break;
   case NO_INDENT:
     flag ("no-first-indent", ip, brown);
@@ -356,7 +357,7 @@ concater_rep::typeset (tree t, path ip) {
   case AROUND:
   case VAR_AROUND:
   case BIG_AROUND:
-    typeset_around (t, ip, env->get_string (MATH_NESTING_MODE) != "off");
+    typeset_around (t, ip, env->get_string (MATH_NESTING_MODE_KEY) != "off");
     break;
   case LEFT:
     typeset_large (t, ip, LEFT_BRACKET_ITEM, OP_OPENING_BRACKET, "<left-");
@@ -984,15 +985,14 @@ typeset_as_atomic (edit_env env, tree t, path ip) {
     int i, n= N(t), k= (n-1)>>1; // is k=0 allowed ?
     if ((n&1) != 1) return empty_box (ip);
 
-    STACK_NEW_ARRAY(vars,string,k);
+    STACK_NEW_ARRAY(vars,int,k);
     STACK_NEW_ARRAY(oldv,tree,k);
     STACK_NEW_ARRAY(newv,tree,k);
     for (i=0; i<k; i++) {
       tree var_t= env->exec (t[i<<1]);
       if (is_atomic (var_t)) {
-	string var= var_t->label;
-	vars[i]= var;
-	oldv[i]= env->read (var);
+	vars[i]= make_env_key (var_t->label);
+	oldv[i]= env->read (vars[i]);
 	newv[i]= env->exec (t[(i<<1)+1]);
       }
       else {
@@ -1019,9 +1019,9 @@ typeset_as_atomic (edit_env env, tree t, path ip) {
     list<string> ids;
     string col;
     (void) build_locus (env, t, ids, col, ref, anchor);
-    tree old= env->local_begin (COLOR, col);
+    tree old= env->local_begin (COLOR_KEY, col);
     box b= typeset_as_atomic (env, t[last], descend (ip, last));
-    env->local_end (COLOR, old);
+    env->local_end (COLOR_KEY, old);
     return b;
   }
   else {
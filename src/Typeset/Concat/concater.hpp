@@ -111,6 +111,8 @@ class concater_rep {
   void typeset_provide (tree t, path ip);
   void typeset_with (tree t, path ip);
   void typeset_compound (tree t, path ip);
+  void typeset_macro (tree t, path ip);
+  void typeset_memorized (tree t, path ip);
   void typeset_auto (tree t, path ip, tree macro);
   void typeset_include (tree t, path ip);
   void typeset_drd_props (tree t, path ip);
@@ -11,12 +11,47 @@
 
 #include "env.hpp"
 #include "iterator.hpp"
-extern hashmap<string,int> default_var_type;
+extern array<int> default_var_type;
 void initialize_default_var_type ();
 extern hashmap<string,tree> default_env;
 void initialize_default_env ();
 #include "page_type.hpp"
 
+/******************************************************************************
+* Conversion between hashmaps and integer keyed environments
+******************************************************************************/
+
+static basic_environment
+as_basic_environment (hashmap<string,tree> h) {
+  basic_environment env (round_pow2 (max (N(h), 1)));
+  iterator<string> it= iterate (h);
+  while (it->busy ()) {
+    string s= it->next ();
+    env->write (s, h[s]);
+  }
+  return env;
+}
+
+static hashmap<string,tree>
+as_hashmap (basic_environment env) {
+  hashmap<string,tree> h (UNINIT, env->n);
+  hash_node* a= env->a;
+  for (int k=0; k<env->n; k++)
+    for (int i= a[k].start; i >= 0; i= a[i].next)
+      h (env_key_name (a[i].key))= a[i].val;
+  return h;
+}
+
+static basic_environment
+default_environment () {
+  static basic_environment def;
+  if (is_nil (def)) {
+    initialize_default_env ();
+    def= as_basic_environment (default_env);
+  }
+  return copy (def);
+}
+
 /******************************************************************************
 * Initialization
 ******************************************************************************/
@@ -30,7 +65,7 @@ edit_env_rep::edit_env_rep (drd_info& drd2,
 			    hashmap<string,tree>& local_att2,
 			    hashmap<string,tree>& global_att2):
   drd (drd2),
-  env (UNINIT), back (UNINIT), src (path (DECORATION)),
+  env (1), back (1), src (path (DECORATION)),
   var_type (default_var_type),
   base_file_name (base_file_name2),
   cur_file_name (base_file_name2),
@@ -38,14 +73,17 @@ edit_env_rep::edit_env_rep (drd_info& drd2,
   local_ref (local_ref2), global_ref (global_ref2),
   local_aux (local_aux2), global_aux (global_aux2),
   local_att (local_att2), global_att (global_att2),
-  missing (UNINIT), redefined (), touched (false)
+  missing (UNINIT), redefined (), touched (false),
+  ref_ip (DETACHED), ref_readers (list<path> ())
 {
-  initialize_default_env ();
   initialize_default_var_type ();
-  env= copy (default_env);
+  env= default_environment ();
   style_init_env ();
   update ();
+  memo_depth= 0;
+  memo_impure= false;
   complete= false;
+  ref_check= false;
   recover_env= tuple ();
   anim_start= anim_end= anim_portion= 0.0;
 }
@@ -69,7 +107,7 @@ edit_env_rep::style_init_env () {
   inch= ((double) dpi*PIXEL);
   flexibility= get_double (PAGE_FLEXIBILITY);
   first_page= get_double (PAGE_FIRST);
-  back= hashmap<string,tree> (UNINIT);
+  back= basic_environment (1);
   update_page_pars ();
 }
 
@@ -120,23 +158,23 @@ edit_env_rep::local_begin_extents (box b) {
 		  env ["w-length"], env ["h-length"],
 		  env ["l-length"], env ["b-length"],
 		  env ["r-length"], env ["t-length"]);
-  env ("w-length")= as_string (b->w ()) * "tmpt";
-  env ("h-length")= as_string (b->h ()) * "tmpt";
-  env ("l-length")= as_string (b->x1) * "tmpt";
-  env ("b-length")= as_string (b->y1) * "tmpt";
-  env ("r-length")= as_string (b->x2) * "tmpt";
-  env ("t-length")= as_string (b->y2) * "tmpt";
+  env->write ("w-length", as_string (b->w ()) * "tmpt");
+  env->write ("h-length", as_string (b->h ()) * "tmpt");
+  env->write ("l-length", as_string (b->x1) * "tmpt");
+  env->write ("b-length", as_string (b->y1) * "tmpt");
+  env->write ("r-length", as_string (b->x2) * "tmpt");
+  env->write ("t-length", as_string (b->y2) * "tmpt");
   return old;
 }
 
 void
 edit_env_rep::local_end_extents (tree t) {
-  env ("w-length")= t[0];
-  env ("h-length")= t[1];
-  env ("l-length")= t[2];
-  env ("b-length")= t[3];
-  env ("r-length")= t[4];
-  env ("t-length")= t[5];
+  env->write ("w-length", t[0]);
+  env->write ("h-length", t[1]);
+  env->write ("l-length", t[2]);
+  env->write ("b-length", t[3]);
+  env->write ("r-length", t[4]);
+  env->write ("t-length", t[5]);
 }
 
 /******************************************************************************
@@ -145,12 +183,12 @@ edit_env_rep::local_end_extents (tree t) {
 
 void
 edit_env_rep::write_default_env () {
-  env= copy (default_env);
+  env= default_environment ();
 }
 
 void
 edit_env_rep::write_env (hashmap<string,tree> user_env) {
-  env= copy (user_env);
+  env= as_basic_environment (user_env);
 }
 
 void
@@ -177,32 +215,55 @@ edit_env_rep::patch_env (hashmap<string,tree> patch) {
 
 void
 edit_env_rep::read_env (hashmap<string,tree>& ret) {
-  ret= copy (env);
+  ret= as_hashmap (env);
 }
 
 void
-edit_env_rep::local_start (hashmap<string,tree>& prev_back) {
+edit_env_rep::local_start (basic_environment& prev_back) {
   prev_back= back;
-  back= hashmap<string,tree> (UNINIT);  
+  back= basic_environment (1);
 }
 
 void
 edit_env_rep::local_update (hashmap<string,tree>& old_patch,
 			    hashmap<string,tree>& change)
 {
-  old_patch->pre_patch (back, env);
-  old_patch->post_patch (change, env);
-  change= invert (back, env);
+  // same as pre_patch (back, env), post_patch (change, env)
+  // and invert (back, env) for hashmaps, but with integer keys for env
+  hash_node* a= back->a;
+  hashmap<string,tree> inv (UNINIT);
+  int i, k, n= back->n;
+  for (k=0; k<n; k++)
+    for (i= a[k].start; i >= 0; i= a[i].next) {
+      string x= env_key_name (a[i].key);
+      tree   y= old_patch->contains (x)? old_patch [x]: a[i].val;
+      if (env [a[i].key] == y) old_patch->reset (x);
+      else old_patch (x)= y;
+    }
+  n= change->n;
+  for (k=0; k<n; k++) {
+    list<hashentry<string,tree> > l= change->a[k];
+    for (; !is_nil(l); l=l->next) {
+      if (env [l->item.key] == l->item.im) old_patch->reset (l->item.key);
+      else old_patch (l->item.key)= l->item.im;
+    }
+  }
+  n= back->n;
+  for (k=0; k<n; k++)
+    for (i= a[k].start; i >= 0; i= a[i].next) {
+      tree y= env [a[i].key];
+      if (a[i].val != y) inv (env_key_name (a[i].key))= y;
+    }
+  change= inv;
 }
 
 void
-edit_env_rep::local_end (hashmap<string,tree>& prev_back) {
-  int i=0, n=back->n;
-  for (; i<n; i++) {
-    list<hashentry<string,tree> > l=back->a[i];
-    for (; !is_nil(l); l=l->next)
-      prev_back->write_back (l->item.key, back);
-  }
+edit_env_rep::local_end (basic_environment& prev_back) {
+  hash_node* a= back->a;
+  for (int k=0; k<back->n; k++)
+    for (int i= a[k].start; i >= 0; i= a[i].next)
+      if (!prev_back->contains (a[i].key))
+        prev_back->write (a[i].key, a[i].val);
   back= prev_back;
 }
 
@@ -19,6 +19,7 @@
 #include "typesetter.hpp"
 #include "drd_mode.hpp"
 #include "dictionary.hpp"
+#include "memorizer.hpp"
 
 extern int script_status;
 extern tree with_package_definitions (string package, tree body);
@@ -82,7 +83,7 @@ edit_env_rep::rewrite (tree t) {
       if (N(t)>=4) start= as_int (exec (t[3]));
       if (N(t)>=5) end  = as_int (exec (t[4]));
 
-      list<hashmap<string,tree> > old_var= macro_arg;
+      list<basic_environment> old_var= macro_arg;
       list<hashmap<string,path> > old_src= macro_src;
       if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
       if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -187,6 +188,7 @@ tree
 edit_env_rep::exec (tree t) {
   // cout << "Execute: " << t << "\n";
   if (is_atomic (t)) return t;
+  if (memo_depth > 0 && is_memo_barrier (L(t))) memo_impure= true;
   switch (L(t)) {
   case MOVE:
   case SHIFT:
@@ -626,15 +628,14 @@ tree
 edit_env_rep::exec_with (tree t) {
   int i, n= N(t), k= (n-1)>>1; // is k=0 allowed ?
   if ((n&1) != 1) return tree (ERROR, "bad with");
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(oldv,tree,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= exec (t[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
-      oldv[i]= read (var);
+      vars[i]= make_env_key (var_t->label);
+      oldv[i]= read (vars[i]);
       newv[i]= exec (t[(i<<1)+1]);
     }
     else {
@@ -652,7 +653,7 @@ edit_env_rep::exec_with (tree t) {
 
   tree u (WITH, n);
   for (i=0; i<k; i++) {
-    u[i<<1]    = vars[i];
+    u[i<<1]    = env_key_name (vars[i]);
     u[(i<<1)+1]= tree (QUOTE, newv[i]);
   }
   u[n-1]= r;
@@ -664,6 +665,12 @@ edit_env_rep::exec_with (tree t) {
 
 tree
 edit_env_rep::exec_compound (tree t) {
+  if (memorize_mode) return exec_memorized (t);
+  return exec_macro (t);
+}
+
+tree
+edit_env_rep::exec_macro (tree t) {
   int d; tree f;
   if (L(t) == COMPOUND) {
     if (N(t)<1) return tree (ERROR, "bad compound");
@@ -685,18 +692,18 @@ edit_env_rep::exec_compound (tree t) {
 
   if (is_applicable (f)) {
     int i, n=N(f)-1, m=N(t)-d;
-    macro_arg= list<hashmap<string,tree> > (
-      hashmap<string,tree> (UNINIT), macro_arg);
+    macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), macro_arg);
     macro_src= list<hashmap<string,path> > (
       hashmap<string,path> (path (DECORATION)), macro_src);
     if (L(f) == XMACRO) {
       if (is_atomic (f[0]))
-	macro_arg->item (f[0]->label)= t;
+	macro_arg->item->write (f[0]->label, t);
     }
     else for (i=0; i<n; i++)
       if (is_atomic (f[i])) {
 	tree st= i<m? t[i+d]: tree (UNINIT);
-	macro_arg->item (f[i]->label)= st;
+	macro_arg->item->write (f[i]->label, st);
 	macro_src->item (f[i]->label)= obtain_ip (st);
       }
     tree r= exec (f[n]);
@@ -881,7 +888,7 @@ edit_env_rep::exec_arg (tree t) {
   if (is_nil (macro_arg) || (!macro_arg->item->contains (r->label)))
     return tree (ERROR, "arg " * r->label);
   r= macro_arg->item [r->label];
-  list<hashmap<string,tree> > old_var= macro_arg;
+  list<basic_environment> old_var= macro_arg;
   list<hashmap<string,path> > old_src= macro_src;
   if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
   if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -954,7 +961,7 @@ edit_env_rep::exec_eval_args (tree t) {
   if(is_nil(macro_arg)) return tree(ERROR, "nil argument");
   tree v= macro_arg->item [as_string (t[0])];
   if (is_atomic (v)) return tree (ERROR, "eval arguments " * t[0]->label);
-  list<hashmap<string,tree> > old_var= macro_arg;
+  list<basic_environment> old_var= macro_arg;
   list<hashmap<string,path> > old_src= macro_src;
   if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
   if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -1765,7 +1772,7 @@ edit_env_rep::exec_arg_recursive (tree t) {
   if (is_nil (macro_arg) || (!macro_arg->item->contains (r->label)))
     return tree (ERROR, "arg " * r->label);
   r= macro_arg->item [r->label];
-  list<hashmap<string,tree> > old_var= macro_arg;
+  list<basic_environment> old_var= macro_arg;
   list<hashmap<string,path> > old_src= macro_src;
   if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
   if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -2007,7 +2014,7 @@ edit_env_rep::exec_set_binding (tree t) {
       local_ref (key) << extra;
     }
     touched (key)= true;
-    if (complete && is_tuple (old_value) && N(old_value) >= 1) {
+    if ((complete || ref_check) && is_tuple (old_value) && N(old_value) >= 1) {
       string old_s= tree_as_string (old_value[0]);
       string new_s= tree_as_string (value);
       if (new_s != old_s && !starts (key, "auto-")) {
@@ -2020,16 +2027,27 @@ edit_env_rep::exec_set_binding (tree t) {
   return tree (HIDDEN_BINDING, keys, value);
 }
 
+void
+edit_env_rep::record_reader (string key) {
+  // remember the bridge which depends on the reference, so that only
+  // this bridge needs to be retypeset when the reference changes
+  if (!complete && !ref_check) return;
+  list<path> l= ref_readers [key];
+  if (is_nil (l) || l->item != ref_ip)
+    ref_readers (key)= list<path> (ref_ip, l);
+}
+
 tree
 edit_env_rep::exec_get_binding (tree t) {
   if (N(t) != 1 && N(t) != 2) return tree (ERROR, "bad get binding");
   string key= exec_string (t[0]);
+  record_reader (key);
   tree value= local_ref->contains (key)? local_ref [key]: global_ref [key];
   int type= (N(t) == 1? 0: as_int (exec_string (t[1])));
   if (type != 0 && type != 1) type= 0;
   if (is_func (value, TUPLE) && (N(value) >= 2)) value= value[type];
   else if (type == 1) value= tree (UNINIT);
-  if (complete && value == tree (UNINIT))
+  if ((complete || ref_check) && value == tree (UNINIT))
     if (get_bool (WARN_MISSING)) {
       missing (key)= tree (GET_BINDING, key);
       //typeset_warning << "Undefined reference " << key << LF;
@@ -2042,6 +2060,7 @@ tree
 edit_env_rep::exec_has_binding (tree t) {
   if (N(t) != 1 && N(t) != 2) return tree (ERROR, "bad get binding");
   string key= exec_string (t[0]);
+  record_reader (key);
   tree value= local_ref->contains (key)? local_ref [key]: global_ref [key];
   int type= (N(t) == 1? 0: as_int (exec_string (t[1])));
   if (type != 0 && type != 1) type= 0;
@@ -2387,13 +2406,12 @@ void
 edit_env_rep::exec_until_with (tree t, path p) {
   int i, n= N(t), k= (n-1)>>1; // is k=0 allowed ?
   if (((n&1) != 1) || (p->item != n-1)) return;
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= exec (t[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
+      vars[i]= make_env_key (var_t->label);
       newv[i]= exec (t[(i<<1)+1]);
     }
     else {
@@ -2438,13 +2456,13 @@ edit_env_rep::exec_until_compound (tree t, path p) {
 
   if (is_applicable (f)) {
     int i, n=N(f)-1, m=N(t)-d;
-    macro_arg= list<hashmap<string,tree> >
-      (hashmap<string,tree> (UNINIT), macro_arg);
+    macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), macro_arg);
     macro_src= list<hashmap<string,path> >
       (hashmap<string,path> (path (DECORATION)), macro_src);
     if (L(f) == XMACRO) {
       if (is_atomic (f[0])) {
-	macro_arg->item (f[0]->label)= t;
+	macro_arg->item->write (f[0]->label, t);
 	macro_src->item (f[0]->label)= obtain_ip (t);
       }
       (void) exec_until (f[n], p, var, 0);
@@ -2453,7 +2471,7 @@ edit_env_rep::exec_until_compound (tree t, path p) {
       for (i=0; i<n; i++)
 	if (is_atomic (f[i])) {
 	  tree st= i<m? t[i+d]: tree (UNINIT);
-	  macro_arg->item (f[i]->label)= st;
+	  macro_arg->item->write (f[i]->label, st);
 	  macro_src->item (f[i]->label)= obtain_ip (st);
 	}
       (void) exec_until (f[n], p->next, var, 0);
@@ -2651,15 +2669,14 @@ bool
 edit_env_rep::exec_until_with (tree t, path p, string var, int level) {
   int i, n= N(t), k= (n-1)>>1; // is k=0 allowed ?
   if ((n&1) != 1) return false;
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(oldv,tree,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= exec (t[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
-      oldv[i]= read (var);
+      vars[i]= make_env_key (var_t->label);
+      oldv[i]= read (vars[i]);
       newv[i]= exec (t[(i<<1)+1]);
     }
     else {
@@ -2706,18 +2723,18 @@ edit_env_rep::exec_until_compound (tree t, path p, string var, int level) {
 
   if (is_applicable (f)) {
     int i, n=N(f)-1, m=N(t)-d;
-    macro_arg= list<hashmap<string,tree> >
-      (hashmap<string,tree> (UNINIT), macro_arg);
+    macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), macro_arg);
     macro_src= list<hashmap<string,path> >
       (hashmap<string,path> (path (DECORATION)), macro_src);
     if (L(f) == XMACRO) {
       if (is_atomic (f[0]))
-	macro_arg->item (f[0]->label)= t;
+	macro_arg->item->write (f[0]->label, t);
     }
     for (i=0; i<n; i++)
       if (is_atomic (f[i])) {
 	tree st= i<m? t[i+d]: tree (UNINIT);
-	macro_arg->item (f[i]->label)= st;
+	macro_arg->item->write (f[i]->label, st);
 	macro_src->item (f[i]->label)= obtain_ip (st);
       }
     bool done= exec_until (f[n], p, var, level+1);
@@ -2737,7 +2754,7 @@ edit_env_rep::exec_until_arg (tree t, path p, string var, int level) {
     {
       bool found;
       tree arg= macro_arg->item [r->label];
-      list<hashmap<string,tree> > old_var= macro_arg;
+      list<basic_environment> old_var= macro_arg;
       list<hashmap<string,path> > old_src= macro_src;
       if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
       if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -2771,7 +2788,7 @@ edit_env_rep::exec_until_arg (tree t, path p, string var, int level) {
   if (is_atomic (r) && (r->label == var) && (!is_nil (macro_arg))) {
     bool found= (level == 0) && macro_arg->item->contains (r->label);
     tree arg  = macro_arg->item [var];
-    list<hashmap<string,tree> > old_var= macro_arg;
+    list<basic_environment> old_var= macro_arg;
     list<hashmap<string,path> > old_src= macro_src;
     if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
     if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -2865,7 +2882,7 @@ edit_env_rep::expand (tree t, bool search_accessible) {
     if (!macro_arg->item->contains (t[0]->label))
       return tree (ERROR, "argument " * t[0]->label);
     tree r= macro_arg->item [t[0]->label];
-    list<hashmap<string,tree> > old_var= macro_arg;
+    list<basic_environment> old_var= macro_arg;
     list<hashmap<string,path> > old_src= macro_src;
     if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
     if (!is_nil (macro_src)) macro_src= macro_src->next;
@@ -2926,7 +2943,7 @@ edit_env_rep::depends (tree t, string s, int level) {
       if (!macro_arg->item->contains (v->label)) return false;
       if (level == 0) return v->label == s;
       tree r= macro_arg->item [v->label];
-      list<hashmap<string,tree> > old_var= macro_arg;
+      list<basic_environment> old_var= macro_arg;
       list<hashmap<string,path> > old_src= macro_src;
       if (!is_nil (macro_arg)) macro_arg= macro_arg->next;
       if (!is_nil (macro_src)) macro_src= macro_src->next;
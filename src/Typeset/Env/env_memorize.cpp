@@ -0,0 +1,109 @@
+/******************************************************************************
+* MODULE     : env_memorize.cpp
+* DESCRIPTION: memorizing macro expansions during the typesetting
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "env.hpp"
+#include "memorizer.hpp"
+
+/******************************************************************************
+* When memorize_mode is set, the expansions of macro applications are
+* remembered for a small number of environments which keep coming back
+* (see memo_environment.hpp).  Only atomic results of closed applications
+* without side effects are memorized, so that no ip information gets lost
+* when reusing them.  The concater memorizes the line items of typeset
+* macro applications in a similar way (see concat_macro.cpp).
+******************************************************************************/
+
+bool
+is_memo_closed (tree t) {
+  // does t not refer to the arguments of an enclosing macro?
+  if (is_atomic (t)) return true;
+  switch (L(t)) {
+  case ARG:
+  case QUOTE_ARG:
+  case MAP_ARGS:
+  case EVAL_ARGS:
+    return false;
+  default:
+    break;
+  }
+  int i, n= N(t);
+  for (i=0; i<n; i++)
+    if (!is_memo_closed (t[i])) return false;
+  return true;
+}
+
+bool
+is_memo_barrier (tree_label l) {
+  // constructs whose value does not only depend on the environment,
+  // or which have side effects outside the environment
+  switch (l) {
+  case EXTERN:
+  case INCLUDE:
+  case VAR_INCLUDE:
+  case WITH_PACKAGE:
+  case USE_PACKAGE:
+  case USE_MODULE:
+  case _DATE:
+  case FIND_FILE:
+  case FIND_FILE_UPWARDS:
+  case HARD_ID:
+  case SCRIPT:
+  case FIND_ACCESSIBLE:
+  case SET_BINDING:
+  case GET_BINDING:
+  case HAS_BINDING:
+  case GET_ATTACHMENT:
+  case WRITE:
+  case ANIM_STATIC:
+  case ANIM_DYNAMIC:
+  case MORPH:
+  case ANIM_TIME:
+  case ANIM_PORTION:
+  case BOX_INFO:
+  case FRAME_DIRECT:
+  case FRAME_INVERSE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/******************************************************************************
+* Memorized expansion
+******************************************************************************/
+
+tree
+edit_env_rep::exec_memorized (tree t) {
+  if (!is_memo_closed (t)) return exec_macro (t);
+  bool found;
+  int  i= memo_slot (found);
+  if (found) {
+    tree r= memo->get (i, t);
+    if (is_atomic (r)) {
+      memorize_hits++;
+      return r;
+    }
+  }
+  memorize_misses++;
+
+  DI   old_stamp = env->stamp;
+  bool old_impure= memo_impure;
+  memo_impure= false;
+  memo_depth++;
+  tree r= exec_macro (t);
+  memo_depth--;
+  bool pure= !memo_impure;
+  memo_impure= old_impure || memo_impure;
+  if (!pure || !is_atomic (r) || i < 0) return r;
+  // the expansion should leave the environment unchanged
+  if (!memo_unchanged (i, old_stamp)) return r;
+  memo->set (i, t, r, memorize_capacity / N(memo));
+  return r;
+}
@@ -19,143 +19,152 @@
 * Retrieving the page size
 ******************************************************************************/
 
-/*static*/ hashmap<string,int> default_var_type (Env_User);
+/*static*/ array<int> default_var_type;
+
+static void
+set_var_type (int key, int type) {
+  int i, n= N(default_var_type);
+  if (key >= n) {
+    default_var_type->resize (key + 1);
+    for (i=n; i<key; i++) default_var_type[i]= Env_User;
+  }
+  default_var_type[key]= type;
+}
 
 /*static*/ void
 initialize_default_var_type () {
   if (N(default_var_type) != 0) return;
-  hashmap<string,int>& var_type= default_var_type;
-
-  var_type (DPI)                = Env_Fixed;
-  var_type (ZOOM_FACTOR)        = Env_Zoom;
-  var_type (PREAMBLE)           = Env_Preamble;
-  var_type (SAVE_AUX)           = Env_Fixed;
-  var_type (MODE)               = Env_Mode;
-  var_type (INFO_FLAG)          = Env_Info_Level;
-
-  var_type (FONT)               = Env_Font;
-  var_type (FONT_FAMILY)        = Env_Font;
-  var_type (FONT_SERIES)        = Env_Font;
-  var_type (FONT_SHAPE)         = Env_Font;
-  var_type (FONT_SIZE)          = Env_Font_Size;
-  var_type (FONT_BASE_SIZE)     = Env_Font_Size;
-  var_type (FONT_EFFECTS)       = Env_Font;
-  var_type (MAGNIFICATION)      = Env_Magnification;
-  var_type (MAGNIFY)            = Env_Magnify;
-  var_type (COLOR)              = Env_Color;
-  var_type (OPACITY)            = Env_Color;
-  var_type (NO_PATTERNS)        = Env_Pattern_Mode;
-  var_type (LANGUAGE)           = Env_Language;
-  var_type (SPACING_POLICY)     = Env_Spacing;
-
-  var_type (MATH_LANGUAGE)      = Env_Language;
-  var_type (MATH_FONT)          = Env_Font;
-  var_type (MATH_FONT_FAMILY)   = Env_Font;
-  var_type (MATH_FONT_SERIES)   = Env_Font;
-  var_type (MATH_FONT_SHAPE)    = Env_Font;
-  var_type (MATH_FONT_SIZES)    = Env_Font_Sizes;
-  var_type (MATH_LEVEL)         = Env_Index_Level;
-  var_type (MATH_DISPLAY)       = Env_Display_Style;
-  var_type (MATH_CONDENSED)     = Env_Math_Condensed;
-  var_type (MATH_VPOS)          = Env_Vertical_Pos;
-  var_type (MATH_NESTING_LEVEL) = Env_Math_Nesting;
-  var_type (MATH_FRAC_LIMIT)    = Env_Math_Width;
-  var_type (MATH_TABLE_LIMIT)   = Env_Math_Width;
-  var_type (MATH_FLATTEN_COLOR) = Env_Math_Width;
-
-  var_type (PROG_LANGUAGE)      = Env_Language;
-  var_type (PROG_FONT)          = Env_Font;
-  var_type (PROG_FONT_FAMILY)   = Env_Font;
-  var_type (PROG_FONT_SERIES)   = Env_Font;
-  var_type (PROG_FONT_SHAPE)    = Env_Font;
-
-  var_type (PAR_MODE)           = Env_Paragraph;
-  var_type (PAR_FLEXIBILITY)    = Env_Paragraph;
-  var_type (PAR_HYPHEN)         = Env_Paragraph;
-  var_type (PAR_MIN_PENALTY)    = Env_Paragraph;
-  var_type (PAR_SPACING)        = Env_Paragraph;
-  var_type (PAR_KERNING_REDUCE) = Env_Paragraph;
-  var_type (PAR_KERNING_STRETCH)= Env_Paragraph;
-  var_type (PAR_KERNING_MARGIN) = Env_Paragraph;
-  var_type (PAR_CONTRACTION)    = Env_Paragraph;
-  var_type (PAR_EXPANSION)      = Env_Paragraph;
-  var_type (PAR_HYPHEN)         = Env_Paragraph;
-  var_type (PAR_WIDTH)          = Env_Paragraph;
-  var_type (PAR_LEFT)           = Env_Paragraph;
-  var_type (PAR_RIGHT)          = Env_Paragraph;
-  var_type (PAR_FIRST)          = Env_Paragraph;
-  var_type (PAR_NO_FIRST)       = Env_Paragraph;
-  var_type (PAR_SEP)            = Env_Paragraph;
-  var_type (PAR_HOR_SEP)        = Env_Paragraph;
-  var_type (PAR_VER_SEP)        = Env_Paragraph;
-  var_type (PAR_LINE_SEP)       = Env_Paragraph;
-  var_type (PAR_PAR_SEP)        = Env_Paragraph;
-
-  var_type (PAGE_TYPE)          = Env_Fixed;
-  var_type (PAGE_BREAKING)      = Env_Fixed;
-  var_type (PAGE_FLEXIBILITY)   = Env_Fixed;
-  var_type (PAGE_FIRST)         = Env_Fixed;
-  var_type (PAGE_WIDTH)         = Env_Page_Extents;
-  var_type (PAGE_HEIGHT)        = Env_Page_Extents;
-  var_type (PAGE_CROP_MARKS)    = Env_Page_Extents;
-  var_type (PAGE_WIDTH_MARGIN)  = Env_Page;
-  var_type (PAGE_SCREEN_MARGIN) = Env_Page;
-  var_type (PAGE_NR)            = Env_Page;
-  var_type (PAGE_THE_PAGE)      = Env_Page;
-  var_type (PAGE_ODD)           = Env_Page;
-  var_type (PAGE_EVEN)          = Env_Page;
-  var_type (PAGE_RIGHT)         = Env_Page;
-  var_type (PAGE_TOP)           = Env_Page;
-  var_type (PAGE_BOT)           = Env_Page;
-  var_type (PAGE_USER_HEIGHT)   = Env_Page;
-  var_type (PAGE_ODD_SHIFT)     = Env_Page;
-  var_type (PAGE_EVEN_SHIFT)    = Env_Page;
-  var_type (PAGE_SHRINK)        = Env_Page;
-  var_type (PAGE_EXTEND)        = Env_Page;
-  var_type (PAGE_HEAD_SEP)      = Env_Page;
-  var_type (PAGE_FOOT_SEP)      = Env_Page;
-  var_type (PAGE_ODD_HEADER)    = Env_Page;
-  var_type (PAGE_ODD_FOOTER)    = Env_Page;
-  var_type (PAGE_EVEN_HEADER)   = Env_Page;
-  var_type (PAGE_EVEN_FOOTER)   = Env_Page;
-  var_type (PAGE_THIS_TOP)      = Env_Page;
-  var_type (PAGE_THIS_BOT)      = Env_Page;
-  var_type (PAGE_THIS_HEADER)   = Env_Page;
-  var_type (PAGE_THIS_FOOTER)   = Env_Page;
-  var_type (PAGE_THIS_BG_COLOR) = Env_Page;
-  var_type (PAGE_FNOTE_SEP)     = Env_Page;
-  var_type (PAGE_FNOTE_BARLEN)  = Env_Page;
-  var_type (PAGE_FLOAT_SEP)     = Env_Page;
-  var_type (PAGE_MNOTE_SEP)     = Env_Page;
-  var_type (PAGE_MNOTE_WIDTH)   = Env_Page;
-
-  var_type (POINT_STYLE)        = Env_Point_Style;
-  var_type (POINT_SIZE)         = Env_Point_Size;
-  var_type (POINT_BORDER)       = Env_Point_Size;
-  var_type (LINE_WIDTH)         = Env_Line_Width;
-  var_type (DASH_STYLE)         = Env_Dash_Style;
-  var_type (DASH_STYLE_UNIT)    = Env_Dash_Style_Unit;
-  var_type (FILL_COLOR)         = Env_Fill_Color;
-  var_type (ARROW_BEGIN)        = Env_Line_Arrows;
-  var_type (ARROW_END)          = Env_Line_Arrows;
-  var_type (ARROW_LENGTH)       = Env_Line_Arrows;
-  var_type (ARROW_HEIGHT)       = Env_Line_Arrows;
-  var_type (LINE_PORTION)       = Env_Line_Portion;
-  var_type (TEXT_AT_HALIGN)     = Env_Text_At_Halign;
-  var_type (TEXT_AT_VALIGN)     = Env_Text_At_Valign;
-  var_type (DOC_AT_VALIGN)      = Env_Doc_At_Valign;
-  var_type (GR_FRAME)           = Env_Frame;
-  var_type (GR_GEOMETRY)        = Env_Geometry;
-  var_type (GR_GRID)            = Env_Grid;
-  var_type (GR_GRID_ASPECT)     = Env_Grid_Aspect;
-  var_type (GR_EDIT_GRID)       = Env_Grid;
-  var_type (GR_EDIT_GRID_ASPECT)= Env_Grid_Aspect;
-
-  var_type (SRC_STYLE)          = Env_Src_Style;
-  var_type (SRC_SPECIAL)        = Env_Src_Special;
-  var_type (SRC_COMPACT)        = Env_Src_Compact;
-  var_type (SRC_CLOSE)          = Env_Src_Close;
-  var_type (SRC_TAG_COLOR)      = Env_Src_Color;
+
+  set_var_type (DPI_KEY,                 Env_Fixed);
+  set_var_type (ZOOM_FACTOR_KEY,         Env_Zoom);
+  set_var_type (PREAMBLE_KEY,            Env_Preamble);
+  set_var_type (SAVE_AUX_KEY,            Env_Fixed);
+  set_var_type (MODE_KEY,                Env_Mode);
+  set_var_type (INFO_FLAG_KEY,           Env_Info_Level);
+
+  set_var_type (FONT_KEY,                Env_Font);
+  set_var_type (FONT_FAMILY_KEY,         Env_Font);
+  set_var_type (FONT_SERIES_KEY,         Env_Font);
+  set_var_type (FONT_SHAPE_KEY,          Env_Font);
+  set_var_type (FONT_SIZE_KEY,           Env_Font_Size);
+  set_var_type (FONT_BASE_SIZE_KEY,      Env_Font_Size);
+  set_var_type (FONT_EFFECTS_KEY,        Env_Font);
+  set_var_type (MAGNIFICATION_KEY,       Env_Magnification);
+  set_var_type (MAGNIFY_KEY,             Env_Magnify);
+  set_var_type (COLOR_KEY,               Env_Color);
+  set_var_type (OPACITY_KEY,             Env_Color);
+  set_var_type (NO_PATTERNS_KEY,         Env_Pattern_Mode);
+  set_var_type (LANGUAGE_KEY,            Env_Language);
+  set_var_type (SPACING_POLICY_KEY,      Env_Spacing);
+
+  set_var_type (MATH_LANGUAGE_KEY,       Env_Language);
+  set_var_type (MATH_FONT_KEY,           Env_Font);
+  set_var_type (MATH_FONT_FAMILY_KEY,    Env_Font);
+  set_var_type (MATH_FONT_SERIES_KEY,    Env_Font);
+  set_var_type (MATH_FONT_SHAPE_KEY,     Env_Font);
+  set_var_type (MATH_FONT_SIZES_KEY,     Env_Font_Sizes);
+  set_var_type (MATH_LEVEL_KEY,          Env_Index_Level);
+  set_var_type (MATH_DISPLAY_KEY,        Env_Display_Style);
+  set_var_type (MATH_CONDENSED_KEY,      Env_Math_Condensed);
+  set_var_type (MATH_VPOS_KEY,           Env_Vertical_Pos);
+  set_var_type (MATH_NESTING_LEVEL_KEY,  Env_Math_Nesting);
+  set_var_type (MATH_FRAC_LIMIT_KEY,     Env_Math_Width);
+  set_var_type (MATH_TABLE_LIMIT_KEY,    Env_Math_Width);
+  set_var_type (MATH_FLATTEN_COLOR_KEY,  Env_Math_Width);
+
+  set_var_type (PROG_LANGUAGE_KEY,       Env_Language);
+  set_var_type (PROG_FONT_KEY,           Env_Font);
+  set_var_type (PROG_FONT_FAMILY_KEY,    Env_Font);
+  set_var_type (PROG_FONT_SERIES_KEY,    Env_Font);
+  set_var_type (PROG_FONT_SHAPE_KEY,     Env_Font);
+
+  set_var_type (PAR_MODE_KEY,            Env_Paragraph);
+  set_var_type (PAR_FLEXIBILITY_KEY,     Env_Paragraph);
+  set_var_type (PAR_HYPHEN_KEY,          Env_Paragraph);
+  set_var_type (PAR_MIN_PENALTY_KEY,     Env_Paragraph);
+  set_var_type (PAR_SPACING_KEY,         Env_Paragraph);
+  set_var_type (PAR_KERNING_REDUCE_KEY,  Env_Paragraph);
+  set_var_type (PAR_KERNING_STRETCH_KEY, Env_Paragraph);
+  set_var_type (PAR_KERNING_MARGIN_KEY,  Env_Paragraph);
+  set_var_type (PAR_CONTRACTION_KEY,     Env_Paragraph);
+  set_var_type (PAR_EXPANSION_KEY,       Env_Paragraph);
+  set_var_type (PAR_HYPHEN_KEY,          Env_Paragraph);
+  set_var_type (PAR_WIDTH_KEY,           Env_Paragraph);
+  set_var_type (PAR_LEFT_KEY,            Env_Paragraph);
+  set_var_type (PAR_RIGHT_KEY,           Env_Paragraph);
+  set_var_type (PAR_FIRST_KEY,           Env_Paragraph);
+  set_var_type (PAR_NO_FIRST_KEY,        Env_Paragraph);
+  set_var_type (PAR_SEP_KEY,             Env_Paragraph);
+  set_var_type (PAR_HOR_SEP_KEY,         Env_Paragraph);
+  set_var_type (PAR_VER_SEP_KEY,         Env_Paragraph);
+  set_var_type (PAR_LINE_SEP_KEY,        Env_Paragraph);
+  set_var_type (PAR_PAR_SEP_KEY,         Env_Paragraph);
+
+  set_var_type (PAGE_TYPE_KEY,           Env_Fixed);
+  set_var_type (PAGE_BREAKING_KEY,       Env_Fixed);
+  set_var_type (PAGE_FLEXIBILITY_KEY,    Env_Fixed);
+  set_var_type (PAGE_FIRST_KEY,          Env_Fixed);
+  set_var_type (PAGE_WIDTH_KEY,          Env_Page_Extents);
+  set_var_type (PAGE_HEIGHT_KEY,         Env_Page_Extents);
+  set_var_type (PAGE_CROP_MARKS_KEY,     Env_Page_Extents);
+  set_var_type (PAGE_WIDTH_MARGIN_KEY,   Env_Page);
+  set_var_type (PAGE_SCREEN_MARGIN_KEY,  Env_Page);
+  set_var_type (PAGE_NR_KEY,             Env_Page);
+  set_var_type (PAGE_THE_PAGE_KEY,       Env_Page);
+  set_var_type (PAGE_ODD_KEY,            Env_Page);
+  set_var_type (PAGE_EVEN_KEY,           Env_Page);
+  set_var_type (PAGE_RIGHT_KEY,          Env_Page);
+  set_var_type (PAGE_TOP_KEY,            Env_Page);
+  set_var_type (PAGE_BOT_KEY,            Env_Page);
+  set_var_type (PAGE_USER_HEIGHT_KEY,    Env_Page);
+  set_var_type (PAGE_ODD_SHIFT_KEY,      Env_Page);
+  set_var_type (PAGE_EVEN_SHIFT_KEY,     Env_Page);
+  set_var_type (PAGE_SHRINK_KEY,         Env_Page);
+  set_var_type (PAGE_EXTEND_KEY,         Env_Page);
+  set_var_type (PAGE_HEAD_SEP_KEY,       Env_Page);
+  set_var_type (PAGE_FOOT_SEP_KEY,       Env_Page);
+  set_var_type (PAGE_ODD_HEADER_KEY,     Env_Page);
+  set_var_type (PAGE_ODD_FOOTER_KEY,     Env_Page);
+  set_var_type (PAGE_EVEN_HEADER_KEY,    Env_Page);
+  set_var_type (PAGE_EVEN_FOOTER_KEY,    Env_Page);
+  set_var_type (PAGE_THIS_TOP_KEY,       Env_Page);
+  set_var_type (PAGE_THIS_BOT_KEY,       Env_Page);
+  set_var_type (PAGE_THIS_HEADER_KEY,    Env_Page);
+  set_var_type (PAGE_THIS_FOOTER_KEY,    Env_Page);
+  set_var_type (PAGE_THIS_BG_COLOR_KEY,  Env_Page);
+  set_var_type (PAGE_FNOTE_SEP_KEY,      Env_Page);
+  set_var_type (PAGE_FNOTE_BARLEN_KEY,   Env_Page);
+  set_var_type (PAGE_FLOAT_SEP_KEY,      Env_Page);
+  set_var_type (PAGE_MNOTE_SEP_KEY,      Env_Page);
+  set_var_type (PAGE_MNOTE_WIDTH_KEY,    Env_Page);
+
+  set_var_type (POINT_STYLE_KEY,         Env_Point_Style);
+  set_var_type (POINT_SIZE_KEY,          Env_Point_Size);
+  set_var_type (POINT_BORDER_KEY,        Env_Point_Size);
+  set_var_type (LINE_WIDTH_KEY,          Env_Line_Width);
+  set_var_type (DASH_STYLE_KEY,          Env_Dash_Style);
+  set_var_type (DASH_STYLE_UNIT_KEY,     Env_Dash_Style_Unit);
+  set_var_type (FILL_COLOR_KEY,          Env_Fill_Color);
+  set_var_type (ARROW_BEGIN_KEY,         Env_Line_Arrows);
+  set_var_type (ARROW_END_KEY,           Env_Line_Arrows);
+  set_var_type (ARROW_LENGTH_KEY,        Env_Line_Arrows);
+  set_var_type (ARROW_HEIGHT_KEY,        Env_Line_Arrows);
+  set_var_type (LINE_PORTION_KEY,        Env_Line_Portion);
+  set_var_type (TEXT_AT_HALIGN_KEY,      Env_Text_At_Halign);
+  set_var_type (TEXT_AT_VALIGN_KEY,      Env_Text_At_Valign);
+  set_var_type (DOC_AT_VALIGN_KEY,       Env_Doc_At_Valign);
+  set_var_type (GR_FRAME_KEY,            Env_Frame);
+  set_var_type (GR_GEOMETRY_KEY,         Env_Geometry);
+  set_var_type (GR_GRID_KEY,             Env_Grid);
+  set_var_type (GR_GRID_ASPECT_KEY,      Env_Grid_Aspect);
+  set_var_type (GR_EDIT_GRID_KEY,        Env_Grid);
+  set_var_type (GR_EDIT_GRID_ASPECT_KEY, Env_Grid_Aspect);
+
+  set_var_type (SRC_STYLE_KEY,           Env_Src_Style);
+  set_var_type (SRC_SPECIAL_KEY,         Env_Src_Special);
+  set_var_type (SRC_COMPACT_KEY,         Env_Src_Compact);
+  set_var_type (SRC_CLOSE_KEY,           Env_Src_Close);
+  set_var_type (SRC_TAG_COLOR_KEY,       Env_Src_Color);
 }
 
 /******************************************************************************
@@ -172,25 +181,25 @@ edit_env_rep::update_page_pars () {
   double magn_old= magn_len;
   magn_len= 1.0;
 
-  page_type         = get_string (PAGE_TYPE);
-  page_landscape    = (get_string (PAGE_ORIENTATION) == "landscape");
-  page_automatic    = (get_string (PAGE_MEDIUM) == "automatic");
-  string width_flag = get_string (PAGE_WIDTH_MARGIN);
-  string height_flag= get_string (PAGE_HEIGHT_MARGIN);
+  page_type         = get_string (PAGE_TYPE_KEY);
+  page_landscape    = (get_string (PAGE_ORIENTATION_KEY) == "landscape");
+  page_automatic    = (get_string (PAGE_MEDIUM_KEY) == "automatic");
+  string width_flag = get_string (PAGE_WIDTH_MARGIN_KEY);
+  string height_flag= get_string (PAGE_HEIGHT_MARGIN_KEY);
   bool   screen_flag= get_bool   (PAGE_SCREEN_MARGIN);
 
-  page_floats       = (get_string (PAGE_FLOAT_ENABLE) == "true");
-  if (get_string (PAGE_FLOAT_ENABLE) == get_string (PAGE_MEDIUM))
+  page_floats       = (get_string (PAGE_FLOAT_ENABLE_KEY) == "true");
+  if (get_string (PAGE_FLOAT_ENABLE_KEY) == get_string (PAGE_MEDIUM_KEY))
     page_floats= true;
 
   if (page_automatic) {
-    page_width        = get_length (PAGE_SCREEN_WIDTH);
-    page_height       = get_length (PAGE_SCREEN_HEIGHT);
-    page_odd_margin   = get_length (PAGE_SCREEN_LEFT);
-    page_right_margin = get_length (PAGE_SCREEN_RIGHT);
+    page_width        = get_length (PAGE_SCREEN_WIDTH_KEY);
+    page_height       = get_length (PAGE_SCREEN_HEIGHT_KEY);
+    page_odd_margin   = get_length (PAGE_SCREEN_LEFT_KEY);
+    page_right_margin = get_length (PAGE_SCREEN_RIGHT_KEY);
     page_even_margin  = page_odd_margin;
-    page_top_margin   = get_length (PAGE_SCREEN_TOP);
-    page_bottom_margin= get_length (PAGE_SCREEN_BOT);
+    page_top_margin   = get_length (PAGE_SCREEN_TOP_KEY);
+    page_bottom_margin= get_length (PAGE_SCREEN_BOT_KEY);
     page_user_width   = page_width - page_odd_margin - page_right_margin;
     page_user_height  = page_height - page_top_margin - page_bottom_margin;
   }
@@ -206,8 +215,8 @@ edit_env_rep::update_page_pars () {
     }
     else if (width_flag == "true") {
       page_user_width   = get_page_par (PAR_WIDTH);
-      SI odd_sh         = get_length (PAGE_ODD_SHIFT);
-      SI even_sh        = get_length (PAGE_EVEN_SHIFT);
+      SI odd_sh         = get_length (PAGE_ODD_SHIFT_KEY);
+      SI even_sh        = get_length (PAGE_EVEN_SHIFT_KEY);
       page_odd_margin   = ((page_width - page_user_width) >> 1) + odd_sh;
       page_even_margin  = ((page_width - page_user_width) >> 1) + even_sh;
       page_right_margin = page_width - page_odd_margin - page_user_width;
@@ -225,41 +234,41 @@ edit_env_rep::update_page_pars () {
       page_user_height  = page_height - page_top_margin - page_bottom_margin;
     }
     else if (height_flag == "true") {
-      page_user_height  = get_length (PAGE_USER_HEIGHT);
+      page_user_height  = get_length (PAGE_USER_HEIGHT_KEY);
       page_top_margin   = (page_height - page_user_width) >> 1;
       page_bottom_margin= page_top_margin;
     }
     else {
-      page_user_height  = get_length (PAGE_USER_HEIGHT);
+      page_user_height  = get_length (PAGE_USER_HEIGHT_KEY);
       page_top_margin   = get_page_par (PAGE_TOP);
       page_bottom_margin= page_height - page_top_margin - page_user_height;
     }
 
     if (page_type == "user") {
-      if (get_string (PAGE_EVEN) == "auto" &&
+      if (get_string (PAGE_EVEN_KEY) == "auto" &&
           get_string (PAGE_ODD ) != "auto")
         page_even_margin= page_odd_margin;
       if (get_string (PAGE_ODD ) == "auto" &&
-          get_string (PAGE_EVEN) != "auto")
+          get_string (PAGE_EVEN_KEY) != "auto")
         page_odd_margin= page_even_margin;
     }
 
     if (screen_flag) {
-      page_odd_margin   = get_length (PAGE_SCREEN_LEFT);
-      page_right_margin = get_length (PAGE_SCREEN_RIGHT);
-      page_top_margin   = get_length (PAGE_SCREEN_TOP);
-      page_bottom_margin= get_length (PAGE_SCREEN_BOT);
+      page_odd_margin   = get_length (PAGE_SCREEN_LEFT_KEY);
+      page_right_margin = get_length (PAGE_SCREEN_RIGHT_KEY);
+      page_top_margin   = get_length (PAGE_SCREEN_TOP_KEY);
+      page_bottom_margin= get_length (PAGE_SCREEN_BOT_KEY);
       page_even_margin  = page_odd_margin;
       page_width = page_user_width + page_odd_margin + page_right_margin;
       page_height= page_user_height + page_top_margin + page_bottom_margin;
     }
   }
 
-  string crop_marks= get_string (PAGE_CROP_MARKS);
+  string crop_marks= get_string (PAGE_CROP_MARKS_KEY);
   page_real_type  = page_type;
   page_real_width = page_width;
   page_real_height= page_height;
-  if (crop_marks != "" && get_string (PAGE_MEDIUM) == "paper") {
+  if (crop_marks != "" && get_string (PAGE_MEDIUM_KEY) == "paper") {
     page_real_type= crop_marks;
     page_real_width=
       as_length (page_get_feature (crop_marks, PAGE_WIDTH, page_landscape));
@@ -267,10 +276,10 @@ edit_env_rep::update_page_pars () {
       as_length (page_get_feature (crop_marks, PAGE_HEIGHT, page_landscape));
   }
   
-  page_single= get_bool (PAGE_SINGLE);
-  page_packet= get_int (PAGE_PACKET);
-  page_offset= get_int (PAGE_OFFSET);
-  page_border= read (PAGE_BORDER);
+  page_single= get_bool (PAGE_SINGLE_KEY);
+  page_packet= get_int (PAGE_PACKET_KEY);
+  page_offset= get_int (PAGE_OFFSET_KEY);
+  page_border= read (PAGE_BORDER_KEY);
 
   magn_len= magn_old;
 }
@@ -288,11 +297,11 @@ edit_env_rep::get_page_pars (SI& w, SI& h, SI& width, SI& height,
   top   = page_top_margin;
   bot   = page_bottom_margin;
 
-  int nr_cols= get_int (PAR_COLUMNS);
+  int nr_cols= get_int (PAR_COLUMNS_KEY);
   if (nr_cols > 1) {
     double magn_old= magn_len;
     magn_len= 1.0;
-    SI col_sep= get_length (PAR_COLUMNS_SEP);
+    SI col_sep= get_length (PAR_COLUMNS_SEP_KEY);
     w= ((w+col_sep) / nr_cols) - col_sep;
     magn_len= magn_old;
   }
@@ -313,8 +322,8 @@ edit_env_rep::get_page_pars (SI& w, SI& h, SI& width, SI& height,
 SI
 edit_env_rep::get_page_width (bool deco) {
   SI w= page_user_width + page_odd_margin + page_right_margin;
-  if (get_string (PAGE_MEDIUM) == "paper" &&
-      get_string (PAGE_BORDER) != "none" &&
+  if (get_string (PAGE_MEDIUM_KEY) == "paper" &&
+      get_string (PAGE_BORDER_KEY) != "none" &&
       deco) w += 20 * pixel;
   return w;
 }
@@ -322,13 +331,13 @@ edit_env_rep::get_page_width (bool deco) {
 SI
 edit_env_rep::get_pages_width (bool deco) {
   SI w= page_user_width + page_odd_margin + page_right_margin;
-  if (get_string (PAGE_MEDIUM) == "paper" &&
-      get_string (PAGE_BORDER) != "attached" &&
-      get_string (PAGE_BORDER) != "none" &&
+  if (get_string (PAGE_MEDIUM_KEY) == "paper" &&
+      get_string (PAGE_BORDER_KEY) != "attached" &&
+      get_string (PAGE_BORDER_KEY) != "none" &&
       deco) w += 20 * pixel;
   w= w * page_packet;
-  if (get_string (PAGE_MEDIUM) == "paper" &&
-      get_string (PAGE_BORDER) == "attached" &&
+  if (get_string (PAGE_MEDIUM_KEY) == "paper" &&
+      get_string (PAGE_BORDER_KEY) == "attached" &&
       deco) w += 20 * pixel;
   return w;
 }
@@ -336,8 +345,8 @@ edit_env_rep::get_pages_width (bool deco) {
 SI
 edit_env_rep::get_page_height (bool deco) {
   SI h= page_user_height + page_top_margin + page_bottom_margin;
-  if (get_string (PAGE_MEDIUM) == "paper" &&
-      get_string (PAGE_BORDER) != "none" &&
+  if (get_string (PAGE_MEDIUM_KEY) == "paper" &&
+      get_string (PAGE_BORDER_KEY) != "none" &&
       deco) h += 20 * pixel;
   return h;
 }
@@ -357,18 +366,18 @@ tuplify (tree t) {
 
 ornament_parameters
 edit_env_rep::get_ornament_parameters () {
-  tree  shape = read (ORNAMENT_SHAPE);
-  tree  tst   = read (ORNAMENT_TITLE_STYLE);
-  tree  bg    = read (ORNAMENT_COLOR);
-  tree  xc    = read (ORNAMENT_EXTRA_COLOR);
-  tree  sunny = read (ORNAMENT_SUNNY_COLOR);
-  tree  shadow= read (ORNAMENT_SHADOW_COLOR);
+  tree  shape = read (ORNAMENT_SHAPE_KEY);
+  tree  tst   = read (ORNAMENT_TITLE_STYLE_KEY);
+  tree  bg    = read (ORNAMENT_COLOR_KEY);
+  tree  xc    = read (ORNAMENT_EXTRA_COLOR_KEY);
+  tree  sunny = read (ORNAMENT_SUNNY_COLOR_KEY);
+  tree  shadow= read (ORNAMENT_SHADOW_COLOR_KEY);
   int   a     = alpha;
-  tree  w     = read (ORNAMENT_BORDER);
-  tree  ext   = read (ORNAMENT_SWELL);
-  tree  cor   = read (ORNAMENT_CORNER);
-  tree  xpad  = read (ORNAMENT_HPADDING);
-  tree  ypad  = read (ORNAMENT_VPADDING);
+  tree  w     = read (ORNAMENT_BORDER_KEY);
+  tree  ext   = read (ORNAMENT_SWELL_KEY);
+  tree  cor   = read (ORNAMENT_CORNER_KEY);
+  tree  xpad  = read (ORNAMENT_HPADDING_KEY);
+  tree  ypad  = read (ORNAMENT_VPADDING_KEY);
 
   array<brush> border;
   if (is_func (sunny, TUPLE)) {
@@ -548,31 +557,35 @@ edit_env_rep::get_script_size (int sz, int level) {
 
 void
 edit_env_rep::update_font () {
-  fn_size= (int) (((double) get_int (FONT_BASE_SIZE)) *
-		  get_double (FONT_SIZE) + 0.5);
+  fn_size= (int) (((double) get_int (FONT_BASE_SIZE_KEY)) *
+		  get_double (FONT_SIZE_KEY) + 0.5);
   switch (mode) {
   case 0:
   case 1:
-    fn= smart_font (get_string (FONT), get_string (FONT_FAMILY),
-                    get_string (FONT_SERIES), get_string (FONT_SHAPE),
+    fn= smart_font (get_string (FONT_KEY), get_string (FONT_FAMILY_KEY),
+                    get_string (FONT_SERIES_KEY), get_string (FONT_SHAPE_KEY),
                     get_script_size (fn_size, index_level), (int) (magn*dpi));
     break;
   case 2:
-    fn= smart_font (get_string (MATH_FONT), get_string (MATH_FONT_FAMILY),
-                    get_string (MATH_FONT_SERIES), get_string (MATH_FONT_SHAPE),
-                    get_string (FONT), get_string (FONT_FAMILY),
-                    get_string (FONT_SERIES), "mathitalic",
+    fn= smart_font (get_string (MATH_FONT_KEY),
+                    get_string (MATH_FONT_FAMILY_KEY),
+                    get_string (MATH_FONT_SERIES_KEY),
+                    get_string (MATH_FONT_SHAPE_KEY),
+                    get_string (FONT_KEY), get_string (FONT_FAMILY_KEY),
+                    get_string (FONT_SERIES_KEY), "mathitalic",
                     get_script_size (fn_size, index_level), (int) (magn*dpi));
     break;
   case 3:
-    fn= smart_font (get_string (PROG_FONT), get_string (PROG_FONT_FAMILY),
-                    get_string (PROG_FONT_SERIES), get_string (PROG_FONT_SHAPE),
-                    get_string (FONT), get_string (FONT_FAMILY) * "-tt",
-                    get_string (FONT_SERIES), get_string (FONT_SHAPE),
+    fn= smart_font (get_string (PROG_FONT_KEY),
+                    get_string (PROG_FONT_FAMILY_KEY),
+                    get_string (PROG_FONT_SERIES_KEY),
+                    get_string (PROG_FONT_SHAPE_KEY),
+                    get_string (FONT_KEY), get_string (FONT_FAMILY_KEY) * "-tt",
+                    get_string (FONT_SERIES_KEY), get_string (FONT_SHAPE_KEY),
                     get_script_size (fn_size, index_level), (int) (magn*dpi));
     break;
   }
-  string eff= get_string (FONT_EFFECTS);
+  string eff= get_string (FONT_EFFECTS_KEY);
   if (N(eff) != 0) fn= apply_effects (fn, eff);
 }
 
@@ -596,13 +609,13 @@ decode_alpha (string s) {
 
 void
 edit_env_rep::update_color () {
-  alpha= decode_alpha (get_string (OPACITY));
-  tree pc= env [COLOR];
-  tree fc= env [FILL_COLOR];
+  alpha= decode_alpha (get_string (OPACITY_KEY));
+  tree pc= env [COLOR_KEY];
+  tree fc= env [FILL_COLOR_KEY];
   if (pc == "none") pen= pencil (false);
   else {
     if (L(pc) == PATTERN) pc= exec (pc);
-    pen= pencil (pc, alpha, get_length (LINE_WIDTH));
+    pen= pencil (pc, alpha, get_length (LINE_WIDTH_KEY));
   }
   if (fc == "none") fill_brush= brush (false);
   else {
@@ -613,25 +626,25 @@ edit_env_rep::update_color () {
 
 void
 edit_env_rep::update_pattern_mode () {
-  no_patterns= (get_string (NO_PATTERNS) == "true");
+  no_patterns= (get_string (NO_PATTERNS_KEY) == "true");
   if (no_patterns) {
-    tree c= env[COLOR];
-    if (is_func (c, PATTERN, 4)) env (COLOR)= exec (c);
-    c= env[BG_COLOR];
-    if (is_func (c, PATTERN, 4)) env (BG_COLOR)= exec (c);
-    c= env[FILL_COLOR];
-    if (is_func (c, PATTERN, 4)) env (FILL_COLOR)= exec (c);
-    c= env[ORNAMENT_COLOR];
-    if (is_func (c, PATTERN, 4)) env (ORNAMENT_COLOR)= exec (c);
-    c= env[ORNAMENT_EXTRA_COLOR];
-    if (is_func (c, PATTERN, 4)) env (ORNAMENT_EXTRA_COLOR)= exec (c);
+    tree c= env[COLOR_KEY];
+    if (is_func (c, PATTERN, 4)) env->write (COLOR, exec (c));
+    c= env[BG_COLOR_KEY];
+    if (is_func (c, PATTERN, 4)) env->write (BG_COLOR, exec (c));
+    c= env[FILL_COLOR_KEY];
+    if (is_func (c, PATTERN, 4)) env->write (FILL_COLOR, exec (c));
+    c= env[ORNAMENT_COLOR_KEY];
+    if (is_func (c, PATTERN, 4)) env->write (ORNAMENT_COLOR, exec (c));
+    c= env[ORNAMENT_EXTRA_COLOR_KEY];
+    if (is_func (c, PATTERN, 4)) env->write (ORNAMENT_EXTRA_COLOR, exec (c));
     update_color ();
   }
 }
 
 void
 edit_env_rep::update_mode () {
-  string s= get_string (MODE);
+  string s= get_string (MODE_KEY);
   if (s == "text") mode=1;
   else if (s == "math") mode=2;
   else if (s == "prog") mode=3;
@@ -642,7 +655,7 @@ edit_env_rep::update_mode () {
 
 void
 edit_env_rep::update_info_level () {
-  string s= get_string (INFO_FLAG);
+  string s= get_string (INFO_FLAG_KEY);
   if (s == "none") info_level= INFO_NONE;
   else if (s == "minimal") info_level= INFO_MINIMAL;
   else if (s == "short") info_level= INFO_SHORT;
@@ -657,13 +670,13 @@ edit_env_rep::update_language () {
   switch (mode) {
   case 0:
   case 1:
-    lan= text_language (get_string (LANGUAGE));
+    lan= text_language (get_string (LANGUAGE_KEY));
     break;
   case 2:
-    lan= math_language (get_string (MATH_LANGUAGE));
+    lan= math_language (get_string (MATH_LANGUAGE_KEY));
     break;
   case 3:
-    lan= prog_language (get_string (PROG_LANGUAGE));
+    lan= prog_language (get_string (PROG_LANGUAGE_KEY));
     break;
   }
   hl_lan= lan->hl_lan;
@@ -671,7 +684,7 @@ edit_env_rep::update_language () {
 
 void
 edit_env_rep::update_geometry () {
-  tree t= env [GR_GEOMETRY];
+  tree t= env [GR_GEOMETRY_KEY];
   gw= as_length ("1par");
   gh= as_length ("0.6par");
   gvalign= as_string ("center");
@@ -688,7 +701,7 @@ edit_env_rep::update_geometry () {
 
 void
 edit_env_rep::update_frame () {
-  tree t= env [GR_FRAME];
+  tree t= env [GR_FRAME_KEY];
   SI yinc= gvalign == "top"    ? - gh
 	 : gvalign == "bottom" ? 0
          : gvalign == "axis" ? - (gh/2) + as_length ("1yfrac")
@@ -726,7 +739,7 @@ edit_env_rep::update_frame () {
 
 void
 edit_env_rep::update_src_style () {
-  string s= as_string (env [SRC_STYLE]);
+  string s= as_string (env [SRC_STYLE_KEY]);
   if (s == "angular") src_style= STYLE_ANGULAR;
   else if (s == "scheme") src_style= STYLE_SCHEME;
   else if (s == "latex") src_style= STYLE_LATEX;
@@ -735,7 +748,7 @@ edit_env_rep::update_src_style () {
 
 void
 edit_env_rep::update_src_special () {
-  string s= as_string (env [SRC_SPECIAL]);
+  string s= as_string (env [SRC_SPECIAL_KEY]);
   if (s == "raw") src_special= SPECIAL_RAW;
   else if (s == "format") src_special= SPECIAL_FORMAT;
   else if (s == "normal") src_special= SPECIAL_NORMAL;
@@ -744,7 +757,7 @@ edit_env_rep::update_src_special () {
 
 void
 edit_env_rep::update_src_compact () {
-  string s= as_string (env [SRC_COMPACT]);
+  string s= as_string (env [SRC_COMPACT_KEY]);
   if (s == "all") src_compact= COMPACT_ALL;
   else if (s == "inline args") src_compact= COMPACT_INLINE_ARGS;
   else if (s == "normal") src_compact= COMPACT_INLINE_START;
@@ -754,7 +767,7 @@ edit_env_rep::update_src_compact () {
 
 void
 edit_env_rep::update_src_close () {
-  string s= as_string (env [SRC_CLOSE]);
+  string s= as_string (env [SRC_CLOSE_KEY]);
   if (s == "minimal") src_close= CLOSE_MINIMAL;
   else if (s == "compact") src_close= CLOSE_COMPACT;
   else if (s == "long") src_close= CLOSE_LONG;
@@ -763,7 +776,7 @@ edit_env_rep::update_src_close () {
 
 void
 edit_env_rep::update_dash_style () {
-  tree t= env [DASH_STYLE];
+  tree t= env [DASH_STYLE_KEY];
   dash_style= array<bool> (0);
   dash_motif= array<point> (0);
   if (is_string (t)) {
@@ -816,7 +829,7 @@ edit_env_rep::update_dash_style () {
 
 void
 edit_env_rep::update_dash_style_unit () {
-  tree t= read (DASH_STYLE_UNIT);
+  tree t= read (DASH_STYLE_UNIT_KEY);
   if (is_tuple (t) && N(t) == 2) {
     SI hunit= as_length (t[0]);
     SI vunit= as_length (t[1]);
@@ -922,10 +935,10 @@ edit_env_rep::decode_arrow (tree t, string l, string h) {
 void
 edit_env_rep::update_line_arrows () {
   line_arrows= array<tree> (2);
-  string l= get_string (ARROW_LENGTH);
-  string h= get_string (ARROW_HEIGHT);
-  line_arrows[0]= decode_arrow (env [ARROW_BEGIN], l, h);
-  line_arrows[1]= decode_arrow (env [ARROW_END], l, h);
+  string l= get_string (ARROW_LENGTH_KEY);
+  string h= get_string (ARROW_HEIGHT_KEY);
+  line_arrows[0]= decode_arrow (env [ARROW_BEGIN_KEY], l, h);
+  line_arrows[1]= decode_arrow (env [ARROW_END_KEY], l, h);
   if (line_arrows[0] != "")
     line_arrows[0]= tree (WITH, LINE_PORTION, "1", line_arrows[0]);
   if (line_arrows[1] != "")
@@ -934,18 +947,18 @@ edit_env_rep::update_line_arrows () {
 
 void
 edit_env_rep::update () {
-  zoomf          = normal_zoom (get_double (ZOOM_FACTOR));
+  zoomf          = normal_zoom (get_double (ZOOM_FACTOR_KEY));
   pixel          = (SI) tm_round ((std_shrinkf * PIXEL) / zoomf);
-  magn           = get_double (MAGNIFICATION);
-  magn_len       = (get_string (LENGTH_MODE) == "fixed"? 1.0: magn);
-  index_level    = get_int (MATH_LEVEL);
-  display_style  = get_bool (MATH_DISPLAY);
-  math_condensed = get_bool (MATH_CONDENSED);
-  vert_pos       = get_int (MATH_VPOS);
-  nesting_level  = get_int (MATH_NESTING_LEVEL);
-  preamble       = get_bool (PREAMBLE);
-  spacing_policy = get_spacing_id (env[SPACING_POLICY]);
-  math_font_sizes= env[MATH_FONT_SIZES];
+  magn           = get_double (MAGNIFICATION_KEY);
+  magn_len       = (get_string (LENGTH_MODE_KEY) == "fixed"? 1.0: magn);
+  index_level    = get_int (MATH_LEVEL_KEY);
+  display_style  = get_bool (MATH_DISPLAY_KEY);
+  math_condensed = get_bool (MATH_CONDENSED_KEY);
+  vert_pos       = get_int (MATH_VPOS_KEY);
+  nesting_level  = get_int (MATH_NESTING_LEVEL_KEY);
+  preamble       = get_bool (PREAMBLE_KEY);
+  spacing_policy = get_spacing_id (env[SPACING_POLICY_KEY]);
+  math_font_sizes= env[MATH_FONT_SIZES_KEY];
   size_cache     = array<array<int> > ();
 
   update_mode ();
@@ -955,29 +968,30 @@ edit_env_rep::update () {
 
   update_geometry ();
   update_frame ();
-  point_style = get_string (POINT_STYLE);
-  point_size  = get_length (POINT_SIZE);
-  point_border= get_length (POINT_BORDER);
+  point_style = get_string (POINT_STYLE_KEY);
+  point_size  = get_length (POINT_SIZE_KEY);
+  point_border= get_length (POINT_BORDER_KEY);
   update_color ();
   update_pattern_mode ();
   update_dash_style ();
   update_dash_style_unit ();
   update_line_arrows ();
-  line_portion= get_double (LINE_PORTION);
-  text_at_halign= get_string (TEXT_AT_HALIGN);
-  text_at_valign= get_string (TEXT_AT_VALIGN);
-  doc_at_valign= get_string (DOC_AT_VALIGN);
+  line_portion= get_double (LINE_PORTION_KEY);
+  text_at_halign= get_string (TEXT_AT_HALIGN_KEY);
+  text_at_valign= get_string (TEXT_AT_VALIGN_KEY);
+  doc_at_valign= get_string (DOC_AT_VALIGN_KEY);
 
   update_src_style ();
   update_src_special ();
   update_src_compact ();
   update_src_close ();
-  src_tag_color= get_string (SRC_TAG_COLOR);
+  src_tag_color= get_string (SRC_TAG_COLOR_KEY);
   src_tag_col= named_color (src_tag_color);
 
-  frac_max   = get_length (MATH_FRAC_LIMIT);
-  table_max  = get_length (MATH_TABLE_LIMIT);
-  flatten_pen= pencil (env[MATH_FLATTEN_COLOR], alpha, get_length (LINE_WIDTH));
+  frac_max   = get_length (MATH_FRAC_LIMIT_KEY);
+  table_max  = get_length (MATH_TABLE_LIMIT_KEY);
+  flatten_pen= pencil (env[MATH_FLATTEN_COLOR_KEY], alpha,
+                       get_length (LINE_WIDTH_KEY));
 }
 
 /******************************************************************************
@@ -985,25 +999,25 @@ edit_env_rep::update () {
 ******************************************************************************/
 
 void
-edit_env_rep::update (string s) {
-  switch (var_type[s]) {
+edit_env_rep::update (int key) {
+  switch (get_var_type (key)) {
   case Env_User:
     break;
   case Env_Fixed:
     break;
   case Env_Zoom:
-    zoomf= normal_zoom (get_double (ZOOM_FACTOR));
+    zoomf= normal_zoom (get_double (ZOOM_FACTOR_KEY));
     pixel= (SI) tm_round ((std_shrinkf * PIXEL) / zoomf);
     break;
   case Env_Magnification:
-    magn= get_double (MAGNIFICATION);
-    magn_len= (get_string (LENGTH_MODE) == "fixed"? 1.0: magn);
+    magn= get_double (MAGNIFICATION_KEY);
+    magn_len= (get_string (LENGTH_MODE_KEY) == "fixed"? 1.0: magn);
     update_font ();
     update_color ();
     update_dash_style_unit ();
     break;
   case Env_Magnify:
-    mgfy= get_double (MAGNIFY);
+    mgfy= get_double (MAGNIFY_KEY);
     update_font ();
     update_color ();
     update_dash_style_unit ();
@@ -1026,30 +1040,31 @@ edit_env_rep::update (string s) {
     update_font ();
     break;
   case Env_Font_Sizes:
-    math_font_sizes= env[MATH_FONT_SIZES];
+    math_font_sizes= env[MATH_FONT_SIZES_KEY];
     size_cache= array<array<int> > ();
     update_font ();
     break;
   case Env_Index_Level:
-    index_level= get_int (MATH_LEVEL);
+    index_level= get_int (MATH_LEVEL_KEY);
     update_font ();
     break;
   case Env_Display_Style:
-    display_style= get_bool (MATH_DISPLAY);
+    display_style= get_bool (MATH_DISPLAY_KEY);
     break;
   case Env_Math_Condensed:
-    math_condensed= get_bool (MATH_CONDENSED);
+    math_condensed= get_bool (MATH_CONDENSED_KEY);
     break;
   case Env_Vertical_Pos:
-    vert_pos= get_int (MATH_VPOS);
+    vert_pos= get_int (MATH_VPOS_KEY);
     break;
   case Env_Math_Nesting:
-    nesting_level= get_int (MATH_NESTING_LEVEL);
+    nesting_level= get_int (MATH_NESTING_LEVEL_KEY);
     break;
   case Env_Math_Width:
-    frac_max= get_length (MATH_FRAC_LIMIT);
-    table_max= get_length (MATH_TABLE_LIMIT);
-    flatten_pen= pencil (env[MATH_FLATTEN_COLOR], alpha, get_length (LINE_WIDTH));
+    frac_max= get_length (MATH_FRAC_LIMIT_KEY);
+    table_max= get_length (MATH_TABLE_LIMIT_KEY);
+    flatten_pen= pencil (env[MATH_FLATTEN_COLOR_KEY], alpha,
+                       get_length (LINE_WIDTH_KEY));
     break;
   case Env_Color:
     update_color ();
@@ -1058,7 +1073,7 @@ edit_env_rep::update (string s) {
     update_pattern_mode ();
     break;
   case Env_Spacing:
-    spacing_policy= get_spacing_id (env[SPACING_POLICY]);
+    spacing_policy= get_spacing_id (env[SPACING_POLICY_KEY]);
     break;
   case Env_Paragraph:
     break;
@@ -1068,7 +1083,7 @@ edit_env_rep::update (string s) {
     update_page_pars ();
     break;
   case Env_Preamble:
-    preamble= get_bool (PREAMBLE);
+    preamble= get_bool (PREAMBLE_KEY);
     break;
   case Env_Geometry:
     update_geometry ();
@@ -1077,11 +1092,11 @@ edit_env_rep::update (string s) {
     update_frame ();
     break;
   case Env_Point_Style:
-    point_style= get_string (POINT_STYLE);
+    point_style= get_string (POINT_STYLE_KEY);
     break;
   case Env_Point_Size:
-    point_size= get_length (POINT_SIZE);
-    point_border= get_length (POINT_BORDER);
+    point_size= get_length (POINT_SIZE_KEY);
+    point_border= get_length (POINT_BORDER_KEY);
     break;
   case Env_Line_Width:
     update_color ();
@@ -1099,16 +1114,16 @@ edit_env_rep::update (string s) {
     update_line_arrows();
     break;
   case Env_Line_Portion:
-    line_portion= get_double (LINE_PORTION);
+    line_portion= get_double (LINE_PORTION_KEY);
     break;
   case Env_Text_At_Halign:
-    text_at_halign= get_string (TEXT_AT_HALIGN);
+    text_at_halign= get_string (TEXT_AT_HALIGN_KEY);
     break;
   case Env_Text_At_Valign:
-    text_at_valign= get_string (TEXT_AT_VALIGN);
+    text_at_valign= get_string (TEXT_AT_VALIGN_KEY);
     break;
   case Env_Doc_At_Valign:
-    doc_at_valign= get_string (DOC_AT_VALIGN);
+    doc_at_valign= get_string (DOC_AT_VALIGN_KEY);
     break;
   case Env_Src_Style:
     update_src_style ();
@@ -1123,7 +1138,7 @@ edit_env_rep::update (string s) {
     update_src_close ();
     break;
   case Env_Src_Color:
-    src_tag_color= get_string (SRC_TAG_COLOR);
+    src_tag_color= get_string (SRC_TAG_COLOR_KEY);
     src_tag_col= named_color (src_tag_color);
     break;
   }
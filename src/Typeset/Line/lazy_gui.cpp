@@ -47,20 +47,21 @@ lazy_canvas_rep::query (lazy_type request, format fm) {
     format_width fmw= (format_width) body_fm;
     SI width= fmw->width;
     edit_env env= props->env;
-    tree old1= env->local_begin (PAGE_MEDIUM, "papyrus");
-    tree old2= env->local_begin (PAR_LEFT, "0tmpt");
-    tree old3= env->local_begin (PAR_RIGHT, "0tmpt");
-    tree old4= env->local_begin (PAR_MODE, "justify");
-    tree old5= env->local_begin (PAR_NO_FIRST, "true");
-    tree old6= env->local_begin (PAR_WIDTH, tree (TMLEN, as_string (width)));
+    tree old1= env->local_begin (PAGE_MEDIUM_KEY, "papyrus");
+    tree old2= env->local_begin (PAR_LEFT_KEY, "0tmpt");
+    tree old3= env->local_begin (PAR_RIGHT_KEY, "0tmpt");
+    tree old4= env->local_begin (PAR_MODE_KEY, "justify");
+    tree old5= env->local_begin (PAR_NO_FIRST_KEY, "true");
+    tree old6=
+      env->local_begin (PAR_WIDTH_KEY, tree (TMLEN, as_string (width)));
     SI x1, x2, scx;
     get_canvas_horizontal (props, 0, fmw->width, x1, x2, scx);
-    env->local_end (PAR_WIDTH, old6);
-    env->local_end (PAR_NO_FIRST, old5);
-    env->local_end (PAR_MODE, old4);
-    env->local_end (PAR_RIGHT, old3);
-    env->local_end (PAR_LEFT, old2);
-    env->local_end (PAGE_MEDIUM, old1);
+    env->local_end (PAR_WIDTH_KEY, old6);
+    env->local_end (PAR_NO_FIRST_KEY, old5);
+    env->local_end (PAR_MODE_KEY, old4);
+    env->local_end (PAR_RIGHT_KEY, old3);
+    env->local_end (PAR_LEFT_KEY, old2);
+    env->local_end (PAGE_MEDIUM_KEY, old1);
     SI delta= 0;
     string type= props->type;
     if (type != "plain") {
@@ -101,22 +102,23 @@ lazy_canvas_rep::produce (lazy_type request, format fm) {
     format_width fmw= (format_width) bfm;
     SI width= fmw->width + delta;
     edit_env env= props->env;
-    tree old1= env->local_begin (PAGE_MEDIUM, "papyrus");
-    tree old2= env->local_begin (PAR_LEFT, "0tmpt");
-    tree old3= env->local_begin (PAR_RIGHT, "0tmpt");
-    tree old4= env->local_begin (PAR_MODE, "justify");
-    tree old5= env->local_begin (PAR_NO_FIRST, "true");
-    tree old6= env->local_begin (PAR_WIDTH, tree (TMLEN, as_string (width)));
+    tree old1= env->local_begin (PAGE_MEDIUM_KEY, "papyrus");
+    tree old2= env->local_begin (PAR_LEFT_KEY, "0tmpt");
+    tree old3= env->local_begin (PAR_RIGHT_KEY, "0tmpt");
+    tree old4= env->local_begin (PAR_MODE_KEY, "justify");
+    tree old5= env->local_begin (PAR_NO_FIRST_KEY, "true");
+    tree old6=
+      env->local_begin (PAR_WIDTH_KEY, tree (TMLEN, as_string (width)));
     SI x1, x2, scx;
     get_canvas_horizontal (props, b->x1, b->x2, x1, x2, scx);
     SI y1, y2, scy;
     get_canvas_vertical (props, b->y1, b->y2, y1, y2, scy);
-    env->local_end (PAR_WIDTH, old6);
-    env->local_end (PAR_NO_FIRST, old5);
-    env->local_end (PAR_MODE, old4);
-    env->local_end (PAR_RIGHT, old3);
-    env->local_end (PAR_LEFT, old2);
-    env->local_end (PAGE_MEDIUM, old1);
+    env->local_end (PAR_WIDTH_KEY, old6);
+    env->local_end (PAR_NO_FIRST_KEY, old5);
+    env->local_end (PAR_MODE_KEY, old4);
+    env->local_end (PAR_RIGHT_KEY, old3);
+    env->local_end (PAR_LEFT_KEY, old2);
+    env->local_end (PAGE_MEDIUM_KEY, old1);
     path dip= (type == "plain"? ip: decorate (ip));
     box rb= clip_box (dip, b, x1, y1, x2, y2, props->xt, props->yt, scx, scy);
     if (type != "plain") rb= put_scroll_bars (props, rb, ip, b, scx, scy);
@@ -33,46 +33,46 @@ lazy_paragraph_rep::lazy_paragraph_rep (edit_env env2, path ip):
   env (env2), style (""), sss (tm_new<stacker_rep> ())
 {
   sss->ip= ip; // is this necessary?
-  style (PAR_FIRST)   = env->read (PAR_FIRST);
-  style (PAR_NO_FIRST)= env->read (PAR_NO_FIRST);
+  style (PAR_FIRST)   = env->read (PAR_FIRST_KEY);
+  style (PAR_NO_FIRST)= env->read (PAR_NO_FIRST_KEY);
   // env->assign (PAR_NO_FIRST, "false");
-  env->monitored_write_update (PAR_NO_FIRST, "false");
+  env->monitored_write_update (PAR_NO_FIRST_KEY, "false");
 
   SI d1, d2, d3, d4, d5, d6, d7;
   env->get_page_pars (width, d1, d2, d3, d4, d5, d6, d7);
 
-  mode       = as_string (env->read (PAR_MODE));
-  flexibility= as_double (env->read (PAR_FLEXIBILITY));
-  hyphen     = as_string (env->read (PAR_HYPHEN));
-  min_pen    = as_double (env->read (PAR_MIN_PENALTY));
-  left       = env->get_length (PAR_LEFT);
-  right      = env->get_length (PAR_RIGHT);
+  mode       = as_string (env->read (PAR_MODE_KEY));
+  flexibility= as_double (env->read (PAR_FLEXIBILITY_KEY));
+  hyphen     = as_string (env->read (PAR_HYPHEN_KEY));
+  min_pen    = as_double (env->read (PAR_MIN_PENALTY_KEY));
+  left       = env->get_length (PAR_LEFT_KEY);
+  right      = env->get_length (PAR_RIGHT_KEY);
   bot        = 0;
   top        = env->fn->yx;
-  sep        = env->get_length (PAR_SEP);
-  hor_sep    = env->get_length (PAR_HOR_SEP);
-  ver_sep    = env->get_length (PAR_VER_SEP);
+  sep        = env->get_length (PAR_SEP_KEY);
+  hor_sep    = env->get_length (PAR_HOR_SEP_KEY);
+  ver_sep    = env->get_length (PAR_VER_SEP_KEY);
   height     = env->as_length (string ("1fn"))+ sep;
   tab_sep    = hor_sep;
-  line_sep   = env->get_vspace (PAR_LINE_SEP);
-  par_sep    = env->get_vspace (PAR_PAR_SEP);
-  nr_cols    = env->get_int (PAR_COLUMNS);
+  line_sep   = env->get_vspace (PAR_LINE_SEP_KEY);
+  par_sep    = env->get_vspace (PAR_PAR_SEP_KEY);
+  nr_cols    = env->get_int (PAR_COLUMNS_KEY);
   swell      = array<SI> ();
 
-  SI sw= env->get_length (PAR_SWELL);
+  SI sw= env->get_length (PAR_SWELL_KEY);
   if (sw > 0)
     swell << sw
-          << env->get_length (MATH_TOP_SWELL_START)
-          << env->get_length (MATH_TOP_SWELL_END)
-          << env->get_length (MATH_BOT_SWELL_START)
-          << env->get_length (MATH_BOT_SWELL_END);
+          << env->get_length (MATH_TOP_SWELL_START_KEY)
+          << env->get_length (MATH_TOP_SWELL_END_KEY)
+          << env->get_length (MATH_BOT_SWELL_START_KEY)
+          << env->get_length (MATH_BOT_SWELL_END_KEY);
 
-  string kr= as_string (env->read (PAR_KERNING_REDUCE));
+  string kr= as_string (env->read (PAR_KERNING_REDUCE_KEY));
   if (kr == "auto") kreduce= 0.4 / 40.0;
   else if (is_double (kr)) kreduce= as_double (kr);
   else kreduce= 0.0;
 
-  string ks= as_string (env->read (PAR_KERNING_STRETCH));
+  string ks= as_string (env->read (PAR_KERNING_STRETCH_KEY));
   if (ks == "auto") {
     double cpl= min (max (((double) width) / max (env->fn->wfn, 1), 10.0), 40.0);
     kstretch= 1.0 / cpl;
@@ -84,16 +84,16 @@ lazy_paragraph_rep::lazy_paragraph_rep (edit_env env2, path ip):
   else if (is_double (ks)) kstretch= as_double (ks);
   else kstretch= 0.0;
 
-  string ps= as_string (env->read (PAR_KERNING_MARGIN));
+  string ps= as_string (env->read (PAR_KERNING_MARGIN_KEY));
   if (ps == "true") protrusion= WESTERN_PROTRUSION;
   else protrusion= 0;
 
-  string cf= as_string (env->read (PAR_CONTRACTION));
+  string cf= as_string (env->read (PAR_CONTRACTION_KEY));
   if (cf == "auto") contraction= 1.0 / 40.0;
   else if (is_double (cf)) contraction= as_double (cf);
   else contraction= 0.0;
 
-  string ef= as_string (env->read (PAR_EXPANSION));
+  string ef= as_string (env->read (PAR_EXPANSION_KEY));
   if (ef == "auto") {
     double cpl= min (max (((double) width) / max (env->fn->wfn, 1), 10.0), 40.0);
     expansion= 0.7 / cpl;
@@ -110,14 +110,14 @@ lazy_paragraph_rep::lazy_paragraph_rep (edit_env env2, path ip):
   //contraction= kreduce= 0.0; // FIXME
   //expansion= contraction= 0.0; // FIXME
 
-  string sm= as_string (env->read (PAR_SPACING));
+  string sm= as_string (env->read (PAR_SPACING_KEY));
   if (sm == "plain");
   else if (sm == "quanjiao") protrusion += QUANJIAO;
   else if (sm == "banjiao") protrusion += BANJIAO;
   else if (sm == "hangmobanjiao") protrusion += HANGMOBANJIAO;
   else if (sm == "kaiming") protrusion += KAIMING;
 
-  tree dec= env->read (ATOM_DECORATIONS);
+  tree dec= env->read (ATOM_DECORATIONS_KEY);
   if (N(dec) > 0) decs << tuple ("0", dec);
 }
 
@@ -544,9 +544,9 @@ lazy_paragraph_rep::handle_decoration (
   if (e != tree (DBOX)) {
     // cout << "Typesetting " << e << LF;
     env->decorated_boxes << b;
-    tree old_xoff= env->local_begin (XOFF_DECORATIONS, xoff_str);
+    tree old_xoff= env->local_begin (XOFF_DECORATIONS_KEY, xoff_str);
     box bb= typeset_as_concat (env, attach_middle (e, ip));
-    env->local_end (XOFF_DECORATIONS, old_xoff);
+    env->local_end (XOFF_DECORATIONS_KEY, old_xoff);
     env->decorated_boxes->resize (N (env->decorated_boxes) - 1);
     b= bb;
   }
@@ -756,7 +756,7 @@ lazy_paragraph_rep::format_paragraph () {
           style (a[j]->t[1]->label)= a[j]->t[2];
         }
     no_first= (style [PAR_NO_FIRST] == "true");
-    if (no_first) env->monitored_write_update (PAR_NO_FIRST, "true");
+    if (no_first) env->monitored_write_update (PAR_NO_FIRST_KEY, "true");
     if (mode == "center") first= 0;
     else first= env->as_length (style [PAR_FIRST]);
     sss->set_env_vars (height, sep, hor_sep, ver_sep, bot, top, swell);
@@ -915,5 +915,5 @@ lazy_paragraph_rep::produce (lazy_type request, format fm) {
 
 void
 lazy_paragraph_rep::propagate () {
-  style (PAR_NO_FIRST)= env->read (PAR_NO_FIRST);
+  style (PAR_NO_FIRST)= env->read (PAR_NO_FIRST_KEY);
 }
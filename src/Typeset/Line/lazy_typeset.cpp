@@ -197,17 +197,17 @@ make_lazy_with (edit_env env, tree t, path ip) {
   int i, k= last>>1; // is k=0 allowed ?
   // if ((last&1) != 0) return;
   
-  STACK_NEW_ARRAY(vars,string,k);
+  STACK_NEW_ARRAY(vars,int,k);
   STACK_NEW_ARRAY(oldv,tree,k);
   STACK_NEW_ARRAY(newv,tree,k);
   for (i=0; i<k; i++) {
     tree var_t= env->exec (t[i<<1]);
     if (is_atomic (var_t)) {
-      string var= var_t->label;
-      vars[i]= var;
-      oldv[i]= env->read (var);
+      vars[i]= make_env_key (var_t->label);
+      oldv[i]= env->read (vars[i]);
       newv[i]= env->exec (t[(i<<1)+1]);
     }
+    else vars[i]= make_env_key ("");
     /*
     else {
       STACK_DELETE_ARRAY(vars);
@@ -264,22 +264,22 @@ make_lazy_compound (edit_env env, tree t, path ip) {
 
   if (is_applicable (f)) {
     int i, n=N(f)-1, m=N(t)-d;
-    env->macro_arg= list<hashmap<string,tree> > (
-      hashmap<string,tree> (UNINIT), env->macro_arg);
+    env->macro_arg= list<basic_environment> (
+      basic_environment (round_pow2 (n)), env->macro_arg);
     env->macro_src= list<hashmap<string,path> > (
       hashmap<string,path> (path (DECORATION)), env->macro_src);
     if (L(f) == XMACRO) {
       if (is_atomic (f[0])) {
 	string var= f[0]->label;
-	env->macro_arg->item (var)= t;
+	env->macro_arg->item->write (var, t);
 	env->macro_src->item (var)= ip;
       }
     }
     else for (i=0; i<n; i++)
       if (is_atomic (f[i])) {
 	string var= f[i]->label;
-	env->macro_arg->item (var)=
-	  i<m? t[i+d]: attach_dip (tree (UNINIT), decorate_right(ip));
+	env->macro_arg->item->write (var,
+	  i<m? t[i+d]: attach_dip (tree (UNINIT), decorate_right(ip)));
 	env->macro_src->item (var)= i<m? descend (ip,i+d): decorate_right(ip);
       }
     if (is_decoration (ip)) par= make_lazy (env, attach_here (f[n], ip));
@@ -339,12 +339,12 @@ make_lazy_auto (edit_env env, tree t, path ip, tree f) {
   }
 
   lazy par;
-  env->macro_arg= list<hashmap<string,tree> > (
-    hashmap<string,tree> (UNINIT), env->macro_arg);
+  env->macro_arg= list<basic_environment> (
+    basic_environment (1), env->macro_arg);
   env->macro_src= list<hashmap<string,path> > (
     hashmap<string,path> (path (DECORATION)), env->macro_src);
   string var= f[0]->label;
-  env->macro_arg->item (var)= t;
+  env->macro_arg->item->write (var, t);
   env->macro_src->item (var)= ip;
   if (is_decoration (ip)) par= make_lazy (env, attach_here (f[1], ip));
   else par= make_lazy (env, attach_right (f[1], ip));
@@ -380,7 +380,7 @@ make_lazy_argument (edit_env env, tree t, path ip) {
 
   array<line_item> a= typeset_marker (env, descend (ip, 0));
   array<line_item> b= typeset_marker (env, descend (ip, 1));
-  list<hashmap<string,tree> > old_var= env->macro_arg;
+  list<basic_environment> old_var= env->macro_arg;
   list<hashmap<string,path> > old_src= env->macro_src;
   if (!is_nil (env->macro_arg)) env->macro_arg= env->macro_arg->next;
   if (!is_nil (env->macro_src)) env->macro_src= env->macro_src->next;
@@ -475,12 +475,12 @@ make_lazy_locus (edit_env env, tree t, path ip) {
   if (!build_locus (env, t, ids, col))
     typeset_warning << "Ignored unaccessible loci\n";
   int last= N(t)-1;
-  tree old_col= env->read (COLOR);
-  env->write_update (COLOR, col);
+  tree old_col= env->read (COLOR_KEY);
+  env->write_update (COLOR_KEY, col);
   array<line_item> a= typeset_marker (env, descend (ip, 0));
   array<line_item> b= typeset_marker (env, descend (ip, 1));
   lazy par= make_lazy (env, t[last], descend (ip, last));
-  env->write_update (COLOR, old_col);
+  env->write_update (COLOR_KEY, old_col);
   return lazy_surround (a, b, par, ip);
 }
 
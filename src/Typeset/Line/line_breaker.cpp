@@ -11,42 +11,38 @@
 
 #include "Boxes/construct.hpp"
 #include "Format/line_item.hpp"
+#include "hashmap.hpp"
 #define PEN DI
 
 /******************************************************************************
 * Information about the best line breaks
 ******************************************************************************/
 
-struct lb_info_rep: concrete_struct {
+struct lb_node {
   path prev;
   int  pen;
   PEN  pen_spc;
 
-  lb_info_rep (): prev (), pen (HYPH_INVALID), pen_spc ((PEN) 1000000000) {}
-};
-
-struct lb_info {
-  CONCRETE(lb_info);
-  lb_info () { rep= tm_new<lb_info_rep> (); }
-  operator tree () {
-    return tuple ((tree) rep->prev,
-		  as_string (rep->pen),
-		  as_string ((double) rep->pen_spc)); }
+  lb_node (): prev (), pen (HYPH_INVALID), pen_spc ((PEN) 1000000000) {}
 };
-CONCRETE_CODE(lb_info);
 
 tm_ostream&
-operator << (tm_ostream& out, lb_info hi) {
-  return out << "[ " << hi->prev << ", "
-	     << hi->pen << ", " << hi->pen_spc << " ]";
+operator << (tm_ostream& out, lb_node hi) {
+  return out << "[ " << hi.prev << ", "
+	     << hi.pen << ", " << hi.pen_spc << " ]";
 }
 
-// FIXME: explicit instantiation for broken g++
-#include "hashmap.hpp"
-template lb_info& hashmap_rep<list<int>, lb_info>::bracket_rw(list<int>);
-
 /******************************************************************************
 * The line_breaker class
+*******************************************************************************
+* The candidate breaks which have been reached are stored in the flat array
+* nodes. The break before the i-th item is the node at_item[i-start]. The
+* hyphenation points of a string item are only computed once and the nodes
+* for the breaks (i, j) inside the item are stored in hyph_node, starting
+* at hyph_base[i-start], together with the widths of the left parts. Only
+* the breaks after repeated hyphenations of the same item are looked up
+* in a hashmap. Breaks which are never reached do not have a node, so that
+* they cost nothing when processing the paragraph.
 ******************************************************************************/
 
 struct line_breaker_rep {
@@ -58,7 +54,15 @@ struct line_breaker_rep {
   SI  first_spc;
   SI  last_spc;
   int pass;
-  hashmap<path,lb_info> best;
+
+  array<lb_node>     nodes;       // all breaks which have been reached
+  array<int>         at_item;     // node for the break before each item
+  array<int>         hyph_base;   // start of the breaks inside each item
+  array<array<int> > hyphens;     // hyphenation penalties of each item
+  array<int>         hyph_node;   // node for each break inside an item
+  array<SI>          hyph_width;  // width of the left part of the item
+  array<bool>        hyph_known;  // left part already hyphenated?
+  hashmap<path,int>  deep;        // nodes for repeated hyphenations
 
   line_breaker_rep (array<line_item> a, int start, int end,
 		    SI line_width, SI large_width, SI first_spc, SI last_spc);
@@ -67,6 +71,10 @@ struct line_breaker_rep {
   path next_ragged_break (path pos);
   array<path> compute_ragged_breaks ();
 
+  int  item_hyphens (int i);
+  int  find_node (path p);
+  int  make_node (path p);
+  SI   hyphen_width (line_item item, int i, int j, bool top);
   void test_better (path new_pos, path old_pos, int penalty, PEN pen_spc);
   bool propose_break (path new_pos, path old_pos, int penalty, space spc);
   void break_string (line_item item, path pos, int i, space spc);
@@ -81,7 +89,13 @@ line_breaker_rep::line_breaker_rep (
     a (a2), start (start2), end (end2),
     line_width (line_width2), large_width (large_width2),
     first_spc (first_spc2), last_spc (last_spc2),
-    best (lb_info ()) {}
+    nodes (0), at_item (end2-start2+1), hyph_base (end2-start2),
+    hyphens (end2-start2), deep (-1)
+{
+  int i;
+  for (i=0; i<N(at_item); i++) at_item[i]= -1;
+  for (i=0; i<N(hyph_base); i++) hyph_base[i]= -1;
+}
 
 /******************************************************************************
 * Some subroutines
@@ -252,6 +266,69 @@ line_breaker_rep::compute_ragged_breaks () {
   return ap;
 }
 
+/******************************************************************************
+* Nodes for the line breaks
+******************************************************************************/
+
+int
+line_breaker_rep::item_hyphens (int i) {
+  int k= i - start;
+  if (hyph_base[k] < 0) {
+    line_item item= a[i];
+    array<int> hp= item->lan->get_hyphens (item->b->get_leaf_string ());
+    int j, base= N(hyph_node), n= N(hp);
+    hyphens[k]= hp;
+    hyph_base[k]= base;
+    hyph_node->resize (base + n);
+    hyph_width->resize (base + n);
+    hyph_known->resize (base + n);
+    for (j=0; j<n; j++) {
+      hyph_node[base+j]= -1;
+      hyph_width[base+j]= 0;
+      hyph_known[base+j]= false;
+    }
+  }
+  return hyph_base[k];
+}
+
+int
+line_breaker_rep::find_node (path p) {
+  int k= p->item - start;
+  if (is_atom (p)) return at_item[k];
+  if (!is_atom (p->next)) return deep[p];
+  int j= p->next->item;
+  if (hyph_base[k] < 0 || j >= N(hyphens[k])) return -1;
+  return hyph_node[hyph_base[k] + j];
+}
+
+int
+line_breaker_rep::make_node (path p) {
+  int r= find_node (p);
+  if (r >= 0) return r;
+  r= N(nodes);
+  nodes << lb_node ();
+  if (is_atom (p)) at_item[p->item - start]= r;
+  else if (!is_atom (p->next)) deep (p)= r;
+  else hyph_node[item_hyphens (p->item) + p->next->item]= r;
+  return r;
+}
+
+SI
+line_breaker_rep::hyphen_width (line_item item, int i, int j, bool top) {
+  line_item item1, item2;
+  if (!top) {
+    hyphenate (item, j, item1, item2);
+    return item1->b->w();
+  }
+  int k= item_hyphens (i) + j;
+  if (!hyph_known[k]) {
+    hyphenate (item, j, item1, item2);
+    hyph_width[k]= item1->b->w();
+    hyph_known[k]= true;
+  }
+  return hyph_width[k];
+}
+
 /******************************************************************************
 * Test whether we found a better break
 ******************************************************************************/
@@ -260,16 +337,16 @@ void
 line_breaker_rep::test_better (path new_pos, path old_pos,
 			       int pen, PEN pen_spc)
 {
-  if (!best->contains (new_pos)) best (new_pos)= lb_info ();
-  lb_info cur= best [new_pos];
+  int k= make_node (new_pos);
+  lb_node& cur= nodes[k];
   //cout << "Test " << new_pos << " vs " << old_pos
-  //     << ", " << pen << " vs " << cur->pen
-  //     << ", " << pen_spc << " vs " << cur->pen_spc << "\n";
-  if ((pen < cur->pen) ||
-      ((pen == cur->pen) && (pen_spc < cur->pen_spc))) {
-    cur->prev   = old_pos;
-    cur->pen    = pen;
-    cur->pen_spc= min (pen_spc, (PEN) 1000000000);
+  //     << ", " << pen << " vs " << cur.pen
+  //     << ", " << pen_spc << " vs " << cur.pen_spc << "\n";
+  if ((pen < cur.pen) ||
+      ((pen == cur.pen) && (pen_spc < cur.pen_spc))) {
+    cur.prev   = old_pos;
+    cur.pen    = pen;
+    cur.pen_spc= min (pen_spc, (PEN) 1000000000);
     //cout << "  Better\n";
   }
 }
@@ -280,32 +357,33 @@ bool
 line_breaker_rep::propose_break (path new_pos, path old_pos,
 				 int pen, space spc)
 {
-  lb_info cur= best[old_pos];
+  int k= find_node (old_pos);
+  lb_node cur= (k < 0? lb_node (): nodes[k]);
 
   if ((spc->min <= line_width) &&
       ((spc->max >= line_width) || (new_pos->item==end))) {
     SI d= max (line_width- spc->def, spc->def- line_width);
     if (new_pos->item==end) d=0;
-    test_better (new_pos, old_pos, min (HYPH_INVALID, cur->pen + pen),
-		 cur->pen_spc + (cur->pen == HYPH_INVALID?
+    test_better (new_pos, old_pos, min (HYPH_INVALID, cur.pen + pen),
+		 cur.pen_spc + (cur.pen == HYPH_INVALID?
                                  ((PEN) 0): square ((PEN) (d / PIXEL))));
   }
 
   if (pass==2) {
     if (spc->max < line_width)
       test_better (new_pos, old_pos, HYPH_INVALID,
-		   (cur->pen == HYPH_INVALID? cur->pen_spc: ((PEN) 0)) +
+		   (cur.pen == HYPH_INVALID? cur.pen_spc: ((PEN) 0)) +
 		   square ((PEN) ((line_width - spc->max)/PIXEL)) +
 		   (new_pos->item==old_pos->item?
 		    square ((PEN) (line_width / PIXEL)): ((PEN) 0)));
     else if (spc->min > large_width)
       test_better (new_pos, old_pos, HYPH_INVALID,
-		   (cur->pen == HYPH_INVALID? cur->pen_spc: ((PEN) 0)) +
+		   (cur.pen == HYPH_INVALID? cur.pen_spc: ((PEN) 0)) +
 		   square ((PEN) ((spc->min - line_width) / PIXEL)) +
 		   square ((PEN) (4*line_width / PIXEL)));
     else if (spc->min > line_width)
       test_better (new_pos, old_pos, HYPH_INVALID,
-		   (cur->pen == HYPH_INVALID? cur->pen_spc: ((PEN) 0)) +
+		   (cur.pen == HYPH_INVALID? cur.pen_spc: ((PEN) 0)) +
 		   square ((PEN) ((spc->min - line_width) / PIXEL)) +
 		   (new_pos->item==old_pos->item?
                     square ((PEN) (line_width / PIXEL)): ((PEN) 0)));
@@ -321,17 +399,21 @@ line_breaker_rep::propose_break (path new_pos, path old_pos,
 void
 line_breaker_rep::break_string (line_item item, path pos, int i, space spc) {
   int j;
+  bool top= (i != pos->item) || is_atom (pos);
   string item_s= item->b->get_leaf_string ();
-  array<int> hp= item->lan->get_hyphens (item_s);
+  array<int> hp;
+  if (!top) hp= item->lan->get_hyphens (item_s);
+  else {
+    (void) item_hyphens (i);
+    hp= hyphens[i - start];
+  }
 
   if ((item->b->w() > line_width) || (!is_atom (pos))) {
     j= get_position (item->b->get_leaf_font (), item_s, line_width- spc->def);
     for (j= min (j+2, N(hp)-1); j>=0; j--)
       if (hp[j] < HYPH_INVALID) {
-	line_item item1, item2;
-	hyphenate (item, j, item1, item2);
 	path next= (i==pos->item)? pos * j: path (i, j);
-	space spc_hyph= spc+ space (item1->b->w());
+	space spc_hyph= spc+ space (hyphen_width (item, i, j, top));
 	if (spc_hyph->min <= line_width) {
 	  propose_break (next, pos, hp[j], spc_hyph->min);
 	  break;
@@ -341,10 +423,8 @@ line_breaker_rep::break_string (line_item item, path pos, int i, space spc) {
   else {
     for (j=0; j<N(hp); j++)
       if (hp[j] < HYPH_INVALID) {
-	line_item item1, item2;
-	hyphenate (item, j, item1, item2);
 	path next= (i==pos->item)? pos * j: path (i, j);
-	space spc_hyph= spc+ space (item1->b->w());
+	space spc_hyph= spc+ space (hyphen_width (item, i, j, top));
 	(void) propose_break (next, pos, hp[j], spc_hyph);
       }
   }
@@ -369,7 +449,8 @@ line_breaker_rep::process (path pos) {
     spc= space (first->b->w());
   }
 
-  if ((pass>1) || (best[pos]->pen < HYPH_INVALID)) {
+  int k= find_node (pos);
+  if ((pass>1) || (k >= 0 && nodes[k].pen < HYPH_INVALID)) {
     // cout << "Process " << pos << ": " << first << "\n";
     for (i=pos->item; i<end; i++) {
       line_item item= a[i];
@@ -398,9 +479,16 @@ line_breaker_rep::process (path pos) {
   if (first->type == STRING_ITEM) {
     string first_s= first->b->get_leaf_string ();
     int n= N(first_s);
-    if (n>4)
+    if (n>4 && is_atom (pos)) {
+      int base= hyph_base[pos->item - start];
+      int m= base < 0? 0: min (n-1, N(hyphens[pos->item - start]));
+      for (i=0; i<m; i++)
+	if (hyph_node[base+i] >= 0)
+	  process (pos * i);
+    }
+    else if (n>4)
       for (i=0; i<n-1; i++)
-	if (best-> contains (pos * i))
+	if (deep->contains (pos * i))
 	  process (pos * i);
   }
 }
@@ -412,8 +500,8 @@ line_breaker_rep::process (path pos) {
 void
 line_breaker_rep::get_breaks (array<path>& ap, path p) {
   if (is_nil (p)) return;
-  lb_info cur= best[p];
-  get_breaks (ap, cur->prev);
+  int k= find_node (p);
+  get_breaks (ap, k < 0? path (): nodes[k].prev);
   ap << p;
 }
 
@@ -427,7 +515,8 @@ line_breaker_rep::compute_breaks () {
     process (path (i));
 
   pass= 2;
-  if (best [path (end)]->pen == HYPH_INVALID)
+  int k= find_node (path (end));
+  if (k < 0 || nodes[k].pen == HYPH_INVALID)
     for (i=start; i<end; i++)
       process (path (i));
 
@@ -173,8 +173,8 @@ pager_rep::pages_make_page (pagelet pg) {
   box lb= move_box (ip, sb, 0, 0);
   int nr= N(pages) + 1 + page_offset;
   SI  left= (nr&1)==0? even: odd;
-  env->write (PAGE_NR, as_string (nr));
-  env->write (PAGE_THE_PAGE, style[PAGE_THE_PAGE]);
+  env->write (PAGE_NR_KEY, as_string (nr));
+  env->write (PAGE_THE_PAGE_KEY, style[PAGE_THE_PAGE]);
   tree page_t= env->exec (compound (PAGE_THE_PAGE));
   bool empty= N (pg->ins) == 0;
   box header= make_header (empty);
@@ -184,9 +184,9 @@ pager_rep::pages_make_page (pagelet pg) {
   box page= page_box (ip, lb, page_t, nr, bgc, width, height,
                       left, top + dtop, top + dtop + text_height,
                       header, footer, head_sep, foot_sep);
-  if (env->get_string (PAGE_CROP_MARKS) == "") return page;
+  if (env->get_string (PAGE_CROP_MARKS_KEY) == "") return page;
   bool ls= env->page_landscape;
-  string sz= env->get_string (PAGE_CROP_MARKS);
+  string sz= env->get_string (PAGE_CROP_MARKS_KEY);
   SI w= env->as_length (page_get_feature (sz, PAGE_WIDTH, ls));
   SI h= env->as_length (page_get_feature (sz, PAGE_HEIGHT, ls));
   SI lw= env->as_length ("0.2ln");
@@ -224,7 +224,7 @@ pager_rep::papyrus_make () {
   SI ph= b->h();
   SI left  = (odd+even) >> 1;
   SI height= top + dtop + bot + dbot + ph;
-  if (env->get_string (PAGE_MEDIUM) == "beamer")
+  if (env->get_string (PAGE_MEDIUM_KEY) == "beamer")
     height= max (height, env->page_user_height + top + bot);
   array<box> bs   (1); bs   [0]= b;
   array<SI>  bs_x (1); bs_x [0]= left;
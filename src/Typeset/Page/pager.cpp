@@ -20,33 +20,33 @@ pager_rep::pager_rep (path ip2, edit_env env2, array<page_item> l2):
   ip (ip2), env (env2), style (UNINIT), l (l2)
 {
   style (PAGE_THE_PAGE)     = tree (MACRO, compound ("page-nr"));
-  style (PAGE_ODD_HEADER)   = env->read (PAGE_ODD_HEADER);
-  style (PAGE_ODD_FOOTER)   = env->read (PAGE_ODD_FOOTER);
-  style (PAGE_EVEN_HEADER)  = env->read (PAGE_EVEN_HEADER);
-  style (PAGE_EVEN_FOOTER)  = env->read (PAGE_EVEN_FOOTER);
+  style (PAGE_ODD_HEADER)   = env->read (PAGE_ODD_HEADER_KEY);
+  style (PAGE_ODD_FOOTER)   = env->read (PAGE_ODD_FOOTER_KEY);
+  style (PAGE_EVEN_HEADER)  = env->read (PAGE_EVEN_HEADER_KEY);
+  style (PAGE_EVEN_FOOTER)  = env->read (PAGE_EVEN_FOOTER_KEY);
   style (PAGE_THIS_HEADER)  = "";
   style (PAGE_THIS_FOOTER)  = "";
   style (PAGE_THIS_BG_COLOR)= "";
 
   double magn_old= env->magn_len;
   env->magn_len= 1.0;
-  int nr_cols= env->get_int (PAR_COLUMNS);
-  paper= (env->get_string (PAGE_MEDIUM) == "paper");
-  string pbr= env->get_string (PAGE_BREAKING);
+  int nr_cols= env->get_int (PAR_COLUMNS_KEY);
+  paper= (env->get_string (PAGE_MEDIUM_KEY) == "paper");
+  string pbr= env->get_string (PAGE_BREAKING_KEY);
   quality= (pbr == "sloppy"? 0: (pbr == "medium"? 1: 2));
   env->get_page_pars (text_width, text_height, width, height,
 		      odd, even, top, bot);
-  may_extend= env->get_length (PAGE_EXTEND);
-  may_shrink= env->get_length (PAGE_SHRINK);
-  head_sep  = env->get_length (PAGE_HEAD_SEP);
-  foot_sep  = env->get_length (PAGE_FOOT_SEP);
-  col_sep   = env->get_length (PAR_COLUMNS_SEP);
-  fn_sep    = env->get_vspace (PAR_FNOTE_SEP);
-  fnote_sep = env->get_vspace (PAGE_FNOTE_SEP) + (2*env->fn->sep);
-  fnote_bl  = env->get_length (PAGE_FNOTE_BARLEN);
-  float_sep = env->get_vspace (PAGE_FLOAT_SEP);
-  mnote_sep = env->get_length (PAGE_MNOTE_SEP);
-  show_hf   = env->get_bool (PAGE_SHOW_HF) && paper;
+  may_extend= env->get_length (PAGE_EXTEND_KEY);
+  may_shrink= env->get_length (PAGE_SHRINK_KEY);
+  head_sep  = env->get_length (PAGE_HEAD_SEP_KEY);
+  foot_sep  = env->get_length (PAGE_FOOT_SEP_KEY);
+  col_sep   = env->get_length (PAR_COLUMNS_SEP_KEY);
+  fn_sep    = env->get_vspace (PAR_FNOTE_SEP_KEY);
+  fnote_sep = env->get_vspace (PAGE_FNOTE_SEP_KEY) + (2*env->fn->sep);
+  fnote_bl  = env->get_length (PAGE_FNOTE_BARLEN_KEY);
+  float_sep = env->get_vspace (PAGE_FLOAT_SEP_KEY);
+  mnote_sep = env->get_length (PAGE_MNOTE_SEP_KEY);
+  show_hf   = env->get_bool (PAGE_SHOW_HF_KEY) && paper;
   if (nr_cols > 1) text_width = (text_width+col_sep+1) * nr_cols - col_sep;
   env->magn_len= magn_old;
 
@@ -195,30 +195,30 @@ pager_rep::end_page (bool flag) {
 box
 pager_rep::make_header (bool empty_flag) {
   if (!show_hf || empty_flag) return empty_box (decorate ());
-  env->write (PAGE_NR, as_string (N(pages)+1+page_offset));
-  env->write (PAGE_THE_PAGE, style[PAGE_THE_PAGE]);
-  tree old= env->local_begin (PAR_COLUMNS, "1");
+  env->write (PAGE_NR_KEY, as_string (N(pages)+1+page_offset));
+  env->write (PAGE_THE_PAGE_KEY, style[PAGE_THE_PAGE]);
+  tree old= env->local_begin (PAR_COLUMNS_KEY, "1");
   string which= (N(pages)&1)==0? PAGE_ODD_HEADER: PAGE_EVEN_HEADER;
   if (style [PAGE_THIS_HEADER] != "") which= PAGE_THIS_HEADER;
   box b= typeset_as_concat (env, attach_here (tree (PARA, style[which]),
 					      decorate()));
   style (PAGE_THIS_HEADER) = "";
-  env->local_end (PAR_COLUMNS, old);
+  env->local_end (PAR_COLUMNS_KEY, old);
   return b;
 }
 
 box
 pager_rep::make_footer (bool empty_flag) {
   if (!show_hf || empty_flag) return empty_box (decorate ());
-  env->write (PAGE_NR, as_string (N(pages)+1+page_offset));
-  env->write (PAGE_THE_PAGE, style[PAGE_THE_PAGE]);
-  tree old= env->local_begin (PAR_COLUMNS, "1");
+  env->write (PAGE_NR_KEY, as_string (N(pages)+1+page_offset));
+  env->write (PAGE_THE_PAGE_KEY, style[PAGE_THE_PAGE]);
+  tree old= env->local_begin (PAR_COLUMNS_KEY, "1");
   string which= (N(pages)&1)==0? PAGE_ODD_FOOTER: PAGE_EVEN_FOOTER;
   if (style [PAGE_THIS_FOOTER] != "") which= PAGE_THIS_FOOTER;
   box b= typeset_as_concat (env, attach_here (tree (PARA, style[which]),
 					      decorate()));
   style (PAGE_THIS_FOOTER) = "";
-  env->local_end (PAR_COLUMNS, old);
+  env->local_end (PAR_COLUMNS_KEY, old);
   return b;
 }
 
@@ -259,15 +259,15 @@ pager_rep::make_pages () {
 
   SI pixel= env->pixel;
   array<box> pg= pages;
-  if (env->get_string (PAGE_MEDIUM) == "paper" &&
-      env->get_string (PAGE_BORDER) != "none")
+  if (env->get_string (PAGE_MEDIUM_KEY) == "paper" &&
+      env->get_string (PAGE_BORDER_KEY) != "none")
     for (int i=0; i<nx; i++)
       for (int j=0; j<ny; j++) {
         int p= j*nx + i - d;
         if (p >= 0 && p < nr_pages) {
           SI l= 10*pixel, r= 10*pixel;
           SI b= 10*pixel, t= 10*pixel;
-          if (env->get_string (PAGE_BORDER) == "attached") {
+          if (env->get_string (PAGE_BORDER_KEY) == "attached") {
 #ifdef QTTEXMACS
             if (i > 0) l= pixel/2;
 #else
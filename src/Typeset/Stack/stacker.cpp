@@ -403,9 +403,9 @@ typeset_as_stack (edit_env env, tree t, path ip) {
   // cout << "Typeset as stack " << t << "\n";
   int i, n= N(t);
   stacker sss= tm_new<stacker_rep> ();
-  SI sep       = env->get_length (PAR_SEP);
-  SI hor_sep   = env->get_length (PAR_HOR_SEP);
-  SI ver_sep   = env->get_length (PAR_VER_SEP);
+  SI sep       = env->get_length (PAR_SEP_KEY);
+  SI hor_sep   = env->get_length (PAR_HOR_SEP_KEY);
+  SI ver_sep   = env->get_length (PAR_VER_SEP_KEY);
   SI height    = env->as_length (string ("1fn"))+ sep;
   SI bot       = 0;
   SI top       = env->fn->yx;
@@ -51,23 +51,23 @@ cell_rep::typeset (tree fm, tree t, path iq) {
       b= empty_box (iq);
 
       tree len = env->as_tmlen ("1par");
-      tree old1= env->local_begin (PAGE_MEDIUM, "papyrus");
-      tree old2= env->local_begin (PAR_LEFT, "0tmpt");
-      tree old3= env->local_begin (PAR_RIGHT, "0tmpt");
-      tree old4= env->local_begin (PAR_MODE, "justify");
-      tree old5= env->local_begin (PAR_NO_FIRST, "true");
+      tree old1= env->local_begin (PAGE_MEDIUM_KEY, "papyrus");
+      tree old2= env->local_begin (PAR_LEFT_KEY, "0tmpt");
+      tree old3= env->local_begin (PAR_RIGHT_KEY, "0tmpt");
+      tree old4= env->local_begin (PAR_MODE_KEY, "justify");
+      tree old5= env->local_begin (PAR_NO_FIRST_KEY, "true");
       //tree old6= env->local_begin (PAR_COLUMNS, "1");
-      tree old7= env->local_begin (PAR_WIDTH, len);
+      tree old7= env->local_begin (PAR_WIDTH_KEY, len);
 
       lz= make_lazy (env, t, iq);
       
-      env->local_end (PAR_WIDTH, old7);
+      env->local_end (PAR_WIDTH_KEY, old7);
       //env->local_end (PAR_COLUMNS, old6);
-      env->local_end (PAR_NO_FIRST, old5);
-      env->local_end (PAR_MODE, old4);
-      env->local_end (PAR_RIGHT, old3);
-      env->local_end (PAR_LEFT, old2);
-      env->local_end (PAGE_MEDIUM, old1);
+      env->local_end (PAR_NO_FIRST_KEY, old5);
+      env->local_end (PAR_MODE_KEY, old4);
+      env->local_end (PAR_RIGHT_KEY, old3);
+      env->local_end (PAR_LEFT_KEY, old2);
+      env->local_end (PAGE_MEDIUM_KEY, old1);
     }
   }
   cell_local_end (fm);
@@ -165,7 +165,7 @@ cell_rep::format_cell (tree fm) {
   else decoration= "";
   if (var->contains (CELL_BACKGROUND)) {
     bg= env->exec (var[CELL_BACKGROUND]);
-    if (bg == "foreground") bg= env->get_string (COLOR);
+    if (bg == "foreground") bg= env->get_string (COLOR_KEY);
   }
   else bg= "";
   if (var->contains (CELL_WIDTH)) {
@@ -384,17 +384,17 @@ cell_rep::position_vertically (SI offset, SI mh, SI bh, SI th) {
 void
 cell_rep::swell_padding () {
   if (row_span > 1) return;
-  SI swt= env->get_length (MATH_TOP_SWELL_START);
-  SI swb= env->get_length (MATH_BOT_SWELL_START);
+  SI swt= env->get_length (MATH_TOP_SWELL_START_KEY);
+  SI swb= env->get_length (MATH_BOT_SWELL_START_KEY);
   if (b->y2 > swt && (border_flags & 1) == 0) {
-    SI swT= env->get_length (MATH_TOP_SWELL_END);
+    SI swT= env->get_length (MATH_TOP_SWELL_END_KEY);
     double exceed= b->y2 - swt;
     double unit  = max (swT - swt, 1);
     double ratio = min (exceed / unit, 1.0);
     tsep += (SI) (ratio * swell);
   }
   if (b->y1 < swb && (border_flags & 2) == 0) {
-    SI swB= env->get_length (MATH_BOT_SWELL_END);
+    SI swB= env->get_length (MATH_BOT_SWELL_END_KEY);
     double exceed= swb - b->y1;
     double unit  = max (swb - swB, 1);
     double ratio = min (exceed / unit, 1.0);
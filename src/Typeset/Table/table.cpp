@@ -70,7 +70,7 @@ table_rep::display (bool flag) {
 void
 table_rep::typeset (tree t, path iq) {
   ip= iq;
-  tree old_format= env->local_begin (CELL_FORMAT, tree (TFORMAT));
+  tree old_format= env->local_begin (CELL_FORMAT_KEY, tree (TFORMAT));
   tree new_format= old_format;
   if (!is_func (new_format, TFORMAT)) new_format= tree (TFORMAT);
   while (is_func (t, TFORMAT)) {
@@ -80,7 +80,7 @@ table_rep::typeset (tree t, path iq) {
   }
   format_table (new_format);
   typeset_table (new_format, t, iq);
-  env->local_end (CELL_FORMAT, old_format);
+  env->local_end (CELL_FORMAT_KEY, old_format);
 }
 
 void
@@ -93,9 +93,9 @@ table_rep::typeset_table (tree fm, tree t, path ip) {
   STACK_NEW_ARRAY (subformat, tree, nr_rows);
   extract_format (fm, subformat, nr_rows);
   for (i=0; i<nr_rows; i++) {
-    tree old= env->local_begin (CELL_ROW_NR, as_string (i));
+    tree old= env->local_begin (CELL_ROW_NR_KEY, as_string (i));
     typeset_row (i, subformat[i], t[i], descend (ip, i));
-    env->local_end (CELL_ROW_NR, old);
+    env->local_end (CELL_ROW_NR_KEY, old);
   }
   STACK_DELETE_ARRAY (subformat);
   mw= tm_new_array<SI> (nr_cols);
@@ -116,9 +116,9 @@ table_rep::typeset_row (int i, tree fm, tree t, path ip) {
     C= cell (env);
     if (i == 0) C->border_flags += 1;
     if (i == nr_rows-1) C->border_flags += 2;
-    tree old= env->local_begin (CELL_COL_NR, as_string (j));
+    tree old= env->local_begin (CELL_COL_NR_KEY, as_string (j));
     C->typeset (subformat[j], t[j], descend (ip, j));
-    env->local_end (CELL_COL_NR, old);
+    env->local_end (CELL_COL_NR_KEY, old);
     C->row_span= min (C->row_span, nr_rows- i);
     C->col_span= min (C->col_span, nr_cols- j);
     if (hyphen == "y") C->row_span= 1;
@@ -872,13 +872,13 @@ lazy_table_rep::produce (lazy_type request, format fm) {
     T->finish_horizontal ();
     T->position_rows ();
     array<box> bs= T->var_finish ();
-    tree old1= T->env->local_begin (PAR_LEFT, "0tmpt");
-    tree old2= T->env->local_begin (PAR_RIGHT, "0tmpt");
+    tree old1= T->env->local_begin (PAR_LEFT_KEY, "0tmpt");
+    tree old2= T->env->local_begin (PAR_RIGHT_KEY, "0tmpt");
     // FIXME: check whether we should also set the other
     // paragraph formatting variables, as in cell_rep::typeset
     lazy tmp= make_lazy_paragraph (T->env, bs, ip);
-    T->env->local_end (PAR_RIGHT, old2);
-    T->env->local_end (PAR_LEFT, old1);
+    T->env->local_end (PAR_RIGHT_KEY, old2);
+    T->env->local_end (PAR_LEFT_KEY, old1);
     return tmp->produce (request, fm);
   }
   return lazy_rep::produce (request, fm);
@@ -18,6 +18,9 @@
 #include "language.hpp"
 #include "path.hpp"
 #include "hashmap.hpp"
+#include "flat_hashmap.hpp"
+#include "basic_environment.hpp"
+#include "memo_environment.hpp"
 #include "boxes.hpp"
 #include "url.hpp"
 #include "frame.hpp"
@@ -129,15 +132,15 @@ class edit_env_rep: public concrete_struct {
 public:
   drd_info&                    drd;
 private:
-  hashmap<string,tree>         env;
-  hashmap<string,tree>         back;
+  basic_environment            env;
+  basic_environment            back;
 public:
   hashmap<string,path>         src;
-  list<hashmap<string,tree> >  macro_arg;
+  list<basic_environment>      macro_arg;
   list<hashmap<string,path> >  macro_src;
   array<box>                   decorated_boxes;
 
-  hashmap<string,int>&         var_type;
+  array<int>&                  var_type;
   url                          base_file_name;
   url                          cur_file_name;
   bool                         secure;
@@ -152,8 +155,14 @@ public:
   hashmap<string,tree>         missing;     // missing refs
   array<tree>                  redefined;   // redefined labels
   hashmap<string,bool>         touched;     // touched refs
+  bool                         ref_check;   // detect refs in partial passes ?
+  path                         ref_ip;      // innermost bridge being typeset
+  hashmap<string,list<path> >  ref_readers; // bridges reading each ref
   link_repository              link_env;    // current links
   array<array<int> >           size_cache;  // math font size cache
+  int                          memo_depth;  // nesting of memorized expansions
+  bool                         memo_impure; // expansion has side effects ?
+  memo_environment             memo;        // memorized envs and expansions
 
   int          dpi;
   double       inch;
@@ -255,6 +264,8 @@ private:
   bool exec_until_with (tree t, path p, string var, int level);
   tree exec_drd_props (tree t);
   tree exec_compound (tree t);
+  tree exec_macro (tree t);
+  tree exec_memorized (tree t);
   void exec_until_compound (tree t, path p);
   bool exec_until_compound (tree t, path p, string var, int level);
   tree exec_provides (tree t);
@@ -372,6 +383,7 @@ private:
   tree exec_script (tree t);
   tree exec_find_accessible (tree t);
   tree exec_set_binding (tree t);
+  void record_reader (string key);
   tree exec_get_binding (tree t);
   tree exec_has_binding (tree t);
   tree exec_get_attachment (tree t);
@@ -448,26 +460,49 @@ public:
   tree   commit_animation (tree t);
   tree   expand_morph (tree t);
 
+  inline void backup (int key) {
+    if (!back->contains (key)) back->write (key, env->read (key)); }
+  inline void monitored_write (int key, tree t) {
+    backup (key); env->write (key, t); }
   inline void monitored_write (string s, tree t) {
-    back->write_back (s, env); env (s)= t; }
+    monitored_write (make_env_key (s), t); }
+  inline void monitored_write_update (int key, tree t) {
+    monitored_write (key, t); update (key); }
   inline void monitored_write_update (string s, tree t) {
-    back->write_back (s, env); env (s)= t; update (s); }
-  inline void write (string s, tree t) { env (s)= t; }
-  inline void write_update (string s, tree t) { env (s)= t; update (s); }
+    monitored_write_update (make_env_key (s), t); }
+  inline void write (int key, tree t) { env->write (key, t); }
+  inline void write (string s, tree t) { env->write (s, t); }
+  inline void write_update (int key, tree t) {
+    env->write (key, t); update (key); }
+  inline void write_update (string s, tree t) {
+    write_update (make_env_key (s), t); }
+  inline tree local_begin (int key, tree t) {
+    // tree r (env [key]); monitored_write_update (key, t); return r;
+    tree r= env->read (key); env->write (key, t); update (key); return r; }
   inline tree local_begin (string s, tree t) {
-    // tree r (env [s]); monitored_write_update (s, t); return r;
-    tree& val= env (s); tree r (val); val= t; update (s); return r; }
+    return local_begin (make_env_key (s), t); }
+  inline void local_end (int key, tree t) {
+     env->write (key, t); update (key); }
   inline void local_end (string s, tree t) {
-     env (s)= t; update (s); }
+     local_end (make_env_key (s), t); }
   inline tree local_begin_script () {
-    return local_begin (MATH_LEVEL, as_string (index_level+1)); }
+    return local_begin (MATH_LEVEL_KEY, as_string (index_level+1)); }
   inline void local_end_script (tree t) {
-    local_end (MATH_LEVEL, t); }
-  inline void assign (string s, tree t) {
-    tree& val= env (s); t= exec(t); if (val != t) {
-      back->write_back (s, env); val= t; update (s); } }
+    local_end (MATH_LEVEL_KEY, t); }
+  inline void assign (int key, tree t) {
+    t= exec(t); if (env->read (key) != t) {
+      backup (key); env->write (key, t); update (key); } }
+  inline void assign (string s, tree t) { assign (make_env_key (s), t); }
+  inline bool provides (int key) { return env->contains (key); }
   inline bool provides (string s) { return env->contains (s); }
-  inline tree read (string s) { return env [s]; }
+  inline tree read (int key) { return env->read (key); }
+  inline DI   memo_stamp () { return env->stamp; }
+  inline int  memo_slot (bool& found) {
+    int i= memo->find (env); found= (i >= 0);
+    return found? i: memo->enter (env); }
+  inline bool memo_unchanged (int i, DI old_stamp) {
+    return env->stamp == old_stamp || memo->matches (i, env); }
+  inline tree read (string s) { return env->read (s); }
   tree local_begin_extents (box b);
   void local_end_extents (tree t);
 
@@ -476,9 +511,9 @@ public:
   void monitored_patch_env (hashmap<string,tree> patch);
   void patch_env (hashmap<string,tree> patch);
   void read_env (hashmap<string,tree>& ret);
-  void local_start (hashmap<string,tree>& prev_back);
+  void local_start (basic_environment& prev_back);
   void local_update (hashmap<string,tree>& oldpat, hashmap<string,tree>& chg);
-  void local_end (hashmap<string,tree>& prev_back);
+  void local_end (basic_environment& prev_back);
 
   /* updating environment variables */
   ornament_parameters get_ornament_parameters ();
@@ -507,7 +542,10 @@ public:
   void   update_dash_style_unit ();
   void   update_line_arrows ();
   void   update ();
-  void   update (string env_var);
+  void   update (int key);
+  inline int get_var_type (int key) {
+    return key >= 0 && key < N(var_type)? var_type[key]: Env_User; }
+  inline void update (string env_var) { update (find_env_key (env_var)); }
 
   /* lengths */
   bool      is_length (string s);
@@ -538,32 +576,45 @@ public:
   point     as_point (tree t);
 
   /* retrieving environment variables */
-  inline bool get_bool (string var) {
+  inline bool get_bool (int var) {
     tree t= env [var];
     if (is_compound (t)) return false;
     return as_bool (t->label); }
-  inline int get_int (string var) {
+  inline int get_int (int var) {
     tree t= env [var];
     if (is_compound (t)) return 0;
     return as_int (t->label); }
-  inline double get_double (string var) {
+  inline double get_double (int var) {
     tree t= env [var];
     if (is_compound (t)) return 0.0;
     return as_double (t->label); }
-  inline string get_string (string var) {
+  inline string get_string (int var) {
     tree t= env [var];
     if (is_compound (t)) return "";
     return t->label; }
-  inline SI get_length (string var) {
+  inline SI get_length (int var) {
     tree t= env [var];
     return as_length (t); }
-  inline space get_vspace (string var) {
+  inline space get_vspace (int var) {
     tree t= env [var];
     return as_vspace (t); }
-  inline color get_color (string var) {
+  inline color get_color (int var) {
     tree t= env [var];
     return named_color (as_string (t), alpha); }
 
+  inline bool get_bool (string var) { return get_bool (find_env_key (var)); }
+  inline int get_int (string var) { return get_int (find_env_key (var)); }
+  inline double get_double (string var) {
+    return get_double (find_env_key (var)); }
+  inline string get_string (string var) {
+    return get_string (find_env_key (var)); }
+  inline SI get_length (string var) {
+    return get_length (find_env_key (var)); }
+  inline space get_vspace (string var) {
+    return get_vspace (find_env_key (var)); }
+  inline color get_color (string var) {
+    return get_color (find_env_key (var)); }
+
   friend class edit_env;
   friend tm_ostream& operator << (tm_ostream& out, edit_env env);
 };
@@ -585,6 +636,8 @@ CONCRETE_NULL_CODE(edit_env);
 
 tm_ostream& operator << (tm_ostream& out, edit_env env);
 tree texmacs_exec (edit_env env, tree cmd);
+bool is_memo_closed (tree t);
+bool is_memo_barrier (tree_label l);
 tree load_inclusion (url u); // implemented in tm_file.cpp
 tree tree_extents (tree t);
 bool is_percentage (tree t, string s);
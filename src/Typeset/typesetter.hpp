@@ -16,6 +16,8 @@
 #include "env.hpp"
 #include "array.hpp"
 
+#define ALL_PAGES 1000000
+
 class typesetter_rep;
 typedef typesetter_rep* typesetter;
 
@@ -40,7 +42,8 @@ box        typeset_as_stack (edit_env env, tree t, path ip);
 box        typeset_as_table (edit_env env, tree t, path ip);
 array<box> typeset_as_var_table (edit_env env, tree t, path ip);
 box        typeset_as_paragraph (edit_env e, tree t, path ip);
-box        typeset_as_document (edit_env e, tree t, path ip);
+box        typeset_as_document (edit_env e, tree t, path ip, int pages= -1);
+int        page_limit_for (int last, int nr_pages= -1);
 tree       box_info (edit_env env, tree t, string what);
 
 #endif // defined TYPESETTER_H
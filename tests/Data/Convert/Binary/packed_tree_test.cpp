@@ -0,0 +1,139 @@
+/******************************************************************************
+* MODULE     : packed_tree_test.cpp
+* DESCRIPTION: test on the binary representation of trees
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "Binary/packed_tree.hpp"
+#include "convert.hpp"
+#include "tm_timer.hpp"
+
+static tree
+node (string name, tree t1, tree t2) {
+  return tree (make_tree_label (name), t1, t2);
+}
+
+TEST (packed_tree, round_trip) {
+  tree t= node ("packed-pair", "", node ("packed-with", "color", "red"));
+  EXPECT_EQ (unpack_tree (pack_tree (t)) == t, true);
+  EXPECT_EQ (unpack_tree (pack_tree ("hello")) == "hello", true);
+  tree e (make_tree_label ("packed-empty"));
+  EXPECT_EQ (unpack_tree (pack_tree (e)) == e, true);
+}
+
+TEST (packed_tree, sharing) {
+  tree u= node ("packed-pair", "some text", node ("packed-em", "x", "y"));
+  tree t= tree (make_tree_label ("packed-document"), u, u, u, u);
+  string s= pack_tree (t);
+  EXPECT_EQ (N(s) < N(pack_tree (node ("packed-document", u, u))) + 16, true);
+  packed_tree p (s);
+  EXPECT_EQ (p->ok (), true);
+  EXPECT_EQ (p->arity (p->root ()), 4);
+  EXPECT_EQ (p->child (p->root (), 0) == p->child (p->root (), 3), true);
+  tree r= p->get (p->root ());
+  EXPECT_EQ (r == t, true);
+  EXPECT_EQ (strong_equal (r[0], r[3]), true);
+  EXPECT_EQ (strong_equal (p->get (p->child (p->root (), 1)), r[1]), true);
+}
+
+TEST (packed_tree, lazy) {
+  tree t= node ("packed-pair", "version",
+                node ("packed-collection",
+                      node ("packed-associate", "font", "roman"),
+                      node ("packed-associate", "par-sep", "0.2fn")));
+  packed_tree p (pack_tree (t));
+  int c= p->child (p->root (), 1);
+  EXPECT_EQ (p->is_atomic (c), false);
+  EXPECT_EQ (p->label (c) == "packed-collection", true);
+  int a= p->child (c, 1);
+  EXPECT_EQ (p->label (p->child (a, 0)) == "par-sep", true);
+  EXPECT_EQ (p->get (p->child (a, 1)) == "0.2fn", true);
+}
+
+TEST (packed_tree, corrupted) {
+  string s= pack_tree (node ("packed-pair", "a", "b"));
+  EXPECT_EQ (packed_tree (s)->ok (), true);
+  string c= copy (s);
+  c[N(c) - 1]= 'z';
+  EXPECT_EQ (packed_tree (c)->ok (), false);
+  EXPECT_EQ (packed_tree (s (0, N(s) - 4))->ok (), false);
+  EXPECT_EQ (packed_tree (string ("(tuple \"a\" \"b\")"))->ok (), false);
+  EXPECT_EQ (unpack_tree ("") == tree (UNINIT), true);
+}
+
+static string
+reseal (string s) {
+  // recompute the checksum, so that only the structure is inconsistent
+  int* w= (int*) &(s[0]);
+  unsigned int h= 2166136261u;
+  for (int i=0; i<w[3]; i++)
+    h= (h ^ ((unsigned int) w[4+i])) * 16777619u;
+  w[2]= (int) h;
+  return s;
+}
+
+TEST (packed_tree, bounds) {
+  string s= pack_tree (node ("packed-pair", "a", node ("packed-em", "b", "c")));
+  packed_tree p (s);
+  const int* w= (const int*) p->data;
+  int pool= (int) (((const int*) p->str_pool) - w);
+  // every word of the structure is replaced by out of range values
+  for (int i=4; i<pool; i++) {
+    int vals[3]= { -1, 1 << 20, w[i] + (N(s) >> 2) };
+    for (int k=0; k<3; k++) {
+      string c= copy (s);
+      ((int*) &(c[0])) [i]= vals[k];
+      packed_tree q (reseal (c));
+      if (q->ok ()) {
+        EXPECT_EQ (is_atomic (q->get (q->root ())), false);
+      }
+    }
+  }
+  // a node which refers to itself is rejected
+  int r= p->root ();
+  int pos= (int) (p->words - w) + p->node_offs[r] + 2;
+  string c= copy (s);
+  ((int*) &(c[0])) [pos]= r;
+  EXPECT_EQ (packed_tree (reseal (c))->ok (), false);
+}
+
+/******************************************************************************
+* Startup benchmark
+******************************************************************************/
+
+static tree
+style_like_environment (int n) {
+  // many macros which share common pieces, as in the standard styles
+  tree body= node ("packed-with", "font-series", node ("packed-arg", "body", ""));
+  tree c (make_tree_label ("packed-collection"));
+  for (int i=0; i<n; i++) {
+    tree m (make_tree_label ("packed-macro"), "body",
+            node ("packed-concat", "item-" * as_string (i), copy (body)));
+    c << node ("packed-associate", "macro-" * as_string (i), m);
+    c << node ("packed-associate", "var-" * as_string (i), as_string (i % 17));
+  }
+  tree drd (make_tree_label ("packed-drd"));
+  return tree (make_tree_label ("packed-tuple"), "version", c, drd);
+}
+
+TEST (packed_tree, startup) {
+  tree t= style_like_environment (5000);
+  string scm= tree_to_scheme (t);
+  string bin= pack_tree (t);
+  time_t t0= texmacs_time ();
+  tree r1= scheme_to_tree (scm);
+  time_t t1= texmacs_time ();
+  tree r2= unpack_tree (bin);
+  time_t t2= texmacs_time ();
+  cout << "Scheme cache : " << N(scm) << " bytes, "
+       << (t1 - t0) << " ms\n";
+  cout << "Packed cache : " << N(bin) << " bytes, "
+       << (t2 - t1) << " ms\n";
+  EXPECT_EQ (r1 == t, true);
+  EXPECT_EQ (r2 == t, true);
+}
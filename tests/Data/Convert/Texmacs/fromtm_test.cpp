@@ -0,0 +1,92 @@
+/******************************************************************************
+* MODULE     : fromtm_test.cpp
+* DESCRIPTION: tests and benchmark for reading the TeXmacs file format
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "convert.hpp"
+#include "file.hpp"
+#include "tm_timer.hpp"
+
+static string
+test_document (int nr) {
+  string s= "<TeXmacs|" * string (TEXMACS_VERSION) * ">\n\n<style|source>\n\n";
+  s << "<\\body>\n";
+  for (int i=0; i<nr; i++) {
+    s << "  <section|Section " << as_string (i) << ">\n\n";
+    s << "  Some <em|emphasized> text, with x\\<less\\>y and <math|a+b>, a\n";
+    s << "  long line which is continued \\\n  on the next line.\n\n";
+    s << "  <\\equation>\n    <frac|1|" << as_string (i) << ">\n";
+    s << "  </equation>\n\n";
+  }
+  s << "</body>\n\n<initial|<\\collection>\n";
+  s << "<associate|page-medium|paper>\n</collection>>";
+  return s;
+}
+
+static tree
+doc (tree t) {
+  return tree (DOCUMENT, t);
+}
+
+TEST (fromtm, text_and_tags) {
+  tree t= texmacs_to_tree ("a <em|b> c");
+  EXPECT_EQ (t == doc (tree (CONCAT, "a ", compound ("em", "b"), " c")), true);
+  EXPECT_EQ (texmacs_to_tree ("x\\<less\\>y") == doc ("x<less>y"), true);
+  EXPECT_EQ (texmacs_to_tree ("ab\\\n   cd ef") == doc ("abcd ef"), true);
+  t= texmacs_to_tree ("<frac|1|2>");
+  EXPECT_EQ (t == doc (compound ("frac", "1", "2")), true);
+  t= texmacs_to_tree ("<#48656C6C6F>");
+  EXPECT_EQ (t == doc (tree (RAW_DATA, "Hello")), true);
+}
+
+TEST (fromtm, blocks) {
+  tree t= texmacs_to_tree ("<\\body>\n  first <em|x>\n\n  second\n</body>");
+  tree d (DOCUMENT, tree (CONCAT, "first ", compound ("em", "x")), "second");
+  EXPECT_EQ (t == doc (compound ("body", d)), true);
+  t= texmacs_to_tree ("<\\session|scheme>\n  a\n<|session>\n  b\n</session>");
+  tree s= compound ("session", "scheme", doc ("a"), doc ("b"));
+  EXPECT_EQ (t == doc (s), true);
+}
+
+TEST (fromtm, documents) {
+  string s= test_document (3);
+  tree d= texmacs_document_to_tree (s);
+  tree body= extract (d, "body");
+  ASSERT_EQ (N(body), 9);
+  EXPECT_EQ (body[0] == compound ("section", "Section 0"), true);
+  EXPECT_EQ (body[1][2] == " text, with x<less>y and ", true);
+  string line= ", a long line which is continued on the next line.";
+  EXPECT_EQ (body[1][4] == line, true);
+  tree eq= compound ("equation", doc (compound ("frac", "1", "0")));
+  EXPECT_EQ (body[2] == eq, true);
+  EXPECT_EQ (extract (d, "style") == tree (TUPLE, "source"), true);
+  url u= url_temp (".tm");
+  ASSERT_EQ (save_string (u, s, false), false);
+  EXPECT_EQ (load_texmacs_document (u) == d, true);
+  remove (u);
+  EXPECT_EQ (is_func (texmacs_document_to_tree ("<html>"), ERROR), true);
+}
+
+TEST (fromtm, benchmark) {
+  string s= test_document (10000);
+  url u= url_temp (".tm");
+  ASSERT_EQ (save_string (u, s, false), false);
+  time_t t0= texmacs_time ();
+  tree d1= texmacs_document_to_tree (s);
+  time_t t1= texmacs_time ();
+  tree d2= load_texmacs_document (u);
+  time_t t2= texmacs_time ();
+  remove (u);
+  cout << "Parse " << N(s) / 1024 << " kb from a string : "
+       << (t1 - t0) << " ms\n";
+  cout << "Parse " << N(s) / 1024 << " kb from a mapped file : "
+       << (t2 - t1) << " ms\n";
+  EXPECT_EQ (N(extract (d1, "body")), 30000);
+  EXPECT_EQ (d1 == d2, true);
+}
@@ -0,0 +1,44 @@
+/******************************************************************************
+* MODULE     : totm_test.cpp
+* DESCRIPTION: tests on writing the TeXmacs and scheme file formats
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "convert.hpp"
+
+static tree
+test_document (int nr) {
+  tree body (DOCUMENT);
+  for (int i=0; i<nr; i++) {
+    body << compound ("section", "Section " * as_string (i));
+    body << tree (CONCAT, "Some ", compound ("em", "emphasized"),
+                  " text, with x<less>y and \"quotes\"");
+    body << compound ("equation", compound ("frac", "1", as_string (i)));
+  }
+  tree doc (DOCUMENT);
+  doc << compound ("TeXmacs", "1.99.13");
+  doc << compound ("style", "source");
+  doc << compound ("body", body);
+  return doc;
+}
+
+static string
+streamed (tree t, bool scheme) {
+  tm_ostream out;
+  out.buffer ();
+  if (scheme) tree_to_scheme (t, out);
+  else tree_to_texmacs (t, out);
+  return out.unbuffer ();
+}
+
+TEST (totm, streamed) {
+  // large enough for the output to be flushed several times
+  tree t= test_document (2000);
+  EXPECT_EQ (streamed (t, false) == tree_to_texmacs (t), true);
+  EXPECT_EQ (streamed (t, true) == tree_to_scheme (t), true);
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+* MODULE     : upgradetm_test.cpp
+* DESCRIPTION: tests on upgrading documents written by older versions
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "convert.hpp"
+#include "tm_timer.hpp"
+
+tree upgrade (tree t, string version);
+
+static tree
+old_document (tree body) {
+  tree doc (DOCUMENT);
+  doc << compound ("TeXmacs", "1.99.5");
+  doc << compound ("style", "source");
+  doc << compound ("body", body);
+  return doc;
+}
+
+static tree
+paragraph (int i) {
+  return tree (CONCAT, "Paragraph " * as_string (i) * " with ",
+               compound ("em", "emphasis"), " and ",
+               compound ("strong", as_string (i)));
+}
+
+TEST (upgradetm, fused_passes) {
+  tree body (DOCUMENT);
+  body << compound ("swell", compound ("solution", tree (VALUE, "qed")));
+  body << compound ("tmdoc-copyright", "1998--2002", "Joris van der Hoeven");
+  body << compound ("html-div", "a", compound ("swell-top", "b"));
+  tree u= extract (upgrade (old_document (body), "1.99.5"), "body");
+  ASSERT_EQ (N(u), 3);
+  tree r= compound ("inflate", compound ("solution*", compound ("qed")));
+  EXPECT_EQ (u[0] == r, true);
+  r= compound ("tmdoc-copyright", "1998\0252002", "Joris van der Hoeven");
+  EXPECT_EQ (u[1] == r, true);
+  r= compound ("html-div-class", "a", compound ("inflate-top", "b"));
+  EXPECT_EQ (u[2] == r, true);
+}
+
+TEST (upgradetm, sharing) {
+  tree body (DOCUMENT);
+  for (int i=0; i<10; i++) body << paragraph (i);
+  body << compound ("swell", "x");
+  tree doc= old_document (body);
+  tree old= copy (doc);
+  tree u= extract (upgrade (doc, "1.99.5"), "body");
+  // the original document is left unchanged and untouched paragraphs
+  // are shared between both versions
+  EXPECT_EQ (doc == old, true);
+  ASSERT_EQ (N(u), 11);
+  for (int i=0; i<10; i++)
+    EXPECT_EQ (strong_equal (u[i], body[i]), true);
+  EXPECT_EQ (u[10] == compound ("inflate", "x"), true);
+}
+
+TEST (upgradetm, benchmark) {
+  tree body (DOCUMENT);
+  for (int i=0; i<20000; i++) {
+    body << paragraph (i);
+    body << compound ("equation", compound ("frac", "1", as_string (i)));
+  }
+  tree doc= old_document (body);
+  time_t t0= texmacs_time ();
+  tree u= upgrade (doc, "1.0.7.20");
+  time_t t1= texmacs_time ();
+  cout << "Upgrade " << N(body) << " paragraphs from 1.0.7.20 : "
+       << (t1 - t0) << " ms\n";
+  EXPECT_EQ (N(extract (u, "body")), 40000);
+}
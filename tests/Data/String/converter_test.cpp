@@ -11,9 +11,28 @@
 #include "gtest/gtest.h"
 
 #include "converter.hpp"
+#include "tm_timer.hpp"
 
 TEST (string, utf8_to_cork) {
   ASSERT_STREQ (as_charp (utf8_to_cork ("中")), "<#4E2D>");
   ASSERT_STREQ (as_charp (utf8_to_cork ("“")), "\x10");
   ASSERT_STREQ (as_charp (utf8_to_cork("”")), "\x11");
-}
\ No newline at end of file
+}
+
+/******************************************************************************
+* Throughput of the compiled dictionaries
+******************************************************************************/
+TEST (string, converter_benchmark) {
+  const char* pieces[8]= { "TeXmacs ", "中", "“", "”", "é", "→", "ℝ", "α" };
+  string s;
+  for (int i=0; i<200000; i++) s << string (pieces[(i * 7) % 8]);
+  time_t t0= texmacs_time ();
+  string c= utf8_to_cork (s);
+  string u= cork_to_utf8 (c);
+  time_t t1= texmacs_time ();
+  ASSERT_TRUE (u == s);
+  double ms= (double) max ((int) (t1 - t0), 1);
+  cout << "Round trip of " << N(s) << " bytes through Cork : "
+       << (t1 - t0) << " ms, " << (int) ((2000.0 * N(s)) / (1048576.0 * ms))
+       << " MB/s\n";
+}
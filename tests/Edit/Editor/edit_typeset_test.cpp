@@ -0,0 +1,82 @@
+/******************************************************************************
+* MODULE     : edit_typeset_test.cpp
+* DESCRIPTION: test on the retypesetting of references
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "edit_typeset.hpp"
+
+static hashmap<string,list<path> >
+no_readers () {
+  return hashmap<string,list<path> > (list<path> ());
+}
+
+static void
+add_reader (hashmap<string,list<path> >& readers, string key, path p) {
+  readers (key)= list<path> (reverse (p), readers[key]);
+}
+
+static bool
+contains (array<path> ps, path p) {
+  for (int i=0; i<N(ps); i++)
+    if (ps[i] == p) return true;
+  return false;
+}
+
+TEST (edit_typeset, retypeset_readers) {
+  // only the bridges which read a changed reference are retypeset
+  path rp (5);
+  hashmap<string,list<path> > readers= no_readers ();
+  add_reader (readers, "eq", rp * path (0, 2));
+  add_reader (readers, "eq", rp * 3);
+  add_reader (readers, "sec", rp * 7);
+  add_reader (readers, "fig", rp * path (0, 2));
+  hashmap<string,tree> missing (UNINIT);
+  missing ("fig")= tree (GET_BINDING, "fig");
+  array<tree> redefined;
+  redefined << tree (TUPLE, "eq", "2");
+  array<path> ps;
+  EXPECT_EQ (ref_readers_of (missing, redefined, readers, rp, ps), true);
+  EXPECT_EQ (N(ps), 2);
+  EXPECT_EQ (contains (ps, rp * path (0, 2)), true);
+  EXPECT_EQ (contains (ps, rp * 3), true);
+  EXPECT_EQ (contains (ps, rp * 7), false);
+
+  // nothing changed: nothing to retypeset
+  EXPECT_EQ (ref_readers_of (hashmap<string,tree> (UNINIT), array<tree> (),
+                             readers, rp, ps), true);
+  EXPECT_EQ (N(ps), 0);
+
+  // changed references which nobody read
+  missing ("unused")= tree (GET_BINDING, "unused");
+  EXPECT_EQ (ref_readers_of (missing, array<tree> (), readers, rp, ps), true);
+  EXPECT_EQ (N(ps), 1);
+  EXPECT_EQ (ps[0] == rp * path (0, 2), true);
+}
+
+TEST (edit_typeset, retypeset_all) {
+  // fall back to a full retypeset when a reader cannot be located
+  path rp (5);
+  array<tree> redefined;
+  redefined << tree (TUPLE, "eq", "");
+  hashmap<string,tree> missing (UNINIT);
+  array<path> ps;
+
+  hashmap<string,list<path> > decorated= no_readers ();
+  add_reader (decorated, "eq", rp * 3);
+  add_reader (decorated, "eq", rp * path (4, -1));
+  EXPECT_EQ (ref_readers_of (missing, redefined, decorated, rp, ps), false);
+
+  hashmap<string,list<path> > outside= no_readers ();
+  add_reader (outside, "eq", path (6, 1));
+  EXPECT_EQ (ref_readers_of (missing, redefined, outside, rp, ps), false);
+
+  hashmap<string,list<path> > root= no_readers ();
+  add_reader (root, "eq", rp);
+  EXPECT_EQ (ref_readers_of (missing, redefined, root, rp, ps), false);
+}
@@ -0,0 +1,167 @@
+/******************************************************************************
+* MODULE     : glyph_test.cpp
+* DESCRIPTION: tests on the word by word operations on glyphs
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "bitmap_font.hpp"
+#include "renderer.hpp"
+
+int pixel_count (glyph g);
+int get_hor_shift (glyph gl, int xfactor, int tx);
+
+static glyph
+ring_glyph (int w, int h, int xoff, int yoff) {
+  // rows wider than one word, with pixels on both sides of word boundaries
+  glyph gl (w, h, xoff, yoff, 1);
+  for (int j=0; j<h; j++)
+    for (int i=0; i<w; i++) {
+      int d= (2*i-w) * (2*i-w) * h * h + (2*j-h) * (2*j-h) * w * w;
+      gl->set_x (i, j, (d < w * w * h * h && 4 * d > w * w * h * h)? 1: 0);
+    }
+  return gl;
+}
+
+static glyph
+stem_glyph (int w, int h, int x1, int x2, int xoff) {
+  // two vertical strokes of width 3 joined by a horizontal bar
+  glyph gl (w, h, xoff, h, 1);
+  for (int j=0; j<h; j++)
+    for (int i=0; i<w; i++) {
+      bool stem= (i >= x1 && i < x1 + 3) || (i >= x2 && i < x2 + 3);
+      gl->set_x (i, j, (stem || j == h/2)? 1: 0);
+    }
+  return gl;
+}
+
+static int
+total_value (glyph gl) {
+  int total= 0;
+  for (int j=0; j<gl->height; j++)
+    for (int i=0; i<gl->width; i++)
+      total += gl->get_x (i, j);
+  return total;
+}
+
+static bool
+same_pixels (glyph g1, glyph g2) {
+  if (g1->width != g2->width || g1->height != g2->height) return false;
+  if (g1->xoff != g2->xoff || g1->yoff != g2->yoff) return false;
+  for (int j=0; j<g1->height; j++)
+    for (int i=0; i<g1->width; i++)
+      if (g1->get_x (i, j) != g2->get_x (i, j)) return false;
+  return true;
+}
+
+TEST (glyph, rows_and_columns) {
+  glyph gl= ring_glyph (150, 40, 75, 30);
+  for (int j=0; j<40; j++) {
+    int first= 150, last= -1;
+    for (int i=0; i<150; i++)
+      if (gl->get_x (i, j) != 0) {
+        first= min (first, i);
+        last = max (last, i);
+      }
+    EXPECT_EQ (first_in_row (gl, j), first);
+    EXPECT_EQ (last_in_row (gl, j), last);
+    EXPECT_EQ (empty_row (gl, j), last < 0);
+  }
+  for (int i=0; i<150; i++) {
+    int first= 40;
+    for (int j=39; j>=0; j--)
+      if (gl->get_x (i, j) != 0) first= j;
+    EXPECT_EQ (first_in_column (gl, i), first);
+  }
+  EXPECT_EQ (empty_column (gl, 150), true);
+}
+
+TEST (glyph, combinations) {
+  glyph g1= ring_glyph (130, 30, 60, 25);
+  glyph g2= ring_glyph (70, 50, 10, 40);
+  glyph j= join (g1, g2), i= intersect (g1, g2), e= exclude (g1, g2);
+  EXPECT_EQ (pixel_count (i) + pixel_count (e), pixel_count (g1));
+  EXPECT_EQ (pixel_count (j) + pixel_count (i),
+             pixel_count (g1) + pixel_count (g2));
+  EXPECT_EQ (same_pixels (copy (g1), g1), true);
+  EXPECT_EQ (same_pixels (ver_flip (ver_flip (g1)), g1), true);
+  glyph s= simplify (padded (g1, 70, 3, 65, 2));
+  EXPECT_EQ (same_pixels (s, simplify (g1)), true);
+}
+
+TEST (glyph, collision_offset) {
+  // golden values of the pixel by pixel implementation
+  glyph g1= ring_glyph (130, 30, 60, 25);
+  glyph g2= ring_glyph (70, 50, 10, 40);
+  EXPECT_EQ (collision_offset (g1, g2, false), 19968);
+  EXPECT_EQ (collision_offset (g1, g2, true), 2816);
+  EXPECT_EQ (collision_offset (g2, g1, false), 30208);
+  EXPECT_EQ (collision_offset (g2, g1, true), 7424);
+}
+
+TEST (glyph, get_hor_shift) {
+  glyph two= stem_glyph (90, 40, 10, 75, 5);
+  glyph one= stem_glyph (20, 40, 7, 7, 3);
+  glyph ring= ring_glyph (40, 40, 0, 40);
+  EXPECT_EQ (get_hor_shift (two, 2, 2), 1);
+  EXPECT_EQ (get_hor_shift (two, 5, 2), 0);
+  EXPECT_EQ (get_hor_shift (two, 8, 2), 3);
+  EXPECT_EQ (get_hor_shift (one, 2, 2), 0);
+  EXPECT_EQ (get_hor_shift (one, 5, 2), 1);
+  EXPECT_EQ (get_hor_shift (one, 8, 2), 4);
+  EXPECT_EQ (get_hor_shift (ring, 2, 2), 1);
+  EXPECT_EQ (get_hor_shift (ring, 5, 2), 3);
+  EXPECT_EQ (get_hor_shift (ring, 8, 2), 6);
+}
+
+TEST (glyph, shrink) {
+  glyph gl= ring_glyph (100, 100, 50, 80);
+  SI xo, yo;
+  glyph sh= shrink (gl, 4, 4, xo, yo);
+  // the pixels are thickened before shrinking
+  EXPECT_GE (total_value (sh), pixel_count (gl));
+  EXPECT_EQ (sh->depth, 5);
+  // golden values of the pixel by pixel implementation
+  EXPECT_EQ (sh->width, 26);
+  EXPECT_EQ (sh->height, 26);
+  EXPECT_EQ (sh->xoff, 12);
+  EXPECT_EQ (sh->yoff, 20);
+  EXPECT_EQ (xo, 3296);
+  EXPECT_EQ (yo, 5088);
+  EXPECT_EQ (total_value (sh), 6164);
+  sh= shrink (gl, 7, 7, xo, yo);
+  EXPECT_EQ (sh->depth, 7);
+  EXPECT_EQ (sh->width, 15);
+  EXPECT_EQ (sh->height, 15);
+  EXPECT_EQ (sh->xoff, 7);
+  EXPECT_EQ (sh->yoff, 11);
+  EXPECT_EQ (xo, 1901);
+  EXPECT_EQ (yo, 2779);
+  EXPECT_EQ (total_value (sh), 6460);
+}
+
+TEST (glyph, shrink_stems) {
+  glyph gl= stem_glyph (90, 40, 10, 75, 5);
+  SI xo, yo;
+  glyph sh= shrink (gl, 4, 4, xo, yo);
+  EXPECT_EQ (sh->width, 24);
+  EXPECT_EQ (sh->height, 11);
+  EXPECT_EQ (sh->xoff, 1);
+  EXPECT_EQ (sh->yoff, 10);
+  EXPECT_EQ (xo, 480);
+  EXPECT_EQ (yo, 2528);
+  EXPECT_EQ (total_value (sh), 494);
+  // the strokes are shifted so as to fall as much as possible on pixels
+  int top[24]= { 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0,
+                 0, 0, 0, 0, 0, 0, 0, 6, 2, 0, 0, 0 };
+  int bar[24]= { 4, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 8,
+                 8, 8, 8, 8, 8, 8, 8, 14, 10, 8, 8, 2 };
+  for (int i=0; i<24; i++) {
+    EXPECT_EQ (sh->get_x (i, 0), top[i]);
+    EXPECT_EQ (sh->get_x (i, 5), bar[i]);
+  }
+}
@@ -0,0 +1,202 @@
+/******************************************************************************
+* MODULE     : raster_test.cpp
+* DESCRIPTION: tests and benchmarks for operations on raster pictures
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "raster.hpp"
+#include "true_color.hpp"
+#include "packed_color.hpp"
+#include "tm_timer.hpp"
+
+static raster<true_color>
+test_picture (int w, int h) {
+  // a disk with an antialiased border on a transparent background
+  raster<true_color> r (w, h, 0, 0);
+  double R= min (w, h) / 3.0;
+  for (int y=0; y<h; y++)
+    for (int x=0; x<w; x++) {
+      double d= sqrt ((x - w/2.0) * (x - w/2.0) + (y - h/2.0) * (y - h/2.0));
+      double a= max (0.0, min (1.0, R - d));
+      r->a[y*w+x]= true_color (x / (double) w, y / (double) h, 0.5, a);
+    }
+  return r;
+}
+
+static double
+distance (raster<true_color> r1, raster<true_color> r2) {
+  if (r1->w != r2->w || r1->h != r2->h) return 1.0e10;
+  if (r1->ox != r2->ox || r1->oy != r2->oy) return 1.0e10;
+  double d= 0.0;
+  for (int i=0; i < r1->w * r1->h; i++) {
+    true_color c1= r1->a[i], c2= r2->a[i];
+    d= max (d, fabs (c1.a - c2.a));
+    if (min (c1.a, c2.a) > 0.01)
+      d= max (d, max (fabs (c1.r - c2.r),
+                      max (fabs (c1.g - c2.g), fabs (c1.b - c2.b))));
+  }
+  return d;
+}
+
+TEST (raster, fft_convolute) {
+  raster<true_color> pic= test_picture (90, 70);
+  raster<double> pen= oval_pen<double> (9.5, 5.5, 0.6);
+  pen= pen / sum (pen);
+  raster<true_color> d1= direct_convolute (pic, pen);
+  raster<true_color> d2= fft_convolute (pic, pen);
+  EXPECT_LT (distance (d1, d2), 1.0e-6);
+}
+
+TEST (raster, factored_convolute) {
+  raster<true_color> pic= test_picture (80, 60);
+  raster<double> pen= gaussian_pen<double> (3.0, 2.0, 0.0);
+  pen= pen / sum (pen);
+  ASSERT_TRUE (can_be_factored (pen));
+  raster<true_color> d1= direct_convolute (pic, pen);
+  raster<true_color> d2= factored_convolute (pic, pen);
+  EXPECT_LT (distance (d1, d2), 1.0e-6);
+}
+
+TEST (raster, box_blur) {
+  raster<true_color> pic= test_picture (120, 100);
+  raster<true_color> d1= blur (pic, gaussian_pen<double> (8.0, 6.0, 0.0));
+  raster<true_color> d2= gaussian_blur (pic, 8.0, 6.0, 0.0);
+  EXPECT_LT (distance (d1, d2), 0.03);
+}
+
+/******************************************************************************
+* Vectorized operations on rows of pixels
+******************************************************************************/
+
+static raster<true_color>
+shifted_picture (int w, int h) {
+  // an odd width exercises the scalar tails of the vectorized rows
+  raster<true_color> r= test_picture (w, h);
+  for (int i=0; i < w*h; i++) {
+    true_color& c= r->a[i];
+    c= true_color (1.0 - c.g, c.b, c.r, 1.0 - c.a);
+    if (i % 7 == 0) c.a= 0.001;
+  }
+  return r;
+}
+
+static double
+max_difference (raster<true_color> r1, raster<true_color> r2) {
+  double d= 0.0;
+  for (int i=0; i < r1->w * r1->h; i++) {
+    true_color c1= r1->a[i], c2= r2->a[i];
+    d= max (d, max (max (fabs (c1.r - c2.r), fabs (c1.g - c2.g)),
+                    max (fabs (c1.b - c2.b), fabs (c1.a - c2.a))));
+  }
+  return d;
+}
+
+template<composition_mode M> static double
+compose_difference (raster<true_color> r1, raster<true_color> r2) {
+  raster<true_color> d1= copy (r1), d2= copy (r1);
+  draw_on<M> (d1, r2, 0, 0);
+  for (int i=0; i < r1->w * r1->h; i++)
+    d2->a[i]= composition_op<M>::op (d2->a[i], r2->a[i]);
+  return max_difference (d1, d2);
+}
+
+TEST (raster, compose_rows) {
+  raster<true_color> r1= test_picture (37, 23), r2= shifted_picture (37, 23);
+  EXPECT_LT (compose_difference<compose_source_over> (r1, r2), 1.0e-12);
+  EXPECT_LT (compose_difference<compose_towards_source> (r1, r2), 1.0e-12);
+  EXPECT_LT (compose_difference<compose_alpha_distance> (r1, r2), 1.0e-12);
+  EXPECT_LT (compose_difference<compose_add> (r1, r2), 1.0e-12);
+  EXPECT_LT (compose_difference<compose_sub> (r1, r2), 1.0e-12);
+  EXPECT_LT (compose_difference<compose_min> (r1, r2), 1.0e-12);
+}
+
+TEST (raster, map_rows) {
+  raster<true_color> r= shifted_picture (37, 23);
+  raster<true_color> s= r + r;
+  raster<true_color> m1= mul_alpha (r), d1= div_alpha (r), n1= normalize (s);
+  raster<true_color> m2= copy (r), d2= copy (r), n2= copy (s);
+  for (int i=0; i < 37*23; i++) {
+    m2->a[i]= mul_alpha (r->a[i]);
+    d2->a[i]= div_alpha (r->a[i]);
+    n2->a[i]= normalize (s->a[i]);
+  }
+  EXPECT_LT (max_difference (m1, m2), 1.0e-12);
+  EXPECT_LT (max_difference (d1, d2), 1.0e-12);
+  EXPECT_LT (max_difference (n1, n2), 1.0e-12);
+}
+
+TEST (raster, packed_rows) {
+  raster<true_color> r1= test_picture (37, 23), r2= shifted_picture (37, 23);
+  raster<packed_color> p1= as_packed (r1), p2= as_packed (r2);
+  raster<packed_color> q1= as_packed (r1);
+  draw_on<compose_source_over> (p1, p2, 0, 0);
+  int err= 0;
+  for (int i=0; i < 37*23; i++) {
+    packed_color c1= source_over (q1->a[i], p2->a[i]), c2= p1->a[i];
+    err= max (err, abs (c1.r - c2.r) + abs (c1.g - c2.g) +
+                   abs (c1.b - c2.b) + abs (c1.a - c2.a));
+  }
+  EXPECT_LE (err, 1);
+  raster<true_color> d= copy (r1);
+  draw_on<compose_source_over> (d, r2, 0, 0);
+  EXPECT_LT (distance (as_true_color (p1), d), 0.02);
+}
+
+/******************************************************************************
+* Benchmark of the effects with pens
+******************************************************************************/
+
+TEST (raster, benchmark) {
+  raster<true_color> pic= test_picture (400, 400);
+  raster<double> pen= oval_pen<double> (12.5, 8.5, 0.4);
+  time_t t0= texmacs_time ();
+  raster<true_color> b= blur (pic, pen);
+  time_t t1= texmacs_time ();
+  raster<true_color> o= variation (pic, pen);
+  time_t t2= texmacs_time ();
+  raster<true_color> t= thicken (pic, pen);
+  time_t t3= texmacs_time ();
+  raster<true_color> e= erode (pic, pen);
+  time_t t4= texmacs_time ();
+  raster<true_color> g= gaussian_blur (pic, 12.0);
+  time_t t5= texmacs_time ();
+  cout << "Blur with oval pen     : " << (t1 - t0) << " ms\n";
+  cout << "Outline with oval pen  : " << (t2 - t1) << " ms\n";
+  cout << "Thicken with oval pen  : " << (t3 - t2) << " ms\n";
+  cout << "Erode with oval pen    : " << (t4 - t3) << " ms\n";
+  cout << "Gaussian blur          : " << (t5 - t4) << " ms\n";
+  int w= 400 + pen->w - 1;
+  ASSERT_TRUE (b->w == w && o->w == w && t->w == w && e->w == 400);
+}
+
+TEST (raster, compose_benchmark) {
+  raster<true_color> r1= test_picture (300, 200);
+  raster<true_color> r2= shifted_picture (300, 200);
+  raster<true_color> d1= copy (r1), d2= copy (r1);
+  raster<packed_color> p1= as_packed (r1), p2= as_packed (r2);
+  int n= 300 * 200;
+  time_t t0= texmacs_time ();
+  for (int k=0; k<100; k++)
+    for (int i=0; i<n; i++)
+      d1->a[i]= source_over (d1->a[i], r2->a[i]);
+  time_t t1= texmacs_time ();
+  for (int k=0; k<100; k++)
+    draw_on<compose_source_over> (d2, r2, 0, 0);
+  time_t t2= texmacs_time ();
+  for (int k=0; k<100; k++)
+    draw_on<compose_source_over> (p1, p2, 0, 0);
+  time_t t3= texmacs_time ();
+  for (int k=0; k<100; k++)
+    d2= div_alpha (mul_alpha (d2));
+  time_t t4= texmacs_time ();
+  cout << "Source over, scalar    : " << (t1 - t0) << " ms\n";
+  cout << "Source over, vectorized: " << (t2 - t1) << " ms\n";
+  cout << "Source over, packed    : " << (t3 - t2) << " ms\n";
+  cout << "Alpha multiplications  : " << (t4 - t3) << " ms\n";
+  ASSERT_TRUE (d2->w == 300 && p1->w == 300);
+}
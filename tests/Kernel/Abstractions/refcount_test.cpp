@@ -0,0 +1,108 @@
+/******************************************************************************
+* MODULE     : refcount_test.cpp
+* DESCRIPTION: Tests and micro benchmark for reference counting
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "tree.hpp"
+#include "hashmap.hpp"
+#include "tm_timer.hpp"
+
+/******************************************************************************
+* Immortal trees
+******************************************************************************/
+
+TEST (refcount, immortal) {
+  tree t (CONCAT, "hello", tree (WITH, "font-series", "bold", "world"));
+  EXPECT_EQ (is_immortal (t), false);
+  make_immortal (t);
+  EXPECT_EQ (is_immortal (t), true);
+  EXPECT_EQ (is_immortal (t[1][2]), true);
+  EXPECT_EQ (is_immortal (t[1][0]->label), true);
+  EXPECT_EQ (is_immortal (string ("hello")), false);
+  tree u= t[1];
+  u= tree ();
+  EXPECT_EQ (t[1][1] == "bold", true);
+  EXPECT_EQ (is_immortal (copy (t)), false);
+}
+
+TEST (refcount, immortal_shared) {
+  // each level refers twice to the previous one
+  tree t ("leaf");
+  for (int i=0; i<100; i++)
+    t= tree (TUPLE, t, t);
+  make_immortal (t);
+  tree u= t;
+  for (int i=0; i<100; i++) {
+    EXPECT_EQ (is_immortal (u), true);
+    u= u[1];
+  }
+  EXPECT_EQ (u == "leaf", true);
+}
+
+/******************************************************************************
+* Micro benchmark on the typical access patterns of the typesetter
+******************************************************************************/
+
+static tree
+make_document (int pars, int words) {
+  tree doc (DOCUMENT, pars);
+  for (int i=0; i<pars; i++) {
+    tree par (CONCAT, words);
+    for (int j=0; j<words; j++)
+      if (j % 7 == 3) par[j]= tree (WITH, "font-shape", "italic", "word");
+      else par[j]= "word";
+    doc[i]= par;
+  }
+  return doc;
+}
+
+static int
+traverse (tree t, hashmap<string,tree>& env) {
+  // copying handles and reading labels as done by the typesetter
+  if (is_atomic (t)) return N (t->label);
+  int i, n= N(t), r= 0;
+  if (is_func (t, WITH, 3)) {
+    string var= t[0]->label;
+    tree old= env[var];
+    env (var)= t[1];
+    r += traverse (t[2], env);
+    env (var)= old;
+    return r;
+  }
+  for (i=0; i<n; i++) {
+    tree c= t[i];
+    r += traverse (c, env);
+  }
+  return r;
+}
+
+TEST (refcount, benchmark) {
+  tree doc= make_document (200, 100);
+  hashmap<string,tree> env (UNINIT);
+  env ("font-shape")= "right";
+  int total= 0;
+  time_t start= texmacs_time ();
+  for (int k=0; k<20; k++)
+    total += traverse (doc, env);
+  time_t mortal= texmacs_time () - start;
+  make_immortal (doc);
+  start= texmacs_time ();
+  for (int k=0; k<20; k++)
+    total -= traverse (doc, env);
+  time_t immortal= texmacs_time () - start;
+  EXPECT_EQ (total, 0);
+#ifdef ATOMIC_REFCOUNT
+  cout << "Atomic reference counting\n";
+#else
+  cout << "Plain reference counting\n";
+#endif
+  cout << "Mortal document   : " << mortal << " ms\n";
+  cout << "Immortal document : " << immortal << " ms\n";
+}
@@ -0,0 +1,132 @@
+/******************************************************************************
+* MODULE     : flat_hashmap_test.cpp
+* DESCRIPTION: test on open addressing hashmaps
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "flat_hashmap.hpp"
+#include "iterator.hpp"
+#include "tree.hpp"
+
+/******************************************************************************
+* tests on insertion, lookup and removal
+******************************************************************************/
+TEST (flat_hashmap, insert) {
+  flat_hashmap<int,int> hm (-1);
+  for (int i=0; i<1000; i++) hm (i * 8)= i;
+  EXPECT_EQ (N(hm) == 1000, true);
+  for (int i=0; i<1000; i++)
+    EXPECT_EQ (hm[i * 8] == i, true);
+  EXPECT_EQ (hm[1] == -1, true);
+  EXPECT_EQ (hm->contains (1), false);
+}
+
+TEST (flat_hashmap, reset) {
+  flat_hashmap<int,int> hm (0);
+  for (int i=0; i<1000; i++) hm (i)= i;
+  for (int i=0; i<1000; i+=2) hm->reset (i);
+  EXPECT_EQ (N(hm) == 500, true);
+  for (int i=0; i<1000; i++)
+    EXPECT_EQ (hm->contains (i), i % 2 == 1);
+  for (int i=1; i<1000; i+=2) hm->reset (i);
+  EXPECT_EQ (hm->empty (), true);
+  hm->reset (7);
+  EXPECT_EQ (N(hm) == 0, true);
+}
+
+TEST (flat_hashmap, resize) {
+  flat_hashmap<int,int> hm (0, 10);
+  hm (1)= 10;
+  hm (2)= 20;
+  hm->resize (1);
+  EXPECT_EQ (hm[1] == 10, true);
+  EXPECT_EQ (hm[2] == 20, true);
+  hm->resize (200);
+  EXPECT_EQ (hm[1] == 10, true);
+  EXPECT_EQ (hm[2] == 20, true);
+}
+
+TEST (flat_hashmap, strings) {
+  flat_hashmap<string,tree> hm (UNINIT);
+  hm ("font")= "roman";
+  hm ("font-size")= "10";
+  hm ("font")= "sans-serif";
+  EXPECT_EQ (N(hm) == 2, true);
+  EXPECT_EQ (hm["font"] == "sans-serif", true);
+  EXPECT_EQ (hm["color"] == UNINIT, true);
+}
+
+/******************************************************************************
+* tests on iteration
+******************************************************************************/
+TEST (flat_hashmap, iterate) {
+  flat_hashmap<int,int> hm (0);
+  for (int i=0; i<100; i++) hm (i)= i;
+  int sum= 0, count= 0;
+  iterator<int> it= iterate (hm);
+  while (it->busy ()) {
+    sum += it->next ();
+    count++;
+  }
+  EXPECT_EQ (count == 100, true);
+  EXPECT_EQ (sum == 4950, true);
+}
+
+/******************************************************************************
+* tests on patching
+******************************************************************************/
+TEST (flat_hashmap, patch) {
+  flat_hashmap<int,int> hm;
+  flat_hashmap<int,int> hm_patch;
+  flat_hashmap<int,int> hm_base;
+  hm (2)= 20;
+  hm_patch (2)= -20;
+  hm_base (2)= 20;
+  hm->pre_patch (hm_patch, hm_base);
+  EXPECT_EQ (hm->contains (2), false);
+  hm_patch (3)= -30;
+  hm->post_patch (hm_patch, hm_base);
+  EXPECT_EQ (hm[2] == -20, true);
+  EXPECT_EQ (hm[3] == -30, true);
+  hm->write_back (2, hm_base);
+  EXPECT_EQ (hm[2] == -20, true);
+  hm->write_back (4, hm_base);
+  EXPECT_EQ (hm->contains (4), true);
+}
+
+TEST (flat_hashmap, changes) {
+  flat_hashmap<int,int> base_m;
+  flat_hashmap<int,int> patch_m;
+  base_m (1)= 10;
+  base_m (2)= 20;
+  patch_m (2)= -20;
+  patch_m (3)= -30;
+  flat_hashmap<int,int> res= changes (patch_m, base_m);
+  EXPECT_EQ (N(res) == 2, true);
+  EXPECT_EQ (res[2] == -20, true);
+  EXPECT_EQ (res[3] == -30, true);
+  flat_hashmap<int,int> inv= invert (patch_m, base_m);
+  EXPECT_EQ (N(inv) == 2, true);
+  EXPECT_EQ (inv[2] == 20, true);
+  EXPECT_EQ (inv[3] == 0, true);
+}
+
+/******************************************************************************
+* tests on copy, join and equality
+******************************************************************************/
+TEST (flat_hashmap, copy) {
+  flat_hashmap<int,int> hm (0);
+  for (int i=0; i<100; i++) hm (i)= i;
+  flat_hashmap<int,int> hm2= copy (hm);
+  EXPECT_EQ (hm == hm2, true);
+  hm2 (100)= 100;
+  EXPECT_EQ (hm != hm2, true);
+  EXPECT_EQ (hm->contains (100), false);
+  hm->join (hm2);
+  EXPECT_EQ (hm == hm2, true);
+}
@@ -11,6 +11,9 @@
 
 #include "gtest/gtest.h"
 #include "hashmap.hpp"
+#include "flat_hashmap.hpp"
+#include "tree.hpp"
+#include "tm_timer.hpp"
 
 /******************************************************************************
 * tests on resize
@@ -234,3 +237,55 @@ TEST (hashmap, N) {
   non_empty_hm(1) = nullptr;
   EXPECT_EQ (N(non_empty_hm) == 1, true);
 }
+
+/******************************************************************************
+* benchmarks against flat_hashmap on hashmap<string,tree> workloads
+******************************************************************************/
+static array<string>
+benchmark_keys (int n) {
+  array<string> keys (n);
+  for (int i=0; i<n; i++)
+    keys[i]= "var-" * as_string (i * 7919);
+  return keys;
+}
+
+template<class M> static time_t
+benchmark_insert (M& m, array<string> keys, int rounds) {
+  time_t start= texmacs_time ();
+  for (int r=0; r<rounds; r++) {
+    m= M (UNINIT);
+    for (int i=0; i<N(keys); i++)
+      m (keys[i])= keys[i];
+  }
+  return texmacs_time () - start;
+}
+
+template<class M> static time_t
+benchmark_lookup (M& m, array<string> keys, int rounds, int& found) {
+  // look up in an order unrelated to the order of insertion
+  int n= N(keys);
+  time_t start= texmacs_time ();
+  for (int r=0; r<rounds; r++)
+    for (int i=0; i<n; i++)
+      if (m[keys[(i * 4099) % n]] != UNINIT) found++;
+  return texmacs_time () - start;
+}
+
+TEST (hashmap, benchmark) {
+  array<string> keys= benchmark_keys (20000);
+  hashmap<string,tree> hm (UNINIT);
+  flat_hashmap<string,tree> fm (UNINIT);
+  int hm_found= 0, fm_found= 0;
+  time_t hm_insert= benchmark_insert (hm, keys, 20);
+  time_t fm_insert= benchmark_insert (fm, keys, 20);
+  time_t hm_lookup= benchmark_lookup (hm, keys, 50, hm_found);
+  time_t fm_lookup= benchmark_lookup (fm, keys, 50, fm_found);
+  EXPECT_EQ (hm_found == 50 * N(keys), true);
+  EXPECT_EQ (fm_found == 50 * N(keys), true);
+  hashmap<string,tree> converted (UNINIT, (tree) fm);
+  EXPECT_EQ (hm == converted, true);
+  cout << "Insertions (hashmap)      : " << hm_insert << " ms\n";
+  cout << "Insertions (flat_hashmap) : " << fm_insert << " ms\n";
+  cout << "Lookups (hashmap)         : " << hm_lookup << " ms\n";
+  cout << "Lookups (flat_hashmap)    : " << fm_lookup << " ms\n";
+}
@@ -0,0 +1,57 @@
+/******************************************************************************
+* MODULE     : atom_test.cpp
+* DESCRIPTION: test on tables of interned strings
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "atom.hpp"
+#include "tree.hpp"
+
+TEST (atom_table, make) {
+  atom_table t (10);
+  int a= t.make ("font");
+  int b= t.make ("font-series");
+  EXPECT_EQ (a, 10);
+  EXPECT_EQ (b, 11);
+  EXPECT_EQ (t.make (string ("font")), 10);
+  EXPECT_EQ (t[a] == "font", true);
+  EXPECT_EQ (t[b] == "font-series", true);
+  EXPECT_EQ (N(t), 2);
+}
+
+TEST (atom_table, set) {
+  atom_table t (0, "?");
+  t.set (5, "concat");
+  EXPECT_EQ (t[5] == "concat", true);
+  EXPECT_EQ (t[3] == "?", true);
+  EXPECT_EQ (t[100] == "?", true);
+  EXPECT_EQ (t.find ("concat"), 5);
+  EXPECT_EQ (t.find ("document"), -1);
+  EXPECT_EQ (t.contains ("document"), false);
+  EXPECT_EQ (t.make ("document"), 6);
+}
+
+TEST (atom_table, immortal) {
+  atom_table t;
+  string s ("<alpha>");
+  t.make (s);
+  EXPECT_EQ (is_immortal (s), true);
+  EXPECT_EQ (is_immortal (t[0]), true);
+}
+
+TEST (atom_table, tree_labels) {
+  tree_label l= make_tree_label ("my-extension");
+  EXPECT_EQ (l >= START_EXTENSIONS, true);
+  EXPECT_EQ (make_tree_label ("my-extension") == l, true);
+  EXPECT_EQ (as_string (l) == "my-extension", true);
+  EXPECT_EQ (as_tree_label ("my-extension") == l, true);
+  EXPECT_EQ (existing_tree_label ("my-other-extension"), false);
+  EXPECT_EQ (as_tree_label ("my-other-extension", (tree_label) -1) ==
+             (tree_label) -1, true);
+}
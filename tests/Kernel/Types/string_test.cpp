@@ -13,6 +13,7 @@
 #include "gtest/gtest.h"
 
 #include "string.hpp"
+#include "tm_timer.hpp"
 
 /******************************************************************************
 * Tests on Common routines for strings
@@ -71,6 +72,60 @@ TEST (string, append) {
   ASSERT_TRUE (str == string("xyz"));
 }
 
+TEST (string, resize) {
+  // cross the boundary between inline and allocated storage
+  string str ("<alpha>");
+  for (int i=0; i<10; i++) str << string ("<beta>");
+  ASSERT_TRUE (N(str) == 67);
+  ASSERT_TRUE (str (61, 67) == "<beta>");
+  str->resize (3);
+  ASSERT_TRUE (str == "<al");
+  str << "pha>";
+  ASSERT_TRUE (str == "<alpha>");
+}
+
+TEST (string, hash) {
+  string str ("font-series");
+  int h= hash (str);
+  ASSERT_TRUE (hash (str) == h);
+  ASSERT_TRUE (hash (copy (str)) == h);
+  str[0]= 'F';
+  ASSERT_TRUE (hash (str) == hash (string ("Font-series")));
+  str << 'x';
+  ASSERT_TRUE (hash (str) == hash (string ("Font-seriesx")));
+}
+
+TEST (string, hash_after_reference) {
+  // the hash code is invalidated when writing, not when taking the reference
+  string str ("font-family");
+  string_char c= str[0];
+  int h= hash (str);
+  c= 'F';
+  ASSERT_TRUE (hash (str) != h);
+  ASSERT_TRUE (hash (str) == hash (string ("Font-family")));
+  string atom ("font-base-size");
+  make_immortal (atom);
+  h= hash (atom);
+  atom[0]++;
+  ASSERT_TRUE (hash (atom) == hash (string ("gont-base-size")));
+}
+
+TEST (string, const_access) {
+  string str ("font-shape");
+  int h= hash (str);
+  const string& c= str;
+  int sum= 0;
+  for (int i=0; i<N(c); i++) sum += (int) c[i];
+  ASSERT_TRUE (sum > 0);
+  ASSERT_TRUE (hash (str) == h);
+  string atom ("font-size");
+  make_immortal (atom);
+  h= hash (atom);
+  ASSERT_TRUE (atom[0] == 'f');
+  ASSERT_TRUE (hash (atom) == h);
+  ASSERT_TRUE (atom == string ("font-size"));
+}
+
 /******************************************************************************
 * Conversions
 ******************************************************************************/
@@ -147,3 +202,27 @@ TEST (string, is_quoted) {
   ASSERT_FALSE (is_quoted ("\"Hello TeXmac\"s"));
   ASSERT_FALSE (is_quoted ("H\"ello TeXmacs\""));
 }
+
+/******************************************************************************
+* Micro benchmark on short strings
+******************************************************************************/
+TEST (string, benchmark) {
+  const char* names[8]= { "<alpha>", "<beta>", "font", "font-series",
+                          "concat", "document", "par-left", "with" };
+  int start= mem_used ();
+  time_t t0= texmacs_time ();
+  string* strs= tm_new_array<string> (100000);
+  for (int i=0; i<100000; i++) strs[i]= string (names[i % 8]);
+  time_t t1= texmacs_time ();
+  int used= mem_used () - start;
+  int sum= 0;
+  for (int k=0; k<20; k++)
+    for (int i=0; i<100000; i++)
+      if (hash (strs[i]) == hash (strs[(i + 8) % 100000])) sum++;
+  time_t t2= texmacs_time ();
+  tm_delete_array (strs);
+  ASSERT_TRUE (sum == 2000000);
+  cout << "Creation of 100000 short strings : " << (t1 - t0) << " ms, "
+       << used << " bytes\n";
+  cout << "4000000 hash computations        : " << (t2 - t1) << " ms\n";
+}
@@ -0,0 +1,182 @@
+/******************************************************************************
+* MODULE     : basic_environment_test.cpp
+* DESCRIPTION: test on hash tables as environments
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "basic_environment.hpp"
+#include "vars.hpp"
+#include "iterator.hpp"
+#include "tm_timer.hpp"
+
+TEST (basic_environment, write_read) {
+  basic_environment env (1);
+  for (int i=0; i<100; i++) env->write (i, as_string (i));
+  EXPECT_EQ (env->size, 100);
+  for (int i=0; i<100; i++)
+    EXPECT_EQ (env[i] == as_string (i), true);
+  EXPECT_EQ (env->contains (100), false);
+  EXPECT_EQ (env[100] == UNINIT, true);
+  for (int i=0; i<100; i+=2) env->remove (i);
+  EXPECT_EQ (env->size, 50);
+  for (int i=0; i<100; i++)
+    EXPECT_EQ (env->contains (i), i % 2 == 1);
+}
+
+TEST (basic_environment, string_keys) {
+  basic_environment env (4);
+  env->write ("font", "roman");
+  env->write ("font-size", "10");
+  EXPECT_EQ (env["font"] == "roman", true);
+  EXPECT_EQ (env[make_env_key ("font-size")] == "10", true);
+  EXPECT_EQ (env_key_name (make_env_key ("font-size")), "font-size");
+  EXPECT_EQ (env->contains ("font-series"), false);
+  EXPECT_EQ (env->contains ("no-such-environment-variable"), false);
+  EXPECT_EQ (find_env_key ("no-such-environment-variable"), -1);
+  env->remove ("font");
+  EXPECT_EQ (env->contains ("font"), false);
+  // the names of macro arguments do not become tree labels
+  env->write ("my-macro-argument", "x");
+  EXPECT_EQ (env["my-macro-argument"] == "x", true);
+  EXPECT_EQ (existing_tree_label ("my-macro-argument"), false);
+}
+
+TEST (basic_environment, precomputed_keys) {
+  EXPECT_EQ (make_env_key (FONT_SIZE), FONT_SIZE_KEY);
+  EXPECT_EQ (find_env_key (MATH_LEVEL), MATH_LEVEL_KEY);
+  EXPECT_EQ (env_key_name (MODE_KEY), MODE);
+  EXPECT_EQ (MODE_KEY != MATH_LEVEL_KEY, true);
+  basic_environment env (4);
+  env->write (MODE_KEY, "math");
+  env->write (MATH_LEVEL, "1");
+  EXPECT_EQ (env[MODE] == "math", true);
+  EXPECT_EQ (env[MATH_LEVEL_KEY] == "1", true);
+}
+
+TEST (basic_environment, copy) {
+  basic_environment env (2);
+  env->write ("color", "black");
+  env->write ("bg-color", "white");
+  basic_environment env2= copy (env);
+  env2->write ("color", "red");
+  env2->write ("opacity", "1");
+  EXPECT_EQ (env["color"] == "black", true);
+  EXPECT_EQ (env->contains ("opacity"), false);
+  EXPECT_EQ (env2["color"] == "red", true);
+  EXPECT_EQ (env2["bg-color"] == "white", true);
+  EXPECT_EQ (env2->size, 3);
+}
+
+TEST (basic_environment, stamps) {
+  basic_environment env (4);
+  tree red ("red"), blue ("blue");
+  env->write ("color", red);
+  basic_environment env2= copy (env);
+  EXPECT_EQ (env->stamp == env2->stamp, true);
+  EXPECT_EQ (env->same_contents (env2), true);
+  env2->write ("color", blue);
+  EXPECT_EQ (env->stamp == env2->stamp, false);
+  EXPECT_EQ (env->same_contents (env2), false);
+  env2->write ("color", red);
+  EXPECT_EQ (env->hv == env2->hv, true);
+  EXPECT_EQ (env->same_contents (env2), true);
+  for (int i=0; i<100; i++) env2->write ("tmp-" * as_string (i), red);
+  for (int i=0; i<100; i++) env2->remove ("tmp-" * as_string (i));
+  EXPECT_EQ (env->hv == env2->hv, true);
+  EXPECT_EQ (env->same_contents (env2), true);
+  env2->write ("color", tree ("red"));
+  EXPECT_EQ (env->same_contents (env2), false);
+}
+
+/******************************************************************************
+* Micro benchmark on the access pattern of the typesetter
+******************************************************************************/
+
+TEST (basic_environment, benchmark) {
+  // an environment with several hundreds of style variables, in which
+  // macro frames are pushed and local changes are undone as in edit_env
+  array<string> vars, args;
+  for (int i=0; i<400; i++) vars << ("style-variable-" * as_string (i));
+  args << string ("body") << string ("name") << string ("x");
+  basic_environment env (512);
+  hashmap<string,tree> h (UNINIT);
+  for (int i=0; i<400; i++) {
+    env->write (vars[i], as_string (i));
+    h (vars[i])= as_string (i);
+  }
+  tree changed ("changed");
+
+  time_t t0= texmacs_time ();
+  int sum1= 0;
+  for (int k=0; k<100000; k++) {
+    basic_environment frame (4);
+    for (int j=0; j<3; j++) frame->write (args[j], vars[(k+j) % 400]);
+    basic_environment back (1);
+    for (int j=0; j<4; j++) {
+      int key= make_env_key (vars[(7*k + j) % 400]);
+      if (!back->contains (key)) back->write (key, env->read (key));
+      env->write (key, changed);
+    }
+    for (int j=0; j<16; j++)
+      if (env[vars[(3*k + j) % 400]] == changed) sum1++;
+    if (frame->contains (args[k % 3])) sum1++;
+    hash_node* a= back->a;
+    for (int b=0; b<back->n; b++)
+      for (int i= a[b].start; i >= 0; i= a[i].next)
+        env->write (a[i].key, a[i].val);
+  }
+  time_t t1= texmacs_time ();
+  int sum2= 0;
+  for (int k=0; k<100000; k++) {
+    hashmap<string,tree> frame (UNINIT);
+    for (int j=0; j<3; j++) frame (args[j])= vars[(k+j) % 400];
+    hashmap<string,tree> back (UNINIT);
+    for (int j=0; j<4; j++) {
+      string var= vars[(7*k + j) % 400];
+      back->write_back (var, h);
+      h (var)= changed;
+    }
+    for (int j=0; j<16; j++)
+      if (h[vars[(3*k + j) % 400]] == changed) sum2++;
+    if (frame->contains (args[k % 3])) sum2++;
+    iterator<string> it= iterate (back);
+    while (it->busy ()) {
+      string var= it->next ();
+      h (var)= back[var];
+    }
+  }
+  time_t t2= texmacs_time ();
+  // same pattern when the typesetter passes precomputed keys
+  array<int> keys, arg_keys;
+  for (int i=0; i<400; i++) keys << make_env_key (vars[i]);
+  for (int j=0; j<3; j++) arg_keys << make_env_key (args[j]);
+  int sum3= 0;
+  for (int k=0; k<100000; k++) {
+    basic_environment frame (4);
+    for (int j=0; j<3; j++) frame->write (arg_keys[j], vars[(k+j) % 400]);
+    basic_environment back (1);
+    for (int j=0; j<4; j++) {
+      int key= keys[(7*k + j) % 400];
+      if (!back->contains (key)) back->write (key, env->read (key));
+      env->write (key, changed);
+    }
+    for (int j=0; j<16; j++)
+      if (env[keys[(3*k + j) % 400]] == changed) sum3++;
+    if (frame->contains (arg_keys[k % 3])) sum3++;
+    hash_node* a= back->a;
+    for (int b=0; b<back->n; b++)
+      for (int i= a[b].start; i >= 0; i= a[i].next)
+        env->write (a[i].key, a[i].val);
+  }
+  time_t t3= texmacs_time ();
+  cout << "Integer keyed environment : " << (t1 - t0) << " ms\n";
+  cout << "String keyed hashmap      : " << (t2 - t1) << " ms\n";
+  cout << "Precomputed keys          : " << (t3 - t2) << " ms\n";
+  EXPECT_EQ (sum1, sum2);
+  EXPECT_EQ (sum1, sum3);
+}
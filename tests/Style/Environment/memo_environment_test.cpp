@@ -0,0 +1,142 @@
+/******************************************************************************
+* MODULE     : memo_environment_test.cpp
+* DESCRIPTION: test on memorizing computations for recurring environments
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "memo_environment.hpp"
+
+static hashmap<string,tree> values (UNINIT);
+
+static tree
+value (string s) {
+  // environments are compared physically, so that values must be shared
+  if (!values->contains (s)) values (s)= tree (s);
+  return values [s];
+}
+
+static basic_environment
+make_env (string color, string size) {
+  basic_environment env (4);
+  env->write ("color", value (color));
+  env->write ("font-size", value (size));
+  return env;
+}
+
+/******************************************************************************
+* Expansion following the protocol of edit_env_rep::exec_memorized
+******************************************************************************/
+
+static int hits= 0, misses= 0;
+
+static string
+expand (memo_environment memo, basic_environment env, tree t) {
+  int i= memo->find (env);
+  if (i >= 0) {
+    tree r= memo->get (i, t);
+    if (is_atomic (r)) { hits++; return r->label; }
+  }
+  else i= memo->enter (env);
+  misses++;
+  string r= as_string (t[0]) * "@" * env["color"]->label;
+  if (i >= 0) memo->set (i, t, r, 100);
+  return r;
+}
+
+TEST (memo_environment, hits_and_misses) {
+  memo_environment memo (4);
+  basic_environment env= make_env ("red", "10");
+  tree t (CONCAT, "a", "b");
+  hits= misses= 0;
+  // an environment is only given a slot when it comes back
+  EXPECT_EQ (expand (memo, env, t), "a@red");
+  EXPECT_EQ (N(memo), 0);
+  EXPECT_EQ (expand (memo, env, t), "a@red");
+  EXPECT_EQ (N(memo), 1);
+  EXPECT_EQ (misses, 2);
+  EXPECT_EQ (hits, 0);
+  EXPECT_EQ (expand (memo, env, t), "a@red");
+  EXPECT_EQ (expand (memo, env, tree (CONCAT, "a", "b")), "a@red");
+  EXPECT_EQ (misses, 2);
+  EXPECT_EQ (hits, 2);
+  // a different expansion in the same environment
+  expand (memo, env, tree (CONCAT, "c"));
+  EXPECT_EQ (misses, 3);
+  // the same expansion in another environment
+  basic_environment env2= make_env ("blue", "10");
+  EXPECT_EQ (expand (memo, env2, t), "a@blue");
+  EXPECT_EQ (expand (memo, env2, t), "a@blue");
+  EXPECT_EQ (expand (memo, env2, t), "a@blue");
+  EXPECT_EQ (misses, 5);
+  EXPECT_EQ (hits, 3);
+  EXPECT_EQ (expand (memo, env, t), "a@red");
+  EXPECT_EQ (hits, 4);
+}
+
+TEST (memo_environment, find_by_contents) {
+  memo_environment memo (4);
+  basic_environment env= make_env ("red", "10");
+  EXPECT_EQ (memo->enter (env), -1);
+  EXPECT_EQ (memo->enter (env), 0);
+  EXPECT_EQ (memo->find (env), 0);
+  // same contents, but written again: the stamp changes
+  env->write ("color", value ("green"));
+  EXPECT_EQ (memo->find (env), -1);
+  DI stamp= env->stamp;
+  env->write ("color", value ("red"));
+  EXPECT_EQ (env->stamp != stamp, true);
+  EXPECT_EQ (memo->find (env), 0);
+  // a physically equal environment shares the stamp of its slot afterwards
+  basic_environment env2= make_env ("red", "10");
+  EXPECT_EQ (memo->find (env2), 0);
+  EXPECT_EQ (env2->stamp == env->stamp, true);
+}
+
+TEST (memo_environment, replace_slots) {
+  memo_environment memo (2);
+  array<basic_environment> envs;
+  for (int i=0; i<3; i++) {
+    envs << make_env ("red", as_string (10 + i));
+    memo->enter (envs[i]);
+    EXPECT_EQ (memo->enter (envs[i]), i % 2);
+  }
+  EXPECT_EQ (N(memo), 2);
+  EXPECT_EQ (memo->find (envs[0]), -1);
+  EXPECT_EQ (memo->find (envs[1]), 1);
+  EXPECT_EQ (memo->find (envs[2]), 0);
+}
+
+/******************************************************************************
+* Results memorized by position
+******************************************************************************/
+
+TEST (memo_environment, positions) {
+  memo_positions<int> memo (3);
+  path ip (1, path (2));
+  tree t (CONCAT, "x", "y");
+  int r= 0;
+  EXPECT_EQ (memo.get (ip, 7, t, r), false);
+  memo.set (ip, 7, t, 42);
+  EXPECT_EQ (memo.get (ip, 7, t, r), true);
+  EXPECT_EQ (r, 42);
+  EXPECT_EQ (memo.get (ip, 8, t, r), false);
+  EXPECT_EQ (memo.get (path (3, path (2)), 7, t, r), false);
+  // modifying the source tree in place invalidates the entry
+  t[1]= "z";
+  EXPECT_EQ (memo.get (ip, 7, t, r), false);
+  memo.set (ip, 7, t, 43);
+  EXPECT_EQ (memo.get (ip, 7, tree (CONCAT, "x", "z"), r), true);
+  EXPECT_EQ (r, 43);
+  EXPECT_EQ (memo.size (), 1);
+  // the table is flushed when full
+  for (int i=0; i<3; i++) memo.set (path (i), 7, t, i);
+  EXPECT_EQ (memo.size (), 1);
+  EXPECT_EQ (memo.get (ip, 7, t, r), false);
+  EXPECT_EQ (memo.get (path (2), 7, t, r), true);
+  EXPECT_EQ (r, 2);
+}
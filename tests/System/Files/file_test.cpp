@@ -14,4 +14,35 @@
 
 TEST (file, work) {
   url_temp_dir();
-}
\ No newline at end of file
+}
+TEST (file, ostream) {
+  url u= url_temp (".txt");
+  string s;
+  for (int i=0; i<10000; i++) s << "line " << as_string (i) << "\n";
+  tm_ostream out= file_ostream (u);
+  for (int i=0; i<N(s); i+=1000) out << s (i, min (i+1000, N(s)));
+  // the file only appears once it has been completely written
+  EXPECT_EQ (exists (u), false);
+  EXPECT_EQ (out->close (), false);
+  string r;
+  EXPECT_EQ (load_string (u, r, false), false);
+  EXPECT_EQ (r == s, true);
+  remove (u);
+}
+
+TEST (file, null_characters) {
+  // file streams keep null characters, the other streams drop them
+  string s ("a\0b", 3);
+  url u= url_temp (".bin");
+  tm_ostream out= file_ostream (u);
+  out << s;
+  EXPECT_EQ (out->close (), false);
+  string r;
+  EXPECT_EQ (load_string (u, r, false), false);
+  EXPECT_EQ (r == s, true);
+  remove (u);
+  tm_ostream buf;
+  buf.buffer ();
+  buf << s;
+  EXPECT_EQ (buf.unbuffer () == "ab", true);
+}
@@ -0,0 +1,146 @@
+/******************************************************************************
+* MODULE     : packrat_parser_test.cpp
+* DESCRIPTION: tests on the incremental packrat parsers
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "packrat_parser.hpp"
+#include "observer.hpp"
+#include "tm_timer.hpp"
+
+packrat_grammar make_packrat_grammar (string s);
+packrat_parser  make_packrat_parser (string lan, tree in);
+packrat_parser  make_packrat_parser (string lan, tree in, path in_pos);
+
+static tree
+sym (string s) {
+  return compound ("symbol", s);
+}
+
+static packrat_grammar
+test_grammar () {
+  packrat_grammar gr= make_packrat_grammar ("packrat-test");
+  if (gr->grammar->contains (encode_symbol (sym ("Main")))) return gr;
+  gr->define ("Atom", compound ("repeat", compound ("range", "a", "z")));
+  gr->define ("Number", compound ("repeat", compound ("range", "0", "9")));
+  gr->define ("Blank", compound ("repeat", compound ("or", " ", "\n")));
+  gr->define ("List", compound ("concat", "(", compound ("while",
+                                sym ("Item")), ")"));
+  gr->define ("Item", compound ("or", sym ("Blank"), sym ("List"),
+                                sym ("Atom"), sym ("Number")));
+  gr->define ("Main", compound ("while", sym ("Item")));
+  tree simple= compound ("or", sym ("Blank"), sym ("Atom"), sym ("Number"));
+  gr->define ("Marked", compound ("concat", compound ("while", simple),
+                                  compound ("tm-cursor")));
+  gr->set_property ("Atom", "highlight", "variable");
+  gr->set_property ("Number", "highlight", "constant_number");
+  return gr;
+}
+
+static tree
+program (int nr) {
+  tree t (DOCUMENT);
+  for (int i=0; i<nr; i++)
+    t << ("(define (f" * as_string (i) * " x y) (plus x " *
+          as_string (i) * "))");
+  return t;
+}
+
+static bool
+same_results (packrat_parser par, packrat_parser ref, array<string> syms) {
+  if (par->current_input != ref->current_input) return false;
+  for (int i=0; i<N(syms); i++) {
+    C s= encode_symbol (sym (syms[i]));
+    for (C pos=0; pos<=N(ref->current_input); pos++)
+      if (par->parse (s, pos) != ref->parse (s, pos)) return false;
+  }
+  return true;
+}
+
+TEST (packrat_parser, incremental) {
+  packrat_grammar gr= test_grammar ();
+  array<string> syms;
+  syms << string ("Main") << string ("Item") << string ("List");
+  tree doc= program (40);
+  packrat_parser par= make_packrat_parser ("packrat-test", doc);
+  C main= encode_symbol (sym ("Main"));
+  EXPECT_EQ (par->parse (main, 0), N(par->current_input));
+  for (int k=0; k<5; k++) {
+    if (k == 0) doc[20]= "(define (g x y) (plus x 20))";
+    if (k == 1) doc[39]= doc[39]->label * " (";
+    if (k == 2) doc[0]= "(" * doc[0]->label;
+    if (k == 3) doc << tree ("(extra)");
+    if (k == 4) doc[39]= "";
+    par= make_packrat_parser ("packrat-test", doc);
+    // the results before the modified line are still available
+    EXPECT_GT (par->current_entries, 0);
+    packrat_parser ref (gr, doc);
+    EXPECT_EQ (same_results (par, ref, syms), true);
+  }
+}
+
+TEST (packrat_parser, cursor) {
+  packrat_grammar gr= test_grammar ();
+  array<string> syms;
+  syms << string ("Marked") << string ("Item");
+  tree doc= program (10);
+  for (int i=0; i<10; i++) {
+    path p (i, path (5));
+    packrat_parser par= make_packrat_parser ("packrat-test", doc, p);
+    packrat_parser ref (gr, doc, p);
+    EXPECT_EQ (same_results (par, ref, syms), true);
+  }
+}
+
+TEST (packrat_parser, highlight) {
+  packrat_grammar gr= test_grammar ();
+  int hl_lan= packrat_abbreviation ("packrat-test", "Main");
+  tree doc= program (200);
+  time_t t0= texmacs_time ();
+  packrat_highlight ("packrat-test", "Main", doc);
+  time_t t1= texmacs_time ();
+  for (int k=0; k<20; k++) {
+    int i= (k * 997) % N(doc);
+    doc[i]= doc[i]->label (0, 9) * "x" * doc[i]->label (9, N(doc[i]->label));
+    packrat_highlight ("packrat-test", "Main", doc);
+  }
+  time_t t2= texmacs_time ();
+  cout << "Highlight " << N(doc) << " lines : " << (t1 - t0) << " ms\n";
+  cout << "Highlight after an edit : " << (t2 - t1) / 20 << " ms\n";
+
+  // compare with the highlighting by a new parser
+  tree ref= copy (doc);
+  gr->stamp++;
+  packrat_highlight ("packrat-test", "Main", ref);
+  for (int i=0; i<N(doc); i++) {
+    array<int> cols= obtain_highlight (doc[i], hl_lan);
+    ASSERT_EQ (N(cols), N(doc[i]->label));
+    EXPECT_EQ (cols == obtain_highlight (ref[i], hl_lan), true);
+  }
+}
+
+TEST (packrat_parser, compiled) {
+  packrat_grammar gr= test_grammar ();
+  gr->compile ();
+  C atom= encode_symbol (sym ("Atom")) - PACKRAT_TM_OPEN;
+  C main= encode_symbol (sym ("Main")) - PACKRAT_TM_OPEN;
+  // matches of Atom start with a letter, whereas Main may be empty
+  ASSERT_GE (gr->first_pos[atom], 0);
+  EXPECT_EQ (gr->first_pos[main], -1);
+  unsigned int* bits= A(gr->first_tokens) + gr->first_pos[atom];
+  EXPECT_NE (bits['x' >> 5] & (1u << ('x' & 31)), 0u);
+  EXPECT_EQ (bits['7' >> 5] & (1u << ('7' & 31)), 0u);
+
+  tree doc= program (2000);
+  time_t t0= texmacs_time ();
+  packrat_parser par (gr, doc);
+  C r= par->parse (encode_symbol (sym ("Main")), 0);
+  time_t t1= texmacs_time ();
+  cout << "Parse " << N(doc) << " lines : " << (t1 - t0) << " ms\n";
+  EXPECT_EQ (r, N(par->current_input));
+}
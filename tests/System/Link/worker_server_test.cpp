@@ -0,0 +1,189 @@
+/******************************************************************************
+* MODULE     : worker_server_test.cpp
+* DESCRIPTION: tests on servers with pools of worker processes
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "worker_server.hpp"
+#include "analyze.hpp"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+static string
+test_handler (string request) {
+  if (request == "crash") _exit (1);
+  if (request == "slow") usleep (200000);
+  if (request == "hang") sleep (10);
+  return "ok\n" * request;
+}
+
+static int
+connect_to (int port) {
+  int fd= socket (AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  addr.sin_family= AF_INET;
+  addr.sin_port= htons (port);
+  addr.sin_addr.s_addr= inet_addr ("127.0.0.1");
+  connect (fd, (struct sockaddr*) &addr, sizeof (addr));
+  fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+static void
+send_request (int fd, string s) {
+  string p= (as_string (N(s)) * "\n") * s;
+  EXPECT_EQ (write (fd, &(p[0]), N(p)), N(p));
+}
+
+static array<string>
+replies (worker_server_rep* srv, int fd, int nr) {
+  array<string> r;
+  string buf;
+  time_t start= texmacs_time ();
+  while (N(r) < nr && texmacs_time () - start < 3000) {
+    srv->listen (10);
+    char tmp[1024];
+    int n= read (fd, tmp, 1024);
+    if (n > 0) buf << string (tmp, n);
+    while (true) {
+      int i= 0;
+      while (i < N(buf) && buf[i] != '\n') i++;
+      if (i == N(buf)) break;
+      int len= as_int (buf (0, i));
+      if (N(buf) - (i+1) < len) break;
+      r << buf (i+1, i+1+len);
+      buf= buf (i+1+len, N(buf));
+    }
+  }
+  return r;
+}
+
+TEST (worker_server, replies_in_order) {
+  worker_server_rep* srv= tm_new<worker_server_rep> (test_handler, 2);
+  ASSERT_EQ (srv->start (0), "ok");
+  int fd= connect_to (srv->port);
+  send_request (fd, "slow");
+  send_request (fd, "fast");
+  send_request (fd, "next");
+  array<string> r= replies (srv, fd, 3);
+  ASSERT_EQ (N(r), 3);
+  EXPECT_EQ (r[0], "ok\nslow");
+  EXPECT_EQ (r[1], "ok\nfast");
+  EXPECT_EQ (r[2], "ok\nnext");
+  close (fd);
+  tm_delete (srv);
+}
+
+TEST (worker_server, several_clients) {
+  worker_server_rep* srv= tm_new<worker_server_rep> (test_handler, 2);
+  ASSERT_EQ (srv->start (0), "ok");
+  int fd1= connect_to (srv->port);
+  int fd2= connect_to (srv->port);
+  send_request (fd1, "slow");
+  send_request (fd2, "other");
+  array<string> r2= replies (srv, fd2, 1);
+  ASSERT_EQ (N(r2), 1);
+  EXPECT_EQ (r2[0], "ok\nother");
+  array<string> r1= replies (srv, fd1, 1);
+  ASSERT_EQ (N(r1), 1);
+  EXPECT_EQ (r1[0], "ok\nslow");
+  close (fd1);
+  close (fd2);
+  tm_delete (srv);
+}
+
+TEST (worker_server, crashing_worker) {
+  worker_server_rep* srv= tm_new<worker_server_rep> (test_handler, 1);
+  ASSERT_EQ (srv->start (0), "ok");
+  int fd= connect_to (srv->port);
+  send_request (fd, "crash");
+  send_request (fd, "after");
+  array<string> r= replies (srv, fd, 2);
+  ASSERT_EQ (N(r), 2);
+  EXPECT_EQ (r[0], "error\nthe worker process died");
+  EXPECT_EQ (r[1], "ok\nafter");
+  send_request (fd, "statistics");
+  array<string> s= replies (srv, fd, 1);
+  ASSERT_EQ (N(s), 1);
+  EXPECT_GE (search_forwards ("\nserved 1\n", s[0]), 0);
+  EXPECT_GE (search_forwards ("\nfailed 1\n", s[0]), 0);
+  close (fd);
+  tm_delete (srv);
+}
+
+TEST (worker_server, malformed_request) {
+  worker_server_rep* srv= tm_new<worker_server_rep> (test_handler, 1);
+  ASSERT_EQ (srv->start (0), "ok");
+  int fd= connect_to (srv->port);
+  string bad= "x\n";
+  EXPECT_EQ (write (fd, &(bad[0]), N(bad)), N(bad));
+  array<string> r= replies (srv, fd, 1);
+  ASSERT_EQ (N(r), 1);
+  EXPECT_EQ (r[0], "error\nmalformed request");
+  close (fd);
+  tm_delete (srv);
+}
+
+TEST (worker_server, timeout) {
+  worker_server_rep* srv= tm_new<worker_server_rep> (test_handler, 1, 200);
+  ASSERT_EQ (srv->start (0), "ok");
+  int fd= connect_to (srv->port);
+  send_request (fd, "hang");
+  send_request (fd, "after");
+  array<string> r= replies (srv, fd, 2);
+  ASSERT_EQ (N(r), 2);
+  EXPECT_EQ (r[0], "error\nthe request timed out");
+  EXPECT_EQ (r[1], "ok\nafter");
+  close (fd);
+  tm_delete (srv);
+}
+
+TEST (worker_server, address) {
+  worker_server_rep* srv= tm_new<worker_server_rep> (test_handler, 1);
+  EXPECT_NE (srv->start (0, "localhost:80"), "ok");
+  ASSERT_EQ (srv->start (0, "127.0.0.1"), "ok");
+  int fd= connect_to (srv->port);
+  send_request (fd, "local");
+  array<string> r= replies (srv, fd, 1);
+  ASSERT_EQ (N(r), 1);
+  EXPECT_EQ (r[0], "ok\nlocal");
+  close (fd);
+  tm_delete (srv);
+}
+
+TEST (worker_server, executed_workers) {
+  // the descriptor of the socket is passed as the last argument ($0)
+  array<string> cmd;
+  cmd << string ("/bin/sh") << string ("-c") << string ("exec cat <&$0 >&$0");
+  worker_server_rep* srv= tm_new<worker_server_rep> (cmd, 2);
+  ASSERT_EQ (srv->start (0), "ok");
+  int fd= connect_to (srv->port);
+  send_request (fd, "ok\nfirst");
+  send_request (fd, "ok\nsecond");
+  array<string> r= replies (srv, fd, 2);
+  ASSERT_EQ (N(r), 2);
+  EXPECT_EQ (r[0], "ok\nfirst");
+  EXPECT_EQ (r[1], "ok\nsecond");
+  close (fd);
+  tm_delete (srv);
+
+  array<string> none;
+  none << string ("/nonexistent/texmacs");
+  srv= tm_new<worker_server_rep> (none, 1);
+  ASSERT_EQ (srv->start (0), "ok");
+  fd= connect_to (srv->port);
+  send_request (fd, "ok\nlost");
+  r= replies (srv, fd, 1);
+  ASSERT_EQ (N(r), 1);
+  EXPECT_EQ (r[0], "error\nthe worker process died");
+  close (fd);
+  tm_delete (srv);
+}
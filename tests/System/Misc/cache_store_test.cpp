@@ -0,0 +1,97 @@
+/******************************************************************************
+* MODULE     : cache_store_test.cpp
+* DESCRIPTION: test on the append-only logs for cached data
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "cache_store.hpp"
+#include "file.hpp"
+
+static tree
+stat_tuple (string a, string b, string c) {
+  return tree (make_tree_label ("cache-stat"), a, b, c);
+}
+
+TEST (cache_store, reload) {
+  url log= url_temp (".log");
+  cache_store c (log, CACHE_BY_PARENT);
+  c->load ();
+  c->set ("/tmp/a/x.ts", "contents of x");
+  c->set ("/tmp/a/y.ts", stat_tuple ("1", "2", "3"));
+  c->save ();
+
+  cache_store d (log, CACHE_BY_PARENT);
+  EXPECT_EQ (d->contains ("/tmp/a/x.ts"), false);
+  d->load ();
+  EXPECT_EQ (d->contains ("/tmp/a/x.ts"), true);
+  EXPECT_EQ (N(d->data), 0);
+  EXPECT_EQ (d->get ("/tmp/a/x.ts") == "contents of x", true);
+  EXPECT_EQ (d->get ("/tmp/a/y.ts") == stat_tuple ("1", "2", "3"), true);
+  EXPECT_EQ (d->get ("/tmp/a/z.ts") == "?", true);
+  remove (log);
+}
+
+TEST (cache_store, append) {
+  url log= url_temp (".log");
+  cache_store c (log);
+  c->load ();
+  c->set ("font", "cmr10");
+  c->save ();
+  string before;
+  EXPECT_EQ (load_string (log, before, false), false);
+  c->set ("other", "ecrm1000");
+  c->reset ("font");
+  c->save ();
+  string after;
+  EXPECT_EQ (load_string (log, after, false), false);
+  EXPECT_EQ (after (0, N(before)) == before, true);
+
+  cache_store d (log);
+  d->load ();
+  EXPECT_EQ (d->contains ("font"), false);
+  EXPECT_EQ (d->get ("other") == "ecrm1000", true);
+  remove (log);
+}
+
+TEST (cache_store, drop) {
+  url log= url_temp (".log");
+  cache_store c (log, CACHE_BY_PARENT);
+  c->load ();
+  c->set ("/tmp/a/x.ts", "x");
+  c->set ("/tmp/a/y.ts", "y");
+  c->set ("/tmp/b/z.ts", "z");
+  c->save ();
+
+  cache_store d (log, CACHE_BY_PARENT);
+  d->drop ("/tmp/a");
+  EXPECT_EQ (d->contains ("/tmp/a/x.ts"), false);
+  EXPECT_EQ (d->contains ("/tmp/a/y.ts"), false);
+  EXPECT_EQ (d->contains ("/tmp/b/z.ts"), true);
+  d->save ();
+
+  cache_store e (log, CACHE_BY_PARENT);
+  e->load ();
+  EXPECT_EQ (e->contains ("/tmp/a/x.ts"), false);
+  EXPECT_EQ (e->get ("/tmp/b/z.ts") == "z", true);
+  remove (log);
+}
+
+TEST (cache_store, corrupted) {
+  url log= url_temp (".log");
+  EXPECT_EQ (save_string (log, "(tuple \"old\" \"format\")", false), false);
+  cache_store c (log);
+  c->load ();
+  EXPECT_EQ (c->contains ("old"), false);
+  c->set ("new", "format");
+  c->save ();
+
+  cache_store d (log);
+  d->load ();
+  EXPECT_EQ (d->get ("new") == "format", true);
+  remove (log);
+}
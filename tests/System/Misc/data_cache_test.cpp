@@ -0,0 +1,28 @@
+/******************************************************************************
+* MODULE     : data_cache_test.cpp
+* DESCRIPTION: test on the invalidation of cached data
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "data_cache.hpp"
+
+TEST (data_cache, declare_modified) {
+  url dir ("/tmp/data-cache-test");
+  string x= concretize (dir * "x.ts"), y= concretize (dir * "y.ts");
+  cache_set ("file_cache", x, "contents of x");
+  cache_set ("file_cache", y, "contents of y");
+  cache_set ("stat_cache.scm", x, "#f");
+  cache_set ("stat_cache.scm", y, "#f");
+  cache_set ("dir_cache.scm", concretize (dir), "x.ts y.ts");
+  declare_modified (dir * "x.ts");
+  EXPECT_EQ (is_cached ("file_cache", x), false);
+  EXPECT_EQ (is_cached ("stat_cache.scm", x), false);
+  EXPECT_EQ (is_cached ("dir_cache.scm", concretize (dir)), false);
+  EXPECT_EQ (cache_get ("file_cache", y) == "contents of y", true);
+  EXPECT_EQ (cache_get ("stat_cache.scm", y) == "#f", true);
+}
@@ -0,0 +1,157 @@
+/******************************************************************************
+* MODULE     : fast_alloc_test.cpp
+* DESCRIPTION: test on the slab based fast allocator
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "fast_alloc.hpp"
+#include <thread>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/******************************************************************************
+* Tests on allocation in a single thread
+******************************************************************************/
+
+TEST (fast_alloc, reuse) {
+  int start= mem_used ();
+  void* ptrs[1000];
+  for (int i=0; i<1000; i++) {
+    ptrs[i]= fast_alloc (24);
+    *((int*) ptrs[i])= i;
+  }
+  EXPECT_EQ (mem_used () - start, 1000 * 24);
+  for (int i=0; i<1000; i++)
+    EXPECT_EQ (*((int*) ptrs[i]), i);
+  for (int i=0; i<1000; i++)
+    fast_free (ptrs[i], 24);
+  EXPECT_EQ (mem_used (), start);
+}
+
+TEST (fast_alloc, large) {
+  int start= mem_used ();
+  void* ptr= fast_alloc (10 * MAX_FAST);
+  EXPECT_EQ (mem_used () - start >= 10 * MAX_FAST, true);
+  fast_free (ptr, 10 * MAX_FAST);
+  EXPECT_EQ (mem_used (), start);
+}
+
+TEST (fast_alloc, tm_new) {
+  int start= mem_used ();
+  int* ptr= tm_new<int> (7);
+  EXPECT_EQ (*ptr, 7);
+  tm_delete (ptr);
+  int* arr= tm_new_array<int> (100);
+  for (int i=0; i<100; i++) arr[i]= i;
+  tm_delete_array (arr);
+  EXPECT_EQ (mem_used (), start);
+}
+
+static bool
+is_mapped (void* slab) {
+  // mincore fails with ENOMEM on pages which are not mapped
+  unsigned char vec[BLOCK_SIZE / 4096 + 1];
+  return mincore (slab, getpagesize (), vec) == 0 || errno != ENOMEM;
+}
+
+TEST (fast_alloc, unmap) {
+  const int n= 300 * (BLOCK_SIZE / 512);
+  void** ptrs= (void**) malloc (n * sizeof (void*));
+  for (int i=0; i<n; i++) ptrs[i]= fast_alloc (512);
+  void* slabs[400];
+  int nr= 0;
+  for (int i=0; i<n; i++) {
+    void* slab= (void*) (((size_t) ptrs[i]) & ~((size_t) (BLOCK_SIZE-1)));
+    if (nr == 0 || slabs[nr-1] != slab) {
+      int j;
+      for (j=0; j<nr; j++)
+        if (slabs[j] == slab) break;
+      if (j == nr && nr < 400) slabs[nr++]= slab;
+    }
+  }
+  EXPECT_GE (nr, 250);
+  for (int i=0; i<n; i++) fast_free (ptrs[i], 512);
+  free (ptrs);
+  // at most 64 empty slabs are retained and the thread cache keeps
+  // a few objects; all other slabs go back to the system
+  int mapped= 0;
+  for (int j=0; j<nr; j++)
+    if (is_mapped (slabs[j])) mapped++;
+  EXPECT_LE (mapped, 64 + 2);
+}
+
+/******************************************************************************
+* Tests on allocation from several threads
+******************************************************************************/
+
+static void
+alloc_routine (void** ptrs, int n) {
+  for (int i=0; i<n; i++)
+    ptrs[i]= fast_alloc (8 + (i % 32) * 8);
+  for (int i=0; i<n; i++)
+    if (i % 2 == 0) fast_free (ptrs[i], 8 + (i % 32) * 8);
+  fast_alloc_thread_exit ();
+}
+
+TEST (fast_alloc, threads) {
+  int start= mem_used ();
+  const int n= 20000;
+  void** ptrs[4];
+  std::thread* ths[4];
+  for (int t=0; t<4; t++) {
+    ptrs[t]= (void**) malloc (n * sizeof (void*));
+    ths[t]= new std::thread (alloc_routine, ptrs[t], n);
+  }
+  for (int t=0; t<4; t++) {
+    ths[t]->join ();
+    delete ths[t];
+  }
+  // the remaining objects are freed by another thread than their owner
+  for (int t=0; t<4; t++) {
+    for (int i=1; i<n; i+=2)
+      fast_free (ptrs[t][i], 8 + (i % 32) * 8);
+    free (ptrs[t]);
+  }
+  EXPECT_EQ (mem_used (), start);
+}
+
+static std::atomic<bool> fork_stop (false);
+
+static void
+busy_routine () {
+  // large objects, so that the caches are often refilled and flushed
+  void* ptrs[512];
+  while (!fork_stop) {
+    for (int i=0; i<512; i++) ptrs[i]= fast_alloc (1024);
+    for (int i=0; i<512; i++) fast_free (ptrs[i], 1024);
+  }
+  fast_alloc_thread_exit ();
+}
+
+TEST (fast_alloc, fork) {
+  // the child must be able to allocate while another thread of the parent
+  // constantly takes and releases the locks of the allocator
+  std::thread th (busy_routine);
+  for (int k=0; k<50; k++) {
+    pid_t pid= fork ();
+    if (pid == 0) {
+      void* ptrs[1000];
+      for (int i=0; i<1000; i++) ptrs[i]= fast_alloc (1024);
+      for (int i=0; i<1000; i++) fast_free (ptrs[i], 1024);
+      _exit (0);
+    }
+    int status= -1;
+    ASSERT_EQ (waitpid (pid, &status, 0), pid);
+    EXPECT_EQ (WIFEXITED (status) && WEXITSTATUS (status) == 0, true);
+  }
+  fork_stop= true;
+  th.join ();
+}
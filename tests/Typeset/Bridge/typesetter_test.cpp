@@ -0,0 +1,28 @@
+/******************************************************************************
+* MODULE     : typesetter_test.cpp
+* DESCRIPTION: test on the typesetting of whole documents
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "typesetter.hpp"
+#include "gtest/gtest.h"
+
+TEST (typesetter, full_export_is_complete) {
+  // exporting all pages must run the complete pass for page references
+  EXPECT_EQ (page_limit_for (ALL_PAGES), -1);
+  EXPECT_EQ (page_limit_for (as_int (string ("1000000"))), -1);
+  EXPECT_EQ (page_limit_for (ALL_PAGES, 12), -1);
+  EXPECT_EQ (page_limit_for (12, 12), -1);
+  EXPECT_EQ (page_limit_for (20, 12), -1);
+  EXPECT_EQ (page_limit_for (-1), -1);
+}
+
+TEST (typesetter, partial_export) {
+  EXPECT_EQ (page_limit_for (3), 3);
+  EXPECT_EQ (page_limit_for (3, 12), 3);
+  EXPECT_EQ (page_limit_for (11, 12), 11);
+}
@@ -0,0 +1,178 @@
+/******************************************************************************
+* MODULE     : line_breaker_test.cpp
+* DESCRIPTION: regression tests and benchmark for the optimal line breaker
+* COPYRIGHT  : (C) 2026  the TeXmacs developers
+*******************************************************************************
+* This software falls under the GNU general public license version 3 or later.
+* It comes WITHOUT ANY WARRANTY WHATSOEVER. For details, see the file LICENSE
+* in the root directory or <http://www.gnu.org/licenses/gpl-3.0.html>.
+******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "Boxes/construct.hpp"
+#include "Format/line_item.hpp"
+#include "impl_language.hpp"
+#include "analyze.hpp"
+#include "tm_timer.hpp"
+
+array<path>
+line_breaks (array<line_item> a, int start, int end,
+             SI line_width, SI large_width,
+             SI first_spc, SI last_spc, bool ragged);
+
+/******************************************************************************
+* A monospaced font and a language with predictable hyphenation points,
+* so that the breaks do not depend on the fonts and patterns installed
+******************************************************************************/
+
+#define CHAR_WIDTH (6*PIXEL)
+
+struct fixed_font_rep: font_rep {
+  fixed_font_rep (string name): font_rep (name) {}
+  bool supports (string c) { (void) c; return true; }
+  void get_extents (string s, metric& ex) {
+    ex->x1= ex->x3= 0; ex->x2= ex->x4= N(s) * CHAR_WIDTH;
+    ex->y1= ex->y3= 0; ex->y2= ex->y4= 10 * PIXEL; }
+  void draw_fixed (renderer ren, string s, SI x, SI y) {
+    (void) ren; (void) s; (void) x; (void) y; }
+  font magnify (double zoomx, double zoomy) {
+    (void) zoomx; (void) zoomy; return this; }
+};
+
+struct fixed_language_rep: language_rep {
+  fixed_language_rep (string name): language_rep (name) {}
+  text_property advance (tree t, int& pos) {
+    pos= N(t->label); return &tp_normal_rep; }
+  array<int> get_hyphens (string s) {
+    array<int> r (max (N(s) - 1, 0));
+    for (int i=0; i<N(r); i++)
+      r[i]= (i % 3 == 2 && i + 2 < N(s))? HYPH_STD + (i % 7) * 100:
+                                          HYPH_INVALID;
+    return r; }
+  void hyphenate (string s, int after, string& l, string& r) {
+    l= s (0, after+1) * "-"; r= s (after+1, N(s)); }
+};
+
+static font
+fixed_font () {
+  static font fn= tm_new<fixed_font_rep> ("line-breaker-test-font");
+  return fn;
+}
+
+static language
+fixed_language () {
+  static language lan= tm_new<fixed_language_rep> ("line-breaker-test");
+  return lan;
+}
+
+static array<line_item>
+paragraph (string text) {
+  array<line_item> a;
+  array<string> words= tokenize (text, " ");
+  pencil pen (black);
+  for (int i=0; i<N(words); i++) {
+    box b= text_box (decorate (), 0, words[i], fixed_font (), pen);
+    line_item item (STRING_ITEM, OP_SKIP, b, 0, fixed_language ());
+    SI sp= 4 * PIXEL + (N(words[i]) % 3) * PIXEL;
+    item->spc= (i == N(words) - 1? space (0): space (sp/2, sp, 3*sp));
+    a << item;
+  }
+  return a;
+}
+
+static string
+as_breaks (array<path> ap) {
+  string r;
+  for (int i=0; i<N(ap); i++) {
+    if (i > 0) r << " ";
+    for (path p= ap[i]; !is_nil (p); p= p->next) {
+      if (p != ap[i]) r << ".";
+      r << as_string (p->item);
+    }
+  }
+  return r;
+}
+
+static string corpus=
+  "The licenses for most software and other practical works are designed "
+  "to take away your freedom to share and change the works. By contrast, "
+  "the GNU General Public License is intended to guarantee your freedom to "
+  "share and change all versions of a program--to make sure it remains free "
+  "software for all its users. We, the Free Software Foundation, use the "
+  "GNU General Public License for most of our software; it applies also to "
+  "any other work released this way by its authors. You can apply it to "
+  "your programs, too. When we speak of free software, we are referring to "
+  "freedom, not price. Our General Public Licenses are designed to make "
+  "sure that you have the freedom to distribute copies of free software "
+  "(and charge for them if you wish), that you receive source code or can "
+  "get it if you want it, that you can change the software or use pieces "
+  "of it in new free programs, and that you know you can do these things.";
+
+static string
+corpus_breaks (int chars) {
+  array<line_item> a= paragraph (corpus);
+  SI w= chars * CHAR_WIDTH;
+  return as_breaks (line_breaks (a, 0, N(a), w, w + w/3, 0, 0, false));
+}
+
+/******************************************************************************
+* The breaks below were computed with the former implementation,
+* which stored the best breaks in a hashmap indexed by paths
+******************************************************************************/
+
+TEST (line_breaker, corpus) {
+  EXPECT_EQ (corpus_breaks (40),
+             string ("0 7 13 21 28 34 41 49 57 63 70 78 87 95 102 108 116 "
+                     "123 131 139 149 158 167 168"));
+  EXPECT_EQ (corpus_breaks (55),
+             string ("0 9 19 28 37 47 57 65 76 87 98 107 118 128 141 153 "
+                     "166 168"));
+  EXPECT_EQ (corpus_breaks (72),
+             string ("0 12 26 38 51 64 78 94 107 120 134 151 168"));
+}
+
+TEST (line_breaker, narrow) {
+  // most lines end with a hyphenated word in narrow columns
+  EXPECT_EQ (corpus_breaks (6),
+             string ("0 1 2 4 5 6 7 7.2 8 9 10 11 13 14 15 16 17.2 19 20 "
+                     "21.2 23 23.2 24 26 27 28 29 30 31 32 32.2 33 34 35 "
+                     "37 38.2 40 41 42 43.2 44 45 47 48 49 50 52 53.2 55 "
+                     "57 58 58.2 59 60 62 63 64 65 67 69 69.2 70 71 72 74 "
+                     "75.2 77 78 80 82 83 85 87 89 89.2 90 91 93 94 96 "
+                     "96.2 97 99 99.2 100 101 102 103.2 105 106 107 108 "
+                     "109 110 112 113 115 117 118 119 119.2 120 121 123 "
+                     "124 125 126 128 130 131 133 134 135 137 139 142 144 "
+                     "146 147.2 149 150 152 153 156 158 158.2 159 161 163 "
+                     "165 167 168"));
+  EXPECT_EQ (corpus_breaks (9),
+             string ("0 1.5 4 5 7 8 10 11 13 15 17 19 21 23 24 26.2 27.2 "
+                     "29 30.2 32 33 34.2 36 38 40 41 43.2 44 46 48 49.2 51 "
+                     "53 55 57 58 59 61 62.2 63.2 65 67 69 70 72 74 75.2 "
+                     "77 78 80 82.2 84 86 89 90 92 93.2 96 97 99.2 101 102 "
+                     "104 105.2 107 108 109.2 111 113 115 117 119 120 122 "
+                     "123.2 125 127 129 130.2 132 133.2 134.2 136 139 142 "
+                     "144 146 148 149.2 151 153 156 158 159 161 163 166 "
+                     "167.2 168"));
+  EXPECT_EQ (corpus_breaks (14),
+             string ("0 3 4.5 7 8.2 11 14 17 19.2 22 24 27 29 32 34 36.2 "
+                     "39 42 43.8 46 49 51 53.2 57 58.2 60 63 65 68 70 73 "
+                     "75.2 77.5 80 83 87 89.5 92 95 97 99.5 102 105 107 "
+                     "109 112 115 117.2 119.5 122 124 127 130 133 135 138 "
+                     "142 145 148 151 154 158 160 163 166.2 168"));
+}
+
+TEST (line_breaker, benchmark) {
+  string text;
+  for (int i=0; i<20; i++) text << corpus << " ";
+  array<line_item> a= paragraph (text (0, N(text) - 1));
+  time_t t0= texmacs_time ();
+  int lines= 0;
+  for (int chars=30; chars<80; chars += 5) {
+    SI w= chars * CHAR_WIDTH;
+    lines += N(line_breaks (a, 0, N(a), w, w + w/3, 0, 0, false));
+  }
+  time_t t1= texmacs_time ();
+  cout << "Breaking " << N(a) << " words into " << lines << " lines: "
+       << (t1 - t0) << " ms\n";
+  EXPECT_EQ (lines > 0, true);
+}